@@ -12,6 +12,7 @@
 
 #include "rm_assert.h"
 #include "rm_macro.h"
+#include "rm_mem.h"
 #include "rm_type.h"
 
 typedef FILE* rm_file;
@@ -71,9 +72,59 @@ typedef enum __rm_file_seek_origin__
 	RM_FILE_SEEK_ORIGIN_END
 } rm_file_seek_origin;
 
+//A read-only mapping of a whole file into memory:
+typedef struct __rm_file_mapping__
+{
+	//The mapped bytes (null for empty files):
+	const rm_void* data;
+
+	//The size of the file (and the mapping) in bytes:
+	rm_size size;
+} rm_file_mapping;
+
+//How are we going to access a mapping? This is passed to the kernel as a hint.
+typedef enum __rm_file_map_access__
+{
+	//No special treatment:
+	RM_FILE_MAP_ACCESS_NORMAL,
+
+	//We read from front to back. Aggressive read-ahead, pages behind us can be dropped early.
+	RM_FILE_MAP_ACCESS_SEQUENTIAL,
+
+	//We jump around. Don't read ahead.
+	RM_FILE_MAP_ACCESS_RANDOM,
+
+	//We are done with this range for now. Its pages can be freed (they are reloaded on the next access).
+	RM_FILE_MAP_ACCESS_DONE
+} rm_file_map_access;
+
+//The default buffer size of a writer:
+#define RM_FILE_WRITER_DEFAULT_CAPACITY ((rm_size)1 << 20)
+
+//A buffered writer on top of a file.
+//Small writes are collected in the buffer and passed on in large blocks, so writing single values is cheap.
+//A positioned writer passes its blocks on via "pwrite(...)" at an explicit offset instead of through the stream.
+//Several positioned writers can fill disjoint regions of the same file in parallel.
+typedef struct __rm_file_writer__
+{
+	rm_file file;
+	rm_uint8* buf;
+	rm_size capacity;
+	rm_size count;
+
+	//Only valid for positioned writers: The offset where the buffer goes.
+	rm_bool is_positioned;
+	rm_file_offset offset;
+} rm_file_writer;
+
 //Open a file:
 rm_file rm_must_check rm_file_open(const rm_char* path, rm_file_mode mode, rm_file_enc enc);
 
+//Create an anonymous temporary file for reading and writing in "dir".
+//If "dir" is null, "$TMPDIR" is used (or "/tmp" if it is not set).
+//The file is deleted right away, so it vanishes when it is closed (or the process dies).
+rm_file rm_must_check rm_file_open_temp(const rm_char* dir);
+
 //Close a file:
 rm_void rm_file_close(rm_file file);
 
@@ -86,6 +137,28 @@ rm_file_offset rm_file_tell(rm_file file);
 //Flush a file opened for writing:
 rm_void rm_file_flush(rm_file file);
 
+//Get the size of a regular file and return "true".
+//Other files (e.g. pipes) have no size, then "false" is returned.
+rm_bool rm_file_get_size(rm_file file, rm_file_offset* size);
+
+//Map a whole file read-only into memory instead of reading it.
+//No copy is made and no read calls are issued, pages are loaded on demand.
+//The data is page-aligned, so it can be reinterpreted as an array of any integer type (e.g. "const rm_tristripper_id*").
+//If "populate" is "true", all pages are loaded in advance (Linux only, ignored elsewhere).
+//The mapping must be released via "rm_file_unmap(...)".
+rm_file_mapping rm_must_check rm_file_map(const rm_char* path, rm_file_map_access access, rm_bool populate);
+
+//Map a whole file that is already open (e.g. a temporary file) like "rm_file_map(...)".
+//Flush the file before if it has been written through its stream. The file can be closed while the mapping is alive.
+rm_file_mapping rm_must_check rm_file_map_open(rm_file file, rm_file_map_access access, rm_bool populate);
+
+//Change the access hint for "size" bytes at "offset" of the mapping.
+//The range is extended to page boundaries.
+rm_void rm_file_map_advise(const rm_file_mapping* mapping, rm_size offset, rm_size size, rm_file_map_access access);
+
+//Release a mapping that has been created by "rm_file_map(...)":
+rm_void rm_file_unmap(const rm_file_mapping* mapping);
+
 //Read "size" bytes from "file" to "dest_ptr".
 //The number of read bytes is returned. If it is != "size", the EOF has been reached prematurely.
 //If the function returns, reading has succeeded (IO errors automatically trigger a precondition).
@@ -119,6 +192,49 @@ inline rm_void rm_file_write_int32(rm_file file, rm_int32 value);
 inline rm_void rm_file_write_uint64(rm_file file, rm_uint64 value);
 inline rm_void rm_file_write_int64(rm_file file, rm_int64 value);
 
+//Read up to "size" bytes at "offset" of "file" to "dest_ptr" via "pread(...)".
+//The number of read bytes is returned. If it is != "size", the EOF has been reached.
+//Like "rm_file_write_at(...)", this bypasses the stream.
+rm_size rm_file_read_at(rm_file file, rm_file_offset offset, rm_void* dest_ptr, rm_size size);
+
+//Write "size" bytes from "src_ptr" at "offset" of "file" via "pwrite(...)".
+//The stream position is not touched and the stream buffer is bypassed, so flush the stream before if you mix both.
+//Writes to disjoint regions can be issued from different threads.
+rm_void rm_file_write_at(rm_file file, rm_file_offset offset, const rm_void* src_ptr, rm_size size);
+
+//Create a writer that appends to "file" at its current position, with a buffer of "capacity" bytes:
+rm_void rm_file_writer_init(rm_file_writer* writer, rm_file file, rm_size capacity);
+
+//Create a positioned writer that fills "file" from "offset" on, with a buffer of "capacity" bytes:
+rm_void rm_file_writer_init_at(rm_file_writer* writer, rm_file file, rm_file_offset offset, rm_size capacity);
+
+//Pass the buffered bytes on to the file.
+//Writers on the stream flush the stream as well, so the bytes are visible to "rm_file_write_at(...)" and other processes.
+rm_void rm_file_writer_flush(rm_file_writer* writer);
+
+//Flush the writer and free its buffer. The file stays open.
+rm_void rm_file_writer_dispose(rm_file_writer* writer);
+
+//Write "size" bytes from "src_ptr".
+//Blocks that are at least as large as the buffer bypass it.
+inline rm_void rm_file_writer_write(rm_file_writer* writer, const rm_void* src_ptr, rm_size size);
+
+//Write different integer types in LE order (like "rm_file_write_uint8(...)" and friends):
+inline rm_void rm_file_writer_write_uint8(rm_file_writer* writer, rm_uint8 value);
+inline rm_void rm_file_writer_write_int8(rm_file_writer* writer, rm_int8 value);
+inline rm_void rm_file_writer_write_uint16(rm_file_writer* writer, rm_uint16 value);
+inline rm_void rm_file_writer_write_int16(rm_file_writer* writer, rm_int16 value);
+inline rm_void rm_file_writer_write_uint32(rm_file_writer* writer, rm_uint32 value);
+inline rm_void rm_file_writer_write_int32(rm_file_writer* writer, rm_int32 value);
+inline rm_void rm_file_writer_write_uint64(rm_file_writer* writer, rm_uint64 value);
+inline rm_void rm_file_writer_write_int64(rm_file_writer* writer, rm_int64 value);
+
+//Write arrays of integers in LE order.
+//On LE hosts, this is a plain copy. On BE hosts, the values are swapped in tight loops that the compiler can vectorize.
+rm_void rm_file_writer_write_uint16_array(rm_file_writer* writer, const rm_uint16* values, rm_size count);
+rm_void rm_file_writer_write_uint32_array(rm_file_writer* writer, const rm_uint32* values, rm_size count);
+rm_void rm_file_writer_write_uint64_array(rm_file_writer* writer, const rm_uint64* values, rm_size count);
+
 inline rm_size rm_file_read(rm_file file, rm_void* dest_ptr, rm_size size)
 {
 	//Try to read all the bytes:
@@ -211,4 +327,81 @@ inline rm_void rm_file_write_int64(rm_file file, rm_int64 value)
 	rm_file_write_uint64(file, (rm_uint64)value);
 }
 
+inline rm_void rm_file_writer_write(rm_file_writer* writer, const rm_void* src_ptr, rm_size size)
+{
+	//Fast path: The bytes fit into the buffer.
+	if (rm_likely(size <= writer->capacity - writer->count))
+	{
+		rm_mem_copy(writer->buf + writer->count, src_ptr, size);
+		writer->count += size;
+
+		return;
+	}
+
+	//Make room:
+	rm_file_writer_flush(writer);
+
+	if (size < writer->capacity)
+	{
+		rm_mem_copy(writer->buf, src_ptr, size);
+		writer->count = size;
+
+		return;
+	}
+
+	//The block is too large to be buffered:
+	if (writer->is_positioned)
+	{
+		rm_file_write_at(writer->file, writer->offset, src_ptr, size);
+		writer->offset += (rm_file_offset)size;
+	}
+	else
+	{
+		rm_file_write(writer->file, src_ptr, size);
+	}
+}
+
+inline rm_void rm_file_writer_write_uint8(rm_file_writer* writer, rm_uint8 value)
+{
+	rm_file_writer_write(writer, &value, sizeof(rm_uint8));
+}
+
+inline rm_void rm_file_writer_write_int8(rm_file_writer* writer, rm_int8 value)
+{
+	rm_file_writer_write_uint8(writer, (rm_uint8)value);
+}
+
+inline rm_void rm_file_writer_write_uint16(rm_file_writer* writer, rm_uint16 value)
+{
+	value = rm_flip_host_to_le_16(value);
+	rm_file_writer_write(writer, &value, sizeof(rm_uint16));
+}
+
+inline rm_void rm_file_writer_write_int16(rm_file_writer* writer, rm_int16 value)
+{
+	rm_file_writer_write_uint16(writer, (rm_uint16)value);
+}
+
+inline rm_void rm_file_writer_write_uint32(rm_file_writer* writer, rm_uint32 value)
+{
+	value = rm_flip_host_to_le_32(value);
+	rm_file_writer_write(writer, &value, sizeof(rm_uint32));
+}
+
+inline rm_void rm_file_writer_write_int32(rm_file_writer* writer, rm_int32 value)
+{
+	rm_file_writer_write_uint32(writer, (rm_uint32)value);
+}
+
+inline rm_void rm_file_writer_write_uint64(rm_file_writer* writer, rm_uint64 value)
+{
+	value = rm_flip_host_to_le_64(value);
+	rm_file_writer_write(writer, &value, sizeof(rm_uint64));
+}
+
+inline rm_void rm_file_writer_write_int64(rm_file_writer* writer, rm_int64 value)
+{
+	rm_file_writer_write_uint64(writer, (rm_uint64)value);
+}
+
 #endif
@@ -32,6 +32,37 @@ typedef enum __rm_hashmap_update_mode__
 	RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE
 } rm_hashmap_update_mode;
 
+//How many chain lengths are counted separately by rm_##name##_hashmap_get_stats(...)? Longer chains are counted in the last one.
+#define RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT ((rm_size)8)
+
+//The layout of a hashmap as reported by rm_##name##_hashmap_get_stats(...).
+//It is gathered by a walk over the table on demand, so a hashmap only pays for the resize counter if nobody asks.
+//
+// - "buckets_by_chain_length": The number of buckets with a chain of i entries (the empty ones at index 0).
+// - "max_chain_length":        The longest chain.
+// - "mean_chain_length":       The mean length of the chains in the used buckets.
+// - "mean_lookup_length":      The mean number of entries a successful lookup visits (every key looked up once).
+// - "collision_entries_count": The entries in the collision vector (in use or in the supply list).
+// - "supply_list_count":       The removed entries in the supply list that wait to be reused.
+// - "resizes_count":           The number of resizes since the hashmap has been initialized.
+// - "allocated_bytes":         Buckets and collision vector capacity.
+//
+//rm_hashmap_oa.h reports probe sequences instead of chains (see there).
+typedef struct __rm_hashmap_stats__
+{
+	rm_size count;
+	rm_size buckets_count;
+	rm_size used_buckets_count;
+	rm_size buckets_by_chain_length[RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT];
+	rm_size max_chain_length;
+	rm_double mean_chain_length;
+	rm_double mean_lookup_length;
+	rm_size collision_entries_count;
+	rm_size supply_list_count;
+	rm_size resizes_count;
+	rm_size allocated_bytes;
+} rm_hashmap_stats;
+
 //********************************************************
 //	Generic type declarations
 //********************************************************
@@ -185,6 +216,9 @@ typedef struct __rm_##name##_hashmap__
 	*/                                                                                                                                             	\
 	public_interface_get rm_double load_factor;                                                                                                    	\
 	public_interface_get rm_size count_threshold;                                                                                                  	\
+                                                                                                                                                   	\
+	/* The number of resizes since the initialization (see rm_##name##_hashmap_get_stats(...)) */                                                  	\
+	public_interface_get rm_size resizes_count;                                                                                                    	\
 } rm_##name##_hashmap;                                                                                                                             	\
                                                                                                                                                    	\
 /* An iteration function that allows to process all key-value pairs in a hashmap */                                                                	\
@@ -212,6 +246,10 @@ typedef rm_bool (*rm_##name##_hashmap_debug_iteration_func)(const rm_##name##_ha
 #define RM_HASHMAP_HASH_EMPTY ((rm_hashmap_hash)0)
 #define RM_HASHMAP_NO_MORE_ENTRIES ((rm_size)0)
 
+//How many keys ahead do the batch functions prefetch?
+//The window should cover the latency of a cache miss, but too many prefetches in flight just evict each other.
+#define RM_HASHMAP_BATCH_WINDOW ((rm_size)16)
+
 //********************************************************
 //	Macro definitions
 //********************************************************
@@ -269,6 +307,43 @@ typedef rm_bool (*rm_##name##_hashmap_debug_iteration_func)(const rm_##name##_ha
 	(((rm_size)(_entry - rm_vec_ptr_at(&(map)->collision_entries, 0))) + 1);           	\
 })
 
+//Callbacks are passed to RM_HASHMAP_DEFINE(...) as function names or null. We decide at compile time:
+//Null callbacks compile out completely (even without optimization), the others are called directly and can be inlined.
+#define rm_hashmap_has_func(func) __builtin_choose_expr(__builtin_types_compatible_p(typeof(func), rm_void*), false, true)
+
+//Call a callback (see above) or evaluate to the fallback if it is null.
+#define rm_hashmap_call_func(func_type, func, fallback, ...) __builtin_choose_expr(__builtin_types_compatible_p(typeof(func), rm_void*), (fallback), ((func_type)(func))(__VA_ARGS__))
+
+/*
+	Hash mixers make every bit of a hash depend on all of its bits. Hash functions can wrap their result in one of them.
+	The buckets are addressed by the low bits of a hash, so hashes that mostly differ in their high bits pile up in long chains.
+	rm_##name##_hashmap_get_stats(...) shows if that happens. But mixing also scatters similar keys that would share cache lines otherwise.
+
+	- rm_hashmap_mix_identity: Leave the hash as it is.
+	- rm_hashmap_mix_fold: Multiply with 2^64 / phi and fold the 128 bit product (cheap, every input bit affects every output bit).
+	- rm_hashmap_mix_murmur3: The 64 bit finalizer of MurmurHash3 (a few cycles more, but a full avalanche).
+*/
+#define rm_hashmap_mix_identity(hash) ((rm_hashmap_hash)(hash))
+
+#define rm_hashmap_mix_fold(hash)                                                    	\
+({                                                                                   	\
+	rm_uint128 _product = ((rm_uint128)(hash)) * ((rm_uint128)0x9e3779b97f4a7c15ULL);	\
+	(rm_hashmap_hash)(((rm_uint64)(_product >> 64)) ^ ((rm_uint64)_product));        	\
+})
+
+#define rm_hashmap_mix_murmur3(hash)     	\
+({                                       	\
+	rm_uint64 _mixed = (rm_uint64)(hash);	\
+                                         	\
+	_mixed ^= _mixed >> 33;              	\
+	_mixed *= 0xff51afd7ed558ccdULL;     	\
+	_mixed ^= _mixed >> 33;              	\
+	_mixed *= 0xc4ceb9fe1a85ec53ULL;     	\
+	_mixed ^= _mixed >> 33;              	\
+                                         	\
+	(rm_hashmap_hash)_mixed;             	\
+})
+
 //Attach a collision vector entry to the head of the supply list.
 //Do not call this for bucket base entries!
 #define rm_hashmap_add_to_supply_list(map, entry)                             	\
@@ -285,74 +360,93 @@ typedef rm_bool (*rm_##name##_hashmap_debug_iteration_func)(const rm_##name##_ha
 //	Generic function declarations
 //********************************************************
 
-#define RM_HASHMAP_DECLARE_FUNCTIONS(name)                                                                                                                                                        	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Initialize a new hashmap.                                                                                                                                                                     	\
-	The extended version also allows to choose an initial bucket count € [0, RM_HASHMAP_MAX_BUCKETS_COUNT]                                                                                        	\
-	(will be ceiled to a PoT >= 1) and a load factor >= 0.                                                                                                                                        	\
-	Hash and key compare functions are required.                                                                                                                                                  	\
-	But all ref / unref funcs may be null (even in an asymmetric manner).                                                                                                                         	\
-*/                                                                                                                                                                                                	\
-inline rm_void rm_##name##_hashmap_init(rm_##name##_hashmap* map);                                                                                                                                	\
-rm_void rm_##name##_hashmap_init_ex(rm_##name##_hashmap* map, rm_size initial_buckets_count, rm_double load_factor);                                                                              	\
-                                                                                                                                                                                                  	\
-/* Dispose an existing hashmap. */                                                                                                                                                                	\
-rm_void rm_##name##_hashmap_dispose(rm_##name##_hashmap* map);                                                                                                                                    	\
-                                                                                                                                                                                                  	\
-/* Clear the given hashmap. The current allocated capacities (bucket count, collision vector capacity) are kept. */                                                                               	\
-rm_void rm_##name##_hashmap_clear(rm_##name##_hashmap* map);                                                                                                                                      	\
-                                                                                                                                                                                                  	\
-/* Check if a given key is in the hashmap. */                                                                                                                                                     	\
-rm_bool rm_##name##_hashmap_contains_key(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key);                                                                                            	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Try to retrieve the value for the given key.                                                                                                                                                  	\
-	Return "default_value" if that fails.                                                                                                                                                         	\
-*/                                                                                                                                                                                                	\
-inline rm_##name##_hashmap_value rm_##name##_hashmap_get(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value default_value);                                   	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Try to retrieve the value for the given key.                                                                                                                                                  	\
-	If "true" is returned, the given key has been found and the corresponding value has been saved to "*value_ptr".                                                                               	\
-	If "false" is returned, the key is not present and the value is left unchanged.                                                                                                               	\
-*/                                                                                                                                                                                                	\
-rm_bool rm_##name##_hashmap_get_ex(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr);                                                            	\
-                                                                                                                                                                                                  	\
-/* Set the value for a given key. Return if the value has been overwritten (true) or newly inserted (false). */                                                                                   	\
-rm_bool rm_##name##_hashmap_set(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value);                                                                          	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Update the value for a given key. Return if a value for this key already exists.                                                                                                              	\
-	If "true" is returned, "*old_value_ptr" receives the old value. For "false", it is left unchanged.                                                                                            	\
-	What "updating" means depends on the mode:                                                                                                                                                    	\
-                                                                                                                                                                                                  	\
-	 - RM_HASHMAP_UPDATE_MODE_REPLACE: Replace, but never insert                                                                                                                                  	\
-	 - RM_HASHMAP_UPDATE_MODE_INSERT: Insert, but never replace                                                                                                                                   	\
-	 - RM_HASHMAP_UPDATE_MODE_SET: Replace and insert (same as rm_hashmap_set(...))                                                                                                               	\
-	 - RM_HASHMAP_UPDATE_MODE_MERGE: Combine old and new value using a merge function, but never insert                                                                                           	\
-	 - RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE: Like RM_HASHMAP_UPDATE_MODE_MERGE, but also insert if no value is present                                                                          	\
-                                                                                                                                                                                                  	\
-	*Important*: In case of return value "true", a potential unref function for the old value *will not be called*!                                                                               	\
-	You have to do that manually, but not for RM_HASHMAP_UPDATE_MODE_INSERT                                                                                                                       	\
-	(in that case, the value is not replaced and still referenced by the hashmap).                                                                                                                	\
-*/                                                                                                                                                                                                	\
-rm_bool rm_##name##_hashmap_update(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr);	\
-                                                                                                                                                                                                  	\
-/* Remove a potential value for the given key. Return if it was found (and removed). */                                                                                                           	\
-rm_bool rm_##name##_hashmap_remove(rm_##name##_hashmap* map, rm_##name##_hashmap_key key);                                                                                                        	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Call "iteration_func" for each key-value pair inside the hashmap.                                                                                                                             	\
-	The function receives the map, the pair and a context. Order is undefined.                                                                                                                    	\
-*/                                                                                                                                                                                                	\
-inline rm_void rm_##name##_hashmap_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context);                                                 	\
-                                                                                                                                                                                                  	\
-/*                                                                                                                                                                                                	\
-	Call "_hashmap_debug_iteration_func" for each key-value pair inside the hashmap.                                                                                                              	\
-	The function receives the map, the entry, a flag to detect collisions and a context. Order is undefined.                                                                                      	\
-*/                                                                                                                                                                                                	\
-inline rm_void rm_##name##_hashmap_debug_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_debug_iteration_func debug_iteration_func, rm_void* context);
+#define RM_HASHMAP_DECLARE_FUNCTIONS(name)                                                                                                                                                                                                            	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Initialize a new hashmap.                                                                                                                                                                                                                         	\
+	The extended version also allows to choose an initial bucket count € [0, RM_HASHMAP_MAX_BUCKETS_COUNT]                                                                                                                                            	\
+	(will be ceiled to a PoT >= 1) and a load factor >= 0.                                                                                                                                                                                            	\
+	Hash and key compare functions are required.                                                                                                                                                                                                      	\
+	But all ref / unref funcs may be null (even in an asymmetric manner).                                                                                                                                                                             	\
+*/                                                                                                                                                                                                                                                    	\
+inline rm_void rm_##name##_hashmap_init(rm_##name##_hashmap* map);                                                                                                                                                                                    	\
+rm_void rm_##name##_hashmap_init_ex(rm_##name##_hashmap* map, rm_size initial_buckets_count, rm_double load_factor);                                                                                                                                  	\
+                                                                                                                                                                                                                                                      	\
+/* Dispose an existing hashmap. */                                                                                                                                                                                                                    	\
+rm_void rm_##name##_hashmap_dispose(rm_##name##_hashmap* map);                                                                                                                                                                                        	\
+                                                                                                                                                                                                                                                      	\
+/* Clear the given hashmap. The current allocated capacities (bucket count, collision vector capacity) are kept. */                                                                                                                                   	\
+rm_void rm_##name##_hashmap_clear(rm_##name##_hashmap* map);                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                                      	\
+/* Check if a given key is in the hashmap. */                                                                                                                                                                                                         	\
+rm_bool rm_##name##_hashmap_contains_key(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key);                                                                                                                                                	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Try to retrieve the value for the given key.                                                                                                                                                                                                      	\
+	Return "default_value" if that fails.                                                                                                                                                                                                             	\
+*/                                                                                                                                                                                                                                                    	\
+inline rm_##name##_hashmap_value rm_##name##_hashmap_get(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value default_value);                                                                                       	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Try to retrieve the value for the given key.                                                                                                                                                                                                      	\
+	If "true" is returned, the given key has been found and the corresponding value has been saved to "*value_ptr".                                                                                                                                   	\
+	If "false" is returned, the key is not present and the value is left unchanged.                                                                                                                                                                   	\
+*/                                                                                                                                                                                                                                                    	\
+rm_bool rm_##name##_hashmap_get_ex(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr);                                                                                                                	\
+                                                                                                                                                                                                                                                      	\
+/* Set the value for a given key. Return if the value has been overwritten (true) or newly inserted (false). */                                                                                                                                       	\
+rm_bool rm_##name##_hashmap_set(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value);                                                                                                                              	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Update the value for a given key. Return if a value for this key already exists.                                                                                                                                                                  	\
+	If "true" is returned, "*old_value_ptr" receives the old value. For "false", it is left unchanged.                                                                                                                                                	\
+	What "updating" means depends on the mode:                                                                                                                                                                                                        	\
+                                                                                                                                                                                                                                                      	\
+	 - RM_HASHMAP_UPDATE_MODE_REPLACE: Replace, but never insert                                                                                                                                                                                      	\
+	 - RM_HASHMAP_UPDATE_MODE_INSERT: Insert, but never replace                                                                                                                                                                                       	\
+	 - RM_HASHMAP_UPDATE_MODE_SET: Replace and insert (same as rm_hashmap_set(...))                                                                                                                                                                   	\
+	 - RM_HASHMAP_UPDATE_MODE_MERGE: Combine old and new value using a merge function, but never insert                                                                                                                                               	\
+	 - RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE: Like RM_HASHMAP_UPDATE_MODE_MERGE, but also insert if no value is present                                                                                                                              	\
+                                                                                                                                                                                                                                                      	\
+	*Important*: In case of return value "true", a potential unref function for the old value *will not be called*!                                                                                                                                   	\
+	You have to do that manually, but not for RM_HASHMAP_UPDATE_MODE_INSERT                                                                                                                                                                           	\
+	(in that case, the value is not replaced and still referenced by the hashmap).                                                                                                                                                                    	\
+*/                                                                                                                                                                                                                                                    	\
+rm_bool rm_##name##_hashmap_update(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr);                                                    	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Batched versions of get_ex(...) and update(...) for "count" keys.                                                                                                                                                                                 	\
+	The keys are resolved one after another in their order, so the outcome is the same as for a loop over the single versions                                                                                                                         	\
+	(this also holds if a key appears multiple times or an update resizes the hashmap).                                                                                                                                                               	\
+	But while resolving a key, the buckets for the keys RM_HASHMAP_BATCH_WINDOW positions ahead are already prefetched.                                                                                                                               	\
+	This hides the cache misses of big hashmaps behind each other instead of stalling on them in turn.                                                                                                                                                	\
+                                                                                                                                                                                                                                                      	\
+	"results" receives the return value of the single version for every key. "values" resp. "old_values" receive the (old) values like "*value_ptr" resp. "*old_value_ptr".                                                                           	\
+	"results" and "old_values" may be null if they are not needed. Both functions return how often the single version would have returned "true".                                                                                                     	\
+*/                                                                                                                                                                                                                                                    	\
+rm_size rm_##name##_hashmap_get_batch(const rm_##name##_hashmap* map, const rm_##name##_hashmap_key* keys, rm_size count, rm_##name##_hashmap_value* values, rm_bool* results);                                                                       	\
+rm_size rm_##name##_hashmap_update_batch(rm_##name##_hashmap* map, const rm_##name##_hashmap_key* keys, const rm_##name##_hashmap_value* values, rm_size count, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_values, rm_bool* results);	\
+                                                                                                                                                                                                                                                      	\
+/* Remove a potential value for the given key. Return if it was found (and removed). */                                                                                                                                                               	\
+rm_bool rm_##name##_hashmap_remove(rm_##name##_hashmap* map, rm_##name##_hashmap_key key);                                                                                                                                                            	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Call "iteration_func" for each key-value pair inside the hashmap.                                                                                                                                                                                 	\
+	The function receives the map, the pair and a context. Order is undefined.                                                                                                                                                                        	\
+*/                                                                                                                                                                                                                                                    	\
+inline rm_void rm_##name##_hashmap_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context);                                                                                                     	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Call "_hashmap_debug_iteration_func" for each key-value pair inside the hashmap.                                                                                                                                                                  	\
+	The function receives the map, the entry, a flag to detect collisions and a context. Order is undefined.                                                                                                                                          	\
+*/                                                                                                                                                                                                                                                    	\
+inline rm_void rm_##name##_hashmap_debug_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_debug_iteration_func debug_iteration_func, rm_void* context);                                                                                   	\
+                                                                                                                                                                                                                                                      	\
+/*                                                                                                                                                                                                                                                    	\
+	Gather statistics about the layout of the hashmap (see rm_hashmap_stats).                                                                                                                                                                         	\
+	This walks all buckets and chains, so it is meant for diagnostics (e.g. to compare hash mixers) and not for hot paths.                                                                                                                            	\
+*/                                                                                                                                                                                                                                                    	\
+rm_void rm_##name##_hashmap_get_stats(const rm_##name##_hashmap* map, rm_hashmap_stats* stats);
 
 //********************************************************
 //	Generic function definitions (private)
@@ -363,35 +457,29 @@ inline rm_void rm_##name##_hashmap_debug_for_each(const rm_##name##_hashmap* map
 /* Calculate the hash for a given key. */                                                                                 	\
 static inline rm_hashmap_hash rm_##name##_hashmap_hash_key(rm_##name##_hashmap_key key)                                   	\
 {                                                                                                                         	\
-	/* Get a function pointer to the hash function. */                                                                    	\
-	rm_##name##_hashmap_hash_func hash = (rm_##name##_hashmap_hash_func)hash_func;                                        	\
-                                                                                                                          	\
-	/* Calculate the hash with it. */                                                                                     	\
-	rm_hashmap_hash new_hash = hash(key);                                                                                 	\
+	/* Calculate the hash (the hash function is called directly, so it can be inlined). */                                	\
+	rm_hashmap_hash new_hash = ((rm_##name##_hashmap_hash_func)(hash_func))(key);                                         	\
                                                                                                                           	\
 	/* Make sure we don't encounter RM_HASHMAP_HASH_EMPTY in the wild, but still make use of bucket 0. */                 	\
 	return (new_hash == RM_HASHMAP_HASH_EMPTY) ? (((rm_hashmap_hash)1) << ((8 * sizeof(rm_hashmap_hash)) - 1)) : new_hash;	\
 }
 
-#define RM_HASHMAP_DEFINE_KEY_MATCHES_ENTRY(name, key_compare_func)                                                                                       	\
-                                                                                                                                                          	\
-/* Does the given key correspond to the given entry? */                                                                                                   	\
-static inline rm_bool rm_##name##_hashmap_key_matches_entry(rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_##name##_hashmap_entry_const_ptr entry) 	\
-{                                                                                                                                                         	\
-	/* Get a function pointer to the key compare function. */                                                                                             	\
-	rm_##name##_hashmap_key_compare_func key_compare = (rm_##name##_hashmap_key_compare_func)key_compare_func;                                            	\
-                                                                                                                                                          	\
-	/*                                                                                                                                                    	\
-		Perform the following two-step comparison algorithm:                                                                                              	\
-                                                                                                                                                          	\
-		1.) Compare the hashes. They are not necessarily equal because we cut off some bits when determining the offset.                                  	\
-		    Comparing hashes is fast and cheap. Equal hashes are required, but not sufficient for equality.                                               	\
-                                                                                                                                                          	\
-	    2.) If the hashes are equal, we have to invoke the key comparison function.                                                                       	\
-	        It is required and sufficient for equality.                                                                                                   	\
-	*/                                                                                                                                                    	\
-                                                                                                                                                          	\
-	return (entry->hash == hash) && key_compare(key, entry->key);                                                                                         	\
+#define RM_HASHMAP_DEFINE_KEY_MATCHES_ENTRY(name, key_compare_func)                                                                                      	\
+                                                                                                                                                         	\
+/* Does the given key correspond to the given entry? */                                                                                                  	\
+static inline rm_bool rm_##name##_hashmap_key_matches_entry(rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_##name##_hashmap_entry_const_ptr entry)	\
+{                                                                                                                                                        	\
+	/*                                                                                                                                                   	\
+		Perform the following two-step comparison algorithm:                                                                                             	\
+                                                                                                                                                         	\
+		1.) Compare the hashes. They are not necessarily equal because we cut off some bits when determining the offset.                                 	\
+		    Comparing hashes is fast and cheap. Equal hashes are required, but not sufficient for equality.                                              	\
+                                                                                                                                                         	\
+	    2.) If the hashes are equal, we have to invoke the key comparison function.                                                                      	\
+	        It is required and sufficient for equality.                                                                                                  	\
+	*/                                                                                                                                                   	\
+                                                                                                                                                         	\
+	return (entry->hash == hash) && ((rm_##name##_hashmap_key_compare_func)(key_compare_func))(key, entry->key);                                         	\
 }
 
 #define RM_HASHMAP_DEFINE_RESIZE(name)                                                                                                                                                                   	\
@@ -412,7 +500,7 @@ static rm_void rm_##name##_hashmap_resize(rm_##name##_hashmap* map)
 	rm_size new_count_threshold = rm_hashmap_calculate_count_threshold(map->load_factor, new_buckets_count);                                                                                             	\
                                                                                                                                                                                                          	\
 	/* Reallocate the table and zero the upper half out. */                                                                                                                                              	\
-	map->buckets = rm_realloc(map->buckets, new_buckets_count * sizeof(rm_##name##_hashmap_entry));                                                                                                      	\
+	map->buckets = rm_realloc_large(map->buckets, new_buckets_count * sizeof(rm_##name##_hashmap_entry));                                                                                                	\
 	rm_mem_set(&map->buckets[map->buckets_count], 0, map->buckets_count * sizeof(rm_##name##_hashmap_entry));                                                                                            	\
                                                                                                                                                                                                          	\
 	/* Print some debug log info. */                                                                                                                                                                     	\
@@ -565,6 +653,7 @@ static rm_void rm_##name##_hashmap_resize(rm_##name##_hashmap* map)
 	/* Assign the new values. */                                                                                                                                                                         	\
 	map->buckets_count = new_buckets_count;                                                                                                                                                              	\
 	map->count_threshold = new_count_threshold;                                                                                                                                                          	\
+	map->resizes_count++;                                                                                                                                                                                	\
 }
 
 #define RM_HASHMAP_DEFINE_FIND_ENTRY_IN_BUCKET(name)                                                                                                                                                                                          	\
@@ -642,6 +731,17 @@ static inline rm_##name##_hashmap_entry_ptr rm_##name##_hashmap_find_entry(const
 	return rm_##name##_hashmap_find_entry_in_bucket(map, entry, key, hash, null);                                                                            	\
 }
 
+#define RM_HASHMAP_DEFINE_PREFETCH(name)                                                                                    	\
+                                                                                                                            	\
+/* Prefetch the bucket for the given hash (a chained entry behind it will still miss, but most keys sit in their bucket). */	\
+static inline rm_void rm_##name##_hashmap_prefetch(const rm_##name##_hashmap* map, rm_hashmap_hash hash)                    	\
+{                                                                                                                           	\
+	if (rm_likely(map->buckets_count > 0))                                                                                  	\
+	{                                                                                                                       	\
+		rm_prefetch(rm_hashmap_get_bucket_for_hash(map, hash));                                                       	\
+	}                                                                                                                       	\
+}
+
 #define RM_HASHMAP_DEFINE_UNREF_ENTRY(name, key_unref_func, value_unref_func)                                                                                        	\
                                                                                                                                                                      	\
 /* Unref key and / or value of a single hashmap entry. */                                                                                                            	\
@@ -650,43 +750,28 @@ static inline rm_bool rm_##name##_hashmap_unref_entry(const rm_##name##_hashmap*
 	rm_unused(map);                                                                                                                                                  	\
 	rm_unused(context);                                                                                                                                              	\
                                                                                                                                                                      	\
-	/* Get function pointers to the unref funcs. */                                                                                                                  	\
-	rm_##name##_hashmap_key_unref_func key_unref = (rm_##name##_hashmap_key_unref_func)key_unref_func;                                                               	\
-	rm_##name##_hashmap_value_unref_func value_unref = (rm_##name##_hashmap_value_unref_func)value_unref_func;                                                       	\
-                                                                                                                                                                     	\
-	/* Key */                                                                                                                                                        	\
-	if (key_unref)                                                                                                                                                   	\
-	{                                                                                                                                                                	\
-		key_unref(key);                                                                                                                                              	\
-	}                                                                                                                                                                	\
-                                                                                                                                                                     	\
-	/* Value */                                                                                                                                                      	\
-	if (value_unref)                                                                                                                                                 	\
-	{                                                                                                                                                                	\
-		value_unref(value);                                                                                                                                          	\
-	}                                                                                                                                                                	\
+	/* Key and value (null unref funcs compile out). */                                                                                                              	\
+	rm_hashmap_call_func(rm_##name##_hashmap_key_unref_func, key_unref_func, (rm_void)0, key);                                                                       	\
+	rm_hashmap_call_func(rm_##name##_hashmap_value_unref_func, value_unref_func, (rm_void)0, value);                                                                 	\
                                                                                                                                                                      	\
 	/* Keep going! */                                                                                                                                                	\
 	return true;                                                                                                                                                     	\
 }
 
-#define RM_HASHMAP_DEFINE_UNREF_ALL(name, key_unref_func, value_unref_func)                                   	\
-                                                                                                              	\
-/* Unref all keys and / or values of entries in the hashmap. */                                               	\
-static inline rm_void rm_##name##_hashmap_unref_all(const rm_##name##_hashmap* map)                           	\
-{                                                                                                             	\
-	/*                                                                                                        	\
-		Unref all keys and values via iteration.                                                              	\
-		This is an expensive operation, so we only perform it                                                 	\
-		if there are entries and at least one unref function pointer is present.                              	\
-	*/                                                                                                        	\
-	rm_##name##_hashmap_key_unref_func key_unref = (rm_##name##_hashmap_key_unref_func)key_unref_func;        	\
-	rm_##name##_hashmap_value_unref_func value_unref = (rm_##name##_hashmap_value_unref_func)value_unref_func;	\
-                                                                                                              	\
-	if ((map->count > 0) && (key_unref || value_unref))                                                       	\
-	{                                                                                                         	\
-		rm_##name##_hashmap_for_each(map, rm_##name##_hashmap_unref_entry, null);                             	\
-	}                                                                                                         	\
+#define RM_HASHMAP_DEFINE_UNREF_ALL(name, key_unref_func, value_unref_func)                                	\
+                                                                                                           	\
+/* Unref all keys and / or values of entries in the hashmap. */                                            	\
+static inline rm_void rm_##name##_hashmap_unref_all(const rm_##name##_hashmap* map)                        	\
+{                                                                                                          	\
+	/*                                                                                                     	\
+		Unref all keys and values via iteration.                                                           	\
+		This is an expensive operation, so we only perform it                                              	\
+		if there are entries and at least one unref function pointer is present.                           	\
+	*/                                                                                                     	\
+	if ((rm_hashmap_has_func(key_unref_func) || rm_hashmap_has_func(value_unref_func)) && (map->count > 0))	\
+	{                                                                                                      	\
+		rm_##name##_hashmap_for_each(map, rm_##name##_hashmap_unref_entry, null);                          	\
+	}                                                                                                      	\
 }
 
 //********************************************************
@@ -802,7 +887,7 @@ rm_void rm_##name##_hashmap_init_ex(rm_##name##_hashmap* map, rm_size initial_bu
 			Allocate the first array of buckets.                                                                                                      	\
 			Make sure it is zeroed out so we can detect empty entries via nullpointers.                                                               	\
 		*/                                                                                                                                            	\
-		map->buckets = rm_malloc_zero(map->buckets_count * sizeof(rm_##name##_hashmap_entry));                                                        	\
+		map->buckets = rm_malloc_large_zero(map->buckets_count * sizeof(rm_##name##_hashmap_entry));                                                  	\
 	}                                                                                                                                                 	\
                                                                                                                                                       	\
 	/* Initialize the vector that will hold the entries. */                                                                                           	\
@@ -814,6 +899,9 @@ rm_void rm_##name##_hashmap_init_ex(rm_##name##_hashmap* map, rm_size initial_bu
 	/* Assign the load factor and calculate the first threshold for the count. */                                                                     	\
 	map->load_factor = load_factor;                                                                                                                   	\
 	map->count_threshold = rm_hashmap_calculate_count_threshold(map->load_factor, map->buckets_count);                                                	\
+                                                                                                                                                      	\
+	/* Nothing has been resized yet. */                                                                                                               	\
+	map->resizes_count = 0;                                                                                                                           	\
 }
 
 #define RM_HASHMAP_DEFINE_DISPOSE(name)                            	\
@@ -833,30 +921,30 @@ rm_void rm_##name##_hashmap_dispose(rm_##name##_hashmap* map)      	\
 	rm_vec_dispose(&map->collision_entries);                       	\
 }
 
-#define RM_HASHMAP_DEFINE_CLEAR(name)                                                           	\
-                                                                                                	\
-rm_void rm_##name##_hashmap_clear(rm_##name##_hashmap* map)                                     	\
-{                                                                                               	\
-	/* Unref all keys and values. */                                                            	\
-	rm_##name##_hashmap_unref_all(map);                                                         	\
-                                                                                                	\
-	/* Reset the count. */                                                                      	\
-	map->count = 0;                                                                             	\
-                                                                                                	\
-	/*                                                                                          	\
-		Null the buckets -> empty hashes.                                                       	\
-		rm_memset() does *not* accept a nullpointer - even for a length of 0.                   	\
-	*/                                                                                          	\
-	if (rm_likely(map->buckets_count > 0))                                                      	\
-	{                                                                                           	\
-		rm_mem_set(map->buckets, 0, map->buckets_count * sizeof(rm_##name##_hashmap_entry_ptr));	\
-	}                                                                                           	\
-                                                                                                	\
-	/* Clear the vector of entries. */                                                          	\
-	rm_vec_clear(&map->collision_entries);                                                      	\
-                                                                                                	\
-	/* Clear the supply list. */                                                                	\
-	map->supply_list = RM_HASHMAP_NO_MORE_ENTRIES;                                              	\
+#define RM_HASHMAP_DEFINE_CLEAR(name)                                                       	\
+                                                                                            	\
+rm_void rm_##name##_hashmap_clear(rm_##name##_hashmap* map)                                 	\
+{                                                                                           	\
+	/* Unref all keys and values. */                                                        	\
+	rm_##name##_hashmap_unref_all(map);                                                     	\
+                                                                                            	\
+	/* Reset the count. */                                                                  	\
+	map->count = 0;                                                                         	\
+                                                                                            	\
+	/*                                                                                      	\
+		Null the buckets -> empty hashes.                                                   	\
+		rm_memset() does *not* accept a nullpointer - even for a length of 0.               	\
+	*/                                                                                      	\
+	if (rm_likely(map->buckets_count > 0))                                                  	\
+	{                                                                                       	\
+		rm_mem_set(map->buckets, 0, map->buckets_count * sizeof(rm_##name##_hashmap_entry));	\
+	}                                                                                       	\
+                                                                                            	\
+	/* Clear the vector of entries. */                                                      	\
+	rm_vec_clear(&map->collision_entries);                                                  	\
+                                                                                            	\
+	/* Clear the supply list. */                                                            	\
+	map->supply_list = RM_HASHMAP_NO_MORE_ENTRIES;                                          	\
 }
 
 #define RM_HASHMAP_DEFINE_CONTAINS_KEY(name)                                                         	\
@@ -873,45 +961,43 @@ rm_bool rm_##name##_hashmap_contains_key(const rm_##name##_hashmap* map, rm_##na
 #define RM_HASHMAP_DEFINE_GET(name) \
 extern rm_##name##_hashmap_value rm_##name##_hashmap_get(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value default_value);
 
-#define RM_HASHMAP_DEFINE_GET_EX(name)                                                                                               	\
-                                                                                                                                     	\
-rm_bool rm_##name##_hashmap_get_ex(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr)	\
-{                                                                                                                                    	\
-	/* Calculate the hash for the key. */                                                                                            	\
-	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                        	\
-                                                                                                                                     	\
-	/* Get the corresponding entry. */                                                                                               	\
-	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry(map, key, hash);                                            	\
-                                                                                                                                     	\
-	/* Is it present? */                                                                                                             	\
-	if (!entry)                                                                                                                      	\
-	{                                                                                                                                	\
-		return false;                                                                                                                	\
-	}                                                                                                                                	\
-                                                                                                                                     	\
-	/* Assign the value to the out parameter. */                                                                                     	\
-	*value_ptr = entry->value;                                                                                                       	\
-                                                                                                                                     	\
-	return true;                                                                                                                     	\
+#define RM_HASHMAP_DEFINE_GET_EX(name)                                                                                                                                             	\
+                                                                                                                                                                                   	\
+/* Retrieve the value for a key with a precalculated hash (see below). */                                                                                                          	\
+static inline rm_bool rm_##name##_hashmap_get_ex_with_hash(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_##name##_hashmap_value* value_ptr)	\
+{                                                                                                                                                                                  	\
+	/* Get the corresponding entry. */                                                                                                                                             	\
+	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry(map, key, hash);                                                                                          	\
+                                                                                                                                                                                   	\
+	/* Is it present? */                                                                                                                                                           	\
+	if (!entry)                                                                                                                                                                    	\
+	{                                                                                                                                                                              	\
+		return false;                                                                                                                                                              	\
+	}                                                                                                                                                                              	\
+                                                                                                                                                                                   	\
+	/* Assign the value to the out parameter. */                                                                                                                                   	\
+	*value_ptr = entry->value;                                                                                                                                                     	\
+                                                                                                                                                                                   	\
+	return true;                                                                                                                                                                   	\
+}                                                                                                                                                                                  	\
+                                                                                                                                                                                   	\
+rm_bool rm_##name##_hashmap_get_ex(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr)                                              	\
+{                                                                                                                                                                                  	\
+	/* Calculate the hash for the key and delegate. */                                                                                                                             	\
+	return rm_##name##_hashmap_get_ex_with_hash(map, key, rm_##name##_hashmap_hash_key(key), value_ptr);                                                                           	\
 }
 
 #define RM_HASHMAP_DEFINE_SET(name, value_unref_func)                                                                  	\
                                                                                                                        	\
 rm_bool rm_##name##_hashmap_set(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value)	\
 {                                                                                                                      	\
-	/* Get a function pointer to the unref func. */                                                                    	\
-	rm_##name##_hashmap_value_unref_func value_unref = (rm_##name##_hashmap_value_unref_func)value_unref_func;         	\
-                                                                                                                       	\
 	/* Delegate to the more complex update function. */                                                                	\
 	rm_##name##_hashmap_value old_value;                                                                               	\
                                                                                                                        	\
 	if (rm_##name##_hashmap_update(map, key, value, RM_HASHMAP_UPDATE_MODE_SET, &old_value))                           	\
 	{                                                                                                                  	\
 		/* The new value has been set. Unref the old one if necessary (the update function does not do that for us). */	\
-		if (value_unref)                                                                                               	\
-		{                                                                                                              	\
-			value_unref(old_value);                                                                                    	\
-		}                                                                                                              	\
+		rm_hashmap_call_func(rm_##name##_hashmap_value_unref_func, value_unref_func, (rm_void)0, old_value);           	\
                                                                                                                        	\
 		return true;                                                                                                   	\
 	}                                                                                                                  	\
@@ -921,140 +1007,221 @@ rm_bool rm_##name##_hashmap_set(rm_##name##_hashmap* map, rm_##name##_hashmap_ke
 	}                                                                                                                  	\
 }
 
-#define RM_HASHMAP_DEFINE_UPDATE(name, key_ref_func, value_ref_func, merge_func)                                                                                                                     \
-                                                                                                                                                                                                     \
-rm_bool rm_##name##_hashmap_update(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)    \
-{                                                                                                                                                                                                    \
-	/* If we have not yet allocated, we must do that now. */                                                                                                                                         \
-	if (rm_unlikely(map->buckets_count == 0))                                                                                                                                                        \
-	{                                                                                                                                                                                                \
-		/* If the mode requires an existing entry, we can leave early. */                                                                                                                            \
-		if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                      \
-		{                                                                                                                                                                                            \
-			return false;                                                                                                                                                                            \
-		}                                                                                                                                                                                            \
-                                                                                                                                                                                                     \
-		/*                                                                                                                                                                                           \
-			RM_HASHMAP_START_BUCKET_COUNT is a PoT.                                                                                                                                                  \
-			It might be above 1 to avoid some reallocations.                                                                                                                                         \
-		*/                                                                                                                                                                                           \
-		map->buckets_count = RM_HASHMAP_START_BUCKET_COUNT;                                                                                                                                          \
-		map->buckets = rm_malloc_zero(map->buckets_count * sizeof(rm_##name##_hashmap_entry));                                                                                                       \
-                                                                                                                                                                                                     \
-		/* Select the first threshold. */                                                                                                                                                            \
-		map->count_threshold = rm_hashmap_calculate_count_threshold(map->load_factor, map->buckets_count);                                                                                           \
-	}                                                                                                                                                                                                \
-                                                                                                                                                                                                     \
-	/* Get function pointers to the ref funcs. */                                                                                                                                                    \
-	rm_##name##_hashmap_key_ref_func key_ref = (rm_##name##_hashmap_key_ref_func)key_ref_func;                                                                                                       \
-	rm_##name##_hashmap_value_ref_func value_ref = (rm_##name##_hashmap_value_ref_func)value_ref_func;                                                                                               \
-	rm_##name##_hashmap_merge_func merge = (rm_##name##_hashmap_merge_func)merge_func;                                                                                                               \
-                                                                                                                                                                                                     \
-	/* Calculate the hash for the key. */                                                                                                                                                            \
-	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                                                                                        \
-                                                                                                                                                                                                     \
-	/* Get the bucket for this hash. */                                                                                                                                                              \
-	rm_##name##_hashmap_entry_ptr bucket_base = rm_hashmap_get_bucket_for_hash(map, hash);                                                                                                           \
-                                                                                                                                                                                                     \
-	/* Get the corresponding entry and the previous one. */                                                                                                                                          \
-	rm_##name##_hashmap_entry_ptr prev;                                                                                                                                                              \
-	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry_in_bucket(map, bucket_base, key, hash, &prev);                                                                              \
-                                                                                                                                                                                                     \
-	/* Does the entry already exist? */                                                                                                                                                              \
-	if (entry)                                                                                                                                                                                       \
-	{                                                                                                                                                                                                \
-		/* Do not assign the old value to the pointee yet. "old_value_ptr" might be "&value" - in that case, we have a problem. */                                                                   \
-		rm_##name##_hashmap_value old_value = entry->value;                                                                                                                                          \
-                                                                                                                                                                                                     \
-		/* How to cope with the existing value? */                                                                                                                                                   \
-		switch (mode)                                                                                                                                                                                \
-		{                                                                                                                                                                                            \
-		case RM_HASHMAP_UPDATE_MODE_REPLACE:                                                                                                                                                         \
-		case RM_HASHMAP_UPDATE_MODE_SET:                                                                                                                                                             \
-                                                                                                                                                                                                     \
-			/* Replace the existing value. Ref it if necessary. */                                                                                                                                   \
-			entry->value = value_ref ? value_ref(value) : value;                                                                                                                                     \
-			break;                                                                                                                                                                                   \
-                                                                                                                                                                                                     \
-		case RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE:                                                                                                                                                 \
-		case RM_HASHMAP_UPDATE_MODE_MERGE:                                                                                                                                                           \
-                                                                                                                                                                                                     \
-			/* Merge old and new value. Ref the result if necessary. */                                                                                                                              \
-			rm_assert(merge, "RM_HASHMAP_UPDATE_MODE_MERGE specified, but merge func pointer is null.");                                                                                             \
-                                                                                                                                                                                                     \
-			rm_##name##_hashmap_value merged_value = merge(key, entry->value, value);                                                                                                                \
-			entry->value = value_ref ? value_ref(merged_value) : merged_value;                                                                                                                       \
-                                                                                                                                                                                                     \
-			break;                                                                                                                                                                                   \
-                                                                                                                                                                                                     \
-		case RM_HASHMAP_UPDATE_MODE_INSERT:                                                                                                                                                          \
-                                                                                                                                                                                                     \
-			/* Nothing to do here, we don't overwrite old values in this mode. */                                                                                                                    \
-			break;                                                                                                                                                                                   \
-		}                                                                                                                                                                                            \
-                                                                                                                                                                                                     \
-		/* Now we can safely assign to the pointee (the user has to unref the old value manually if we have replaced it). */                                                                         \
-		*old_value_ptr = old_value;                                                                                                                                                                  \
-                                                                                                                                                                                                     \
-		return true;                                                                                                                                                                                 \
-	}                                                                                                                                                                                                \
-                                                                                                                                                                                                     \
-	/*                                                                                                                                                                                               \
-		The entry does not exist yet.                                                                                                                                                                \
-		In replace and pure merge mode, we can stop here because inserting new entries is forbidden.                                                                                                 \
-	*/                                                                                                                                                                                               \
-	if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                          \
-	{                                                                                                                                                                                                \
-		return false;                                                                                                                                                                                \
-	}                                                                                                                                                                                                \
-                                                                                                                                                                                                     \
-	/*                                                                                                                                                                                               \
-		If the previous entry is null, we have to place ours at the bucket base.                                                                                                                     \
-		*Caution*: At the end of this compound statement, prev is poisoned and must not be used anymore!                                                                                             \
-		The reason is the call to rm_vec_push_empty(...): It may reallocate the collision vector.                                                                                                    \
-	*/                                                                                                                                                                                               \
-	if (rm_likely(prev == null))                                                                                                                                                                     \
-	{                                                                                                                                                                                                \
-		entry = bucket_base;                                                                                                                                                                         \
-	}                                                                                                                                                                                                \
-	else                                                                                                                                                                                             \
-	{                                                                                                                                                                                                \
-		/* Pull a new entry from the supply list resp. from the collision vector. */                                                                                                                 \
-		if (map->supply_list != RM_HASHMAP_NO_MORE_ENTRIES)                                                                                                                                          \
-		{                                                                                                                                                                                            \
-			/* The next entry will be the head of the supply list. */                                                                                                                                \
-			prev->next_entry_index = map->supply_list;                                                                                                                                               \
-                                                                                                                                                                                                     \
-			/* Obtain the entry and assign the new supply list head. */                                                                                                                              \
-			entry = rm_hashmap_get_entry_ptr(map, prev->next_entry_index);                                                                                                                           \
-			map->supply_list = entry->next_entry_index;                                                                                                                                              \
-		}                                                                                                                                                                                            \
-		else                                                                                                                                                                                         \
-		{                                                                                                                                                                                            \
-			/* *Important*: Fix the previous entry *first*! */                                                                                                                                       \
-			prev->next_entry_index = map->collision_entries.count + 1;                                                                                                                               \
-                                                                                                                                                                                                     \
-			/* Down from here, "prev" might be poisoned! */                                                                                                                                          \
-			entry = rm_vec_push_empty(&map->collision_entries);                                                                                                                                      \
-		}                                                                                                                                                                                            \
-	}                                                                                                                                                                                                \
-                                                                                                                                                                                                     \
-	/*                                                                                                                                                                                               \
-		Initialize the entry.                                                                                                                                                                        \
-		Ref key and / or value if necessary.                                                                                                                                                         \
-	*/                                                                                                                                                                                               \
-	entry->key = key_ref ? key_ref(key) : key;                                                                                                                                                       \
-	entry->hash = hash;                                                                                                                                                                              \
-	entry->value = value_ref ? value_ref(value) : value;                                                                                                                                             \
-	entry->next_entry_index = RM_HASHMAP_NO_MORE_ENTRIES;                                                                                                                                            \
-                                                                                                                                                                                                     \
-	/* Increment the count and resize if necessary. */                                                                                                                                               \
-	if (rm_unlikely(++map->count > map->count_threshold))                                                                                                                                            \
-	{                                                                                                                                                                                                \
-		rm_##name##_hashmap_resize(map);                                                                                                                                                             \
-	}                                                                                                                                                                                                \
-                                                                                                                                                                                                     \
-	return false;                                                                                                                                                                                	 \
+#define RM_HASHMAP_DEFINE_UPDATE(name, key_ref_func, value_ref_func, merge_func)                                                                                                                                                                   \
+                                                                                                                                                                                                                                                   \
+/* Update the value for a key with a precalculated hash (see below). */                                                                                                                                                                            \
+static inline rm_bool rm_##name##_hashmap_update_with_hash(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)    \
+{                                                                                                                                                                                                                                                  \
+	/* If we have not yet allocated, we must do that now. */                                                                                                                                                                                       \
+	if (rm_unlikely(map->buckets_count == 0))                                                                                                                                                                                                      \
+	{                                                                                                                                                                                                                                              \
+		/* If the mode requires an existing entry, we can leave early. */                                                                                                                                                                          \
+		if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                                                                    \
+		{                                                                                                                                                                                                                                          \
+			return false;                                                                                                                                                                                                                          \
+		}                                                                                                                                                                                                                                          \
+                                                                                                                                                                                                                                                   \
+		/*                                                                                                                                                                                                                                         \
+			RM_HASHMAP_START_BUCKET_COUNT is a PoT.                                                                                                                                                                                                \
+			It might be above 1 to avoid some reallocations.                                                                                                                                                                                       \
+		*/                                                                                                                                                                                                                                         \
+		map->buckets_count = RM_HASHMAP_START_BUCKET_COUNT;                                                                                                                                                                                        \
+		map->buckets = rm_malloc_large_zero(map->buckets_count * sizeof(rm_##name##_hashmap_entry));                                                                                                                                               \
+                                                                                                                                                                                                                                                   \
+		/* Select the first threshold. */                                                                                                                                                                                                          \
+		map->count_threshold = rm_hashmap_calculate_count_threshold(map->load_factor, map->buckets_count);                                                                                                                                         \
+	}                                                                                                                                                                                                                                              \
+                                                                                                                                                                                                                                                   \
+	/* Get the bucket for this hash. */                                                                                                                                                                                                            \
+	rm_##name##_hashmap_entry_ptr bucket_base = rm_hashmap_get_bucket_for_hash(map, hash);                                                                                                                                                         \
+                                                                                                                                                                                                                                                   \
+	/* Get the corresponding entry and the previous one. */                                                                                                                                                                                        \
+	rm_##name##_hashmap_entry_ptr prev;                                                                                                                                                                                                            \
+	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry_in_bucket(map, bucket_base, key, hash, &prev);                                                                                                                            \
+                                                                                                                                                                                                                                                   \
+	/* Does the entry already exist? */                                                                                                                                                                                                            \
+	if (entry)                                                                                                                                                                                                                                     \
+	{                                                                                                                                                                                                                                              \
+		/* Do not assign the old value to the pointee yet. "old_value_ptr" might be "&value" - in that case, we have a problem. */                                                                                                                 \
+		rm_##name##_hashmap_value old_value = entry->value;                                                                                                                                                                                        \
+                                                                                                                                                                                                                                                   \
+		/* How to cope with the existing value? */                                                                                                                                                                                                 \
+		switch (mode)                                                                                                                                                                                                                              \
+		{                                                                                                                                                                                                                                          \
+		case RM_HASHMAP_UPDATE_MODE_REPLACE:                                                                                                                                                                                                       \
+		case RM_HASHMAP_UPDATE_MODE_SET:                                                                                                                                                                                                           \
+                                                                                                                                                                                                                                                   \
+			/* Replace the existing value. Ref it if necessary. */                                                                                                                                                                                 \
+			entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, value, value);                                                                                                                                 \
+			break;                                                                                                                                                                                                                                 \
+                                                                                                                                                                                                                                                   \
+		case RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE:                                                                                                                                                                                               \
+		case RM_HASHMAP_UPDATE_MODE_MERGE:                                                                                                                                                                                                         \
+                                                                                                                                                                                                                                                   \
+			/* Merge old and new value. Ref the result if necessary. */                                                                                                                                                                            \
+			rm_assert(rm_hashmap_has_func(merge_func), "RM_HASHMAP_UPDATE_MODE_MERGE specified, but merge func pointer is null.");                                                                                                                 \
+                                                                                                                                                                                                                                                   \
+			rm_##name##_hashmap_value merged_value = rm_hashmap_call_func(rm_##name##_hashmap_merge_func, merge_func, entry->value, key, entry->value, value);                                                                                     \
+			entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, merged_value, merged_value);                                                                                                                   \
+                                                                                                                                                                                                                                                   \
+			break;                                                                                                                                                                                                                                 \
+                                                                                                                                                                                                                                                   \
+		case RM_HASHMAP_UPDATE_MODE_INSERT:                                                                                                                                                                                                        \
+                                                                                                                                                                                                                                                   \
+			/* Nothing to do here, we don't overwrite old values in this mode. */                                                                                                                                                                  \
+			break;                                                                                                                                                                                                                                 \
+		}                                                                                                                                                                                                                                          \
+                                                                                                                                                                                                                                                   \
+		/* Now we can safely assign to the pointee (the user has to unref the old value manually if we have replaced it). */                                                                                                                       \
+		*old_value_ptr = old_value;                                                                                                                                                                                                                \
+                                                                                                                                                                                                                                                   \
+		return true;                                                                                                                                                                                                                               \
+	}                                                                                                                                                                                                                                              \
+                                                                                                                                                                                                                                                   \
+	/*                                                                                                                                                                                                                                             \
+		The entry does not exist yet.                                                                                                                                                                                                              \
+		In replace and pure merge mode, we can stop here because inserting new entries is forbidden.                                                                                                                                               \
+	*/                                                                                                                                                                                                                                             \
+	if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                                                                        \
+	{                                                                                                                                                                                                                                              \
+		return false;                                                                                                                                                                                                                              \
+	}                                                                                                                                                                                                                                              \
+                                                                                                                                                                                                                                                   \
+	/*                                                                                                                                                                                                                                             \
+		If the previous entry is null, we have to place ours at the bucket base.                                                                                                                                                                   \
+		*Caution*: At the end of this compound statement, prev is poisoned and must not be used anymore!                                                                                                                                           \
+		The reason is the call to rm_vec_push_empty(...): It may reallocate the collision vector.                                                                                                                                                  \
+	*/                                                                                                                                                                                                                                             \
+	if (rm_likely(prev == null))                                                                                                                                                                                                                   \
+	{                                                                                                                                                                                                                                              \
+		entry = bucket_base;                                                                                                                                                                                                                       \
+	}                                                                                                                                                                                                                                              \
+	else                                                                                                                                                                                                                                           \
+	{                                                                                                                                                                                                                                              \
+		/* Pull a new entry from the supply list resp. from the collision vector. */                                                                                                                                                               \
+		if (map->supply_list != RM_HASHMAP_NO_MORE_ENTRIES)                                                                                                                                                                                        \
+		{                                                                                                                                                                                                                                          \
+			/* The next entry will be the head of the supply list. */                                                                                                                                                                              \
+			prev->next_entry_index = map->supply_list;                                                                                                                                                                                             \
+                                                                                                                                                                                                                                                   \
+			/* Obtain the entry and assign the new supply list head. */                                                                                                                                                                            \
+			entry = rm_hashmap_get_entry_ptr(map, prev->next_entry_index);                                                                                                                                                                         \
+			map->supply_list = entry->next_entry_index;                                                                                                                                                                                            \
+		}                                                                                                                                                                                                                                          \
+		else                                                                                                                                                                                                                                       \
+		{                                                                                                                                                                                                                                          \
+			/* *Important*: Fix the previous entry *first*! */                                                                                                                                                                                     \
+			prev->next_entry_index = map->collision_entries.count + 1;                                                                                                                                                                             \
+                                                                                                                                                                                                                                                   \
+			/* Down from here, "prev" might be poisoned! */                                                                                                                                                                                        \
+			entry = rm_vec_push_empty(&map->collision_entries);                                                                                                                                                                                    \
+		}                                                                                                                                                                                                                                          \
+	}                                                                                                                                                                                                                                              \
+                                                                                                                                                                                                                                                   \
+	/*                                                                                                                                                                                                                                             \
+		Initialize the entry.                                                                                                                                                                                                                      \
+		Ref key and / or value if necessary.                                                                                                                                                                                                       \
+	*/                                                                                                                                                                                                                                             \
+	entry->key = rm_hashmap_call_func(rm_##name##_hashmap_key_ref_func, key_ref_func, key, key);                                                                                                                                                   \
+	entry->hash = hash;                                                                                                                                                                                                                            \
+	entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, value, value);                                                                                                                                         \
+	entry->next_entry_index = RM_HASHMAP_NO_MORE_ENTRIES;                                                                                                                                                                                          \
+                                                                                                                                                                                                                                                   \
+	/* Increment the count and resize if necessary. */                                                                                                                                                                                             \
+	if (rm_unlikely(++map->count > map->count_threshold))                                                                                                                                                                                          \
+	{                                                                                                                                                                                                                                              \
+		rm_##name##_hashmap_resize(map);                                                                                                                                                                                                           \
+	}                                                                                                                                                                                                                                              \
+                                                                                                                                                                                                                                                   \
+	return false;                                                                                                                                                                                                                                  \
+}                                                                                                                                                                                                                                                  \
+                                                                                                                                                                                                                                                   \
+rm_bool rm_##name##_hashmap_update(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)                                                  \
+{                                                                                                                                                                                                                                                  \
+	/* Calculate the hash for the key and delegate. */                                                                                                                                                                                             \
+	return rm_##name##_hashmap_update_with_hash(map, key, rm_##name##_hashmap_hash_key(key), value, mode, old_value_ptr);                                                                                                                          \
+}
+
+#define RM_HASHMAP_DEFINE_GET_BATCH(name)                                                                                                                                     	\
+                                                                                                                                                                              	\
+rm_size rm_##name##_hashmap_get_batch(const rm_##name##_hashmap* map, const rm_##name##_hashmap_key* keys, rm_size count, rm_##name##_hashmap_value* values, rm_bool* results)	\
+{                                                                                                                                                                             	\
+	/* The hashes of the prefetched keys that are not yet resolved (a ring buffer, indexed by the key index). */                                                              	\
+	rm_hashmap_hash hashes[RM_HASHMAP_BATCH_WINDOW];                                                                                                                          	\
+	rm_size found_count = 0;                                                                                                                                                  	\
+                                                                                                                                                                              	\
+	/* Fill the window. */                                                                                                                                                    	\
+	for (rm_size i = 0; (i < count) && (i < RM_HASHMAP_BATCH_WINDOW); i++)                                                                                                    	\
+	{                                                                                                                                                                         	\
+		hashes[i] = rm_##name##_hashmap_hash_key(keys[i]);                                                                                                                    	\
+		rm_##name##_hashmap_prefetch(map, hashes[i]);                                                                                                                         	\
+	}                                                                                                                                                                         	\
+                                                                                                                                                                              	\
+	for (rm_size i = 0; i < count; i++)                                                                                                                                       	\
+	{                                                                                                                                                                         	\
+		/* Take the hash out of the ring buffer and replace it with the one for the key a window ahead. */                                                                    	\
+		rm_size slot = i % RM_HASHMAP_BATCH_WINDOW;                                                                                                                           	\
+		rm_hashmap_hash hash = hashes[slot];                                                                                                                                  	\
+                                                                                                                                                                              	\
+		if ((i + RM_HASHMAP_BATCH_WINDOW) < count)                                                                                                                            	\
+		{                                                                                                                                                                     	\
+			hashes[slot] = rm_##name##_hashmap_hash_key(keys[i + RM_HASHMAP_BATCH_WINDOW]);                                                                                   	\
+			rm_##name##_hashmap_prefetch(map, hashes[slot]);                                                                                                                  	\
+		}                                                                                                                                                                     	\
+                                                                                                                                                                              	\
+		/* Now the bucket for the current key should already be in the cache. */                                                                                              	\
+		rm_bool result = rm_##name##_hashmap_get_ex_with_hash(map, keys[i], hash, &values[i]);                                                                                	\
+		found_count += result ? 1 : 0;                                                                                                                                        	\
+                                                                                                                                                                              	\
+		if (results)                                                                                                                                                          	\
+		{                                                                                                                                                                     	\
+			results[i] = result;                                                                                                                                              	\
+		}                                                                                                                                                                     	\
+	}                                                                                                                                                                         	\
+                                                                                                                                                                              	\
+	return found_count;                                                                                                                                                       	\
+}
+
+#define RM_HASHMAP_DEFINE_UPDATE_BATCH(name)                                                                                                                                                                                                         	\
+                                                                                                                                                                                                                                                     	\
+rm_size rm_##name##_hashmap_update_batch(rm_##name##_hashmap* map, const rm_##name##_hashmap_key* keys, const rm_##name##_hashmap_value* values, rm_size count, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_values, rm_bool* results)	\
+{                                                                                                                                                                                                                                                    	\
+	/* The hashes of the prefetched keys that are not yet resolved (a ring buffer, indexed by the key index). */                                                                                                                                     	\
+	rm_hashmap_hash hashes[RM_HASHMAP_BATCH_WINDOW];                                                                                                                                                                                                 	\
+	rm_size found_count = 0;                                                                                                                                                                                                                         	\
+                                                                                                                                                                                                                                                     	\
+	/* Fill the window. */                                                                                                                                                                                                                           	\
+	for (rm_size i = 0; (i < count) && (i < RM_HASHMAP_BATCH_WINDOW); i++)                                                                                                                                                                           	\
+	{                                                                                                                                                                                                                                                	\
+		hashes[i] = rm_##name##_hashmap_hash_key(keys[i]);                                                                                                                                                                                           	\
+		rm_##name##_hashmap_prefetch(map, hashes[i]);                                                                                                                                                                                                	\
+	}                                                                                                                                                                                                                                                	\
+                                                                                                                                                                                                                                                     	\
+	for (rm_size i = 0; i < count; i++)                                                                                                                                                                                                              	\
+	{                                                                                                                                                                                                                                                	\
+		/* Take the hash out of the ring buffer and replace it with the one for the key a window ahead. */                                                                                                                                           	\
+		/* If an update resizes the hashmap, the prefetches in flight are wasted, but the hashes stay valid. */                                                                                                                                      	\
+		rm_size slot = i % RM_HASHMAP_BATCH_WINDOW;                                                                                                                                                                                                  	\
+		rm_hashmap_hash hash = hashes[slot];                                                                                                                                                                                                         	\
+                                                                                                                                                                                                                                                     	\
+		if ((i + RM_HASHMAP_BATCH_WINDOW) < count)                                                                                                                                                                                                   	\
+		{                                                                                                                                                                                                                                            	\
+			hashes[slot] = rm_##name##_hashmap_hash_key(keys[i + RM_HASHMAP_BATCH_WINDOW]);                                                                                                                                                          	\
+			rm_##name##_hashmap_prefetch(map, hashes[slot]);                                                                                                                                                                                         	\
+		}                                                                                                                                                                                                                                            	\
+                                                                                                                                                                                                                                                     	\
+		/* Now the bucket for the current key should already be in the cache. */                                                                                                                                                                     	\
+		rm_##name##_hashmap_value old_value;                                                                                                                                                                                                         	\
+		rm_bool result = rm_##name##_hashmap_update_with_hash(map, keys[i], hash, values[i], mode, old_values ? &old_values[i] : &old_value);                                                                                                        	\
+		found_count += result ? 1 : 0;                                                                                                                                                                                                               	\
+                                                                                                                                                                                                                                                     	\
+		if (results)                                                                                                                                                                                                                                 	\
+		{                                                                                                                                                                                                                                            	\
+			results[i] = result;                                                                                                                                                                                                                     	\
+		}                                                                                                                                                                                                                                            	\
+	}                                                                                                                                                                                                                                                	\
+                                                                                                                                                                                                                                                     	\
+	return found_count;                                                                                                                                                                                                                              	\
 }
 
 #define RM_HASHMAP_DEFINE_REMOVE(name)                                                                                                               	\
@@ -1121,6 +1288,59 @@ rm_bool rm_##name##_hashmap_remove(rm_##name##_hashmap* map, rm_##name##_hashmap
 	return true;                                                                                                                                     	\
 }
 
+#define RM_HASHMAP_DEFINE_GET_STATS(name)                                                                                                                    	\
+                                                                                                                                                             	\
+rm_void rm_##name##_hashmap_get_stats(const rm_##name##_hashmap* map, rm_hashmap_stats* stats)                                                               	\
+{                                                                                                                                                            	\
+	rm_assert(stats, "Passed stats must be valid.");                                                                                                         	\
+                                                                                                                                                             	\
+	*stats = (rm_hashmap_stats)                                                                                                                              	\
+	{                                                                                                                                                        	\
+		.count = map->count,                                                                                                                                 	\
+		.buckets_count = map->buckets_count,                                                                                                                 	\
+		.collision_entries_count = map->collision_entries.count,                                                                                             	\
+		.resizes_count = map->resizes_count,                                                                                                                 	\
+		.allocated_bytes = (map->buckets_count + map->collision_entries.capacity) * sizeof(rm_##name##_hashmap_entry)                                        	\
+	};                                                                                                                                                       	\
+                                                                                                                                                             	\
+	/*                                                                                                                                                       	\
+		Walk the chains of all buckets.                                                                                                                      	\
+		A successful lookup of the i-th entry of a chain visits i entries, so a chain with n entries costs n * (n + 1) / 2 lookup steps in total.            	\
+	*/                                                                                                                                                       	\
+	rm_size lookup_steps_count = 0;                                                                                                                          	\
+                                                                                                                                                             	\
+	for (rm_size i = 0; i < map->buckets_count; i++)                                                                                                         	\
+	{                                                                                                                                                        	\
+		rm_size chain_length = 0;                                                                                                                            	\
+                                                                                                                                                             	\
+		if (!rm_hashmap_is_empty_entry(&map->buckets[i]))                                                                                                    	\
+		{                                                                                                                                                    	\
+			for (rm_##name##_hashmap_entry_const_ptr entry = &map->buckets[i]; entry != null; entry = rm_hashmap_get_entry_ptr(map, entry->next_entry_index))	\
+			{                                                                                                                                                	\
+				chain_length++;                                                                                                                              	\
+			}                                                                                                                                                	\
+		}                                                                                                                                                    	\
+                                                                                                                                                             	\
+		stats->buckets_by_chain_length[rm_min(chain_length, RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT - 1)]++;                                                    	\
+		stats->max_chain_length = rm_max(stats->max_chain_length, chain_length);                                                                             	\
+		lookup_steps_count += (chain_length * (chain_length + 1)) / 2;                                                                                       	\
+	}                                                                                                                                                        	\
+                                                                                                                                                             	\
+	stats->used_buckets_count = map->buckets_count - stats->buckets_by_chain_length[0];                                                                      	\
+                                                                                                                                                             	\
+	if (map->count > 0)                                                                                                                                      	\
+	{                                                                                                                                                        	\
+		stats->mean_chain_length = (rm_double)map->count / (rm_double)stats->used_buckets_count;                                                             	\
+		stats->mean_lookup_length = (rm_double)lookup_steps_count / (rm_double)map->count;                                                                   	\
+	}                                                                                                                                                        	\
+                                                                                                                                                             	\
+	/* Count the entries in the supply list. */                                                                                                              	\
+	for (rm_size index = map->supply_list; index != RM_HASHMAP_NO_MORE_ENTRIES; index = rm_hashmap_get_entry_ptr(map, index)->next_entry_index)              	\
+	{                                                                                                                                                        	\
+		stats->supply_list_count++;                                                                                                                          	\
+	}                                                                                                                                                        	\
+}
+
 #define RM_HASHMAP_DEFINE_FOR_EACH(name) \
 extern rm_void rm_##name##_hashmap_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context);
 
@@ -1158,6 +1378,7 @@ RM_HASHMAP_DEFINE_KEY_MATCHES_ENTRY(name, key_compare_func)
 RM_HASHMAP_DEFINE_RESIZE(name)                                                                                                          	\
 RM_HASHMAP_DEFINE_FIND_ENTRY_IN_BUCKET(name)                                                                                            	\
 RM_HASHMAP_DEFINE_FIND_ENTRY(name)                                                                                                      	\
+RM_HASHMAP_DEFINE_PREFETCH(name)                                                                                                        	\
 RM_HASHMAP_DEFINE_UNREF_ENTRY(name, key_unref_func, value_unref_func)                                                                   	\
 RM_HASHMAP_DEFINE_UNREF_ALL(name, key_unref_func, value_unref_func)                                                                     	\
 RM_HASHMAP_DEFINE_INIT(name)                                                                                                            	\
@@ -1169,7 +1390,10 @@ RM_HASHMAP_DEFINE_GET(name)
 RM_HASHMAP_DEFINE_GET_EX(name)                                                                                                          	\
 RM_HASHMAP_DEFINE_SET(name, value_unref_func)                                                                                           	\
 RM_HASHMAP_DEFINE_UPDATE(name, key_ref_func, value_ref_func, merge_func)                                                                	\
+RM_HASHMAP_DEFINE_GET_BATCH(name)                                                                                                       	\
+RM_HASHMAP_DEFINE_UPDATE_BATCH(name)                                                                                                    	\
 RM_HASHMAP_DEFINE_REMOVE(name)                                                                                                          	\
+RM_HASHMAP_DEFINE_GET_STATS(name)                                                                                                       	\
 RM_HASHMAP_DEFINE_FOR_EACH(name)                                                                                                        	\
 RM_HASHMAP_DEFINE_DEBUG_FOR_EACH(name)
 
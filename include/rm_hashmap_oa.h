@@ -0,0 +1,843 @@
+#ifndef __RM_HASHMAP_OA_H__
+#define __RM_HASHMAP_OA_H__
+
+/*
+	An open addressing variant of rm_hashmap.h, loosely based on the "Swiss table" design of Abseil (https://abseil.io/about/design/swisstables).
+	It generates exactly the same types and functions (rm_##name##_hashmap_update(...) etc.) with exactly the same semantics.
+	So a map can be switched between both designs by replacing RM_HASHMAP_DECLARE / RM_HASHMAP_DEFINE with RM_HASHMAP_OA_DECLARE / RM_HASHMAP_OA_DEFINE.
+
+	The entries live in a single flat array, there is no collision vector and no supply list.
+	Next to it, there is an array of control bytes (one per entry):
+
+	- RM_HASHMAP_OA_CTRL_EMPTY: The entry has never been used (since the last resize).
+	- RM_HASHMAP_OA_CTRL_DELETED: The entry has been removed, but a probe sequence might run across it ("tombstone").
+	- 0 ... 127: The entry is in use, the control byte holds seven bits of its (mixed) hash.
+
+	A lookup compares a whole group of control bytes against the hash bits at once (SSE2 / AVX2 if available)
+	and only touches the entries that match. Most lookups therefore cost one load of control bytes and one load of an entry.
+	The control bytes of the first group are mirrored behind the last one, so groups can start at any position without wrapping.
+
+	Removing an entry only leaves a tombstone if there is no empty control byte close enough to stop all probe sequences that might run across it.
+	Tombstones are reused by insertions and dropped when the table is rebuilt.
+
+	rm_##name##_hashmap_get_stats(...) reports probe sequences instead of chains:
+	"buckets_by_chain_length" counts the entries by the number of groups a lookup probes to find them (the free entries at index 0),
+	"max_chain_length", "mean_chain_length" and "mean_lookup_length" are in groups as well.
+	"supply_list_count" is the number of tombstones, "resizes_count" also counts rebuilds that keep the size.
+*/
+
+#include "rm_assert.h"
+#include "rm_hashmap.h"
+#include "rm_macro.h"
+#include "rm_mem.h"
+#include "rm_type.h"
+
+//********************************************************
+//	Constants
+//********************************************************
+
+//Control bytes (see above):
+#define RM_HASHMAP_OA_CTRL_EMPTY ((rm_int8)-128)
+#define RM_HASHMAP_OA_CTRL_DELETED ((rm_int8)-2)
+
+//We never fill more than 7 / 8 of the entries, even if the load factor is higher.
+//Otherwise, probe sequences get very long and there must always be an empty entry to terminate them.
+#define RM_HASHMAP_OA_MAX_LOAD_FACTOR 0.875
+
+//********************************************************
+//	Groups of control bytes
+//********************************************************
+
+//Compare a group of control bytes (starting at "ctrl", unaligned) against a byte and return a mask with one bit per match (lowest bit = first byte).
+//Empty and deleted control bytes are the only ones with the highest bit set, so both can be found at once.
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#define RM_HASHMAP_OA_GROUP_SIZE ((rm_size)32)
+
+#define rm_hashmap_oa_group_match(ctrl, byte) ((rm_uint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(ctrl)), _mm256_set1_epi8((byte)))))
+#define rm_hashmap_oa_group_match_empty_or_deleted(ctrl) ((rm_uint32)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(ctrl))))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+
+#define RM_HASHMAP_OA_GROUP_SIZE ((rm_size)16)
+
+#define rm_hashmap_oa_group_match(ctrl, byte) ((rm_uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(ctrl)), _mm_set1_epi8((byte)))))
+#define rm_hashmap_oa_group_match_empty_or_deleted(ctrl) ((rm_uint32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(ctrl))))
+#else
+#define RM_HASHMAP_OA_GROUP_SIZE ((rm_size)8)
+
+#define rm_hashmap_oa_group_match(ctrl, byte)                	\
+({                                                           	\
+	const rm_int8* _ctrl = (ctrl);                           	\
+	rm_int8 _byte = (byte);                                  	\
+	rm_uint32 _mask = 0;                                     	\
+                                                             	\
+	for (rm_size _i = 0; _i < RM_HASHMAP_OA_GROUP_SIZE; _i++)	\
+	{                                                        	\
+		_mask |= ((rm_uint32)(_ctrl[_i] == _byte)) << _i;    	\
+	}                                                        	\
+                                                             	\
+	_mask;                                                   	\
+})
+
+#define rm_hashmap_oa_group_match_empty_or_deleted(ctrl)     	\
+({                                                           	\
+	const rm_int8* _ctrl = (ctrl);                           	\
+	rm_uint32 _mask = 0;                                     	\
+                                                             	\
+	for (rm_size _i = 0; _i < RM_HASHMAP_OA_GROUP_SIZE; _i++)	\
+	{                                                        	\
+		_mask |= ((rm_uint32)(_ctrl[_i] < 0)) << _i;         	\
+	}                                                        	\
+                                                             	\
+	_mask;                                                   	\
+})
+#endif
+
+#define rm_hashmap_oa_group_match_empty(ctrl) rm_hashmap_oa_group_match((ctrl), RM_HASHMAP_OA_CTRL_EMPTY)
+
+//A map never has less entries than a group has control bytes, so the mirrored bytes never wrap more than once:
+#define RM_HASHMAP_OA_MIN_BUCKETS_COUNT RM_HASHMAP_OA_GROUP_SIZE
+
+//********************************************************
+//	Macro definitions
+//********************************************************
+
+/*
+	Mix the bits of a user hash.
+	Many hash functions are the identity of the key (or close to it). Their low bits are crowded into a small range (e.g. the IDs of a mesh),
+	which rm_hashmap.h tolerates (the buckets simply grow longer chains), but which causes huge clusters with open addressing.
+	We multiply with a large odd constant and fold the 128 bit product (see rm_hashmap_mix_fold(...)), so every input bit affects every output bit.
+*/
+#define rm_hashmap_oa_mix_hash(hash) rm_hashmap_mix_fold(hash)
+
+//Split a mixed hash into the start of its probe sequence (the high bits) and its control byte (the low seven bits):
+#define rm_hashmap_oa_get_probe_start(hash) ((hash) >> 7)
+#define rm_hashmap_oa_get_ctrl_for_hash(hash) ((rm_int8)((hash) & 0x7f))
+
+//Determine the count threshold (see rm_hashmap_calculate_count_threshold(...)), but never exceed RM_HASHMAP_OA_MAX_LOAD_FACTOR:
+#define rm_hashmap_oa_calculate_count_threshold(load_factor, buckets_count)                                                                                 	\
+({                                                                                                                                                          	\
+	rm_size _oa_buckets_count = (buckets_count);                                                                                                            	\
+	rm_min(rm_hashmap_calculate_count_threshold((load_factor), _oa_buckets_count), (rm_size)(RM_HASHMAP_OA_MAX_LOAD_FACTOR * (rm_double)_oa_buckets_count));	\
+})
+
+//Set a control byte and its mirror (for the first group). For all other entries, the "mirror" is the control byte itself.
+#define rm_hashmap_oa_set_ctrl(map, index, ctrl_value)                                                                     	\
+({                                                                                                                         	\
+	typeof(map) _map = (map);                                                                                              	\
+	rm_size _index = (index);                                                                                              	\
+	rm_int8 _ctrl_value = (ctrl_value);                                                                                    	\
+                                                                                                                           	\
+	_map->ctrl[_index] = _ctrl_value;                                                                                      	\
+	_map->ctrl[((_index - RM_HASHMAP_OA_GROUP_SIZE) & (_map->buckets_count - 1)) + RM_HASHMAP_OA_GROUP_SIZE] = _ctrl_value;	\
+})
+
+//********************************************************
+//	Generic type declarations
+//********************************************************
+
+/*
+	An entry only consists of key and value, the control bytes are stored separately.
+	We accept the same struct orders as rm_hashmap.h, so switching is a one-liner. All orders with the key first result in KV.
+*/
+
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KV(name)	\
+typedef struct __rm_##name##_hashmap_entry__     	\
+{                                                	\
+	rm_##name##_hashmap_key key;                 	\
+	rm_##name##_hashmap_value value;             	\
+} rm_##name##_hashmap_entry;
+
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VK(name)	\
+typedef struct __rm_##name##_hashmap_entry__     	\
+{                                                	\
+	rm_##name##_hashmap_value value;             	\
+	rm_##name##_hashmap_key key;                 	\
+} rm_##name##_hashmap_entry;
+
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_SKV(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KV(name)
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KSV(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KV(name)
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KVS(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_KV(name)
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_SVK(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VK(name)
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VSK(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VK(name)
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VKS(name) RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_VK(name)
+
+//... and also the packed variant:
+#define RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_PACKED(name)	\
+typedef packed_struct                                	\
+(                                                    	\
+	struct __rm_##name##_hashmap_entry__             	\
+	{                                                	\
+		rm_##name##_hashmap_key key;                 	\
+		rm_##name##_hashmap_value value;             	\
+	}                                                	\
+) rm_##name##_hashmap_entry;
+
+#define RM_HASHMAP_OA_DECLARE_TYPES(name, key_type, value_type, struct_order)                                                                      	\
+                                                                                                                                                   	\
+/* Key and value */                                                                                                                                	\
+typedef key_type rm_##name##_hashmap_key;                                                                                                          	\
+typedef value_type rm_##name##_hashmap_value;                                                                                                      	\
+                                                                                                                                                   	\
+/* A hash function to map from a key to a hash. */                                                                                                 	\
+typedef rm_hashmap_hash (*rm_##name##_hashmap_hash_func)(rm_##name##_hashmap_key);                                                                 	\
+                                                                                                                                                   	\
+/* A predicate function to compare keys. */                                                                                                        	\
+typedef rm_bool (*rm_##name##_hashmap_key_compare_func)(rm_##name##_hashmap_key, rm_##name##_hashmap_key);                                         	\
+                                                                                                                                                   	\
+/* Ref and unref functions for memory management. */                                                                                               	\
+typedef rm_##name##_hashmap_key (*rm_##name##_hashmap_key_ref_func)(rm_##name##_hashmap_key);                                                      	\
+typedef rm_void (*rm_##name##_hashmap_key_unref_func)(rm_##name##_hashmap_key);                                                                    	\
+                                                                                                                                                   	\
+typedef rm_##name##_hashmap_value (*rm_##name##_hashmap_value_ref_func)(rm_##name##_hashmap_value);                                                	\
+typedef rm_void (*rm_##name##_hashmap_value_unref_func)(rm_##name##_hashmap_value);                                                                	\
+                                                                                                                                                   	\
+/* A merge function to combine values. */                                                                                                          	\
+typedef rm_##name##_hashmap_value (*rm_##name##_hashmap_merge_func)(rm_##name##_hashmap_key, rm_##name##_hashmap_value, rm_##name##_hashmap_value);	\
+                                                                                                                                                   	\
+/* A single entry inside the hashmap. */                                                                                                           	\
+RM_HASHMAP_OA_DECLARE_ENTRY_TYPE_##struct_order(name)                                                                                              	\
+                                                                                                                                                   	\
+/* Pointers to (const) hashmap entries */                                                                                                          	\
+typedef rm_##name##_hashmap_entry* rm_##name##_hashmap_entry_ptr;                                                                                  	\
+typedef rm_##name##_hashmap_entry const* rm_##name##_hashmap_entry_const_ptr;                                                                      	\
+                                                                                                                                                   	\
+/* The hashmap itself */                                                                                                                           	\
+typedef struct __rm_##name##_hashmap__                                                                                                             	\
+{                                                                                                                                                  	\
+	/* How many key-value-pairs are currently saved inside the hasmap? */                                                                          	\
+	public_interface_get rm_size count;                                                                                                            	\
+                                                                                                                                                   	\
+	/*                                                                                                                                             	\
+		The array of entries and its size (guaranteed to be a PoT >= RM_HASHMAP_OA_MIN_BUCKETS_COUNT once allocated).                              	\
+		The control bytes ("buckets_count" + RM_HASHMAP_OA_GROUP_SIZE of them) follow the entries in the same allocation.                          	\
+	*/                                                                                                                                             	\
+	rm_##name##_hashmap_entry_ptr buckets;                                                                                                         	\
+	rm_int8* ctrl;                                                                                                                                 	\
+	rm_size buckets_count;                                                                                                                         	\
+                                                                                                                                                   	\
+	/*                                                                                                                                             	\
+		The number of empty entries that can still be filled before the table must be rebuilt.                                                     	\
+		Filling tombstones does not count, so this also limits the number of tombstones.                                                           	\
+	*/                                                                                                                                             	\
+	rm_size growth_left;                                                                                                                           	\
+                                                                                                                                                   	\
+	/*                                                                                                                                             	\
+		The count threshold is the number of key-value-pairs                                                                                       	\
+		that can be present in the hashmap before rehashing occurs.                                                                                	\
+		count_threshold := min(load_factor, RM_HASHMAP_OA_MAX_LOAD_FACTOR) * buckets_count                                                         	\
+	*/                                                                                                                                             	\
+	public_interface_get rm_double load_factor;                                                                                                    	\
+	public_interface_get rm_size count_threshold;                                                                                                  	\
+                                                                                                                                                   	\
+	/* The number of rehashes since the initialization (see rm_##name##_hashmap_get_stats(...)) */                                                 	\
+	public_interface_get rm_size resizes_count;                                                                                                    	\
+} rm_##name##_hashmap;                                                                                                                             	\
+                                                                                                                                                   	\
+/* An iteration function that allows to process all key-value pairs in a hashmap */                                                                	\
+typedef rm_bool (*rm_##name##_hashmap_iteration_func)(const rm_##name##_hashmap*, rm_##name##_hashmap_key, rm_##name##_hashmap_value, rm_void*);   	\
+                                                                                                                                                   	\
+/* A debug version of the iteration function (the flag is set for entries that are followed by a group without empty control bytes) */             	\
+typedef rm_bool (*rm_##name##_hashmap_debug_iteration_func)(const rm_##name##_hashmap*, rm_##name##_hashmap_entry_const_ptr, rm_bool, rm_void*);
+
+//********************************************************
+//	Generic function definitions (private)
+//********************************************************
+
+#define RM_HASHMAP_OA_DEFINE_HASH_KEY(name, hash_func)                                                                	\
+                                                                                                                      	\
+/* Calculate the (mixed) hash for a given key. */                                                                     	\
+static inline rm_hashmap_hash rm_##name##_hashmap_hash_key(rm_##name##_hashmap_key key)                               	\
+{                                                                                                                     	\
+	/* There are no reserved hash values here (the control bytes mark empty entries), we only have to mix the bits. */	\
+	return rm_hashmap_oa_mix_hash(((rm_##name##_hashmap_hash_func)(hash_func))(key));                                 	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_ALLOCATE(name)                                                              	\
+                                                                                                         	\
+/* Allocate entries and control bytes for "buckets_count" entries (a PoT) and mark them all as empty. */ 	\
+static rm_void rm_##name##_hashmap_allocate(rm_##name##_hashmap* map, rm_size buckets_count)             	\
+{                                                                                                        	\
+	rm_size ctrl_count = buckets_count + RM_HASHMAP_OA_GROUP_SIZE;                                       	\
+	rm_uint8* memory = rm_malloc_large((buckets_count * sizeof(rm_##name##_hashmap_entry)) + ctrl_count);	\
+                                                                                                         	\
+	map->buckets = (rm_##name##_hashmap_entry_ptr)memory;                                                	\
+	map->ctrl = (rm_int8*)(memory + (buckets_count * sizeof(rm_##name##_hashmap_entry)));                	\
+	map->buckets_count = buckets_count;                                                                  	\
+                                                                                                         	\
+	rm_mem_set(map->ctrl, (rm_uint8)RM_HASHMAP_OA_CTRL_EMPTY, ctrl_count);                               	\
+                                                                                                         	\
+	map->count_threshold = rm_hashmap_oa_calculate_count_threshold(map->load_factor, map->buckets_count);	\
+	rm_assert(map->count_threshold >= map->count, "Hashmap table is too small for its entries.");        	\
+	map->growth_left = map->count_threshold - map->count;                                                	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_FIND_FREE_ENTRY(name)                                                             	\
+                                                                                                               	\
+/* Find the first empty or deleted entry in the probe sequence of a hash. There must be one. */                	\
+static inline rm_size rm_##name##_hashmap_find_free_entry(const rm_##name##_hashmap* map, rm_hashmap_hash hash)	\
+{                                                                                                              	\
+	rm_size mask = map->buckets_count - 1;                                                                     	\
+	rm_size position = rm_hashmap_oa_get_probe_start(hash) & mask;                                             	\
+	rm_size stride = 0;                                                                                        	\
+                                                                                                               	\
+	while (true)                                                                                               	\
+	{                                                                                                          	\
+		rm_uint32 free_mask = rm_hashmap_oa_group_match_empty_or_deleted(&map->ctrl[position]);                	\
+                                                                                                               	\
+		if (rm_likely(free_mask != 0))                                                                         	\
+		{                                                                                                      	\
+			return (position + (rm_size)__builtin_ctz(free_mask)) & mask;                                      	\
+		}                                                                                                      	\
+                                                                                                               	\
+		/* Triangular probing visits every group once (the number of groups is a PoT). */                      	\
+		stride += RM_HASHMAP_OA_GROUP_SIZE;                                                                    	\
+		position = (position + stride) & mask;                                                                 	\
+	}                                                                                                          	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_REHASH(name)                                                                                             	\
+                                                                                                                                      	\
+/*                                                                                                                                    	\
+	Move all entries into a new table with "new_buckets_count" entries.                                                               	\
+	This also drops all tombstones, so it is used with an unchanged size as well.                                                     	\
+*/                                                                                                                                    	\
+static rm_void rm_##name##_hashmap_rehash(rm_##name##_hashmap* map, rm_size new_buckets_count)                                        	\
+{                                                                                                                                     	\
+	rm_##name##_hashmap_entry_ptr old_buckets = map->buckets;                                                                         	\
+	const rm_int8* old_ctrl = map->ctrl;                                                                                              	\
+	rm_size old_buckets_count = map->buckets_count;                                                                                   	\
+                                                                                                                                      	\
+	/* Print some debug log info. */                                                                                                  	\
+	rm_log(RM_LOG_TYPE_DEBUG, "Hashmap rehash (entries: %zu, buckets: %zu -> %zu)", map->count, old_buckets_count, new_buckets_count);	\
+                                                                                                                                      	\
+	rm_##name##_hashmap_allocate(map, new_buckets_count);                                                                             	\
+                                                                                                                                      	\
+	/* The new table has no tombstones and enough room, so every entry goes to the first empty slot of its probe sequence. */         	\
+	for (rm_size i = 0; i < old_buckets_count; i++)                                                                                   	\
+	{                                                                                                                                 	\
+		if (old_ctrl[i] < 0)                                                                                                          	\
+		{                                                                                                                             	\
+			continue;                                                                                                                 	\
+		}                                                                                                                             	\
+                                                                                                                                      	\
+		rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(old_buckets[i].key);                                                      	\
+		rm_size index = rm_##name##_hashmap_find_free_entry(map, hash);                                                               	\
+                                                                                                                                      	\
+		rm_hashmap_oa_set_ctrl(map, index, rm_hashmap_oa_get_ctrl_for_hash(hash));                                                    	\
+		map->buckets[index] = old_buckets[i];                                                                                         	\
+	}                                                                                                                                 	\
+                                                                                                                                      	\
+	/* Entries and control bytes share one allocation. */                                                                             	\
+	rm_free(old_buckets);                                                                                                             	\
+                                                                                                                                      	\
+	map->resizes_count++;                                                                                                             	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_FIND_ENTRY(name, key_compare_func)                                                                                                                          	\
+                                                                                                                                                                                         	\
+/*                                                                                                                                                                                       	\
+	Find the entry with the given key.                                                                                                                                                   	\
+	If it is missing, null is returned. If "free_index_ptr" is not null, it receives the entry a new key would be inserted into.                                                         	\
+*/                                                                                                                                                                                       	\
+static inline rm_##name##_hashmap_entry_ptr rm_##name##_hashmap_find_entry_ex(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_size* free_index_ptr)	\
+{                                                                                                                                                                                        	\
+	rm_size mask = map->buckets_count - 1;                                                                                                                                               	\
+	rm_size position = rm_hashmap_oa_get_probe_start(hash) & mask;                                                                                                                       	\
+	rm_size stride = 0;                                                                                                                                                                  	\
+	rm_int8 ctrl_value = rm_hashmap_oa_get_ctrl_for_hash(hash);                                                                                                                          	\
+                                                                                                                                                                                         	\
+	/* The first tombstone on the way is where a new key goes. */                                                                                                                        	\
+	rm_bool has_free_index = false;                                                                                                                                                      	\
+	rm_size free_index = 0;                                                                                                                                                              	\
+                                                                                                                                                                                         	\
+	while (true)                                                                                                                                                                         	\
+	{                                                                                                                                                                                    	\
+		const rm_int8* group = &map->ctrl[position];                                                                                                                                     	\
+                                                                                                                                                                                         	\
+		/* Only compare keys of entries whose control byte matches. */                                                                                                                   	\
+		for (rm_uint32 match_mask = rm_hashmap_oa_group_match(group, ctrl_value); match_mask != 0; match_mask &= match_mask - 1)                                                         	\
+		{                                                                                                                                                                                	\
+			rm_size index = (position + (rm_size)__builtin_ctz(match_mask)) & mask;                                                                                                      	\
+                                                                                                                                                                                         	\
+			if (rm_likely(((rm_##name##_hashmap_key_compare_func)(key_compare_func))(key, map->buckets[index].key)))                                                                     	\
+			{                                                                                                                                                                            	\
+				return &map->buckets[index];                                                                                                                                             	\
+			}                                                                                                                                                                            	\
+		}                                                                                                                                                                                	\
+                                                                                                                                                                                         	\
+		/* An empty entry ends every probe sequence: The key would have been inserted here. */                                                                                           	\
+		rm_uint32 empty_mask = rm_hashmap_oa_group_match_empty(group);                                                                                                                   	\
+                                                                                                                                                                                         	\
+		if (free_index_ptr && !has_free_index)                                                                                                                                           	\
+		{                                                                                                                                                                                	\
+			rm_uint32 free_mask = rm_hashmap_oa_group_match_empty_or_deleted(group);                                                                                                     	\
+                                                                                                                                                                                         	\
+			if (free_mask != 0)                                                                                                                                                          	\
+			{                                                                                                                                                                            	\
+				has_free_index = true;                                                                                                                                                   	\
+				free_index = (position + (rm_size)__builtin_ctz(free_mask)) & mask;                                                                                                      	\
+			}                                                                                                                                                                            	\
+		}                                                                                                                                                                                	\
+                                                                                                                                                                                         	\
+		if (rm_likely(empty_mask != 0))                                                                                                                                                  	\
+		{                                                                                                                                                                                	\
+			if (free_index_ptr)                                                                                                                                                          	\
+			{                                                                                                                                                                            	\
+				*free_index_ptr = free_index;                                                                                                                                            	\
+			}                                                                                                                                                                            	\
+                                                                                                                                                                                         	\
+			return null;                                                                                                                                                                 	\
+		}                                                                                                                                                                                	\
+                                                                                                                                                                                         	\
+		/* Triangular probing visits every group once (the number of groups is a PoT). */                                                                                                	\
+		stride += RM_HASHMAP_OA_GROUP_SIZE;                                                                                                                                              	\
+		position = (position + stride) & mask;                                                                                                                                           	\
+	}                                                                                                                                                                                    	\
+}                                                                                                                                                                                        	\
+                                                                                                                                                                                         	\
+/* Find the entry with the given key or return null if it is missing. */                                                                                                                 	\
+static inline rm_##name##_hashmap_entry_ptr rm_##name##_hashmap_find_entry(const rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_hashmap_hash hash)                            	\
+{                                                                                                                                                                                        	\
+	/* If we have not yet allocated, there is nothing to find. */                                                                                                                        	\
+	if (rm_unlikely(map->buckets_count == 0))                                                                                                                                            	\
+	{                                                                                                                                                                                    	\
+		return null;                                                                                                                                                                     	\
+	}                                                                                                                                                                                    	\
+                                                                                                                                                                                         	\
+	return rm_##name##_hashmap_find_entry_ex(map, key, hash, null);                                                                                                                      	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_PREFETCH(name)                                                                  	\
+                                                                                                             	\
+/* Prefetch the first group of control bytes and the first entry of the probe sequence for the given hash. */	\
+static inline rm_void rm_##name##_hashmap_prefetch(const rm_##name##_hashmap* map, rm_hashmap_hash hash)     	\
+{                                                                                                            	\
+	if (rm_likely(map->buckets_count > 0))                                                                   	\
+	{                                                                                                        	\
+		rm_size position = rm_hashmap_oa_get_probe_start(hash) & (map->buckets_count - 1);                   	\
+                                                                                                             	\
+		rm_prefetch(&map->ctrl[position]);                                                                   	\
+		rm_prefetch(&map->buckets[position]);                                                                	\
+	}                                                                                                        	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_UNREF_ALL(name, key_unref_func, value_unref_func)                             	\
+                                                                                                           	\
+/* Unref all keys and / or values of entries in the hashmap. */                                            	\
+static inline rm_void rm_##name##_hashmap_unref_all(const rm_##name##_hashmap* map)                        	\
+{                                                                                                          	\
+	/*                                                                                                     	\
+		Unref all keys and values via iteration.                                                           	\
+		This is an expensive operation, so we only perform it                                              	\
+		if there are entries and at least one unref function pointer is present.                           	\
+	*/                                                                                                     	\
+	if ((rm_hashmap_has_func(key_unref_func) || rm_hashmap_has_func(value_unref_func)) && (map->count > 0))	\
+	{                                                                                                      	\
+		rm_##name##_hashmap_for_each(map, rm_##name##_hashmap_unref_entry, null);                          	\
+	}                                                                                                      	\
+}
+
+//********************************************************
+//	Generic function definitions (public, inline)
+//********************************************************
+
+#define RM_HASHMAP_OA_DEFINE_INLINE_FOR_EACH(name)                                                                                              	\
+                                                                                                                                                	\
+inline rm_void rm_##name##_hashmap_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context)	\
+{                                                                                                                                               	\
+	/* Scan the control bytes group by group (the mirrored bytes at the end are skipped). */                                                    	\
+	for (rm_size i = 0; i < map->buckets_count; i += RM_HASHMAP_OA_GROUP_SIZE)                                                                  	\
+	{                                                                                                                                           	\
+		rm_uint32 full_mask = ~rm_hashmap_oa_group_match_empty_or_deleted(&map->ctrl[i]);                                                       	\
+                                                                                                                                                	\
+		for (rm_size j = 0; j < RM_HASHMAP_OA_GROUP_SIZE; j++)                                                                                  	\
+		{                                                                                                                                       	\
+			if (((full_mask >> j) & 1) == 0)                                                                                                    	\
+			{                                                                                                                                   	\
+				continue;                                                                                                                       	\
+			}                                                                                                                                   	\
+                                                                                                                                                	\
+			/* Invoke the iteration function and pass the user's context while "true" is returned. */                                           	\
+			rm_##name##_hashmap_entry_ptr entry = &map->buckets[i + j];                                                                         	\
+                                                                                                                                                	\
+			if (!iteration_func(map, entry->key, entry->value, context))                                                                        	\
+			{                                                                                                                                   	\
+				return;                                                                                                                         	\
+			}                                                                                                                                   	\
+		}                                                                                                                                       	\
+	}                                                                                                                                           	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_INLINE_DEBUG_FOR_EACH(name)                                                                                                          	\
+                                                                                                                                                                  	\
+inline rm_void rm_##name##_hashmap_debug_for_each(const rm_##name##_hashmap* map, rm_##name##_hashmap_debug_iteration_func debug_iteration_func, rm_void* context)	\
+{                                                                                                                                                                 	\
+	for (rm_size i = 0; i < map->buckets_count; i++)                                                                                                              	\
+	{                                                                                                                                                             	\
+		/* Ignore empty and deleted entries. */                                                                                                                   	\
+		if (map->ctrl[i] < 0)                                                                                                                                     	\
+		{                                                                                                                                                         	\
+			continue;                                                                                                                                             	\
+		}                                                                                                                                                         	\
+                                                                                                                                                                  	\
+		/* Is the entry part of a group without empty control bytes? Then probe sequences run across it (and removing it leaves a tombstone). */                  	\
+		rm_##name##_hashmap_entry_const_ptr entry = &map->buckets[i];                                                                                             	\
+		rm_bool is_crowded = rm_hashmap_oa_group_match_empty(&map->ctrl[i]) == 0;                                                                                 	\
+                                                                                                                                                                  	\
+		if (!debug_iteration_func(map, entry, is_crowded, context))                                                                                               	\
+		{                                                                                                                                                         	\
+			return;                                                                                                                                               	\
+		}                                                                                                                                                         	\
+	}                                                                                                                                                             	\
+}
+
+//********************************************************
+//	Generic function definitions (public, non-inline)
+//********************************************************
+
+#define RM_HASHMAP_OA_DEFINE_INIT_EX(name)                                                                                                            	\
+                                                                                                                                                      	\
+rm_void rm_##name##_hashmap_init_ex(rm_##name##_hashmap* map, rm_size initial_buckets_count, rm_double load_factor)                                   	\
+{                                                                                                                                                     	\
+	/* Start with a count of 0. */                                                                                                                    	\
+	map->count = 0;                                                                                                                                   	\
+                                                                                                                                                      	\
+	/* Limit the bucket count. */                                                                                                                     	\
+	rm_precond(initial_buckets_count <= RM_HASHMAP_MAX_BUCKETS_COUNT, "Initial bucket count is too big (maximum: %zu)", RM_HASHMAP_MAX_BUCKETS_COUNT);	\
+	rm_precond(load_factor >= 0, "Invalid load factor: %lf", load_factor);                                                                            	\
+                                                                                                                                                      	\
+	map->load_factor = load_factor;                                                                                                                   	\
+	map->resizes_count = 0;                                                                                                                           	\
+                                                                                                                                                      	\
+	if (initial_buckets_count == 0)                                                                                                                   	\
+	{                                                                                                                                                 	\
+		/* Start without allocating. */                                                                                                               	\
+		map->buckets = null;                                                                                                                          	\
+		map->ctrl = null;                                                                                                                             	\
+		map->buckets_count = 0;                                                                                                                       	\
+		map->count_threshold = 0;                                                                                                                     	\
+		map->growth_left = 0;                                                                                                                         	\
+	}                                                                                                                                                 	\
+	else                                                                                                                                              	\
+	{                                                                                                                                                 	\
+		/* Select the first PoT that is sufficient. */                                                                                                	\
+		rm_size buckets_count = RM_HASHMAP_OA_MIN_BUCKETS_COUNT;                                                                                      	\
+                                                                                                                                                      	\
+		while (buckets_count < initial_buckets_count)                                                                                                 	\
+		{                                                                                                                                             	\
+			buckets_count <<= 1;                                                                                                                      	\
+		}                                                                                                                                             	\
+                                                                                                                                                      	\
+		rm_##name##_hashmap_allocate(map, buckets_count);                                                                                             	\
+	}                                                                                                                                                 	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_DISPOSE(name)                         	\
+                                                                   	\
+rm_void rm_##name##_hashmap_dispose(rm_##name##_hashmap* map)      	\
+{                                                                  	\
+	/* Unref all keys and values. */                               	\
+	rm_##name##_hashmap_unref_all(map);                            	\
+                                                                   	\
+	/*                                                             	\
+		Free entries and control bytes.                            	\
+		If we have not yet allocated, this becomes "rm_free(null)".	\
+	*/                                                             	\
+	rm_free(map->buckets);                                         	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_CLEAR(name)                                                                         	\
+                                                                                                                 	\
+rm_void rm_##name##_hashmap_clear(rm_##name##_hashmap* map)                                                      	\
+{                                                                                                                	\
+	/* Unref all keys and values. */                                                                             	\
+	rm_##name##_hashmap_unref_all(map);                                                                          	\
+                                                                                                                 	\
+	/* Reset the count. */                                                                                       	\
+	map->count = 0;                                                                                              	\
+                                                                                                                 	\
+	/* Mark all entries as empty (this drops the tombstones as well). */                                         	\
+	if (rm_likely(map->buckets_count > 0))                                                                       	\
+	{                                                                                                            	\
+		rm_mem_set(map->ctrl, (rm_uint8)RM_HASHMAP_OA_CTRL_EMPTY, map->buckets_count + RM_HASHMAP_OA_GROUP_SIZE);	\
+	}                                                                                                            	\
+                                                                                                                 	\
+	map->growth_left = map->count_threshold;                                                                     	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_UPDATE(name, key_ref_func, value_ref_func, merge_func)                                                                                                                                                            	\
+                                                                                                                                                                                                                                               	\
+/* Update the value for a key with a precalculated hash (see below). */                                                                                                                                                                        	\
+static inline rm_bool rm_##name##_hashmap_update_with_hash(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_hashmap_hash hash, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)	\
+{                                                                                                                                                                                                                                              	\
+	/* If we have not yet allocated, we must do that now. */                                                                                                                                                                                   	\
+	if (rm_unlikely(map->buckets_count == 0))                                                                                                                                                                                                  	\
+	{                                                                                                                                                                                                                                          	\
+		/* If the mode requires an existing entry, we can leave early. */                                                                                                                                                                      	\
+		if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                                                                	\
+		{                                                                                                                                                                                                                                      	\
+			return false;                                                                                                                                                                                                                      	\
+		}                                                                                                                                                                                                                                      	\
+                                                                                                                                                                                                                                               	\
+		rm_##name##_hashmap_allocate(map, RM_HASHMAP_OA_MIN_BUCKETS_COUNT);                                                                                                                                                                    	\
+	}                                                                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                               	\
+	/* Get the corresponding entry or the place for a new one. */                                                                                                                                                                              	\
+	rm_size index;                                                                                                                                                                                                                             	\
+	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry_ex(map, key, hash, &index);                                                                                                                                           	\
+                                                                                                                                                                                                                                               	\
+	/* Does the entry already exist? */                                                                                                                                                                                                        	\
+	if (entry)                                                                                                                                                                                                                                 	\
+	{                                                                                                                                                                                                                                          	\
+		/* Do not assign the old value to the pointee yet. "old_value_ptr" might be "&value" - in that case, we have a problem. */                                                                                                             	\
+		rm_##name##_hashmap_value old_value = entry->value;                                                                                                                                                                                    	\
+                                                                                                                                                                                                                                               	\
+		/* How to cope with the existing value? */                                                                                                                                                                                             	\
+		switch (mode)                                                                                                                                                                                                                          	\
+		{                                                                                                                                                                                                                                      	\
+		case RM_HASHMAP_UPDATE_MODE_REPLACE:                                                                                                                                                                                                   	\
+		case RM_HASHMAP_UPDATE_MODE_SET:                                                                                                                                                                                                       	\
+                                                                                                                                                                                                                                               	\
+			/* Replace the existing value. Ref it if necessary. */                                                                                                                                                                             	\
+			entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, value, value);                                                                                                                             	\
+			break;                                                                                                                                                                                                                             	\
+                                                                                                                                                                                                                                               	\
+		case RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE:                                                                                                                                                                                           	\
+		case RM_HASHMAP_UPDATE_MODE_MERGE:                                                                                                                                                                                                     	\
+                                                                                                                                                                                                                                               	\
+			/* Merge old and new value. Ref the result if necessary. */                                                                                                                                                                        	\
+			rm_assert(rm_hashmap_has_func(merge_func), "RM_HASHMAP_UPDATE_MODE_MERGE specified, but merge func pointer is null.");                                                                                                             	\
+                                                                                                                                                                                                                                               	\
+			rm_##name##_hashmap_value merged_value = rm_hashmap_call_func(rm_##name##_hashmap_merge_func, merge_func, entry->value, key, entry->value, value);                                                                                 	\
+			entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, merged_value, merged_value);                                                                                                               	\
+                                                                                                                                                                                                                                               	\
+			break;                                                                                                                                                                                                                             	\
+                                                                                                                                                                                                                                               	\
+		case RM_HASHMAP_UPDATE_MODE_INSERT:                                                                                                                                                                                                    	\
+                                                                                                                                                                                                                                               	\
+			/* Nothing to do here, we don't overwrite old values in this mode. */                                                                                                                                                              	\
+			break;                                                                                                                                                                                                                             	\
+		}                                                                                                                                                                                                                                      	\
+                                                                                                                                                                                                                                               	\
+		/* Now we can safely assign to the pointee (the user has to unref the old value manually if we have replaced it). */                                                                                                                   	\
+		*old_value_ptr = old_value;                                                                                                                                                                                                            	\
+                                                                                                                                                                                                                                               	\
+		return true;                                                                                                                                                                                                                           	\
+	}                                                                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                               	\
+	/*                                                                                                                                                                                                                                         	\
+		The entry does not exist yet.                                                                                                                                                                                                          	\
+		In replace and pure merge mode, we can stop here because inserting new entries is forbidden.                                                                                                                                           	\
+	*/                                                                                                                                                                                                                                         	\
+	if ((mode == RM_HASHMAP_UPDATE_MODE_REPLACE) || (mode == RM_HASHMAP_UPDATE_MODE_MERGE))                                                                                                                                                    	\
+	{                                                                                                                                                                                                                                          	\
+		return false;                                                                                                                                                                                                                          	\
+	}                                                                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                               	\
+	/*                                                                                                                                                                                                                                         	\
+		Filling a tombstone is always fine.                                                                                                                                                                                                    	\
+		Filling an empty entry needs growth left, otherwise we rebuild the table and look for a new place:                                                                                                                                     	\
+		If tombstones make up a large part of the load, the table keeps its size. Otherwise, it is doubled.                                                                                                                                    	\
+	*/                                                                                                                                                                                                                                         	\
+	if (rm_unlikely((map->growth_left == 0) && (map->ctrl[index] == RM_HASHMAP_OA_CTRL_EMPTY)))                                                                                                                                                	\
+	{                                                                                                                                                                                                                                          	\
+		if (map->count < (map->count_threshold / 2))                                                                                                                                                                                           	\
+		{                                                                                                                                                                                                                                      	\
+			rm_##name##_hashmap_rehash(map, map->buckets_count);                                                                                                                                                                               	\
+		}                                                                                                                                                                                                                                      	\
+		else                                                                                                                                                                                                                                   	\
+		{                                                                                                                                                                                                                                      	\
+			/* With a tiny load factor, the threshold is clamped to 1 for a while, so doubling once might not make room. */                                                                                                                    	\
+			rm_size new_buckets_count = map->buckets_count;                                                                                                                                                                                    	\
+                                                                                                                                                                                                                                               	\
+			do                                                                                                                                                                                                                                 	\
+			{                                                                                                                                                                                                                                  	\
+				rm_precond(new_buckets_count < RM_HASHMAP_MAX_BUCKETS_COUNT, "Hashmap has reached its maximum bucket count (%zu).", RM_HASHMAP_MAX_BUCKETS_COUNT);                                                                             	\
+				new_buckets_count <<= 1;                                                                                                                                                                                                       	\
+			} while (rm_hashmap_oa_calculate_count_threshold(map->load_factor, new_buckets_count) <= map->count);                                                                                                                              	\
+                                                                                                                                                                                                                                               	\
+			rm_##name##_hashmap_rehash(map, new_buckets_count);                                                                                                                                                                                	\
+		}                                                                                                                                                                                                                                      	\
+                                                                                                                                                                                                                                               	\
+		index = rm_##name##_hashmap_find_free_entry(map, hash);                                                                                                                                                                                	\
+	}                                                                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                               	\
+	/* Claim the entry. */                                                                                                                                                                                                                     	\
+	if (map->ctrl[index] == RM_HASHMAP_OA_CTRL_EMPTY)                                                                                                                                                                                          	\
+	{                                                                                                                                                                                                                                          	\
+		map->growth_left--;                                                                                                                                                                                                                    	\
+	}                                                                                                                                                                                                                                          	\
+                                                                                                                                                                                                                                               	\
+	rm_hashmap_oa_set_ctrl(map, index, rm_hashmap_oa_get_ctrl_for_hash(hash));                                                                                                                                                                 	\
+                                                                                                                                                                                                                                               	\
+	/*                                                                                                                                                                                                                                         	\
+		Initialize the entry.                                                                                                                                                                                                                  	\
+		Ref key and / or value if necessary.                                                                                                                                                                                                   	\
+	*/                                                                                                                                                                                                                                         	\
+	entry = &map->buckets[index];                                                                                                                                                                                                              	\
+	entry->key = rm_hashmap_call_func(rm_##name##_hashmap_key_ref_func, key_ref_func, key, key);                                                                                                                                               	\
+	entry->value = rm_hashmap_call_func(rm_##name##_hashmap_value_ref_func, value_ref_func, value, value);                                                                                                                                     	\
+                                                                                                                                                                                                                                               	\
+	map->count++;                                                                                                                                                                                                                              	\
+                                                                                                                                                                                                                                               	\
+	return false;                                                                                                                                                                                                                              	\
+}                                                                                                                                                                                                                                              	\
+                                                                                                                                                                                                                                               	\
+rm_bool rm_##name##_hashmap_update(rm_##name##_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)                                              	\
+{                                                                                                                                                                                                                                              	\
+	/* Calculate the hash for the key and delegate. */                                                                                                                                                                                         	\
+	return rm_##name##_hashmap_update_with_hash(map, key, rm_##name##_hashmap_hash_key(key), value, mode, old_value_ptr);                                                                                                                      	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_GET_STATS(name)                                                                                                                         	\
+                                                                                                                                                                     	\
+rm_void rm_##name##_hashmap_get_stats(const rm_##name##_hashmap* map, rm_hashmap_stats* stats)                                                                       	\
+{                                                                                                                                                                    	\
+	rm_assert(stats, "Passed stats must be valid.");                                                                                                                 	\
+                                                                                                                                                                     	\
+	*stats = (rm_hashmap_stats)                                                                                                                                      	\
+	{                                                                                                                                                                	\
+		.count = map->count,                                                                                                                                         	\
+		.buckets_count = map->buckets_count,                                                                                                                         	\
+		.used_buckets_count = map->count,                                                                                                                            	\
+		.resizes_count = map->resizes_count,                                                                                                                         	\
+		.allocated_bytes = (map->buckets_count == 0) ? 0 : ((map->buckets_count * sizeof(rm_##name##_hashmap_entry)) + map->buckets_count + RM_HASHMAP_OA_GROUP_SIZE)	\
+	};                                                                                                                                                               	\
+                                                                                                                                                                     	\
+	/* Follow the probe sequence of every entry until the first group that contains it (that is where a lookup finds it). */                                         	\
+	rm_size mask = map->buckets_count - 1;                                                                                                                           	\
+	rm_size probed_groups_count = 0;                                                                                                                                 	\
+                                                                                                                                                                     	\
+	for (rm_size i = 0; i < map->buckets_count; i++)                                                                                                                 	\
+	{                                                                                                                                                                	\
+		if (map->ctrl[i] < 0)                                                                                                                                        	\
+		{                                                                                                                                                            	\
+			stats->buckets_by_chain_length[0]++;                                                                                                                     	\
+			stats->supply_list_count += (map->ctrl[i] == RM_HASHMAP_OA_CTRL_DELETED) ? 1 : 0;                                                                        	\
+                                                                                                                                                                     	\
+			continue;                                                                                                                                                	\
+		}                                                                                                                                                            	\
+                                                                                                                                                                     	\
+		rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(map->buckets[i].key);                                                                                    	\
+		rm_size position = rm_hashmap_oa_get_probe_start(hash) & mask;                                                                                               	\
+		rm_size stride = 0;                                                                                                                                          	\
+		rm_size probe_length = 1;                                                                                                                                    	\
+                                                                                                                                                                     	\
+		while (((i - position) & mask) >= RM_HASHMAP_OA_GROUP_SIZE)                                                                                                  	\
+		{                                                                                                                                                            	\
+			stride += RM_HASHMAP_OA_GROUP_SIZE;                                                                                                                      	\
+			position = (position + stride) & mask;                                                                                                                   	\
+			probe_length++;                                                                                                                                          	\
+		}                                                                                                                                                            	\
+                                                                                                                                                                     	\
+		stats->buckets_by_chain_length[rm_min(probe_length, RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT - 1)]++;                                                            	\
+		stats->max_chain_length = rm_max(stats->max_chain_length, probe_length);                                                                                     	\
+		probed_groups_count += probe_length;                                                                                                                         	\
+	}                                                                                                                                                                	\
+                                                                                                                                                                     	\
+	if (map->count > 0)                                                                                                                                              	\
+	{                                                                                                                                                                	\
+		stats->mean_chain_length = (rm_double)probed_groups_count / (rm_double)map->count;                                                                           	\
+		stats->mean_lookup_length = stats->mean_chain_length;                                                                                                        	\
+	}                                                                                                                                                                	\
+}
+
+#define RM_HASHMAP_OA_DEFINE_REMOVE(name)                                                                                                 	\
+                                                                                                                                          	\
+rm_bool rm_##name##_hashmap_remove(rm_##name##_hashmap* map, rm_##name##_hashmap_key key)                                                 	\
+{                                                                                                                                         	\
+	/* Calculate the hash for the key. */                                                                                                 	\
+	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                             	\
+                                                                                                                                          	\
+	/* Get the corresponding entry. If it does not exist, there is nothing to do. */                                                      	\
+	rm_##name##_hashmap_entry_ptr entry = rm_##name##_hashmap_find_entry(map, key, hash);                                                 	\
+                                                                                                                                          	\
+	if (!entry)                                                                                                                           	\
+	{                                                                                                                                     	\
+		return false;                                                                                                                     	\
+	}                                                                                                                                     	\
+                                                                                                                                          	\
+	/* Unref key and value if necessary. */                                                                                               	\
+	rm_##name##_hashmap_unref_entry(map, key, entry->value, null);                                                                        	\
+                                                                                                                                          	\
+	/*                                                                                                                                    	\
+		A probe sequence only runs across our entry if the entry is part of a full group of non-empty control bytes.                      	\
+		So we count the non-empty control bytes around it: If there are less than a group, nobody has ever gone past the entry            	\
+		and it can become empty again. Otherwise, we need a tombstone.                                                                    	\
+	*/                                                                                                                                    	\
+	rm_size mask = map->buckets_count - 1;                                                                                                	\
+	rm_size index = (rm_size)(entry - map->buckets);                                                                                      	\
+                                                                                                                                          	\
+	rm_uint32 empty_before_mask = rm_hashmap_oa_group_match_empty(&map->ctrl[(index - RM_HASHMAP_OA_GROUP_SIZE) & mask]);                 	\
+	rm_uint32 empty_after_mask = rm_hashmap_oa_group_match_empty(&map->ctrl[index]);                                                      	\
+                                                                                                                                          	\
+	rm_bool is_empty = false;                                                                                                             	\
+                                                                                                                                          	\
+	if ((empty_before_mask != 0) && (empty_after_mask != 0))                                                                              	\
+	{                                                                                                                                     	\
+		/* The highest bit of the "before" mask is the control byte right before our entry. */                                            	\
+		rm_size non_empty_before_count = (rm_size)__builtin_clz(empty_before_mask) - ((8 * sizeof(rm_uint32)) - RM_HASHMAP_OA_GROUP_SIZE);	\
+		rm_size non_empty_after_count = (rm_size)__builtin_ctz(empty_after_mask);                                                         	\
+                                                                                                                                          	\
+		is_empty = (non_empty_before_count + non_empty_after_count) < RM_HASHMAP_OA_GROUP_SIZE;                                           	\
+	}                                                                                                                                     	\
+                                                                                                                                          	\
+	if (is_empty)                                                                                                                         	\
+	{                                                                                                                                     	\
+		rm_hashmap_oa_set_ctrl(map, index, RM_HASHMAP_OA_CTRL_EMPTY);                                                                     	\
+		map->growth_left++;                                                                                                               	\
+	}                                                                                                                                     	\
+	else                                                                                                                                  	\
+	{                                                                                                                                     	\
+		rm_hashmap_oa_set_ctrl(map, index, RM_HASHMAP_OA_CTRL_DELETED);                                                                   	\
+	}                                                                                                                                     	\
+                                                                                                                                          	\
+	/* Decrement the count, we definitely have removed one entry at this point. */                                                        	\
+	map->count--;                                                                                                                         	\
+                                                                                                                                          	\
+	return true;                                                                                                                          	\
+}
+
+//********************************************************
+//	Collective macros for decl. and def.
+//********************************************************
+
+//The declarations are exactly the ones of rm_hashmap.h (see there for the documentation of the functions).
+#define RM_HASHMAP_OA_DECLARE(name, key_type, value_type, struct_order)	\
+RM_HASHMAP_OA_DECLARE_TYPES(name, key_type, value_type, struct_order)  	\
+RM_HASHMAP_DECLARE_FUNCTIONS(name)                                     	\
+RM_HASHMAP_DEFINE_INLINE_INIT(name)                                    	\
+RM_HASHMAP_DEFINE_INLINE_GET(name)                                     	\
+RM_HASHMAP_OA_DEFINE_INLINE_FOR_EACH(name)                             	\
+RM_HASHMAP_OA_DEFINE_INLINE_DEBUG_FOR_EACH(name)
+
+//The functions that don't depend on the layout are shared with rm_hashmap.h:
+#define RM_HASHMAP_OA_DEFINE(name, hash_func, key_compare_func, key_ref_func, key_unref_func, value_ref_func, value_unref_func, merge_func)	\
+RM_HASHMAP_OA_DEFINE_HASH_KEY(name, hash_func)                                                                                             	\
+RM_HASHMAP_OA_DEFINE_ALLOCATE(name)                                                                                                        	\
+RM_HASHMAP_OA_DEFINE_FIND_FREE_ENTRY(name)                                                                                                 	\
+RM_HASHMAP_OA_DEFINE_REHASH(name)                                                                                                          	\
+RM_HASHMAP_OA_DEFINE_FIND_ENTRY(name, key_compare_func)                                                                                    	\
+RM_HASHMAP_OA_DEFINE_PREFETCH(name)                                                                                                        	\
+RM_HASHMAP_DEFINE_UNREF_ENTRY(name, key_unref_func, value_unref_func)                                                                      	\
+RM_HASHMAP_OA_DEFINE_UNREF_ALL(name, key_unref_func, value_unref_func)                                                                     	\
+RM_HASHMAP_DEFINE_INIT(name)                                                                                                               	\
+RM_HASHMAP_OA_DEFINE_INIT_EX(name)                                                                                                         	\
+RM_HASHMAP_OA_DEFINE_DISPOSE(name)                                                                                                         	\
+RM_HASHMAP_OA_DEFINE_CLEAR(name)                                                                                                           	\
+RM_HASHMAP_DEFINE_CONTAINS_KEY(name)                                                                                                       	\
+RM_HASHMAP_DEFINE_GET(name)                                                                                                                	\
+RM_HASHMAP_DEFINE_GET_EX(name)                                                                                                             	\
+RM_HASHMAP_DEFINE_SET(name, value_unref_func)                                                                                              	\
+RM_HASHMAP_OA_DEFINE_UPDATE(name, key_ref_func, value_ref_func, merge_func)                                                                	\
+RM_HASHMAP_DEFINE_GET_BATCH(name)                                                                                                          	\
+RM_HASHMAP_DEFINE_UPDATE_BATCH(name)                                                                                                       	\
+RM_HASHMAP_OA_DEFINE_REMOVE(name)                                                                                                          	\
+RM_HASHMAP_OA_DEFINE_GET_STATS(name)                                                                                                       	\
+RM_HASHMAP_DEFINE_FOR_EACH(name)                                                                                                           	\
+RM_HASHMAP_DEFINE_DEBUG_FOR_EACH(name)
+
+#endif
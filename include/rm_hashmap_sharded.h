@@ -0,0 +1,470 @@
+#ifndef __RM_HASHMAP_SHARDED_H__
+#define __RM_HASHMAP_SHARDED_H__
+
+/*
+	A concurrent variant of rm_hashmap.h (or rm_hashmap_oa.h) for maps that are filled by multiple threads at once.
+	It is generated on top of an existing monomorphization: The keys are distributed over a PoT number of shards by their (mixed) hash,
+	every shard is an ordinary rm_##name##_hashmap with a mutex of its own. Threads that update different shards never wait for each other.
+
+	A lock per update would still be expensive, so threads should update through a buffer of their own (rm_##name##_sharded_hashmap_buffer):
+	It collects the updates per shard and applies a whole bunch of them while holding the lock once (with the prefetching of the batch functions).
+	The updates of a single key are applied in order per buffer, but updates from different buffers are interleaved in an undefined order.
+	So the result only depends on the input if the merge function is commutative (like counting occurrences).
+
+	Reads come in two flavors: Single lookups lock the shard, while the batch lookup, the iteration and the statistics don't lock at all.
+	The latter are meant for the phase after all writers have finished (e.g. a verifier is built by many threads and queried afterwards).
+
+	Usage (in the translation unit that defines the hashmap functions):
+
+		RM_HASHMAP_DECLARE(name, ...)
+		RM_HASHMAP_SHARDED_DECLARE(name)
+
+		RM_HASHMAP_DEFINE(name, ...)
+		RM_HASHMAP_SHARDED_DEFINE(name)
+*/
+
+#include "rm_assert.h"
+#include "rm_hashmap.h"
+#include "rm_macro.h"
+#include "rm_mem.h"
+#include "rm_thread.h"
+#include "rm_type.h"
+
+//********************************************************
+//	Constants
+//********************************************************
+
+//How many updates does a buffer collect for a shard before it locks the shard and applies them?
+#define RM_HASHMAP_SHARDED_BUFFER_COUNT ((rm_size)64)
+
+//How many consecutive hashes are always put into the same shard?
+//Smaller blocks balance the shards better, larger ones keep more locality.
+#define RM_HASHMAP_SHARDED_BLOCK_SIZE ((rm_hashmap_hash)256)
+
+//How many shards per thread should a map have? More shards mean less contention, but also more (partially filled) buffers.
+#define RM_HASHMAP_SHARDED_SHARDS_PER_THREAD ((rm_size)4)
+
+//********************************************************
+//	Macro definitions
+//********************************************************
+
+//Get a sufficient number of shards (a PoT) for the given number of threads:
+#define rm_hashmap_sharded_get_shards_count(threads_count)                                                          	\
+({                                                                                                                  	\
+	rm_size _min_shards_count = rm_max((rm_size)(threads_count), (rm_size)1) * RM_HASHMAP_SHARDED_SHARDS_PER_THREAD;	\
+	rm_size _shards_count = 1;                                                                                      	\
+                                                                                                                    	\
+	while (_shards_count < _min_shards_count)                                                                       	\
+	{                                                                                                               	\
+		_shards_count <<= 1;                                                                                        	\
+	}                                                                                                               	\
+                                                                                                                    	\
+	_shards_count;                                                                                                  	\
+})
+
+//Get the index of the shard for a hash.
+//Blocks of RM_HASHMAP_SHARDED_BLOCK_SIZE consecutive hashes share a shard, the blocks are mixed to spread them evenly.
+//This keeps the locality of hash functions that map nearby keys to nearby buckets (like the XOR of vertex IDs).
+#define rm_hashmap_sharded_get_shard_index(map, hash) (rm_hashmap_mix_fold((hash) / RM_HASHMAP_SHARDED_BLOCK_SIZE) & ((map)->shards_count - 1))
+
+//********************************************************
+//	Generic type declarations
+//********************************************************
+
+#define RM_HASHMAP_SHARDED_DECLARE_TYPES(name)                                                                                                  	\
+                                                                                                                                                	\
+/*                                                                                                                                              	\
+	A shard: A hashmap and the mutex that guards it.                                                                                            	\
+	The padding keeps the mutex of the next shard out of the cache line that holds our counters.                                                	\
+*/                                                                                                                                              	\
+typedef struct __rm_##name##_hashmap_shard__                                                                                                    	\
+{                                                                                                                                               	\
+	rm_mutex mutex;                                                                                                                             	\
+	rm_##name##_hashmap map;                                                                                                                    	\
+	rm_uint8 padding[RM_THREAD_CACHE_LINE_SIZE];                                                                                                	\
+} rm_##name##_hashmap_shard;                                                                                                                    	\
+                                                                                                                                                	\
+/* The sharded hashmap itself */                                                                                                                	\
+typedef struct __rm_##name##_sharded_hashmap__                                                                                                  	\
+{                                                                                                                                               	\
+	rm_##name##_hashmap_shard* shards;                                                                                                          	\
+	public_interface_get rm_size shards_count;                                                                                                  	\
+} rm_##name##_sharded_hashmap;                                                                                                                  	\
+                                                                                                                                                	\
+/* An update that waits in a buffer (the hash is kept, so it is calculated only once) */                                                        	\
+typedef struct __rm_##name##_sharded_hashmap_pending_update__                                                                                   	\
+{                                                                                                                                               	\
+	rm_##name##_hashmap_key key;                                                                                                                	\
+	rm_hashmap_hash hash;                                                                                                                       	\
+	rm_##name##_hashmap_value value;                                                                                                            	\
+} rm_##name##_sharded_hashmap_pending_update;                                                                                                   	\
+                                                                                                                                                	\
+/*                                                                                                                                              	\
+	The update buffer of a single thread.                                                                                                       	\
+	"found_count" is the number of applied updates that have found an existing value (like the return value of rm_##name##_hashmap_update(...)).	\
+*/                                                                                                                                              	\
+typedef struct __rm_##name##_sharded_hashmap_buffer__                                                                                           	\
+{                                                                                                                                               	\
+	rm_##name##_sharded_hashmap* map;                                                                                                           	\
+	rm_hashmap_update_mode mode;                                                                                                                	\
+                                                                                                                                                	\
+	/* RM_HASHMAP_SHARDED_BUFFER_COUNT pending updates per shard and their counts */                                                            	\
+	rm_##name##_sharded_hashmap_pending_update* pending_updates;                                                                                	\
+	rm_size* pending_counts;                                                                                                                    	\
+                                                                                                                                                	\
+	public_interface_get rm_size found_count;                                                                                                   	\
+} rm_##name##_sharded_hashmap_buffer;
+
+//********************************************************
+//	Generic function declarations
+//********************************************************
+
+#define RM_HASHMAP_SHARDED_DECLARE_FUNCTIONS(name)                                                                                                                                                                	\
+                                                                                                                                                                                                                  	\
+/*                                                                                                                                                                                                                	\
+	Initialize a new sharded hashmap with "shards_count" shards (a PoT, see rm_hashmap_sharded_get_shards_count(...)).                                                                                            	\
+	"initial_buckets_count" and "load_factor" are the ones of rm_##name##_hashmap_init_ex(...), the buckets are split among the shards.                                                                           	\
+*/                                                                                                                                                                                                                	\
+rm_void rm_##name##_sharded_hashmap_init(rm_##name##_sharded_hashmap* map, rm_size shards_count, rm_size initial_buckets_count, rm_double load_factor);                                                           	\
+                                                                                                                                                                                                                  	\
+/* Dispose an existing sharded hashmap. No thread must use it anymore. */                                                                                                                                         	\
+rm_void rm_##name##_sharded_hashmap_dispose(rm_##name##_sharded_hashmap* map);                                                                                                                                    	\
+                                                                                                                                                                                                                  	\
+/* Get the number of key-value-pairs in all shards (only exact if no thread updates the hashmap). */                                                                                                              	\
+rm_size rm_##name##_sharded_hashmap_get_count(const rm_##name##_sharded_hashmap* map);                                                                                                                            	\
+                                                                                                                                                                                                                  	\
+/* The single versions of rm_##name##_hashmap_get_ex(...), rm_##name##_hashmap_update(...) and rm_##name##_hashmap_remove(...) lock the shard of the key. */                                                      	\
+rm_bool rm_##name##_sharded_hashmap_get_ex(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr);                                                                  	\
+rm_bool rm_##name##_sharded_hashmap_update(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr);	\
+rm_bool rm_##name##_sharded_hashmap_remove(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key);                                                                                                        	\
+                                                                                                                                                                                                                  	\
+/*                                                                                                                                                                                                                	\
+	Like rm_##name##_hashmap_get_batch(...), rm_##name##_hashmap_for_each(...) and rm_##name##_hashmap_get_stats(...) (summed up over all shards).                                                                	\
+	*Important*: They don't lock, no thread must update the hashmap at the same time.                                                                                                                             	\
+	The iteration visits the shards one after another, the iteration function receives the hashmap of the shard.                                                                                                  	\
+*/                                                                                                                                                                                                                	\
+rm_size rm_##name##_sharded_hashmap_get_batch(const rm_##name##_sharded_hashmap* map, const rm_##name##_hashmap_key* keys, rm_size count, rm_##name##_hashmap_value* values, rm_bool* results);                   	\
+rm_void rm_##name##_sharded_hashmap_for_each(const rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context);                                                        	\
+rm_void rm_##name##_sharded_hashmap_get_stats(const rm_##name##_sharded_hashmap* map, rm_hashmap_stats* stats);                                                                                                   	\
+                                                                                                                                                                                                                  	\
+/*                                                                                                                                                                                                                	\
+	Create an update buffer for the calling thread. All updates through it use "mode".                                                                                                                            	\
+	The old values of updates that find an existing value are dropped, so don't replace values that need an unref this way.                                                                                       	\
+*/                                                                                                                                                                                                                	\
+rm_void rm_##name##_sharded_hashmap_buffer_init(rm_##name##_sharded_hashmap_buffer* buffer, rm_##name##_sharded_hashmap* map, rm_hashmap_update_mode mode);                                                       	\
+                                                                                                                                                                                                                  	\
+/* Queue an update. If the buffer for its shard is full, the shard is locked and all of them are applied. */                                                                                                      	\
+rm_void rm_##name##_sharded_hashmap_buffer_update(rm_##name##_sharded_hashmap_buffer* buffer, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value);                                                      	\
+                                                                                                                                                                                                                  	\
+/* Apply all queued updates. */                                                                                                                                                                                   	\
+rm_void rm_##name##_sharded_hashmap_buffer_flush(rm_##name##_sharded_hashmap_buffer* buffer);                                                                                                                     	\
+                                                                                                                                                                                                                  	\
+/* Apply all queued updates and dispose the buffer. */                                                                                                                                                            	\
+rm_void rm_##name##_sharded_hashmap_buffer_dispose(rm_##name##_sharded_hashmap_buffer* buffer);
+
+//********************************************************
+//	Generic function definitions (private)
+//********************************************************
+
+#define RM_HASHMAP_SHARDED_DEFINE_FLUSH_SHARD(name)                                                                                                                                   	\
+                                                                                                                                                                                      	\
+/* Apply the pending updates of a buffer for a single shard while holding its lock. */                                                                                                	\
+static rm_void rm_##name##_sharded_hashmap_buffer_flush_shard(rm_##name##_sharded_hashmap_buffer* buffer, rm_size shard_index)                                                        	\
+{                                                                                                                                                                                     	\
+	rm_size count = buffer->pending_counts[shard_index];                                                                                                                              	\
+                                                                                                                                                                                      	\
+	if (count == 0)                                                                                                                                                                   	\
+	{                                                                                                                                                                                 	\
+		return;                                                                                                                                                                       	\
+	}                                                                                                                                                                                 	\
+                                                                                                                                                                                      	\
+	rm_##name##_hashmap_shard* shard = &buffer->map->shards[shard_index];                                                                                                             	\
+	const rm_##name##_sharded_hashmap_pending_update* pending_updates = &buffer->pending_updates[shard_index * RM_HASHMAP_SHARDED_BUFFER_COUNT];                                      	\
+	rm_size found_count = 0;                                                                                                                                                          	\
+                                                                                                                                                                                      	\
+	rm_mutex_lock(&shard->mutex);                                                                                                                                                     	\
+                                                                                                                                                                                      	\
+	/* Prefetch a window ahead like rm_##name##_hashmap_update_batch(...), the hashes are known already. */                                                                           	\
+	for (rm_size i = 0; (i < count) && (i < RM_HASHMAP_BATCH_WINDOW); i++)                                                                                                            	\
+	{                                                                                                                                                                                 	\
+		rm_##name##_hashmap_prefetch(&shard->map, pending_updates[i].hash);                                                                                                           	\
+	}                                                                                                                                                                                 	\
+                                                                                                                                                                                      	\
+	for (rm_size i = 0; i < count; i++)                                                                                                                                               	\
+	{                                                                                                                                                                                 	\
+		if ((i + RM_HASHMAP_BATCH_WINDOW) < count)                                                                                                                                    	\
+		{                                                                                                                                                                             	\
+			rm_##name##_hashmap_prefetch(&shard->map, pending_updates[i + RM_HASHMAP_BATCH_WINDOW].hash);                                                                             	\
+		}                                                                                                                                                                             	\
+                                                                                                                                                                                      	\
+		rm_##name##_hashmap_value old_value;                                                                                                                                          	\
+		found_count += rm_##name##_hashmap_update_with_hash(&shard->map, pending_updates[i].key, pending_updates[i].hash, pending_updates[i].value, buffer->mode, &old_value) ? 1 : 0;	\
+	}                                                                                                                                                                                 	\
+                                                                                                                                                                                      	\
+	rm_mutex_unlock(&shard->mutex);                                                                                                                                                   	\
+                                                                                                                                                                                      	\
+	buffer->pending_counts[shard_index] = 0;                                                                                                                                          	\
+	buffer->found_count += found_count;                                                                                                                                               	\
+}
+
+//********************************************************
+//	Generic function definitions (public)
+//********************************************************
+
+#define RM_HASHMAP_SHARDED_DEFINE_INIT(name)                                                                                                          	\
+                                                                                                                                                      	\
+rm_void rm_##name##_sharded_hashmap_init(rm_##name##_sharded_hashmap* map, rm_size shards_count, rm_size initial_buckets_count, rm_double load_factor)	\
+{                                                                                                                                                     	\
+	rm_precond((shards_count > 0) && ((shards_count & (shards_count - 1)) == 0), "Shard count must be a PoT: %zu", shards_count);                     	\
+                                                                                                                                                      	\
+	map->shards = rm_malloc(shards_count * sizeof(rm_##name##_hashmap_shard));                                                                        	\
+	map->shards_count = shards_count;                                                                                                                 	\
+                                                                                                                                                      	\
+	/* Every shard gets its part of the buckets (rounding up keeps a single shard exactly like a plain hashmap). */                                   	\
+	rm_size shard_buckets_count = (initial_buckets_count + shards_count - 1) / shards_count;                                                          	\
+                                                                                                                                                      	\
+	for (rm_size i = 0; i < shards_count; i++)                                                                                                        	\
+	{                                                                                                                                                 	\
+		rm_mutex_init(&map->shards[i].mutex);                                                                                                         	\
+		rm_##name##_hashmap_init_ex(&map->shards[i].map, shard_buckets_count, load_factor);                                                           	\
+	}                                                                                                                                                 	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_DISPOSE(name)                              	\
+                                                                             	\
+rm_void rm_##name##_sharded_hashmap_dispose(rm_##name##_sharded_hashmap* map)	\
+{                                                                            	\
+	for (rm_size i = 0; i < map->shards_count; i++)                          	\
+	{                                                                        	\
+		rm_##name##_hashmap_dispose(&map->shards[i].map);                    	\
+		rm_mutex_dispose(&map->shards[i].mutex);                             	\
+	}                                                                        	\
+                                                                             	\
+	rm_free(map->shards);                                                    	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_GET_COUNT(name)                                    	\
+                                                                                     	\
+rm_size rm_##name##_sharded_hashmap_get_count(const rm_##name##_sharded_hashmap* map)	\
+{                                                                                    	\
+	rm_size count = 0;                                                               	\
+                                                                                     	\
+	for (rm_size i = 0; i < map->shards_count; i++)                                  	\
+	{                                                                                	\
+		count += map->shards[i].map.count;                                           	\
+	}                                                                                	\
+                                                                                     	\
+	return count;                                                                    	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_GET_EX(name)                                                                                                 	\
+                                                                                                                                               	\
+rm_bool rm_##name##_sharded_hashmap_get_ex(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value* value_ptr)	\
+{                                                                                                                                              	\
+	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                                  	\
+	rm_##name##_hashmap_shard* shard = &map->shards[rm_hashmap_sharded_get_shard_index(map, hash)];                                            	\
+                                                                                                                                               	\
+	rm_mutex_lock(&shard->mutex);                                                                                                              	\
+	rm_bool result = rm_##name##_hashmap_get_ex_with_hash(&shard->map, key, hash, value_ptr);                                                  	\
+	rm_mutex_unlock(&shard->mutex);                                                                                                            	\
+                                                                                                                                               	\
+	return result;                                                                                                                             	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_UPDATE(name)                                                                                                                                                                   	\
+                                                                                                                                                                                                                 	\
+rm_bool rm_##name##_sharded_hashmap_update(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value, rm_hashmap_update_mode mode, rm_##name##_hashmap_value* old_value_ptr)	\
+{                                                                                                                                                                                                                	\
+	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                                                                                                    	\
+	rm_##name##_hashmap_shard* shard = &map->shards[rm_hashmap_sharded_get_shard_index(map, hash)];                                                                                                              	\
+                                                                                                                                                                                                                 	\
+	rm_mutex_lock(&shard->mutex);                                                                                                                                                                                	\
+	rm_bool result = rm_##name##_hashmap_update_with_hash(&shard->map, key, hash, value, mode, old_value_ptr);                                                                                                   	\
+	rm_mutex_unlock(&shard->mutex);                                                                                                                                                                              	\
+                                                                                                                                                                                                                 	\
+	return result;                                                                                                                                                                                               	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_REMOVE(name)                                                                                  	\
+                                                                                                                                	\
+rm_bool rm_##name##_sharded_hashmap_remove(rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_key key)                       	\
+{                                                                                                                               	\
+	/* The plain version calculates the hash again, but removing is rare enough. */                                             	\
+	rm_##name##_hashmap_shard* shard = &map->shards[rm_hashmap_sharded_get_shard_index(map, rm_##name##_hashmap_hash_key(key))];	\
+                                                                                                                                	\
+	rm_mutex_lock(&shard->mutex);                                                                                               	\
+	rm_bool result = rm_##name##_hashmap_remove(&shard->map, key);                                                              	\
+	rm_mutex_unlock(&shard->mutex);                                                                                             	\
+                                                                                                                                	\
+	return result;                                                                                                              	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_GET_BATCH(name)                                                                                                                                             	\
+                                                                                                                                                                                              	\
+rm_size rm_##name##_sharded_hashmap_get_batch(const rm_##name##_sharded_hashmap* map, const rm_##name##_hashmap_key* keys, rm_size count, rm_##name##_hashmap_value* values, rm_bool* results)	\
+{                                                                                                                                                                                             	\
+	/* This is rm_##name##_hashmap_get_batch(...), but every key is looked up in its own shard. */                                                                                            	\
+	rm_hashmap_hash hashes[RM_HASHMAP_BATCH_WINDOW];                                                                                                                                          	\
+	rm_size found_count = 0;                                                                                                                                                                  	\
+                                                                                                                                                                                              	\
+	for (rm_size i = 0; (i < count) && (i < RM_HASHMAP_BATCH_WINDOW); i++)                                                                                                                    	\
+	{                                                                                                                                                                                         	\
+		hashes[i] = rm_##name##_hashmap_hash_key(keys[i]);                                                                                                                                    	\
+		rm_##name##_hashmap_prefetch(&map->shards[rm_hashmap_sharded_get_shard_index(map, hashes[i])].map, hashes[i]);                                                                        	\
+	}                                                                                                                                                                                         	\
+                                                                                                                                                                                              	\
+	for (rm_size i = 0; i < count; i++)                                                                                                                                                       	\
+	{                                                                                                                                                                                         	\
+		rm_size slot = i % RM_HASHMAP_BATCH_WINDOW;                                                                                                                                           	\
+		rm_hashmap_hash hash = hashes[slot];                                                                                                                                                  	\
+                                                                                                                                                                                              	\
+		if ((i + RM_HASHMAP_BATCH_WINDOW) < count)                                                                                                                                            	\
+		{                                                                                                                                                                                     	\
+			hashes[slot] = rm_##name##_hashmap_hash_key(keys[i + RM_HASHMAP_BATCH_WINDOW]);                                                                                                   	\
+			rm_##name##_hashmap_prefetch(&map->shards[rm_hashmap_sharded_get_shard_index(map, hashes[slot])].map, hashes[slot]);                                                              	\
+		}                                                                                                                                                                                     	\
+                                                                                                                                                                                              	\
+		rm_bool result = rm_##name##_hashmap_get_ex_with_hash(&map->shards[rm_hashmap_sharded_get_shard_index(map, hash)].map, keys[i], hash, &values[i]);                                    	\
+		found_count += result ? 1 : 0;                                                                                                                                                        	\
+                                                                                                                                                                                              	\
+		if (results)                                                                                                                                                                          	\
+		{                                                                                                                                                                                     	\
+			results[i] = result;                                                                                                                                                              	\
+		}                                                                                                                                                                                     	\
+	}                                                                                                                                                                                         	\
+                                                                                                                                                                                              	\
+	return found_count;                                                                                                                                                                       	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_FOR_EACH(name)                                                                                                         	\
+                                                                                                                                                         	\
+rm_void rm_##name##_sharded_hashmap_for_each(const rm_##name##_sharded_hashmap* map, rm_##name##_hashmap_iteration_func iteration_func, rm_void* context)	\
+{                                                                                                                                                        	\
+	for (rm_size i = 0; i < map->shards_count; i++)                                                                                                      	\
+	{                                                                                                                                                    	\
+		rm_##name##_hashmap_for_each(&map->shards[i].map, iteration_func, context);                                                                      	\
+	}                                                                                                                                                    	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_GET_STATS(name)                                                             	\
+                                                                                                              	\
+rm_void rm_##name##_sharded_hashmap_get_stats(const rm_##name##_sharded_hashmap* map, rm_hashmap_stats* stats)	\
+{                                                                                                             	\
+	rm_assert(stats, "Passed stats must be valid.");                                                          	\
+                                                                                                              	\
+	*stats = (rm_hashmap_stats) { .count = 0 };                                                               	\
+                                                                                                              	\
+	/* Sum up the shards. The means are weighted by the used buckets resp. the entries they are taken over. */	\
+	rm_double chain_lengths_sum = 0;                                                                          	\
+	rm_double lookup_lengths_sum = 0;                                                                         	\
+                                                                                                              	\
+	for (rm_size i = 0; i < map->shards_count; i++)                                                           	\
+	{                                                                                                         	\
+		rm_hashmap_stats shard_stats;                                                                         	\
+		rm_##name##_hashmap_get_stats(&map->shards[i].map, &shard_stats);                                     	\
+                                                                                                              	\
+		stats->count += shard_stats.count;                                                                    	\
+		stats->buckets_count += shard_stats.buckets_count;                                                    	\
+		stats->used_buckets_count += shard_stats.used_buckets_count;                                          	\
+                                                                                                              	\
+		for (rm_size j = 0; j < RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT; j++)                                    	\
+		{                                                                                                     	\
+			stats->buckets_by_chain_length[j] += shard_stats.buckets_by_chain_length[j];                      	\
+		}                                                                                                     	\
+                                                                                                              	\
+		stats->max_chain_length = rm_max(stats->max_chain_length, shard_stats.max_chain_length);              	\
+		stats->collision_entries_count += shard_stats.collision_entries_count;                                	\
+		stats->supply_list_count += shard_stats.supply_list_count;                                            	\
+		stats->resizes_count += shard_stats.resizes_count;                                                    	\
+		stats->allocated_bytes += shard_stats.allocated_bytes;                                                	\
+                                                                                                              	\
+		chain_lengths_sum += shard_stats.mean_chain_length * (rm_double)shard_stats.used_buckets_count;       	\
+		lookup_lengths_sum += shard_stats.mean_lookup_length * (rm_double)shard_stats.count;                  	\
+	}                                                                                                         	\
+                                                                                                              	\
+	if (stats->count > 0)                                                                                     	\
+	{                                                                                                         	\
+		stats->mean_chain_length = chain_lengths_sum / (rm_double)stats->used_buckets_count;                  	\
+		stats->mean_lookup_length = lookup_lengths_sum / (rm_double)stats->count;                             	\
+	}                                                                                                         	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_BUFFER_INIT(name)                                                                                                       	\
+                                                                                                                                                          	\
+rm_void rm_##name##_sharded_hashmap_buffer_init(rm_##name##_sharded_hashmap_buffer* buffer, rm_##name##_sharded_hashmap* map, rm_hashmap_update_mode mode)	\
+{                                                                                                                                                         	\
+	buffer->map = map;                                                                                                                                    	\
+	buffer->mode = mode;                                                                                                                                  	\
+	buffer->pending_updates = rm_malloc(map->shards_count * RM_HASHMAP_SHARDED_BUFFER_COUNT * sizeof(rm_##name##_sharded_hashmap_pending_update));        	\
+	buffer->pending_counts = rm_malloc_zero(map->shards_count * sizeof(rm_size));                                                                         	\
+	buffer->found_count = 0;                                                                                                                              	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_BUFFER_UPDATE(name)                                                                                                              	\
+                                                                                                                                                                   	\
+rm_void rm_##name##_sharded_hashmap_buffer_update(rm_##name##_sharded_hashmap_buffer* buffer, rm_##name##_hashmap_key key, rm_##name##_hashmap_value value)        	\
+{                                                                                                                                                                  	\
+	rm_hashmap_hash hash = rm_##name##_hashmap_hash_key(key);                                                                                                      	\
+	rm_size shard_index = rm_hashmap_sharded_get_shard_index(buffer->map, hash);                                                                                   	\
+                                                                                                                                                                   	\
+	/* Make room first, so the updates of a key stay in order. */                                                                                                  	\
+	if (rm_unlikely(buffer->pending_counts[shard_index] == RM_HASHMAP_SHARDED_BUFFER_COUNT))                                                                       	\
+	{                                                                                                                                                              	\
+		rm_##name##_sharded_hashmap_buffer_flush_shard(buffer, shard_index);                                                                                       	\
+	}                                                                                                                                                              	\
+                                                                                                                                                                   	\
+	buffer->pending_updates[(shard_index * RM_HASHMAP_SHARDED_BUFFER_COUNT) + buffer->pending_counts[shard_index]++] = (rm_##name##_sharded_hashmap_pending_update)	\
+	{                                                                                                                                                              	\
+		.key = key,                                                                                                                                                	\
+		.hash = hash,                                                                                                                                              	\
+		.value = value                                                                                                                                             	\
+	};                                                                                                                                                             	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_BUFFER_FLUSH(name)                                        	\
+                                                                                            	\
+rm_void rm_##name##_sharded_hashmap_buffer_flush(rm_##name##_sharded_hashmap_buffer* buffer)	\
+{                                                                                           	\
+	for (rm_size i = 0; i < buffer->map->shards_count; i++)                                 	\
+	{                                                                                       	\
+		rm_##name##_sharded_hashmap_buffer_flush_shard(buffer, i);                          	\
+	}                                                                                       	\
+}
+
+#define RM_HASHMAP_SHARDED_DEFINE_BUFFER_DISPOSE(name)                                        	\
+                                                                                              	\
+rm_void rm_##name##_sharded_hashmap_buffer_dispose(rm_##name##_sharded_hashmap_buffer* buffer)	\
+{                                                                                             	\
+	rm_##name##_sharded_hashmap_buffer_flush(buffer);                                         	\
+                                                                                              	\
+	rm_free(buffer->pending_updates);                                                         	\
+	rm_free(buffer->pending_counts);                                                          	\
+}
+
+//********************************************************
+//	Collective macros for decl. and def.
+//********************************************************
+
+//Declare the sharded variant after RM_HASHMAP_DECLARE(name, ...) or RM_HASHMAP_OA_DECLARE(name, ...):
+#define RM_HASHMAP_SHARDED_DECLARE(name)  	\
+RM_HASHMAP_SHARDED_DECLARE_TYPES(name)    	\
+RM_HASHMAP_SHARDED_DECLARE_FUNCTIONS(name)
+
+//Define the sharded variant after RM_HASHMAP_DEFINE(name, ...) or RM_HASHMAP_OA_DEFINE(name, ...) in the same translation unit:
+#define RM_HASHMAP_SHARDED_DEFINE(name)       	\
+RM_HASHMAP_SHARDED_DEFINE_FLUSH_SHARD(name)   	\
+RM_HASHMAP_SHARDED_DEFINE_INIT(name)          	\
+RM_HASHMAP_SHARDED_DEFINE_DISPOSE(name)       	\
+RM_HASHMAP_SHARDED_DEFINE_GET_COUNT(name)     	\
+RM_HASHMAP_SHARDED_DEFINE_GET_EX(name)        	\
+RM_HASHMAP_SHARDED_DEFINE_UPDATE(name)        	\
+RM_HASHMAP_SHARDED_DEFINE_REMOVE(name)        	\
+RM_HASHMAP_SHARDED_DEFINE_GET_BATCH(name)     	\
+RM_HASHMAP_SHARDED_DEFINE_FOR_EACH(name)      	\
+RM_HASHMAP_SHARDED_DEFINE_GET_STATS(name)     	\
+RM_HASHMAP_SHARDED_DEFINE_BUFFER_INIT(name)   	\
+RM_HASHMAP_SHARDED_DEFINE_BUFFER_UPDATE(name) 	\
+RM_HASHMAP_SHARDED_DEFINE_BUFFER_FLUSH(name)  	\
+RM_HASHMAP_SHARDED_DEFINE_BUFFER_DISPOSE(name)
+
+#endif
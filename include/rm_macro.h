@@ -189,6 +189,9 @@
 #define rm_likely(x) __builtin_expect((x), true)
 #define rm_unlikely(x) __builtin_expect((x), false)
 
+//Hint that the cache line at the given address will be needed soon (this never faults, even for invalid addresses):
+#define rm_prefetch(ptr) __builtin_prefetch((ptr))
+
 //Mark some parameter as unused:
 #define rm_unused(x) (void)(x)
 
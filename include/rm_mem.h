@@ -13,6 +13,141 @@
 #include "rm_macro.h"
 #include "rm_type.h"
 
+/*
+	Allocations can be tracked (build with -DRM_MEM_TRACKING):
+	Every allocation is then counted for a tag, so you can tell how much memory each phase of the tristripper needs.
+	The tag is the one of the calling thread at the time of the allocation (see rm_mem_push_tag(...)), it sticks to the block through reallocations.
+	A small header in front of each block remembers its size and tag, so tracking costs 16 bytes per allocation and a few atomic operations.
+	Without tracking, the tag functions are empty and the statistics stay zero.
+*/
+
+#ifdef RM_MEM_TRACKING
+#define RM_MEM_TRACKING_ENABLED true
+#else
+#define RM_MEM_TRACKING_ENABLED false
+#endif
+
+//The tags for tracked allocations:
+typedef enum __rm_mem_tag__
+{
+	//Everything that is not attributed to a phase:
+	RM_MEM_TAG_OTHER,
+
+	//The triangles and their adjacency (see "rm_tristripper_tri.h"):
+	RM_MEM_TAG_BUILD_TRIS,
+
+	//The open edge hashmap that is used to build the triangles:
+	RM_MEM_TAG_HASHMAP,
+
+	//The strips and everything that is needed to find them:
+	RM_MEM_TAG_STRIPS,
+
+	//The tunnel stacks of the tunneling algorithm:
+	RM_MEM_TAG_TUNNEL_STACK,
+
+	//The verifier (see "rm_tristripper_verifier.h"):
+	RM_MEM_TAG_VERIFIER,
+
+	RM_MEM_TAGS_COUNT
+} rm_mem_tag;
+
+//The statistics of a tag (or of all of them):
+//
+// - "live_bytes":   The bytes that are allocated right now.
+// - "peak_bytes":   The maximum of "live_bytes" since the start (or the last call to "rm_mem_reset_peaks()").
+// - "allocs_count": The number of allocations (reallocations included).
+typedef struct __rm_mem_stats__
+{
+	rm_size live_bytes;
+	rm_size peak_bytes;
+	rm_size allocs_count;
+} rm_mem_stats;
+
+#ifdef RM_MEM_TRACKING
+//The header in front of every tracked block.
+//"offset" is the distance from the start of the block to the pointer we have handed out.
+typedef struct __rm_mem_header__
+{
+	rm_size size;
+	rm_uint32 tag;
+	rm_uint32 offset;
+} rm_mem_header;
+
+//The current tag of the calling thread:
+extern __thread rm_mem_tag rm_mem_current_tag;
+
+//Write the header into a new block and count it for the tag.
+//Returns the pointer for the caller.
+rm_void* rm_mem_track(rm_void* block, rm_size offset, rm_size size, rm_mem_tag tag);
+
+//Stop counting a block and return its start.
+//The header is copied to "header" before the block is released.
+rm_void* rm_mem_untrack(const rm_void* ptr, rm_mem_header* header);
+#endif
+
+//Set the tag for the following allocations of the calling thread.
+//Returns the previous tag, pass it to "rm_mem_pop_tag(...)" at the end of the phase.
+inline rm_mem_tag rm_mem_push_tag(rm_mem_tag tag) rm_force_inline;
+inline rm_void rm_mem_pop_tag(rm_mem_tag previous_tag) rm_force_inline;
+
+//Query the statistics of a tag (or RM_MEM_TAGS_COUNT for all of them together):
+rm_void rm_mem_get_stats(rm_mem_tag tag, rm_mem_stats* stats);
+
+//Reset the peaks to the bytes that are live right now (e. g. before a phase is measured):
+rm_void rm_mem_reset_peaks(rm_void);
+
+//Get the name of a tag:
+const rm_char* rm_mem_tag_get_name(rm_mem_tag tag);
+
+/*
+	By default, all the allocations below end up in malloc(...) and friends.
+	A thread can install an allocator of its own instead (e. g. an arena per request that is released in one shot):
+
+		const rm_mem_allocator* previous_allocator = rm_mem_push_allocator(&arena_allocator);
+		rm_tristripper_create_strips(...);
+		rm_mem_pop_allocator(previous_allocator);
+
+	Threads that are spawned via rm_thread_create(...) inherit the allocator of their creator.
+	So it must be thread-safe if the call uses multiple threads (see "threads_count" in the tristripper config).
+	Memory must be freed with the allocator it has been allocated with (the strips of the example must be disposed before the pop).
+*/
+
+//The alignment of malloc(...), allocators must provide at least this one:
+#define RM_MEM_MALLOC_ALIGNMENT ((rm_size)16)
+
+//An allocator for rm_mem_push_allocator(...).
+//"context" is passed to all the functions:
+//
+// - "alloc":   Allocate "size" bytes (>= 1) aligned to "alignment" (a PoT >= RM_MEM_MALLOC_ALIGNMENT). Return null on failure.
+// - "realloc": Resize a block to "size" bytes (>= 1) and keep its contents. It is only called for blocks with RM_MEM_MALLOC_ALIGNMENT.
+//              The old size is not passed, an arena has to remember it on its own. Return null on failure.
+// - "free":    Release a block (never null). Arenas might ignore this.
+typedef struct __rm_mem_allocator__
+{
+	rm_void* (*alloc)(rm_void* context, rm_size alignment, rm_size size);
+	rm_void* (*realloc)(rm_void* context, rm_void* ptr, rm_size size);
+	rm_void (*free)(rm_void* context, rm_void* ptr);
+
+	rm_void* context;
+} rm_mem_allocator;
+
+//The allocator of the calling thread (null for malloc(...) and friends):
+extern __thread const rm_mem_allocator* rm_mem_current_allocator;
+
+//Install an allocator for the following allocations of the calling thread (null for malloc(...) and friends).
+//Returns the previous allocator, pass it to "rm_mem_pop_allocator(...)" when you are done.
+inline const rm_mem_allocator* rm_mem_push_allocator(const rm_mem_allocator* allocator) rm_force_inline;
+inline rm_void rm_mem_pop_allocator(const rm_mem_allocator* previous_allocator) rm_force_inline;
+
+//Get the allocator of the calling thread:
+inline const rm_mem_allocator* rm_mem_get_allocator(rm_void) rm_force_inline;
+
+//The primitives of the allocation functions below, they dispatch to the allocator of the calling thread.
+//Use the functions below instead, these know nothing about tracking.
+inline rm_void* rm_must_check rm_mem_alloc_block(rm_size alignment, rm_size size, rm_bool zero) rm_force_inline;
+inline rm_void* rm_must_check rm_mem_realloc_block(rm_void* block, rm_size size) rm_force_inline;
+inline rm_void rm_mem_free_block(rm_void* block) rm_force_inline;
+
 //Memory allocation for structs with flexible array members.
 //See ttps://www.geeksforgeeks.org/flexible-array-members-structure-c/ for details.
 #define rm_malloc_flex_array_struct(struct_type, array_member_name, count)	\
@@ -58,6 +193,45 @@ inline rm_void* rm_must_check rm_realloc_aligned(rm_void* ptr, rm_size alignment
 //Freeing a null pointer is a nop.
 inline rm_void rm_free_aligned(const rm_void* ptr) rm_force_inline;
 
+/*
+	Large working sets (triangles, hashmap buckets, ...) are accessed all over the place, so they suffer from TLB misses with 4 KiB pages.
+	rm_malloc_large*(...) asks the kernel to back them with transparent huge pages (MADV_HUGEPAGE) and can prefault them up front.
+	The blocks are ordinary heap blocks, so they are freed via rm_free(...) and can be passed to code that does not know about them.
+	glibc serves blocks of this size via mmap(...) anyway.
+	If an allocator is installed (see above), it is used as usual and the kernel is not advised.
+*/
+
+//The default size from which on allocations are advised:
+#define RM_MEM_LARGE_DEFAULT_THRESHOLD ((rm_size)4 << 20)
+
+typedef struct __rm_mem_large_config__
+{
+	//Allocations smaller than this are plain rm_malloc*(...) calls:
+	rm_size threshold;
+
+	//Advise the kernel to use transparent huge pages (default: true):
+	rm_bool huge_pages;
+
+	//Fault in all pages right away instead of on first touch (default: false).
+	//This moves the page faults out of the hot loops, but commits the memory even if it is never used.
+	rm_bool prefault;
+} rm_mem_large_config;
+
+//Set resp. query the config for all threads.
+//Set it before any large allocations are done, it is not synchronized.
+rm_void rm_mem_set_large_config(const rm_mem_large_config* config);
+rm_void rm_mem_get_large_config(rm_mem_large_config* config);
+
+//Allocate memory on the heap for a large working set.
+//Size must be >= 1.
+//Guaranteed to return a valid pointer that must be freed via rm_free(...).
+rm_void* rm_must_check rm_malloc_large(rm_size size);
+rm_void* rm_must_check rm_malloc_large_zero(rm_size size);
+
+//Reallocate a large block (or any other block from rm_malloc*(...)).
+//If null is passed, the behavior is identical to rm_malloc_large(size).
+rm_void* rm_must_check rm_realloc_large(rm_void* ptr, rm_size size);
+
 //A memset wrapper.
 //"count" bytes a "ptr" are set to "value".
 inline rm_void rm_mem_set(rm_void* ptr, rm_uint8 value, rm_size count) rm_force_inline;
@@ -92,18 +266,126 @@ inline rm_void rm_mem_lock(const rm_void* ptr, rm_size size) rm_force_inline;
 //Unlock memory that has been locked via rm_mem_lock(...).
 inline rm_void rm_mem_unlock(const rm_void* ptr, rm_size size) rm_force_inline;
 
+inline rm_mem_tag rm_mem_push_tag(rm_mem_tag tag)
+{
+#ifdef RM_MEM_TRACKING
+	rm_mem_tag previous_tag = rm_mem_current_tag;
+	rm_mem_current_tag = tag;
+
+	return previous_tag;
+#else
+	rm_unused(tag);
+	return RM_MEM_TAG_OTHER;
+#endif
+}
+
+inline rm_void rm_mem_pop_tag(rm_mem_tag previous_tag)
+{
+#ifdef RM_MEM_TRACKING
+	rm_mem_current_tag = previous_tag;
+#else
+	rm_unused(previous_tag);
+#endif
+}
+
+inline const rm_mem_allocator* rm_mem_push_allocator(const rm_mem_allocator* allocator)
+{
+	const rm_mem_allocator* previous_allocator = rm_mem_current_allocator;
+	rm_mem_current_allocator = allocator;
+
+	return previous_allocator;
+}
+
+inline rm_void rm_mem_pop_allocator(const rm_mem_allocator* previous_allocator)
+{
+	rm_mem_current_allocator = previous_allocator;
+}
+
+inline const rm_mem_allocator* rm_mem_get_allocator(rm_void)
+{
+	return rm_mem_current_allocator;
+}
+
+inline rm_void* rm_mem_alloc_block(rm_size alignment, rm_size size, rm_bool zero)
+{
+	rm_void* ptr = null;
+
+	//Is there an allocator for this thread?
+	if (rm_unlikely(rm_mem_current_allocator != null))
+	{
+		ptr = rm_mem_current_allocator->alloc(rm_mem_current_allocator->context, rm_max(alignment, RM_MEM_MALLOC_ALIGNMENT), size);
+		rm_precond(ptr, "The allocator of the thread has failed.");
+	}
+	else if (alignment <= RM_MEM_MALLOC_ALIGNMENT)
+	{
+		//calloc(...) zeroes the memory on its own (and might get it from the OS that way):
+		if (zero)
+		{
+			ptr = calloc(size, sizeof(rm_uint8));
+			rm_precond(ptr, "calloc() has failed.");
+
+			return ptr;
+		}
+
+		ptr = malloc(size);
+		rm_precond(ptr, "malloc() has failed.");
+	}
+	else
+	{
+		rm_int result = posix_memalign(&ptr, alignment, size);
+		rm_precond(result == 0, "posix_memalign() has failed: %s", strerror(result));
+	}
+
+	if (zero)
+	{
+		memset(ptr, 0, size);
+	}
+
+	return ptr;
+}
+
+inline rm_void* rm_mem_realloc_block(rm_void* block, rm_size size)
+{
+	if (rm_unlikely(rm_mem_current_allocator != null))
+	{
+		block = rm_mem_current_allocator->realloc(rm_mem_current_allocator->context, block, size);
+		rm_precond(block, "The allocator of the thread has failed.");
+	}
+	else
+	{
+		block = realloc(block, size);
+		rm_precond(block, "realloc() has failed.");
+	}
+
+	return block;
+}
+
+inline rm_void rm_mem_free_block(rm_void* block)
+{
+	if (rm_unlikely(rm_mem_current_allocator != null))
+	{
+		rm_mem_current_allocator->free(rm_mem_current_allocator->context, block);
+	}
+	else
+	{
+		free(block);
+	}
+}
+
 inline rm_void* rm_malloc(rm_size size)
 {
 	//Size check:
 	rm_assert(size >= 1, "Memory size to allocate must be >= 1.");
 
-	//Allocate memory:
-	rm_void* ptr = malloc(size);
-
-	//Always check for errors:
-	rm_precond(ptr, "malloc() has failed.");
+#ifdef RM_MEM_TRACKING
+	//Allocate memory for the header as well:
+	rm_void* block = rm_mem_alloc_block(RM_MEM_MALLOC_ALIGNMENT, sizeof(rm_mem_header) + size, false);
 
-	return ptr;
+	return rm_mem_track(block, sizeof(rm_mem_header), size, rm_mem_current_tag);
+#else
+	//Allocate memory (errors are checked there):
+	return rm_mem_alloc_block(RM_MEM_MALLOC_ALIGNMENT, size, false);
+#endif
 }
 
 inline rm_void* rm_malloc_zero(rm_size size)
@@ -111,13 +393,14 @@ inline rm_void* rm_malloc_zero(rm_size size)
 	//Size check:
 	rm_assert(size >= 1, "Memory size to allocate must be >= 1.");
 
-	//Allocate memory via calloc(...) -> will be zeroed:
-	rm_void* ptr = calloc(size, sizeof(rm_uint8));
-
-	//Always check for errors:
-	rm_precond(ptr, "calloc() has failed.");
+#ifdef RM_MEM_TRACKING
+	rm_void* block = rm_mem_alloc_block(RM_MEM_MALLOC_ALIGNMENT, sizeof(rm_mem_header) + size, true);
 
-	return ptr;
+	return rm_mem_track(block, sizeof(rm_mem_header), size, rm_mem_current_tag);
+#else
+	//Allocate zeroed memory:
+	return rm_mem_alloc_block(RM_MEM_MALLOC_ALIGNMENT, size, true);
+#endif
 }
 
 inline rm_void* rm_realloc(rm_void* ptr, rm_size size)
@@ -125,13 +408,23 @@ inline rm_void* rm_realloc(rm_void* ptr, rm_size size)
 	//Size check:
 	rm_assert(size >= 1, "Memory size to allocate must be >= 1.");
 
-	//Use realloc(...) directly for this:
-	ptr = realloc(ptr, size);
+	//Allocators never see null:
+	if (!ptr)
+	{
+		return rm_malloc(size);
+	}
 
-	//Always check for errors:
-	rm_precond(ptr, "realloc() has failed.");
+#ifdef RM_MEM_TRACKING
+	//The block keeps its tag:
+	rm_mem_header header;
+	rm_void* block = rm_mem_untrack(ptr, &header);
 
-	return ptr;
+	block = rm_mem_realloc_block(block, sizeof(rm_mem_header) + size);
+
+	return rm_mem_track(block, sizeof(rm_mem_header), size, (rm_mem_tag)header.tag);
+#else
+	return rm_mem_realloc_block(ptr, size);
+#endif
 }
 
 inline rm_void rm_free(const rm_void* ptr)
@@ -148,7 +441,17 @@ inline rm_void rm_free(const rm_void* ptr)
 		The downside: We are casting const away. Theoretically, that's a bad idea.
 	*/
 
-	free((rm_void*)ptr);
+	if (!ptr)
+	{
+		return;
+	}
+
+#ifdef RM_MEM_TRACKING
+	rm_mem_header header;
+	rm_mem_free_block(rm_mem_untrack(ptr, &header));
+#else
+	rm_mem_free_block((rm_void*)ptr);
+#endif
 }
 
 inline rm_void* rm_malloc_aligned(rm_size alignment, rm_size size)
@@ -156,12 +459,15 @@ inline rm_void* rm_malloc_aligned(rm_size alignment, rm_size size)
 	//Size check:
 	rm_assert(size >= 1, "Memory size to allocate must be >= 1.");
 
-	//Allocate memory via posix_memalign(...):
-	rm_void* ptr = null;
-	int result = posix_memalign(&ptr, alignment, size);
-
-	//Always check for errors:
-	rm_precond(result == 0, "posix_memalign() has failed: %s", strerror(result));
+#ifdef RM_MEM_TRACKING
+	//The header needs a whole alignment unit in front of the pointer, so the pointer stays aligned:
+	rm_size offset = rm_max(alignment, sizeof(rm_mem_header));
+	rm_void* block = rm_mem_alloc_block(alignment, offset + size, false);
+	rm_void* ptr = rm_mem_track(block, offset, size, rm_mem_current_tag);
+#else
+	//Allocate aligned memory (errors are checked there):
+	rm_void* ptr = rm_mem_alloc_block(alignment, size, false);
+#endif
 
 	//Did the alignment work out?
 	rm_assert((((rm_uword)ptr) % alignment) == 0, "Failed to align allocated memory.");
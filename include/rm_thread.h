@@ -0,0 +1,183 @@
+#ifndef __RM_THREAD_H__
+#define __RM_THREAD_H__
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rm_assert.h"
+#include "rm_macro.h"
+#include "rm_type.h"
+
+//Threads, mutexes and condition variables are thin wrappers around pthreads:
+typedef pthread_t rm_thread;
+typedef pthread_mutex_t rm_mutex;
+typedef pthread_cond_t rm_cond;
+
+//The entry point of a thread.
+//It receives the argument that has been passed to "rm_thread_create(...)".
+typedef rm_void* (*rm_thread_func)(rm_void*);
+
+//Atomic operations on integers (sequentially consistent, we don't want to think too hard about this):
+#define rm_atomic_load(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define rm_atomic_store(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define rm_atomic_fetch_add(ptr, value) __atomic_fetch_add((ptr), (value), __ATOMIC_SEQ_CST)
+#define rm_atomic_fetch_sub(ptr, value) __atomic_fetch_sub((ptr), (value), __ATOMIC_SEQ_CST)
+
+//Replace "*ptr" by "desired" if it is "*expected_ptr". Otherwise, the current value is stored to "*expected_ptr".
+//Returns whether the value has been replaced.
+#define rm_atomic_compare_exchange(ptr, expected_ptr, desired) __atomic_compare_exchange_n((ptr), (expected_ptr), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+
+//Spawn a new thread that executes "func(arg)".
+//It inherits the allocator of the calling thread (see "rm_mem_push_allocator(...)").
+//If the function returns, the thread has been created (errors automatically trigger a precondition).
+rm_void rm_thread_create(rm_thread* thread, rm_thread_func func, rm_void* arg);
+
+//Wait for the given thread to terminate and return the result of its entry point:
+rm_void* rm_thread_join(rm_thread thread);
+
+//Query the number of processors that are currently online (always >= 1):
+rm_size rm_thread_get_processors_count(rm_void);
+
+//Give up the processor to other threads that are ready to run:
+rm_void rm_thread_yield(rm_void);
+
+//Suspend the calling thread for (at least) the given number of nanoseconds:
+rm_void rm_thread_sleep(rm_uint64 nsecs);
+
+//Manage a mutex:
+inline rm_void rm_mutex_init(rm_mutex* mutex) rm_force_inline;
+inline rm_void rm_mutex_dispose(rm_mutex* mutex) rm_force_inline;
+inline rm_void rm_mutex_lock(rm_mutex* mutex) rm_force_inline;
+inline rm_void rm_mutex_unlock(rm_mutex* mutex) rm_force_inline;
+
+//Manage a condition variable.
+//"rm_cond_wait(...)" must be called with the mutex locked, spurious wakeups are possible.
+inline rm_void rm_cond_init(rm_cond* cond) rm_force_inline;
+inline rm_void rm_cond_dispose(rm_cond* cond) rm_force_inline;
+inline rm_void rm_cond_wait(rm_cond* cond, rm_mutex* mutex) rm_force_inline;
+inline rm_void rm_cond_signal(rm_cond* cond) rm_force_inline;
+inline rm_void rm_cond_broadcast(rm_cond* cond) rm_force_inline;
+
+inline rm_void rm_mutex_init(rm_mutex* mutex)
+{
+	//Note: pthreads return their error codes instead of setting errno.
+	rm_int result = pthread_mutex_init(mutex, null);
+	rm_precond(result == 0, "pthread_mutex_init() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_mutex_dispose(rm_mutex* mutex)
+{
+	rm_int result = pthread_mutex_destroy(mutex);
+	rm_precond(result == 0, "pthread_mutex_destroy() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_mutex_lock(rm_mutex* mutex)
+{
+	rm_int result = pthread_mutex_lock(mutex);
+	rm_precond(result == 0, "pthread_mutex_lock() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_mutex_unlock(rm_mutex* mutex)
+{
+	rm_int result = pthread_mutex_unlock(mutex);
+	rm_precond(result == 0, "pthread_mutex_unlock() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_cond_init(rm_cond* cond)
+{
+	rm_int result = pthread_cond_init(cond, null);
+	rm_precond(result == 0, "pthread_cond_init() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_cond_dispose(rm_cond* cond)
+{
+	rm_int result = pthread_cond_destroy(cond);
+	rm_precond(result == 0, "pthread_cond_destroy() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_cond_wait(rm_cond* cond, rm_mutex* mutex)
+{
+	rm_int result = pthread_cond_wait(cond, mutex);
+	rm_precond(result == 0, "pthread_cond_wait() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_cond_signal(rm_cond* cond)
+{
+	rm_int result = pthread_cond_signal(cond);
+	rm_precond(result == 0, "pthread_cond_signal() has failed: %s", strerror(result));
+}
+
+inline rm_void rm_cond_broadcast(rm_cond* cond)
+{
+	rm_int result = pthread_cond_broadcast(cond);
+	rm_precond(result == 0, "pthread_cond_broadcast() has failed: %s", strerror(result));
+}
+
+//We assume this size of a cache line to keep data that is written by different threads apart:
+#define RM_THREAD_CACHE_LINE_SIZE ((rm_size)64)
+
+//A bounded queue of pointers between exactly one producer thread and exactly one consumer thread.
+//It is lock-free: The producer only writes "tail", the consumer only writes "head".
+//Both counters grow monotonically, "tail - head" is the number of contained pointers.
+typedef struct __rm_spsc_queue__
+{
+	rm_void** slots;
+	rm_size capacity;
+
+	rm_uint8 head_padding[RM_THREAD_CACHE_LINE_SIZE];
+	rm_size head;
+	rm_uint8 tail_padding[RM_THREAD_CACHE_LINE_SIZE - sizeof(rm_size)];
+	rm_size tail;
+	rm_uint8 end_padding[RM_THREAD_CACHE_LINE_SIZE - sizeof(rm_size)];
+} rm_spsc_queue;
+
+//Create an empty queue with room for "capacity" (>= 1) pointers:
+rm_void rm_spsc_queue_init(rm_spsc_queue* queue, rm_size capacity);
+
+//Dispose a queue. Pointers that are still contained are not touched.
+rm_void rm_spsc_queue_dispose(rm_spsc_queue* queue);
+
+//Append a pointer (producer only).
+//Return false if the queue is full.
+inline rm_bool rm_spsc_queue_try_push(rm_spsc_queue* queue, rm_void* item) rm_force_inline;
+
+//Remove the oldest pointer (consumer only).
+//Return false if the queue is empty.
+inline rm_bool rm_spsc_queue_try_pop(rm_spsc_queue* queue, rm_void** item) rm_force_inline;
+
+inline rm_bool rm_spsc_queue_try_push(rm_spsc_queue* queue, rm_void* item)
+{
+	//Only we write "tail", so we can read it without an atomic:
+	rm_size tail = queue->tail;
+
+	if ((tail - rm_atomic_load(&queue->head)) == queue->capacity)
+	{
+		return false;
+	}
+
+	//Publish the slot before the new tail:
+	queue->slots[tail % queue->capacity] = item;
+	rm_atomic_store(&queue->tail, tail + 1);
+
+	return true;
+}
+
+inline rm_bool rm_spsc_queue_try_pop(rm_spsc_queue* queue, rm_void** item)
+{
+	//Only we write "head", so we can read it without an atomic:
+	rm_size head = queue->head;
+
+	if (head == rm_atomic_load(&queue->tail))
+	{
+		return false;
+	}
+
+	//Read the slot before the producer may reuse it:
+	*item = queue->slots[head % queue->capacity];
+	rm_atomic_store(&queue->head, head + 1);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef __RM_TIME_H__
+#define __RM_TIME_H__
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "rm_assert.h"
+#include "rm_macro.h"
+#include "rm_type.h"
+
+//The number of nanoseconds per second:
+#define RM_TIME_NSECS_PER_SEC ((rm_uint64)1000000000)
+
+//Get a timestamp (in nanoseconds) from a monotonic clock.
+//Only the difference between two timestamps is meaningful.
+inline rm_uint64 rm_time_now(rm_void) rm_force_inline;
+
+//Convert a duration in nanoseconds to seconds:
+inline rm_double rm_time_to_secs(rm_uint64 nsecs) rm_force_inline;
+
+inline rm_uint64 rm_time_now(rm_void)
+{
+	struct timespec ts;
+	rm_precond(clock_gettime(CLOCK_MONOTONIC, &ts) == 0, "clock_gettime() has failed: %s", strerror(errno));
+
+	return ((rm_uint64)ts.tv_sec * RM_TIME_NSECS_PER_SEC) + (rm_uint64)ts.tv_nsec;
+}
+
+inline rm_double rm_time_to_secs(rm_uint64 nsecs)
+{
+	return (rm_double)nsecs / (rm_double)RM_TIME_NSECS_PER_SEC;
+}
+
+#endif
@@ -2,14 +2,26 @@
 #define __RM_TRISTRIPPER_H__
 
 #include "rm_tristripper_common.h"
+#include "rm_tristripper_context.h"
 #include "rm_tristripper_stats.h"
+#include "rm_tristripper_tri.h"
 #include "rm_tristripper_verifier.h"
 
 //Execute the stripification operation.
 //The resulting tristrips must be freed using "rm_tristripper_dispose_strips(...)".
 //Note: The config is passed non-const because we might rectify / optimize some parts of it.
+//The IDs are only read, so they can come straight from a file mapping (see "rm_file_map(...)").
 rm_void rm_tristripper_create_strips(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count);
 
+//Like "rm_tristripper_create_strips(...)", but all the memory that is only needed while the call runs is kept in "context".
+//Use this to strip many meshes in a row (see "rm_tristripper_context.h").
+rm_void rm_tristripper_create_strips_with_context(rm_tristripper_context* context, const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count);
+
+//Execute the stripification operation on triangles that have already been built by "rm_tristripper_build_tris(...)".
+//This is the second half of "rm_tristripper_create_strips(...)", so building and stripping can run as different steps.
+//The triangles might be reordered, so "*tris" can be replaced. The caller frees "*tris" afterwards.
+rm_void rm_tristripper_create_strips_from_tris(rm_tristripper_tri** tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count);
+
 //Dispose a given array of tristrip pointers that has been created by "rm_tristripper_create_strips(...)".
 //"rm_tristripper_dispose_strips(null, 0)" is a no-op.
 rm_void rm_tristripper_dispose_strips(const rm_tristripper_strip* strips, rm_size strips_count);
@@ -0,0 +1,148 @@
+#ifndef __RM_TRISTRIPPER_BATCH_H__
+#define __RM_TRISTRIPPER_BATCH_H__
+
+#include "rm_tristripper_common.h"
+#include "rm_tristripper_stats.h"
+
+//We reserve this number of bytes per triangle of a tile while it is in flight.
+//This covers the IDs, the triangles, BFS reordering and the resulting strips (measured on large meshes).
+#define RM_TRISTRIPPER_BATCH_BYTES_PER_TRI ((rm_size)144)
+
+//Before a mesh file has been read, we assume that every triangle takes at least this number of bytes in the file.
+//That overestimates all supported formats, the reservation is corrected after reading.
+#define RM_TRISTRIPPER_BATCH_MIN_FILE_BYTES_PER_TRI ((rm_size)12)
+
+#define RM_TRISTRIPPER_BATCH_NO_MEMORY_LIMIT ((rm_size)0)
+
+//The input of a single tile.
+//If "path" is not null, the tile is read from that file: Meshes are recognized by their extension (see "rm_tristripper_mesh.h"),
+// everything else is mapped as a raw array of IDs in host byte order.
+//Otherwise, "ids" and "ids_count" describe the tile in memory (it must stay valid until the batch is done).
+typedef struct __rm_tristripper_batch_input__
+{
+	const rm_char* path;
+	const rm_tristripper_id* ids;
+	rm_size ids_count;
+} rm_tristripper_batch_input;
+
+//Receive the strips of a tile.
+//This is called in tile order and never concurrently. The strips are disposed afterwards.
+typedef rm_void (*rm_tristripper_batch_output_func)(rm_size tile_index, const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_stats* stats, rm_void* user_data);
+
+//How is the batch processed?
+//
+// - "config":         The config for every tile. Every tile gets its own copy, "stats" is ignored.
+//                     Note that "threads_count" still applies within a tile if "split_components" is set.
+// - "threads_count":  How many tiles shall be stripped in parallel (including the calling thread)?
+//                     Use RM_TRISTRIPPER_THREADS_COUNT_AUTO to use one thread per online processor.
+// - "memory_limit":   The number of bytes that all tiles in flight may reserve together (see "RM_TRISTRIPPER_BATCH_BYTES_PER_TRI").
+//                     A tile stays in flight until its output has been written.
+//                     The next tile in output order is always admitted, so a single tile above the limit does not stall the batch.
+//                     Use RM_TRISTRIPPER_BATCH_NO_MEMORY_LIMIT to admit tiles as soon as a thread is free.
+// - "verify":         Shall the strips of every tile be verified against its input?
+// - "output_path":    If this is not null, the strips are written to a strip file (see "rm_tristripper_strip_file.h"), one tile per input.
+// - "output_func":    If this is not null, it is called with the strips of every tile (after they have been written to the file).
+typedef struct __rm_tristripper_batch_config__
+{
+	const rm_tristripper_config* config;
+	rm_size threads_count;
+	rm_size memory_limit;
+	rm_bool verify;
+	const rm_char* output_path;
+	rm_tristripper_batch_output_func output_func;
+	rm_void* output_user_data;
+} rm_tristripper_batch_config;
+
+//Statistics about a batch:
+typedef struct __rm_tristripper_batch_stats__
+{
+	rm_size tiles_count;
+	rm_size tris_count;
+
+	//The number of tiles that have failed verification (only if "verify" is set):
+	rm_size invalid_tiles_count;
+
+	//The sum of the statistics of all tiles (including the process):
+	rm_tristripper_stats stats;
+
+	//The wall time of the whole batch and the resulting throughput:
+	rm_uint64 nsecs;
+	rm_double tiles_per_sec;
+	rm_double tris_per_sec;
+
+	//Percentiles of the time from reading a tile until its strips (and optionally the verification) are done (in nanoseconds):
+	rm_uint64 latency_p50_nsecs;
+	rm_uint64 latency_p90_nsecs;
+	rm_uint64 latency_p99_nsecs;
+	rm_uint64 latency_max_nsecs;
+
+	//The maximum number of bytes that have been reserved at the same time:
+	rm_size peak_memory_bytes;
+} rm_tristripper_batch_stats;
+
+//Strip all tiles of a batch on a pool of worker threads.
+//Tiles are started in input order, outputs are delivered in input order, so the result does not depend on the number of threads.
+//Malformed inputs trigger a precondition.
+rm_void rm_tristripper_run_batch(const rm_tristripper_batch_input* inputs, rm_size inputs_count, const rm_tristripper_batch_config* batch_config, rm_tristripper_batch_stats* batch_stats);
+
+//The pipeline keeps this number of tiles between two stages by default:
+#define RM_TRISTRIPPER_PIPELINE_DEFAULT_QUEUE_CAPACITY ((rm_size)4)
+
+//The stages of a pipeline in the order a tile passes them.
+//Every stage runs on its own thread and works on a different tile than the others.
+typedef enum __rm_tristripper_pipeline_stage__
+{
+	RM_TRISTRIPPER_PIPELINE_STAGE_READ,
+	RM_TRISTRIPPER_PIPELINE_STAGE_BUILD,
+	RM_TRISTRIPPER_PIPELINE_STAGE_STRIP,
+	RM_TRISTRIPPER_PIPELINE_STAGE_VERIFY,
+	RM_TRISTRIPPER_PIPELINE_STAGE_WRITE,
+
+	RM_TRISTRIPPER_PIPELINE_STAGES_COUNT
+} rm_tristripper_pipeline_stage;
+
+//How is the pipeline processed?
+//
+// - "config":         The config for every tile (see "rm_tristripper_batch_config").
+// - "queue_capacity": The number of tiles that may wait between two stages (>= 1).
+//                     This bounds the tiles in flight to "(RM_TRISTRIPPER_PIPELINE_STAGES_COUNT - 1) * queue_capacity + RM_TRISTRIPPER_PIPELINE_STAGES_COUNT".
+// - "verify", "output_path", "output_func": See "rm_tristripper_batch_config".
+typedef struct __rm_tristripper_pipeline_config__
+{
+	const rm_tristripper_config* config;
+	rm_size queue_capacity;
+	rm_bool verify;
+	const rm_char* output_path;
+	rm_tristripper_batch_output_func output_func;
+	rm_void* output_user_data;
+} rm_tristripper_pipeline_config;
+
+//Where has a stage spent its time (in nanoseconds)?
+//"busy" is the work on tiles, "starved" is waiting for the previous stage, "blocked" is waiting for the next one.
+//The stage with the least waiting is the bottleneck.
+typedef struct __rm_tristripper_pipeline_stage_stats__
+{
+	rm_size tiles_count;
+	rm_uint64 busy_nsecs;
+	rm_uint64 starved_nsecs;
+	rm_uint64 blocked_nsecs;
+} rm_tristripper_pipeline_stage_stats;
+
+//Statistics about a pipeline.
+//"batch" is filled exactly like for "rm_tristripper_run_batch(...)", a tile is reserved from reading until its output has been written.
+typedef struct __rm_tristripper_pipeline_stats__
+{
+	rm_tristripper_batch_stats batch;
+	rm_tristripper_pipeline_stage_stats stages[RM_TRISTRIPPER_PIPELINE_STAGES_COUNT];
+} rm_tristripper_pipeline_stats;
+
+//Get the name of a stage (e.g. "strip"):
+const rm_char* rm_tristripper_pipeline_stage_name(rm_tristripper_pipeline_stage stage);
+
+//Strip all tiles of a batch in a pipeline: Reading, building the triangles, stripping, verifying and writing run concurrently on different tiles.
+//The stages are connected by bounded lock-free queues, so disk reads and writes overlap with stripping.
+//Outputs are delivered in input order, the results are identical to "rm_tristripper_run_batch(...)".
+//Malformed inputs trigger a precondition.
+rm_void rm_tristripper_run_pipeline(const rm_tristripper_batch_input* inputs, rm_size inputs_count, const rm_tristripper_pipeline_config* pipeline_config, rm_tristripper_pipeline_stats* pipeline_stats);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef __RM_TRISTRIPPER_CODEC_H__
+#define __RM_TRISTRIPPER_CODEC_H__
+
+#include "rm_type.h"
+
+#include "rm_tristripper_common.h"
+
+/*
+	A compact encoding for strips, meant for shipping them (as opposed to the strip file, which is meant for random access).
+	All strips of a stream share one decoder state, so vertices that are shared between strips stay cheap.
+	All integers are little endian, varints carry seven bits per byte (the high bit marks that there are more):
+
+	+--------------------------------------------------------------------------------------------------+
+	| Header                                                                                           |
+	|   uint32 magic ("RMTC"), varint strips_count, varint ids_count (of all strips together)          |
+	|   Per strip: varint ids_count (>= 1)                                                             |
+	+--------------------------------------------------------------------------------------------------+
+	| Codes                                                                                            |
+	|   One code per ID: A tag byte (S TT PPPPP), sometimes followed by a varint.                      |
+	+--------------------------------------------------------------------------------------------------+
+
+	The decoder keeps the highest ID so far ("high water mark"), the ID of the previous LITERAL code and a ring of the last 32 IDs
+	 that have been coded as NEW or LITERAL. The type "TT" of a tag decides where the ID comes from:
+
+	 - 0 (NEW):     ID = high water mark + 1 + P. This is the common case for meshes that have been renumbered in strip order
+	                (see "rm_tristripper_codec_renumber(...)").
+	 - 1 (CACHE):   ID = ring[P], counted backwards from the most recent entry. Hits don't touch the ring.
+	 - 2 (LITERAL): ID = ID of the previous LITERAL code + delta, where P is the zigzag-coded delta.
+	                The vertices a strip shares with its neighbour are usually visited in order, so the deltas are small.
+	 - 3 (SWAP):    ID = the ID two positions before (P must be 0).
+
+	For NEW and LITERAL, the low four bits of P are the low bits of the value. If the fifth bit is set, the rest follows as varint.
+	A set flag "S" inserts a swap before the ID of the code, so most swaps don't cost a byte at all.
+	The common codes are one byte per ID, which makes decoding a single, mostly predictable branch per ID.
+*/
+
+#define RM_TRISTRIPPER_CODEC_MAGIC ((rm_uint32)0x43544d52)
+
+//The number of recent IDs a CACHE code can refer to:
+#define RM_TRISTRIPPER_CODEC_RING_SIZE ((rm_size)32)
+
+//Vertices that are not used by any strip are renumbered to this ID:
+#define RM_TRISTRIPPER_CODEC_UNUSED_ID ((rm_tristripper_id)UINT32_MAX)
+
+//The counts in the header of an encoded stream:
+typedef struct __rm_tristripper_codec_header__
+{
+	rm_size strips_count;
+	rm_size ids_count;
+} rm_tristripper_codec_header;
+
+//Renumber the vertices in the order the strips use them first, so most of them can be coded as NEW.
+//The vertex buffer must be permuted the same way: "remap" (with room for "remap_count" entries, which must be greater than every ID)
+// receives the new ID of every old one or RM_TRISTRIPPER_CODEC_UNUSED_ID for vertices that are not used at all.
+//Return the number of used vertices.
+rm_size rm_tristripper_codec_renumber(rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_id* remap, rm_size remap_count);
+
+//Get the maximum number of bytes "rm_tristripper_codec_encode(...)" can produce for the given strips:
+rm_size rm_tristripper_codec_max_size(const rm_tristripper_strip* strips, rm_size strips_count);
+
+//Encode strips into "data" (which must have room for "rm_tristripper_codec_max_size(...)" bytes) and return the size of the stream.
+//Strips must not be empty.
+rm_size rm_tristripper_codec_encode(const rm_tristripper_strip* strips, rm_size strips_count, rm_uint8* data);
+
+//Read the header of an encoded stream (e.g. to allocate the buffers for "rm_tristripper_codec_decode_ids(...)").
+//Malformed streams trigger a precondition.
+rm_void rm_tristripper_codec_read_header(const rm_uint8* data, rm_size size, rm_tristripper_codec_header* header);
+
+//Decode all strips of a stream into a single buffer of "header.ids_count" IDs (e.g. an index buffer), strip after strip.
+//If "strip_ids_counts" is not null, it receives the number of IDs of every strip ("header.strips_count" entries).
+//Malformed streams trigger a precondition.
+rm_void rm_tristripper_codec_decode_ids(const rm_uint8* data, rm_size size, rm_tristripper_id* ids, rm_size* strip_ids_counts);
+
+//Decode a stream into separate strips.
+//The strips must be freed using "rm_tristripper_dispose_strips(...)".
+rm_void rm_tristripper_codec_decode(const rm_uint8* data, rm_size size, rm_tristripper_strip** strips, rm_size* strips_count);
+
+#endif
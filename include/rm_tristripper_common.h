@@ -28,6 +28,23 @@ typedef struct __rm_tristripper_strip__
 // - "use_tunneling":              Shall we use tunneling or fall back to stripify-only?
 // - "preserve_orientation":       Shall the orientation of strips be preserved? Might introduce some more degenerated triangles ...
 //                                 This parameter is available for stripify and for tunneling.
+// - "reorder_algorithm":          Shall the triangles be renumbered before stripping to improve cache locality?
+//                                 This parameter is available for stripify and for tunneling.
+// - "split_components":           Shall every connected component of the mesh be stripped on its own?
+//                                 Implies BFS reordering. Components with up to three triangles take a fast path.
+//                                 The strips are emitted component by component in a deterministic order.
+// - "threads_count":              Only valid if "split_components" is "true".
+//                                 How many threads shall strip components in parallel (including the calling one)?
+//                                 Use RM_TRISTRIPPER_THREADS_COUNT_AUTO to use one thread per online processor.
+// - "cost_per_swap":              How many vertices does a swap cost? This is part of the cost model for optimization passes.
+// - "cost_per_primitive_restart": How many vertices does a primitive restart cost? Also part of the cost model.
+//                                 Every strip costs two vertices plus one per triangle on top (see "rm_tristripper_stats.h").
+//                                 Zero for both means that only the number of strips is minimized.
+// - "exact_max_count":            Components (or whole meshes if "split_components" is "false") with up to this number of triangles
+//                                 are passed to an exact branch-and-bound solver after the heuristics have run.
+//                                 Its result is used if it is cheaper. Must be <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT.
+//                                 Use RM_TRISTRIPPER_NO_EXACT to disable the solver.
+// - "stats":                      If this is not null, the statistics of the result (including the process) are written to it.
 //
 // Everything below here is only relevant for tunneling!
 //
@@ -46,6 +63,14 @@ typedef struct __rm_tristripper_strip__
 //                                 On success, the loop count is reset and we search again.
 // - "dest_count":                 Stop tunneling as soon as the specified number of strips has been reached.
 //                                 Use RM_TRISTRIPPER_NO_DEST_COUNT to keep tunneling until all paths have been discovered.
+//                                 If "split_components" is "true", this is applied to each component separately.
+// - "optimize_usecs":             After tunneling, improve the links by local search for this number of microseconds.
+//                                 The search minimizes the cost model (see above) and returns the best state it has found.
+//                                 If "split_components" is "true", the budget is divided among the components by size.
+//                                 Since the search is limited by time, the result might differ between runs.
+//                                 Use RM_TRISTRIPPER_NO_OPTIMIZE to skip the search.
+// - "reduce_swaps":               After tunneling (and the local search), re-link the strips to get rid of swaps.
+//                                 The number of strips does not change, so this never increases the cost.
 
 typedef enum __rm_tristripper_preproc_algorithm__
 {
@@ -60,19 +85,42 @@ typedef enum __rm_tristripper_preproc_algorithm__
 	RM_TRISTRIPPER_PREPROC_ALGORITHM_STRIPIFY
 } rm_tristripper_preproc_algorithm;
 
+typedef enum __rm_tristripper_reorder_algorithm__
+{
+	//Keep the triangles in input order:
+	RM_TRISTRIPPER_REORDER_ALGORITHM_NONE,
+
+	//Renumber the triangles in BFS order over the dual graph.
+	//Neighbours end up close to each other in memory, which pays off for spatially random inputs.
+	RM_TRISTRIPPER_REORDER_ALGORITHM_BFS
+} rm_tristripper_reorder_algorithm;
+
 #define RM_TRISTRIPPER_NO_LOOP_LIMIT ((rm_size)0)
 #define RM_TRISTRIPPER_NO_DEST_COUNT ((rm_size)0)
+#define RM_TRISTRIPPER_THREADS_COUNT_AUTO ((rm_size)0)
+#define RM_TRISTRIPPER_NO_EXACT ((rm_size)0)
+#define RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT ((rm_size)64)
+#define RM_TRISTRIPPER_NO_OPTIMIZE ((rm_size)0)
 
 typedef struct __rm_tristripper_config__
 {
 	rm_bool use_tunneling;
 	rm_bool preserve_orientation;
+	rm_tristripper_reorder_algorithm reorder_algorithm;
+	rm_bool split_components;
+	rm_size threads_count;
+	rm_size cost_per_swap;
+	rm_size cost_per_primitive_restart;
+	rm_size exact_max_count;
+	struct __rm_tristripper_stats__* stats;
 	rm_tristripper_preproc_algorithm preproc_algorithm;
 	rm_size max_count;
 	rm_bool incremental;
 	rm_size loop_limit;
 	rm_bool backtrack_after_loop_limit;
 	rm_size dest_count;
+	rm_size optimize_usecs;
+	rm_bool reduce_swaps;
 } rm_tristripper_config;
 
 //Vectors for indices and strips:
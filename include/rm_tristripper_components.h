@@ -0,0 +1,22 @@
+#ifndef __RM_TRISTRIPPER_COMPONENTS_H__
+#define __RM_TRISTRIPPER_COMPONENTS_H__
+
+#include "rm_tristripper_context.h"
+#include "rm_tristripper_tri.h"
+#include "rm_tristripper_stats.h"
+
+//Strip the given triangles with stripify or tunneling, depending on the config.
+//The triangles must not reference any neighbours outside of the passed range.
+//Small sets of triangles are passed to the exact solver afterwards (see "exact_max_count"), its effort is added to "process_stats".
+//Note: "max_count" is truncated to something meaningful for the given number of triangles, so the config is modified!
+//The scratch memory comes from "scratch" (see "rm_tristripper_context.h").
+rm_void rm_tristripper_create_strips_component(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count);
+
+//Strip each connected component of the given triangles on its own, using up to "config->threads_count" threads.
+//"component_offsets" contains the start index of each component (as created by "rm_tristripper_reorder_tris(...)").
+//The strips of all components are concatenated in component order, so the result does not depend on the number of threads.
+//"process_stats" is updated atomically by all threads.
+//The calling thread works with "scratch", every additional thread gets a scratch of its own.
+rm_void rm_tristripper_create_strips_components(rm_tristripper_tri* tris, rm_size tris_count, const rm_size* component_offsets, rm_size components_count, const rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __RM_TRISTRIPPER_CONTEXT_H__
+#define __RM_TRISTRIPPER_CONTEXT_H__
+
+#include "rm_type.h"
+#include "rm_vec.h"
+
+#include "rm_tristripper_common.h"
+#include "rm_tristripper_tri.h"
+
+/*
+	Every stripping call needs memory that is only used while it runs: the triangles, the hashmap that stitches them, the tunnel stack, ...
+	A context keeps all of it alive between calls, so a loop over many tiles does not allocate the same buffers over and over again:
+
+		rm_tristripper_context context;
+		rm_tristripper_init_context(&context);
+
+		for (...)
+		{
+			rm_tristripper_create_strips_with_context(&context, ids, ids_count, &config, &strips, &strips_count);
+			...
+		}
+
+		rm_tristripper_dispose_context(&context);
+
+	The buffers grow with the largest tile and are kept until the context is trimmed or disposed.
+	A context serves one call at a time. Only the calling thread uses it, additional threads (see "threads_count" in the config) still have their own scratch.
+	All the fields are internal.
+*/
+
+//The scratch memory of a thread that strips a set of triangles:
+typedef struct __rm_tristripper_scratch__
+{
+	//The stack for the tunnel DFS:
+	rm_tristripper_tri** tunnel;
+	rm_size tunnel_capacity;
+
+	//The IDs of the strip that is being built, they are copied to the strip once it is complete:
+	rm_tristripper_id_vec strip_ids;
+} rm_tristripper_scratch;
+
+typedef struct __rm_tristripper_context__
+{
+	//The triangles and a spare array with the same capacity (null until the triangles are reordered into it, then the two are swapped):
+	rm_tristripper_tri* tris;
+	rm_tristripper_tri* spare_tris;
+	rm_size tris_capacity;
+
+	//The hashmap that stitches the triangles, it is cleared after every call:
+	rm_tristripper_open_edge_hashmap open_edges;
+
+	//The start index of each connected component:
+	rm_size_vec component_offsets;
+
+	//The scratch of the calling thread:
+	rm_tristripper_scratch scratch;
+} rm_tristripper_context;
+
+//Initialize an empty context, nothing is allocated before the first call:
+rm_void rm_tristripper_init_context(rm_tristripper_context* context);
+
+//Release all the memory of a context (e. g. after a huge tile), it stays ready for the next call:
+rm_void rm_tristripper_trim_context(rm_tristripper_context* context);
+
+//Dispose a context:
+rm_void rm_tristripper_dispose_context(rm_tristripper_context* context);
+
+//Initialize resp. dispose the scratch of a thread:
+rm_void rm_tristripper_init_scratch(rm_tristripper_scratch* scratch);
+rm_void rm_tristripper_dispose_scratch(rm_tristripper_scratch* scratch);
+
+//Get the tunnel stack of a scratch with room for at least "count" triangles:
+rm_tristripper_tri** rm_tristripper_reserve_tunnel(rm_tristripper_scratch* scratch, rm_size count);
+
+#endif
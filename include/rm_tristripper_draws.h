@@ -0,0 +1,80 @@
+#ifndef __RM_TRISTRIPPER_DRAWS_H__
+#define __RM_TRISTRIPPER_DRAWS_H__
+
+#include "rm_type.h"
+
+#include "rm_tristripper_common.h"
+
+/*
+	Strips packed for multi-draw: A single index buffer and one indirect draw command per strip.
+	Short strips can be merged into a trailing triangle list, so they don't cost a draw each:
+
+	+--------------------------------------------------------------------------------------------------+
+	| Index buffer                                                                                     |
+	|   The IDs of all strips, one strip after another, followed by the triangles of the list.         |
+	+--------------------------------------------------------------------------------------------------+
+	| Commands                                                                                         |
+	|   One command per strip (draw with a triangle strip topology),                                   |
+	|   followed by at most one command for the list (draw with a triangle list topology).             |
+	+--------------------------------------------------------------------------------------------------+
+
+	The triangles of the list keep the orientation they have in their strip (odd triangles are flipped like the GPU does it).
+	Swaps are dropped from the list, they would be degenerated triangles anyway.
+*/
+
+//Use this constant to keep every strip as a draw of its own:
+#define RM_TRISTRIPPER_NO_LIST ((rm_size)0)
+
+//An indexed indirect draw.
+//The layout matches "DrawElementsIndirectCommand" (OpenGL) and "VkDrawIndexedIndirectCommand" (Vulkan),
+// so the commands can be uploaded as they are.
+typedef struct __rm_tristripper_draw_command__
+{
+	rm_uint32 count;
+	rm_uint32 instance_count;
+	rm_uint32 first_index;
+	rm_int32 base_vertex;
+	rm_uint32 base_instance;
+} rm_tristripper_draw_command;
+
+//How are the strips packed?
+//
+// - "list_max_tris_count": Strips with up to this number of triangles (swaps included) are merged into the list.
+//                          Use RM_TRISTRIPPER_NO_LIST to disable the list.
+typedef struct __rm_tristripper_draws_config__
+{
+	rm_size list_max_tris_count;
+} rm_tristripper_draws_config;
+
+//The packed draws of a mesh.
+//Index buffer and commands share a single allocation.
+//
+// - "ids":                  The index buffer ("ids_count" IDs).
+// - "commands":             The commands ("commands_count" of them), the strips come first.
+// - "strip_commands_count": The number of strip commands. If it is less than "commands_count", the last command draws the list.
+// - "list_tris_count":      The number of triangles in the list.
+typedef struct __rm_tristripper_draws__
+{
+	rm_tristripper_id* ids;
+	rm_size ids_count;
+
+	rm_tristripper_draw_command* commands;
+	rm_size commands_count;
+	rm_size strip_commands_count;
+
+	rm_size list_tris_count;
+} rm_tristripper_draws;
+
+//Pack strips into draws in a single pass over their IDs.
+//The draws must be freed using "rm_tristripper_dispose_draws(...)".
+rm_void rm_tristripper_pack_draws(const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_draws_config* draws_config, rm_tristripper_draws* draws);
+
+//Strip a mesh (see "rm_tristripper_create_strips(...)") and pack the strips into draws.
+//This is a shorthand for both calls: All the strips are built first and freed once they are packed.
+//The draws must be freed using "rm_tristripper_dispose_draws(...)".
+rm_void rm_tristripper_create_draws(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, const rm_tristripper_draws_config* draws_config, rm_tristripper_draws* draws);
+
+//Free the draws:
+rm_void rm_tristripper_dispose_draws(rm_tristripper_draws* draws);
+
+#endif
@@ -1,10 +1,20 @@
 #ifndef __RM_TRISTRIPPER_EX_H__
 #define __RM_TRISTRIPPER_EX_H__
 
+#include "rm_tristripper_context.h"
 #include "rm_tristripper_tri.h"
+#include "rm_tristripper_stats.h"
 
 //Create tristrips with a preprocessing algorithm and reduce their number with tunneling.
 //Details about the configuration can be found in "rm_tristripper_common.h".
-rm_void rm_tristripper_create_strips_ex(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count);
+//The effort of the optional local search is added to "process_stats".
+//The tunnel stack and the strip IDs are taken from "scratch" (see "rm_tristripper_context.h").
+rm_void rm_tristripper_create_strips_ex(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count);
+
+//Follow the link state of the triangles and create one strip per path.
+//"tris_endpoint_list" must contain both endpoints of every path (isolated triangles once) and all of them must be flagged as endpoints.
+//Each strip starts at the endpoint that comes first in the list, the other endpoint is removed from it.
+//The IDs of each strip are gathered in the scratch before they are copied out.
+rm_void rm_tristripper_collect_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, rm_bool preserve_orientation, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips);
 
 #endif
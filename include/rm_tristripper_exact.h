@@ -0,0 +1,34 @@
+#ifndef __RM_TRISTRIPPER_EXACT_H__
+#define __RM_TRISTRIPPER_EXACT_H__
+
+#include "rm_tristripper_context.h"
+#include "rm_tristripper_tri.h"
+
+//The exact solver gives up after visiting this number of search nodes (and keeps the best solution found until then):
+#define RM_TRISTRIPPER_EXACT_MAX_NODES_COUNT ((rm_size)1 << 20)
+
+//The result of the exact solver:
+typedef enum __rm_tristripper_exact_result__
+{
+	//The search space has been exhausted without finding something cheaper than the incumbent:
+	RM_TRISTRIPPER_EXACT_RESULT_NO_IMPROVEMENT,
+
+	//We have found a cheaper solution and it is optimal:
+	RM_TRISTRIPPER_EXACT_RESULT_OPTIMAL,
+
+	//The node limit has been hit, but we have found a cheaper solution anyway:
+	RM_TRISTRIPPER_EXACT_RESULT_IMPROVED_ABORTED,
+
+	//The node limit has been hit and we have found nothing better:
+	RM_TRISTRIPPER_EXACT_RESULT_NO_IMPROVEMENT_ABORTED
+} rm_tristripper_exact_result;
+
+//Search a strip decomposition of minimum cost (see "rm_tristripper_calculate_cost(...)") for a small set of triangles.
+//This is a branch-and-bound search over the edges of the dual graph that selects a linear forest (every path becomes a strip).
+//"incumbent_cost" is the cost of a known solution, we are only interested in cheaper ones.
+//If one is found, it is returned in "strips" / "strips_count". Otherwise, those are not touched.
+//The link states and flags of the triangles are overwritten.
+//The strips are collected with the help of "scratch" (see "rm_tristripper_context.h").
+rm_tristripper_exact_result rm_tristripper_create_strips_exact(rm_tristripper_tri* tris, rm_size tris_count, const rm_tristripper_config* config, rm_size incumbent_cost, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef __RM_TRISTRIPPER_MESH_H__
+#define __RM_TRISTRIPPER_MESH_H__
+
+#include "rm_tristripper_common.h"
+
+//Mesh files are read in chunks of this size (lines that are longer make the buffer grow):
+#define RM_TRISTRIPPER_MESH_CHUNK_SIZE ((rm_size)1 << 20)
+
+//The mesh file formats we can read:
+typedef enum __rm_tristripper_mesh_format__
+{
+	//Stanford PLY (ASCII, binary little endian and binary big endian).
+	//The "vertex_indices" (or "vertex_index") list of the "face" element is evaluated.
+	RM_TRISTRIPPER_MESH_FORMAT_PLY,
+
+	//Wavefront OBJ.
+	//Only "f" lines are evaluated. "v" lines are counted to resolve negative (relative) indices.
+	RM_TRISTRIPPER_MESH_FORMAT_OBJ,
+
+	//Binary STL.
+	//There are no indices, so vertices with bitwise equal positions are merged (-0.0 and 0.0 are treated as equal).
+	RM_TRISTRIPPER_MESH_FORMAT_STL
+} rm_tristripper_mesh_format;
+
+//Determine the format of a mesh file from the extension of its path (case-insensitive).
+//Return "false" if the extension is unknown.
+rm_bool rm_tristripper_mesh_format_from_path(const rm_char* path, rm_tristripper_mesh_format* format);
+
+//Read the faces of a mesh file and append them as triangles to "ids" (which must have been initialized).
+//Quads and polygons are triangulated on the fly as fans, the winding order is kept. Faces with less than three vertices are dropped.
+//The file is streamed in chunks, so only the resulting indices are held in memory.
+//Malformed files trigger a precondition.
+rm_void rm_tristripper_read_mesh(const rm_char* path, rm_tristripper_mesh_format format, rm_tristripper_id_vec* ids);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __RM_TRISTRIPPER_OPTIMIZE_H__
+#define __RM_TRISTRIPPER_OPTIMIZE_H__
+
+#include "rm_tristripper_tri.h"
+#include "rm_tristripper_stats.h"
+
+//The number of past costs the late acceptance criterion compares against:
+#define RM_TRISTRIPPER_OPTIMIZE_HISTORY_COUNT ((rm_size)512)
+
+//The cycle check walks this number of triangles along both paths before it looks the paths up in their treaps:
+#define RM_TRISTRIPPER_OPTIMIZE_MAX_WALK_COUNT ((rm_size)16)
+
+//Improve the linked graph state that tunneling has left behind by local search with late acceptance.
+//A move links two unlinked neighbours and drops one link at each of them if necessary ("edge flip").
+//Moves are rated under the cost model of the config, swaps are counted with the pivot rule.
+//If "config->preserve_orientation" is set, the orientation fixes of the touched strips are counted as swaps as well.
+//Every strip is then collected from an end that needs no fix if it has one.
+//The search runs for "config->optimize_usecs" and returns to the best state that has been encountered.
+//If that state is cheaper than the initial one, the endpoint flags and the endpoint list are rebuilt and "*strips_count_inout" is updated.
+//Otherwise, everything is left as it was.
+rm_void rm_tristripper_optimize_links(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_size* strips_count_inout, const rm_tristripper_config* config, rm_tristripper_process_stats* process_stats);
+
+//Reduce the number of swaps in the linked graph state without changing the number of strips.
+//We visit every unlinked pair of neighbours next to a swap and try to link them.
+//To keep the number of strips, one link is dropped at one of them or at both, where one of the dropped partners is linked elsewhere then.
+//The move that saves the most swaps is applied. We repeat that until nothing improves anymore, so the result is deterministic.
+//Swaps are counted with the pivot rule like in "rm_tristripper_optimize_links(...)".
+//Afterwards, the endpoint flags and the endpoint list are rebuilt (with "preserve_orientation", every strip starts at an end without orientation fix if possible).
+rm_void rm_tristripper_reduce_swaps(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_bool preserve_orientation, rm_tristripper_process_stats* process_stats);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef __RM_TRISTRIPPER_OUT_OF_CORE_H__
+#define __RM_TRISTRIPPER_OUT_OF_CORE_H__
+
+#include "rm_tristripper_batch.h"
+#include "rm_tristripper_common.h"
+#include "rm_tristripper_stats.h"
+
+/*
+	Out-of-core stripping for meshes whose triangles and edge hashmap don't fit into memory.
+
+	1.) Adjacency: Every edge of every triangle is written as (edge key, triangle) record to sorted runs on disk.
+	    Merging the runs brings equal edges together, so neighbours are paired exactly like the open edge hashmap does it.
+	    A second external sort by triangle turns the pairs into an adjacency file with three neighbours per triangle.
+	2.) Chunks: The dual graph is partitioned into chunks by BFS (connected triangles end up in the same chunk, small components share one).
+	    Every chunk is stripped in memory on its own and its strips are streamed to the output right away.
+	3.) Seams: Triangles with a neighbour in another chunk are held back from their chunk.
+	    The final pass strips these seams together, so strips run across chunk borders instead of ending there.
+
+	The memory limit covers the anonymous memory of the whole process: Two bits per triangle stay allocated,
+	 the sort buffers and chunks share the rest. The input IDs and the adjacency file are mapped,
+	 their clean pages are file-backed and can be dropped by the kernel at any time.
+	The tables of the strip file (16 bytes per strip, see "rm_tristripper_strip_file.h") stay in memory until it is closed.
+*/
+
+//We reserve this number of bytes per triangle of a chunk.
+//This covers the triangles, BFS reordering, the lookup of the chunk members and the resulting strips.
+#define RM_TRISTRIPPER_OUT_OF_CORE_BYTES_PER_TRI ((rm_size)160)
+
+//The write buffers and other small allocations are covered by this number of bytes:
+#define RM_TRISTRIPPER_OUT_OF_CORE_FIXED_BYTES ((rm_size)4 << 20)
+
+//The memory limit must leave room for chunks of at least this number of triangles:
+#define RM_TRISTRIPPER_OUT_OF_CORE_MIN_CHUNK_TRIS_COUNT ((rm_size)4096)
+
+//Merging reads every sorted run in blocks of at least this number of records (16 bytes each).
+//So the runs of a sort (three records per triangle) must not outnumber the blocks its buffer can hold, this is checked up front.
+#define RM_TRISTRIPPER_OUT_OF_CORE_MIN_MERGE_BLOCK_COUNT ((rm_size)4096)
+
+//How is a mesh stripped out of core?
+//
+// - "config":       The config for every chunk. Every chunk gets its own copy, "stats" is ignored.
+// - "memory_limit": The number of bytes we may allocate (see above).
+// - "temp_dir":     The directory for the temporary files (null for "$TMPDIR" or "/tmp").
+//                   They need up to 96 bytes per triangle at the same time and are deleted automatically.
+// - "output_path":  If this is not null, the strips are written to a strip file (see "rm_tristripper_strip_file.h"), one tile per chunk.
+// - "output_func":  If this is not null, it is called with the strips of every chunk (after they have been written to the file).
+//                   The tile index is the chunk index.
+typedef struct __rm_tristripper_out_of_core_config__
+{
+	const rm_tristripper_config* config;
+	rm_size memory_limit;
+	const rm_char* temp_dir;
+	const rm_char* output_path;
+	rm_tristripper_batch_output_func output_func;
+	rm_void* output_user_data;
+} rm_tristripper_out_of_core_config;
+
+//Statistics about an out-of-core run:
+typedef struct __rm_tristripper_out_of_core_stats__
+{
+	//The sum of the statistics of all chunks (including the process):
+	rm_tristripper_stats stats;
+
+	//The number of chunks (including the seams) and the part of them that has been stripped in the final pass:
+	rm_size chunks_count;
+	rm_size seam_chunks_count;
+	rm_size seam_tris_count;
+
+	//The number of sorted runs and the number of bytes that have been written to temporary files:
+	rm_size runs_count;
+	rm_uint64 temp_bytes;
+
+	//The maximum number of bytes that have been reserved at the same time:
+	rm_size peak_memory_bytes;
+
+	//The time spent in the single phases (in nanoseconds):
+	rm_uint64 adjacency_nsecs;
+	rm_uint64 chunks_nsecs;
+	rm_uint64 seams_nsecs;
+} rm_tristripper_out_of_core_stats;
+
+//Strip a mesh in chunks that fit into "memory_limit".
+//The IDs are only read, pass a mapping (see "rm_file_map(...)") to keep them out of memory.
+//The triangles of a chunk keep their input order, so a mesh that fits into a single chunk gets the same strips as from "rm_tristripper_create_strips(...)".
+//Malformed inputs and a memory limit that is too small trigger a precondition.
+rm_void rm_tristripper_create_strips_out_of_core(const rm_tristripper_id* ids, rm_size ids_count, const rm_tristripper_out_of_core_config* out_of_core_config, rm_tristripper_out_of_core_stats* out_of_core_stats);
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef __RM_TRISTRIPPER_SIMPLE_H__
 #define __RM_TRISTRIPPER_SIMPLE_H__
 
+#include "rm_tristripper_context.h"
 #include "rm_tristripper_tri.h"
 
-//Apply the "stripify" algorithm to the triangles and return strips:
-rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_strip** strips, rm_size* strips_count);
+//Apply the "stripify" algorithm to the triangles and return strips.
+//The IDs of each strip are gathered in "scratch" (see "rm_tristripper_context.h") before they are copied out.
+rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count);
 
 #endif
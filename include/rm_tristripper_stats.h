@@ -5,6 +5,46 @@
 
 #include "rm_tristripper_common.h"
 
+//Statistics about the stripping process itself (as opposed to the resulting strips).
+//Counters are summed over all components and threads.
+typedef struct __rm_tristripper_process_stats__
+{
+	//The number of components that have been passed to the exact solver:
+	rm_size exact_components_count;
+
+	//How often has the exact solver found a cheaper solution than the heuristics?
+	rm_size exact_improvements_count;
+
+	//How often has the exact solver hit its node limit before proving optimality?
+	rm_size exact_aborts_count;
+
+	//The time spent in the exact solver (in nanoseconds):
+	rm_uint64 exact_nsecs;
+
+	//The number of moves the local search has tried and accepted:
+	rm_size optimize_iterations_count;
+	rm_size optimize_accepted_moves_count;
+
+	//The number of strips before and after the local search.
+	//Note that the search might end up with more strips if that saves enough swaps.
+	rm_size optimize_initial_strips_count;
+	rm_size optimize_final_strips_count;
+
+	//How much cost has the local search saved (compared to tunneling)?
+	rm_size optimize_saved_cost;
+
+	//The time spent in the local search (in nanoseconds).
+	//Divide the savings by it to rate the budget.
+	rm_uint64 optimize_nsecs;
+
+	//The number of swaps before and after the swap reduction (counted without orientation fixes):
+	rm_size reduce_swaps_initial_swaps_count;
+	rm_size reduce_swaps_final_swaps_count;
+
+	//The time spent in the swap reduction (in nanoseconds):
+	rm_uint64 reduce_swaps_nsecs;
+} rm_tristripper_process_stats;
+
 //Interesting statistics about a collection of triangle strips:
 typedef struct __rm_tristripper_stats__
 {
@@ -34,9 +74,22 @@ typedef struct __rm_tristripper_stats__
 		- PR2: Primitive restarts cost 2 vertices
 	*/
 	rm_size vertex_cost_models[2][3];
+
+	//Only filled by "rm_tristripper_create_strips(...)" (see "stats" in the config).
+	//"rm_tristripper_calculate_stats(...)" sets it to zero.
+	rm_tristripper_process_stats process;
 } rm_tristripper_stats;
 
 //Calculate the statistics for a given strip collection:
-rm_void rm_tristripper_calculate_stats(rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_stats* stats);
+rm_void rm_tristripper_calculate_stats(const rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_stats* stats);
+
+//Add "stats" to "sum" (e.g. to sum up tiles). All counters and timings are added, including the process statistics.
+//Note that the cost models are the sums of the single collections, so primitive restarts between them are not counted.
+rm_void rm_tristripper_add_stats(rm_tristripper_stats* sum, const rm_tristripper_stats* stats);
+
+//Calculate the vertex cost of a strip collection that describes "valid_tris_count" non-degenerated triangles.
+//Swaps and primitive restarts are weighted with "cost_per_swap" and "cost_per_primitive_restart" from the config.
+//For weights in 0...1 resp. 0...2, this is identical to the corresponding entry of "vertex_cost_models".
+rm_size rm_tristripper_calculate_cost(const rm_tristripper_strip* strips, rm_size strips_count, rm_size valid_tris_count, const rm_tristripper_config* config);
 
 #endif
@@ -0,0 +1,136 @@
+#ifndef __RM_TRISTRIPPER_STRIP_FILE_H__
+#define __RM_TRISTRIPPER_STRIP_FILE_H__
+
+#include "rm_file.h"
+#include "rm_vec.h"
+
+#include "rm_tristripper_common.h"
+#include "rm_tristripper_stats.h"
+
+/*
+	A strip file stores the strips of any number of tiles (e.g. one tile per mesh chunk).
+	It is meant to be mapped into memory, so single strips and tiles can be decoded without touching the rest.
+	All integers are little endian, all tables are 8-byte aligned:
+
+	+--------------------------------------------------------------------------------------------------+
+	| Header (64 bytes)                                                                                |
+	|   uint32 magic ("RMTS"), uint32 version, uint64 tiles_count, uint64 strips_count,                |
+	|   uint64 tile_table_offset, uint64 strip_table_offset, uint64 file_size, 16 bytes reserved (zero)|
+	+--------------------------------------------------------------------------------------------------+
+	| Strip data                                                                                       |
+	|   Per strip: the deltas between consecutive IDs (zigzag + varint coded, usually one byte each).  |
+	|   The first ID of a strip lives in the strip table.                                              |
+	+--------------------------------------------------------------------------------------------------+
+	| Tile table (88 bytes per tile)                                                                   |
+	|   uint64 first_strip_index, uint64 strips_count, uint64 ids_count,                               |
+	|   uint64 valid_tris_count, uint64 swaps_count, uint64 vertex_cost_models[2][3]                   |
+	+--------------------------------------------------------------------------------------------------+
+	| Strip table (16 bytes per strip)                                                                 |
+	|   uint64 data_offset (from the start of the file), uint32 ids_count, uint32 first_id             |
+	+--------------------------------------------------------------------------------------------------+
+
+	The tables are at the end, so the writer can stream the strip data and only keeps the tables in memory.
+	The process statistics are not stored, they describe a run and not the strips.
+*/
+
+#define RM_TRISTRIPPER_STRIP_FILE_MAGIC ((rm_uint32)0x53544d52)
+#define RM_TRISTRIPPER_STRIP_FILE_VERSION ((rm_uint32)1)
+
+#define RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE ((rm_size)64)
+#define RM_TRISTRIPPER_STRIP_FILE_TILE_ENTRY_SIZE ((rm_size)88)
+#define RM_TRISTRIPPER_STRIP_FILE_STRIP_ENTRY_SIZE ((rm_size)16)
+
+//The entries of the tables while writing:
+typedef struct __rm_tristripper_strip_file_tile_entry__
+{
+	rm_size first_strip_index;
+	rm_size strips_count;
+	rm_size ids_count;
+	rm_tristripper_stats stats;
+} rm_tristripper_strip_file_tile_entry;
+
+typedef struct __rm_tristripper_strip_file_strip_entry__
+{
+	rm_uint64 data_offset;
+	rm_uint32 ids_count;
+	rm_tristripper_id first_id;
+} rm_tristripper_strip_file_strip_entry;
+
+typedef rm_vec(rm_tristripper_strip_file_tile_entry) rm_tristripper_strip_file_tile_entry_vec;
+typedef rm_vec(rm_tristripper_strip_file_strip_entry) rm_tristripper_strip_file_strip_entry_vec;
+
+//A strip file that is being written:
+typedef struct __rm_tristripper_strip_file_writer__
+{
+	rm_file file;
+	rm_file_writer writer;
+
+	//The offset where the next strip data goes:
+	rm_uint64 data_offset;
+
+	//The tables that are written on close:
+	rm_tristripper_strip_file_tile_entry_vec tiles;
+	rm_tristripper_strip_file_strip_entry_vec strips;
+} rm_tristripper_strip_file_writer;
+
+//A mapped strip file:
+typedef struct __rm_tristripper_strip_file__
+{
+	rm_file_mapping mapping;
+	rm_size tiles_count;
+	rm_size strips_count;
+
+	//The tables inside the mapping:
+	const rm_uint8* tile_table;
+	const rm_uint8* strip_table;
+
+	//The strip data ends here (exclusive, relative to the start of the file):
+	rm_size data_end;
+} rm_tristripper_strip_file;
+
+//A tile as it is read from a strip file.
+//Its strips are "first_strip_index ... first_strip_index + strips_count - 1".
+//"ids_count" is the sum of the IDs of all strips (e.g. to allocate a single index buffer for the tile).
+//"stats.process" is zero.
+typedef struct __rm_tristripper_strip_file_tile__
+{
+	rm_size first_strip_index;
+	rm_size strips_count;
+	rm_size ids_count;
+	rm_tristripper_stats stats;
+} rm_tristripper_strip_file_tile;
+
+//Create a strip file and prepare it for writing tiles:
+rm_void rm_tristripper_strip_file_writer_open(rm_tristripper_strip_file_writer* writer, const rm_char* path);
+
+//Append the strips of a tile to the file.
+//If "stats" is null, it is calculated from the strips. Otherwise, it must describe them.
+//Tiles are numbered in the order they are added.
+rm_void rm_tristripper_strip_file_writer_add_tile(rm_tristripper_strip_file_writer* writer, const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_stats* stats);
+
+//Write the tables and close the file:
+rm_void rm_tristripper_strip_file_writer_close(rm_tristripper_strip_file_writer* writer);
+
+//Map a strip file.
+//Only the header is validated here, so opening is O(1). Every access validates the parts of the file it touches.
+//"access" is passed to "rm_file_map(...)". Use "RM_FILE_MAP_ACCESS_RANDOM" if only a few tiles are needed.
+//Malformed files trigger a precondition.
+rm_void rm_tristripper_strip_file_open(rm_tristripper_strip_file* file, const rm_char* path, rm_file_map_access access);
+
+//Unmap a strip file:
+rm_void rm_tristripper_strip_file_close(rm_tristripper_strip_file* file);
+
+//Read the table entry of a tile:
+rm_void rm_tristripper_strip_file_get_tile(const rm_tristripper_strip_file* file, rm_size tile_index, rm_tristripper_strip_file_tile* tile);
+
+//Get the number of IDs of a strip:
+rm_size rm_tristripper_strip_file_get_strip_ids_count(const rm_tristripper_strip_file* file, rm_size strip_index);
+
+//Decode the IDs of a strip into "ids" (which must have room for "rm_tristripper_strip_file_get_strip_ids_count(...)" IDs).
+rm_void rm_tristripper_strip_file_decode_strip(const rm_tristripper_strip_file* file, rm_size strip_index, rm_tristripper_id* ids);
+
+//Decode all strips of a tile.
+//The strips must be freed using "rm_tristripper_dispose_strips(...)".
+rm_void rm_tristripper_strip_file_read_tile(const rm_tristripper_strip_file* file, rm_size tile_index, rm_tristripper_strip** strips, rm_size* strips_count);
+
+#endif
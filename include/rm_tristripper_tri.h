@@ -2,6 +2,7 @@
 #define __RM_TRISTRIPPER_TRI_H__
 
 #include "rm_assert.h"
+#include "rm_hashmap.h"
 #include "rm_macro.h"
 
 #include "rm_tristripper_common.h"
@@ -144,10 +145,49 @@ inline rm_void rm_tristripper_order_tris(rm_tristripper_tri* tris, rm_size tris_
 //Derive the entrance vertex IDs for all of them.
 inline rm_void rm_tristripper_determine_core_entrance_vertex_ids(const rm_tristripper_id* first_shared_edge, const rm_tristripper_id* second_shared_edge, rm_tristripper_id* core_entrance_vertix_ids);
 
+//An edge key is formed by two vertices that form an edge.
+//The vertex indices are stuffed in one numeric value twice the size (lower one to the lower bits).
+typedef rm_uint64 rm_tristripper_edge_key;
+
+//A triangle pointer in combination with an edge index (0, 1 or 2) that represents a free neighbour position.
+typedef struct __rm_tristripper_open_edge__
+{
+	rm_tristripper_tri* tri;
+	rm_uint8 edge_index;
+} rm_tristripper_open_edge;
+
+//We need a hashmap monomorphization that maps edge keys to open edges.
+//It will be used to stitch triangles to their neighbours.
+//The open addressing variant (see "rm_hashmap_oa.h") is a drop-in replacement, but it is slower here:
+//The identity hash keeps the edges of nearby vertices in nearby buckets, while open addressing must mix the hash and loses that locality.
+RM_HASHMAP_DECLARE(tristripper_open_edge, rm_tristripper_edge_key, rm_tristripper_open_edge, SKV)
+#define RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR 0.75
+
 //Take the given IDs, build triangles from them and assign their neighbour pointers.
 //Preserve the winding order for all triangles.
 rm_void rm_tristripper_build_tris(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri** tris, rm_size* tris_count);
 
+//Like "rm_tristripper_build_tris(...)", but if "open_edges_stats" is not null, it receives the layout of the hashmap that has stitched the triangles.
+//It is taken at the end, so it only holds the edges without a neighbour (but the supply list, resizes and allocations tell about the peak).
+rm_void rm_tristripper_build_tris_ex(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri** tris, rm_size* tris_count, rm_hashmap_stats* open_edges_stats);
+
+//Like "rm_tristripper_build_tris_ex(...)", but with memory of the caller:
+//"tris" must have room for "ids_count / 3" triangles and "open_edges" must be an empty hashmap.
+//Afterwards, "open_edges" holds the edges without a neighbour, clear it before it is used again.
+//Returns the number of triangles that have been built.
+rm_size rm_tristripper_build_tris_into(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri* tris, rm_tristripper_open_edge_hashmap* open_edges, rm_hashmap_stats* open_edges_stats);
+
+//Renumber the given triangles in BFS order over the dual graph and remap all neighbour pointers.
+//The triangle array is replaced by a new one, the old one is freed.
+//The output stays traceable to the input because strips reference vertex IDs and never triangle indices.
+//As a side effect, every connected component of the dual graph ends up in a contiguous range of the new array.
+//If "component_offsets" is not null, the start index of each component is appended to it (in ascending order).
+rm_void rm_tristripper_reorder_tris(rm_tristripper_tri** tris, rm_size tris_count, rm_size_vec* component_offsets);
+
+//Like "rm_tristripper_reorder_tris(...)", but the triangles are copied to "new_tris" (room for "tris_count" triangles) instead of a new array.
+//The old triangles are left behind as garbage, their memory can be reused for the next reordering.
+rm_void rm_tristripper_reorder_tris_into(rm_tristripper_tri* old_tris, rm_size tris_count, rm_tristripper_tri* new_tris, rm_size_vec* component_offsets);
+
 //This function is used to select the second and third core triangles.
 //Also return the shared edge and the index of the new triangle as seen from "tri".
 rm_tristripper_tri* rm_tristripper_select_next_core_tri(rm_tristripper_tri* tri, rm_tristripper_tri** tris_adjacency_lists, rm_tristripper_id* shared_edge, rm_size* index_from_tri);
@@ -2,6 +2,7 @@
 #define __RM_TRISTRIPPER_VERIFIER_H__
 
 #include "rm_hashmap.h"
+#include "rm_hashmap_sharded.h"
 #include "rm_type.h"
 
 #include "rm_tristripper_common.h"
@@ -27,10 +28,16 @@ typedef struct __rm_tristripper_tri_occurrence__
 } rm_tristripper_tri_occurrence;
 
 //We need a hashmap monomorphization that maps triangles to their occurrences.
+//Like the open edges, it is faster with chaining than with open addressing (see "rm_hashmap_oa.h") because the XOR hash keeps nearby triangles together.
+//It is sharded (see "rm_hashmap_sharded.h"), so multiple threads can fill it.
 RM_HASHMAP_DECLARE(tristripper_tri_occurrence, rm_tristripper_tri_key, rm_tristripper_tri_occurrence, SKV)
+RM_HASHMAP_SHARDED_DECLARE(tristripper_tri_occurrence)
 
 typedef struct __rm_tristripper_verifier__
 {
+	//The total number of triangles (valid or not), the occurrences are indexed by their position among them:
+	rm_size tris_count;
+
 	//The total number of valid triangles:
 	rm_size valid_tris_count;
 
@@ -38,11 +45,15 @@ typedef struct __rm_tristripper_verifier__
 	rm_size distinct_valid_tris_count;
 
 	//The hashmap for the triangle occurrences:
-	rm_tristripper_tri_occurrence_hashmap occurrences;
+	rm_tristripper_tri_occurrence_sharded_hashmap occurrences;
 } rm_tristripper_verifier;
 
 //Initialize the verifier from an ID list:
-rm_void rm_tristripper_init_verifier(rm_tristripper_verifier* verifier, rm_tristripper_id* ids, rm_size ids_count);
+rm_void rm_tristripper_init_verifier(rm_tristripper_verifier* verifier, const rm_tristripper_id* ids, rm_size ids_count);
+
+//Initialize the verifier from an ID list on multiple threads (RM_TRISTRIPPER_THREADS_COUNT_AUTO for one per processor).
+//With a single thread, it is exactly "rm_tristripper_init_verifier(...)".
+rm_void rm_tristripper_init_verifier_ex(rm_tristripper_verifier* verifier, const rm_tristripper_id* ids, rm_size ids_count, rm_size threads_count);
 
 //Dispose a verifier:
 rm_void rm_tristripper_dispose_verifier(rm_tristripper_verifier* verifier);
@@ -7,6 +7,17 @@
 #include "rm_mem.h"
 #include "rm_type.h"
 
+/*
+	Vectors grow via rm_realloc_large(...), so from the large threshold on (see "rm_mem.h"), their data is advised for huge pages.
+	Only blocks above glibc's mmap threshold get a mapping of their own. That threshold is dynamic: It starts at 128 KiB,
+	 but rises to the size of freed mappings (up to 32 MiB on 64-bit systems).
+	realloc(...) grows such a mapping via mremap(...), i. e. the pages are moved instead of copied and the peak memory is not doubled.
+	Below the threshold, the data may live in the heap, then a realloc(...) that can't grow in place allocates anew and copies.
+	Doubling keeps those copies at an amortized O(1) per element and they stop at 32 MiB at the latest,
+	 so there is no need for a mode that reserves address space up front.
+	A large rm_vec_ensure_capacity(...) reserves anyway: The pages are only faulted in when they are touched.
+*/
+
 //If an element is pushed to an empty vector, this start capacity is assigned:
 #define RM_VEC_START_CAPACITY ((rm_size)8)
 
@@ -244,7 +255,7 @@ inline rm_void __rm_vec_ensure_capacity__(rm_void* data, rm_size* capacity, rm_s
 
 	//Reallocate the pointer.
 	//If it was null, this works like malloc.
-	*actual_data = rm_realloc(*actual_data, *capacity * element_size);
+	*actual_data = rm_realloc_large(*actual_data, *capacity * element_size);
 }
 
 inline rm_void __rm_vec_trim_capacity__(rm_void* data, rm_size count, rm_size* capacity, rm_size element_size)
@@ -330,7 +341,7 @@ inline rm_void __rm_vec_reallocate__(rm_void* data, rm_size* capacity, rm_size e
 
 	//Reallocate the pointer.
 	//If it was null, this works like malloc.
-	*actual_data = rm_realloc(*actual_data, *capacity * element_size);
+	*actual_data = rm_realloc_large(*actual_data, *capacity * element_size);
 }
 
 //Some typical vector declarations:
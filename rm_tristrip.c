@@ -0,0 +1,1338 @@
+#include "rm_file.h"
+#include "rm_log.h"
+#include "rm_mem.h"
+#include "rm_time.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_batch.h"
+#include "rm_tristripper_codec.h"
+#include "rm_tristripper_draws.h"
+#include "rm_tristripper_mesh.h"
+#include "rm_tristripper_out_of_core.h"
+#include "rm_tristripper_strip_file.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+//Strip a mesh or a raw index file, optionally verify the result and print timings and statistics.
+//In batch mode, many tiles are stripped on a pool of worker threads (or in a pipeline of stages) and the throughput is reported instead.
+//Every config field is exposed as an option, so settings can be evaluated on real assets from the shell.
+
+//The long options without a short equivalent:
+typedef enum __rm_tristrip_option__
+{
+	RM_TRISTRIP_OPTION_NO_TUNNELING = 256,
+	RM_TRISTRIP_OPTION_PRESERVE_ORIENTATION,
+	RM_TRISTRIP_OPTION_REORDER,
+	RM_TRISTRIP_OPTION_SPLIT_COMPONENTS,
+	RM_TRISTRIP_OPTION_THREADS,
+	RM_TRISTRIP_OPTION_COST_PER_SWAP,
+	RM_TRISTRIP_OPTION_COST_PER_PRIMITIVE_RESTART,
+	RM_TRISTRIP_OPTION_EXACT_MAX_COUNT,
+	RM_TRISTRIP_OPTION_PREPROC,
+	RM_TRISTRIP_OPTION_MAX_COUNT,
+	RM_TRISTRIP_OPTION_NO_INCREMENTAL,
+	RM_TRISTRIP_OPTION_LOOP_LIMIT,
+	RM_TRISTRIP_OPTION_NO_BACKTRACK,
+	RM_TRISTRIP_OPTION_DEST_COUNT,
+	RM_TRISTRIP_OPTION_OPTIMIZE_USECS,
+	RM_TRISTRIP_OPTION_REDUCE_SWAPS,
+	RM_TRISTRIP_OPTION_RAW,
+	RM_TRISTRIP_OPTION_BATCH,
+	RM_TRISTRIP_OPTION_INPUTS_FROM,
+	RM_TRISTRIP_OPTION_WORKERS,
+	RM_TRISTRIP_OPTION_MEMORY_LIMIT,
+	RM_TRISTRIP_OPTION_PIPELINE,
+	RM_TRISTRIP_OPTION_QUEUE_CAPACITY,
+	RM_TRISTRIP_OPTION_OUT_OF_CORE,
+	RM_TRISTRIP_OPTION_TEMP_DIR,
+	RM_TRISTRIP_OPTION_CODEC,
+	RM_TRISTRIP_OPTION_CODEC_OUTPUT,
+	RM_TRISTRIP_OPTION_CODEC_RENUMBER,
+	RM_TRISTRIP_OPTION_DRAWS,
+	RM_TRISTRIP_OPTION_LIST_MAX_TRIS,
+	RM_TRISTRIP_OPTION_HASHMAP_STATS,
+	RM_TRISTRIP_OPTION_MEM_STATS,
+	RM_TRISTRIP_OPTION_NO_HUGE_PAGES,
+	RM_TRISTRIP_OPTION_PREFAULT,
+	RM_TRISTRIP_OPTION_LARGE_THRESHOLD
+} rm_tristrip_option;
+
+static const struct option long_options[] =
+{
+	{ "no-tunneling",               no_argument,       null, RM_TRISTRIP_OPTION_NO_TUNNELING },
+	{ "preserve-orientation",       no_argument,       null, RM_TRISTRIP_OPTION_PRESERVE_ORIENTATION },
+	{ "reorder",                    required_argument, null, RM_TRISTRIP_OPTION_REORDER },
+	{ "split-components",           no_argument,       null, RM_TRISTRIP_OPTION_SPLIT_COMPONENTS },
+	{ "threads",                    required_argument, null, RM_TRISTRIP_OPTION_THREADS },
+	{ "cost-per-swap",              required_argument, null, RM_TRISTRIP_OPTION_COST_PER_SWAP },
+	{ "cost-per-primitive-restart", required_argument, null, RM_TRISTRIP_OPTION_COST_PER_PRIMITIVE_RESTART },
+	{ "exact-max-count",            required_argument, null, RM_TRISTRIP_OPTION_EXACT_MAX_COUNT },
+	{ "preproc",                    required_argument, null, RM_TRISTRIP_OPTION_PREPROC },
+	{ "max-count",                  required_argument, null, RM_TRISTRIP_OPTION_MAX_COUNT },
+	{ "no-incremental",             no_argument,       null, RM_TRISTRIP_OPTION_NO_INCREMENTAL },
+	{ "loop-limit",                 required_argument, null, RM_TRISTRIP_OPTION_LOOP_LIMIT },
+	{ "no-backtrack",               no_argument,       null, RM_TRISTRIP_OPTION_NO_BACKTRACK },
+	{ "dest-count",                 required_argument, null, RM_TRISTRIP_OPTION_DEST_COUNT },
+	{ "optimize-usecs",             required_argument, null, RM_TRISTRIP_OPTION_OPTIMIZE_USECS },
+	{ "reduce-swaps",               no_argument,       null, RM_TRISTRIP_OPTION_REDUCE_SWAPS },
+	{ "raw",                        no_argument,       null, RM_TRISTRIP_OPTION_RAW },
+	{ "batch",                      no_argument,       null, RM_TRISTRIP_OPTION_BATCH },
+	{ "inputs-from",                required_argument, null, RM_TRISTRIP_OPTION_INPUTS_FROM },
+	{ "workers",                    required_argument, null, RM_TRISTRIP_OPTION_WORKERS },
+	{ "memory-limit",               required_argument, null, RM_TRISTRIP_OPTION_MEMORY_LIMIT },
+	{ "pipeline",                   no_argument,       null, RM_TRISTRIP_OPTION_PIPELINE },
+	{ "queue-capacity",             required_argument, null, RM_TRISTRIP_OPTION_QUEUE_CAPACITY },
+	{ "out-of-core",                required_argument, null, RM_TRISTRIP_OPTION_OUT_OF_CORE },
+	{ "temp-dir",                   required_argument, null, RM_TRISTRIP_OPTION_TEMP_DIR },
+	{ "codec",                      no_argument,       null, RM_TRISTRIP_OPTION_CODEC },
+	{ "codec-output",               required_argument, null, RM_TRISTRIP_OPTION_CODEC_OUTPUT },
+	{ "codec-renumber",             no_argument,       null, RM_TRISTRIP_OPTION_CODEC_RENUMBER },
+	{ "draws",                      no_argument,       null, RM_TRISTRIP_OPTION_DRAWS },
+	{ "list-max-tris",              required_argument, null, RM_TRISTRIP_OPTION_LIST_MAX_TRIS },
+	{ "hashmap-stats",              no_argument,       null, RM_TRISTRIP_OPTION_HASHMAP_STATS },
+	{ "mem-stats",                  no_argument,       null, RM_TRISTRIP_OPTION_MEM_STATS },
+	{ "no-huge-pages",              no_argument,       null, RM_TRISTRIP_OPTION_NO_HUGE_PAGES },
+	{ "prefault",                   no_argument,       null, RM_TRISTRIP_OPTION_PREFAULT },
+	{ "large-threshold",            required_argument, null, RM_TRISTRIP_OPTION_LARGE_THRESHOLD },
+	{ "verify",                     no_argument,       null, 'v' },
+	{ "output",                     required_argument, null, 'o' },
+	{ "json",                       no_argument,       null, 'j' },
+	{ "help",                       no_argument,       null, 'h' },
+	{ null,                         0,                 null, 0 }
+};
+
+static const rm_char* const format_names[] = { "ply", "obj", "stl" };
+
+//The results of a run:
+typedef struct __rm_tristrip_report__
+{
+	const rm_char* path;
+	const rm_char* format_name;
+	rm_size tris_count;
+	rm_size strips_count;
+	rm_tristripper_stats stats;
+
+	//Has the verifier run? Has it passed?
+	rm_bool is_verified;
+	rm_bool is_valid;
+
+	//The time spent in the different phases (in nanoseconds):
+	rm_uint64 read_nsecs;
+	rm_uint64 strip_nsecs;
+	rm_uint64 verify_nsecs;
+	rm_uint64 write_nsecs;
+
+	//Only set if the input has been stripped out of core (otherwise null):
+	const rm_tristripper_out_of_core_stats* out_of_core_stats;
+	rm_size max_resident_bytes;
+
+	//Only set if the strips have been encoded (see "rm_tristripper_codec.h").
+	//Decoding is repeated "codec_decode_rounds" times, "codec_decode_nsecs" is the time of a single round.
+	rm_bool is_encoded;
+	rm_bool is_renumbered;
+	rm_size ids_count;
+	rm_size codec_size;
+	rm_uint64 codec_encode_nsecs;
+	rm_uint64 codec_decode_nsecs;
+	rm_size codec_decode_rounds;
+
+	//Only set if the strips have been packed into draws (see "rm_tristripper_draws.h"):
+	rm_bool is_packed;
+	rm_size draw_commands_count;
+	rm_size strip_draws_count;
+	rm_size list_tris_count;
+	rm_size draw_ids_count;
+	rm_uint64 pack_nsecs;
+
+	//Only set if the hashmap statistics have been requested (see "rm_hashmap_stats"):
+	rm_bool has_hashmap_stats;
+	rm_hashmap_stats open_edges_hashmap_stats;
+	rm_hashmap_stats tri_occurrences_hashmap_stats;
+
+	//Only set if the memory statistics have been requested (see "rm_mem.h"), one per tag and the total at the end:
+	rm_bool has_mem_stats;
+	rm_mem_stats mem_stats[RM_MEM_TAGS_COUNT + 1];
+} rm_tristrip_report;
+
+//Decoding is repeated for at least this time to get a stable throughput:
+#define RM_TRISTRIP_CODEC_MIN_DECODE_NSECS ((rm_uint64)200000000)
+
+//The longest line we accept in a list of inputs:
+#define RM_TRISTRIP_MAX_PATH_LENGTH ((rm_size)4096)
+
+typedef rm_vec(rm_tristripper_batch_input) rm_tristrip_input_vec;
+
+//Print the usage to "file":
+static rm_void print_usage(rm_file file, const rm_char* name);
+
+//Parse the numeric argument of an option:
+static rm_size parse_size(const rm_char* option_name, const rm_char* arg);
+
+//Print the cost table of "stats" (see "rm_tristripper_stats.h"):
+static rm_void print_cost_table(const rm_tristripper_stats* stats);
+
+//Print the timings of the optional passes that have been enabled in "config":
+static rm_void print_process_timings(const rm_tristripper_stats* stats, const rm_tristripper_config* config);
+
+//Print parts of a JSON report. The objects are followed by a comma.
+static rm_void print_json_string(const rm_char* string);
+static rm_void print_json_config(const rm_tristripper_config* config);
+static rm_void print_json_stats(const rm_tristripper_stats* stats);
+
+//Collect copies of the strips of all chunks in a "rm_tristripper_strip_vec" (see "rm_tristripper_batch_output_func"):
+static rm_void collect_strips(rm_size tile_index, const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_stats* stats, rm_void* user_data);
+
+//Encode the strips, check that they survive the round trip and measure how fast they are decoded.
+//The stream is written to "output_path" if it is not null.
+//If "renumber" is "true", the vertices are renumbered in the order of their first use first (on a copy of the strips).
+static rm_void run_codec(const rm_tristripper_strip* strips, rm_size strips_count, rm_bool renumber, const rm_char* output_path, rm_tristrip_report* report);
+
+//Pack the strips into draws and fill in the report.
+//If "verify" is "true", the triangles that are drawn are checked against the input as well.
+static rm_void run_draws(const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_draws_config* draws_config, rm_bool verify, const rm_tristripper_id* ids, rm_size ids_count, rm_tristrip_report* report);
+
+//Get the throughput of the decoder in GB of IDs per second:
+static rm_double get_codec_decode_gbps(const rm_tristrip_report* report);
+
+//Gather the layout of the hashmaps that stitch the triangles and verify the strips.
+//The verifier hashmap is taken from "verifier" if it is not null, otherwise a verifier is initialized for this.
+static rm_void run_hashmap_stats(const rm_tristripper_id* ids, rm_size ids_count, const rm_tristripper_verifier* verifier, rm_tristrip_report* report);
+
+//Print the statistics of a single hashmap in human-readable form or as JSON (as the value of the member "name"):
+static rm_void print_hashmap_stats_text(const rm_char* name, const rm_hashmap_stats* hashmap_stats);
+static rm_void print_hashmap_stats_json(const rm_char* name, const rm_hashmap_stats* hashmap_stats, rm_bool is_last);
+
+//Print the report in human-readable form or as JSON:
+static rm_void print_text(const rm_tristrip_report* report, const rm_tristripper_config* config);
+static rm_void print_json(const rm_tristrip_report* report, const rm_tristripper_config* config);
+
+//Append the paths in a list file (one per line, empty lines are skipped) to "inputs".
+//The paths are duplicated and must be freed.
+static rm_void read_inputs(const rm_char* list_path, rm_tristrip_input_vec* inputs);
+
+//Print the report of a batch in human-readable form or as JSON.
+//If the batch has run in a pipeline, "pipeline_config" and "pipeline_stats" describe it (otherwise, they are null).
+static rm_void print_batch_text(const rm_tristripper_batch_stats* batch_stats, const rm_tristripper_batch_config* batch_config, const rm_tristripper_pipeline_config* pipeline_config, const rm_tristripper_pipeline_stats* pipeline_stats);
+static rm_void print_batch_json(const rm_tristripper_batch_stats* batch_stats, const rm_tristripper_batch_config* batch_config, const rm_tristripper_pipeline_config* pipeline_config, const rm_tristripper_pipeline_stats* pipeline_stats);
+
+static rm_void print_usage(rm_file file, const rm_char* name)
+{
+	rm_file_print(file,
+		"Usage: %s [options] <mesh.ply|mesh.obj|mesh.stl|ids.bin>\n"
+		"       %s --batch [options] <inputs...>\n"
+		"\n"
+		"Input:\n"
+		"  --raw                             Treat the input as a raw array of uint32 IDs in host byte order (three per triangle).\n"
+		"                                    This is implied for unknown extensions.\n"
+		"\n"
+		"Batch mode (every input is a tile):\n"
+		"  --batch                           Strip all inputs and report the throughput and latency.\n"
+		"  --inputs-from <path>              Read more inputs from a file, one path per line (implies --batch).\n"
+		"  --workers <n>                     Tiles in parallel, 0 for one per processor [0].\n"
+		"  --memory-limit <MiB>              Memory for all tiles in flight, 0 for no limit [0].\n"
+		"  --pipeline                        Run reading, building, stripping, verifying and writing as concurrent stages\n"
+		"                                    instead of a pool of workers and report where each stage spends its time (implies --batch).\n"
+		"  --queue-capacity <n>              Tiles that may wait between two pipeline stages [%zu].\n"
+		"\n"
+		"Out-of-core mode (for meshes that don't fit into memory):\n"
+		"  --out-of-core <MiB>               Strip in chunks within this memory limit, the strips are written as one tile per chunk.\n"
+		"                                    Raw inputs are mapped, meshes are read into memory first.\n"
+		"  --temp-dir <path>                 Directory for the temporary files [$TMPDIR or /tmp].\n"
+		"\n"
+		"Config (defaults in brackets):\n"
+		"  --no-tunneling                    Stripify only.\n"
+		"  --preserve-orientation            Preserve the orientation of the triangles.\n"
+		"  --reorder <none|bfs>              Renumber the triangles before stripping [none].\n"
+		"  --split-components                Strip every connected component on its own.\n"
+		"  --threads <n>                     Threads for split components and the verifier, 0 for one per processor [1].\n"
+		"  --cost-per-swap <n>               Vertex cost of a swap [0].\n"
+		"  --cost-per-primitive-restart <n>  Vertex cost of a primitive restart [0].\n"
+		"  --exact-max-count <n>             Solve components up to this size exactly, 0 to disable [0].\n"
+		"  --preproc <isolated|pairs|stripify>\n"
+		"                                    Initial strips for tunneling [stripify].\n"
+		"  --max-count <n>                   Maximum tunnel length [16].\n"
+		"  --no-incremental                  Search tunnels with the full depth right away.\n"
+		"  --loop-limit <n>                  Loop iterations per tunnel, 0 for no limit [2000].\n"
+		"  --no-backtrack                    Fail instead of backtracking when the loop limit is hit.\n"
+		"  --dest-count <n>                  Stop tunneling at this number of strips, 0 to disable [0].\n"
+		"  --optimize-usecs <n>              Local search budget in microseconds, 0 to disable [0].\n"
+		"  --reduce-swaps                    Re-link the strips to get rid of swaps.\n"
+		"\n"
+		"Memory (see \"rm_malloc_large(...)\"):\n"
+		"  --no-huge-pages                   Don't ask for transparent huge pages for the triangles and hashmaps.\n"
+		"  --prefault                        Fault in the triangles and hashmaps right after allocating them.\n"
+		"  --large-threshold <KiB>           Allocations from this size on are treated as large [%zu].\n"
+		"\n"
+		"Output:\n"
+		"  -v, --verify                      Verify the strips against the input (exit code 1 if that fails).\n"
+		"  -o, --output <path>               Write the strips to a strip file (see \"rm_tristripper_strip_file.h\").\n"
+		"                                    In batch mode, it contains one tile per input in input order.\n"
+		"  --codec                           Encode the strips (see \"rm_tristripper_codec.h\"), check the round trip\n"
+		"                                    and report the compression ratio and decoding speed.\n"
+		"  --codec-output <path>             Write the encoded strips to a file (implies --codec).\n"
+		"  --codec-renumber                  Renumber the vertices in the order of their first use before encoding (implies --codec).\n"
+		"                                    This is what the codec is made for, but the vertex buffer must be permuted the same way.\n"
+		"  --draws                           Pack the strips into one index buffer and indirect draw commands (see \"rm_tristripper_draws.h\").\n"
+		"  --list-max-tris <n>               Merge strips with up to this many triangles into a trailing triangle list,\n"
+		"                                    0 to draw every strip on its own (implies --draws) [0].\n"
+		"  --hashmap-stats                   Report the layout of the hashmaps for the open edges and the verifier (costs another\n"
+		"                                    adjacency build and a verifier). The hash mixers can be set at build time, see the sources.\n"
+		"  --mem-stats                       Report the live and peak memory of every phase (needs a build with -DRM_MEM_TRACKING).\n"
+		"  -j, --json                        Print the report as JSON.\n"
+		"  -h, --help                        Print this help.\n",
+		name, name, RM_TRISTRIPPER_PIPELINE_DEFAULT_QUEUE_CAPACITY, RM_MEM_LARGE_DEFAULT_THRESHOLD / 1024);
+}
+
+static rm_size parse_size(const rm_char* option_name, const rm_char* arg)
+{
+	rm_char* end;
+	errno = 0;
+	unsigned long long value = strtoull(arg, &end, 10);
+
+	if ((end == arg) || (*end != '\0') || (arg[0] == '-') || (errno != 0) || (value > SIZE_MAX))
+	{
+		rm_exit("Invalid value for \"--%s\": \"%s\"", option_name, arg);
+	}
+
+	return (rm_size)value;
+}
+
+static rm_void print_cost_table(const rm_tristripper_stats* stats)
+{
+	rm_file_print(rm_stdout, "\nVertex cost:\n");
+	rm_file_print(rm_stdout, "  +-----+------------+------------+------------+\n");
+	rm_file_print(rm_stdout, "  |     |        PR0 |        PR1 |        PR2 |\n");
+	rm_file_print(rm_stdout, "  +=====+============+============+============+\n");
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_file_print(rm_stdout, "  | SW%zu | %10zu | %10zu | %10zu |\n", i, stats->vertex_cost_models[i][0], stats->vertex_cost_models[i][1], stats->vertex_cost_models[i][2]);
+	}
+
+	rm_file_print(rm_stdout, "  +-----+------------+------------+------------+\n");
+}
+
+static rm_void print_process_timings(const rm_tristripper_stats* stats, const rm_tristripper_config* config)
+{
+	//The optional passes are part of stripping (and summed over threads):
+	if (config->exact_max_count != RM_TRISTRIPPER_NO_EXACT)
+	{
+		rm_file_print(rm_stdout, "    exact          %.6f (%zu components, %zu improved, %zu aborted)\n", rm_time_to_secs(stats->process.exact_nsecs), stats->process.exact_components_count, stats->process.exact_improvements_count, stats->process.exact_aborts_count);
+	}
+
+	if (config->optimize_usecs != RM_TRISTRIPPER_NO_OPTIMIZE)
+	{
+		rm_file_print(rm_stdout, "    optimize       %.6f (%zu moves, %zu accepted, %zu saved)\n", rm_time_to_secs(stats->process.optimize_nsecs), stats->process.optimize_iterations_count, stats->process.optimize_accepted_moves_count, stats->process.optimize_saved_cost);
+	}
+
+	if (config->reduce_swaps)
+	{
+		rm_file_print(rm_stdout, "    reduce swaps   %.6f (%zu -> %zu swaps)\n", rm_time_to_secs(stats->process.reduce_swaps_nsecs), stats->process.reduce_swaps_initial_swaps_count, stats->process.reduce_swaps_final_swaps_count);
+	}
+}
+
+static rm_void print_json_string(const rm_char* string)
+{
+	rm_file_print(rm_stdout, "\"");
+
+	for (const rm_char* c = string; *c; c++)
+	{
+		if ((*c == '"') || (*c == '\\'))
+		{
+			rm_file_print(rm_stdout, "\\%c", *c);
+		}
+		else if ((rm_uint8)*c < 0x20)
+		{
+			rm_file_print(rm_stdout, "\\u%04x", (rm_uint32)(rm_uint8)*c);
+		}
+		else
+		{
+			rm_file_print(rm_stdout, "%c", *c);
+		}
+	}
+
+	rm_file_print(rm_stdout, "\"");
+}
+
+static rm_void print_json_config(const rm_tristripper_config* config)
+{
+	rm_file_print(rm_stdout, "  \"config\": {\n");
+	rm_file_print(rm_stdout, "    \"use_tunneling\": %s,\n", config->use_tunneling ? "true" : "false");
+	rm_file_print(rm_stdout, "    \"preserve_orientation\": %s,\n", config->preserve_orientation ? "true" : "false");
+	rm_file_print(rm_stdout, "    \"reorder_algorithm\": \"%s\",\n", (config->reorder_algorithm == RM_TRISTRIPPER_REORDER_ALGORITHM_BFS) ? "bfs" : "none");
+	rm_file_print(rm_stdout, "    \"split_components\": %s,\n", config->split_components ? "true" : "false");
+	rm_file_print(rm_stdout, "    \"threads_count\": %zu,\n", config->threads_count);
+	rm_file_print(rm_stdout, "    \"cost_per_swap\": %zu,\n", config->cost_per_swap);
+	rm_file_print(rm_stdout, "    \"cost_per_primitive_restart\": %zu,\n", config->cost_per_primitive_restart);
+	rm_file_print(rm_stdout, "    \"exact_max_count\": %zu,\n", config->exact_max_count);
+	rm_file_print(rm_stdout, "    \"preproc_algorithm\": \"%s\",\n", (config->preproc_algorithm == RM_TRISTRIPPER_PREPROC_ALGORITHM_ISOLATED) ? "isolated" : ((config->preproc_algorithm == RM_TRISTRIPPER_PREPROC_ALGORITHM_PAIRS) ? "pairs" : "stripify"));
+	rm_file_print(rm_stdout, "    \"max_count\": %zu,\n", config->max_count);
+	rm_file_print(rm_stdout, "    \"incremental\": %s,\n", config->incremental ? "true" : "false");
+	rm_file_print(rm_stdout, "    \"loop_limit\": %zu,\n", config->loop_limit);
+	rm_file_print(rm_stdout, "    \"backtrack_after_loop_limit\": %s,\n", config->backtrack_after_loop_limit ? "true" : "false");
+	rm_file_print(rm_stdout, "    \"dest_count\": %zu,\n", config->dest_count);
+	rm_file_print(rm_stdout, "    \"optimize_usecs\": %zu,\n", config->optimize_usecs);
+	rm_file_print(rm_stdout, "    \"reduce_swaps\": %s\n", config->reduce_swaps ? "true" : "false");
+	rm_file_print(rm_stdout, "  },\n");
+}
+
+static rm_void print_json_stats(const rm_tristripper_stats* stats)
+{
+	rm_file_print(rm_stdout, "  \"stats\": {\n");
+	rm_file_print(rm_stdout, "    \"strips_count\": %zu,\n", stats->strips_count);
+	rm_file_print(rm_stdout, "    \"valid_tris_count\": %zu,\n", stats->valid_tris_count);
+	rm_file_print(rm_stdout, "    \"swaps_count\": %zu,\n", stats->swaps_count);
+	rm_file_print(rm_stdout, "    \"vertex_cost_models\": [[%zu, %zu, %zu], [%zu, %zu, %zu]]\n", stats->vertex_cost_models[0][0], stats->vertex_cost_models[0][1], stats->vertex_cost_models[0][2], stats->vertex_cost_models[1][0], stats->vertex_cost_models[1][1], stats->vertex_cost_models[1][2]);
+	rm_file_print(rm_stdout, "  },\n");
+
+	rm_file_print(rm_stdout, "  \"process\": {\n");
+	rm_file_print(rm_stdout, "    \"exact_components_count\": %zu,\n", stats->process.exact_components_count);
+	rm_file_print(rm_stdout, "    \"exact_improvements_count\": %zu,\n", stats->process.exact_improvements_count);
+	rm_file_print(rm_stdout, "    \"exact_aborts_count\": %zu,\n", stats->process.exact_aborts_count);
+	rm_file_print(rm_stdout, "    \"optimize_iterations_count\": %zu,\n", stats->process.optimize_iterations_count);
+	rm_file_print(rm_stdout, "    \"optimize_accepted_moves_count\": %zu,\n", stats->process.optimize_accepted_moves_count);
+	rm_file_print(rm_stdout, "    \"optimize_initial_strips_count\": %zu,\n", stats->process.optimize_initial_strips_count);
+	rm_file_print(rm_stdout, "    \"optimize_final_strips_count\": %zu,\n", stats->process.optimize_final_strips_count);
+	rm_file_print(rm_stdout, "    \"optimize_saved_cost\": %zu,\n", stats->process.optimize_saved_cost);
+	rm_file_print(rm_stdout, "    \"reduce_swaps_initial_swaps_count\": %zu,\n", stats->process.reduce_swaps_initial_swaps_count);
+	rm_file_print(rm_stdout, "    \"reduce_swaps_final_swaps_count\": %zu\n", stats->process.reduce_swaps_final_swaps_count);
+	rm_file_print(rm_stdout, "  },\n");
+}
+
+static rm_void collect_strips(rm_size tile_index, const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_stats* stats, rm_void* user_data)
+{
+	rm_unused(tile_index);
+	rm_unused(stats);
+
+	rm_tristripper_strip_vec* strips_vec = user_data;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		rm_tristripper_strip strip =
+		{
+			.ids = rm_mem_dup(strips[i].ids, strips[i].ids_count * sizeof(rm_tristripper_id)),
+			.ids_count = strips[i].ids_count
+		};
+
+		rm_vec_push(strips_vec, strip);
+	}
+}
+
+static rm_void run_codec(const rm_tristripper_strip* strips, rm_size strips_count, rm_bool renumber, const rm_char* output_path, rm_tristrip_report* report)
+{
+	//Renumber a copy of the strips:
+	rm_tristripper_strip* renumbered_strips = null;
+
+	if (renumber && (strips_count > 0))
+	{
+		rm_tristripper_id max_id = 0;
+		renumbered_strips = rm_malloc(strips_count * sizeof(rm_tristripper_strip));
+
+		for (rm_size i = 0; i < strips_count; i++)
+		{
+			renumbered_strips[i].ids_count = strips[i].ids_count;
+			renumbered_strips[i].ids = rm_mem_dup(strips[i].ids, strips[i].ids_count * sizeof(rm_tristripper_id));
+
+			for (rm_size j = 0; j < strips[i].ids_count; j++)
+			{
+				max_id = rm_max(max_id, strips[i].ids[j]);
+			}
+		}
+
+		rm_size remap_count = (rm_size)max_id + 1;
+		rm_tristripper_id* remap = rm_malloc(remap_count * sizeof(rm_tristripper_id));
+
+		rm_tristripper_codec_renumber(renumbered_strips, strips_count, remap, remap_count);
+		rm_free(remap);
+
+		strips = renumbered_strips;
+	}
+
+	report->is_renumbered = renumber;
+
+	//Encode:
+	rm_uint64 start_nsecs = rm_time_now();
+
+	rm_uint8* data = rm_malloc(rm_tristripper_codec_max_size(strips, strips_count));
+	report->codec_size = rm_tristripper_codec_encode(strips, strips_count, data);
+
+	report->codec_encode_nsecs = rm_time_now() - start_nsecs;
+
+	rm_tristripper_codec_header header;
+	rm_tristripper_codec_read_header(data, report->codec_size, &header);
+
+	report->is_encoded = true;
+	report->ids_count = header.ids_count;
+
+	//Decode into one buffer (like an index buffer) until the time is long enough to measure.
+	//Without IDs, there is nothing to decode (and nothing to measure):
+	report->codec_decode_nsecs = 0;
+	report->codec_decode_rounds = 0;
+
+	if (header.ids_count > 0)
+	{
+		rm_tristripper_id* ids = rm_malloc(header.ids_count * sizeof(rm_tristripper_id));
+		rm_size rounds = 0;
+
+		start_nsecs = rm_time_now();
+		rm_uint64 elapsed_nsecs;
+
+		do
+		{
+			rm_tristripper_codec_decode_ids(data, report->codec_size, ids, null);
+			rounds++;
+
+			elapsed_nsecs = rm_time_now() - start_nsecs;
+		}
+		while (elapsed_nsecs < RM_TRISTRIP_CODEC_MIN_DECODE_NSECS);
+
+		report->codec_decode_nsecs = elapsed_nsecs / rounds;
+		report->codec_decode_rounds = rounds;
+
+		//The decoded IDs must be the strips, one after another:
+		rm_size ids_index = 0;
+
+		for (rm_size i = 0; i < strips_count; i++)
+		{
+			rm_precond(memcmp(&ids[ids_index], strips[i].ids, strips[i].ids_count * sizeof(rm_tristripper_id)) == 0, "Strip %zu has not survived the round trip through the codec.", i);
+			ids_index += strips[i].ids_count;
+		}
+
+		rm_free(ids);
+	}
+
+	//Write:
+	if (output_path)
+	{
+		rm_file file = rm_file_open(output_path, RM_FILE_MODE_WRITE, RM_FILE_ENC_BINARY);
+		rm_file_write(file, data, report->codec_size);
+		rm_file_close(file);
+	}
+
+	rm_free(data);
+
+	if (renumbered_strips)
+	{
+		rm_tristripper_dispose_strips(renumbered_strips, strips_count);
+	}
+}
+
+static rm_void run_draws(const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_draws_config* draws_config, rm_bool verify, const rm_tristripper_id* ids, rm_size ids_count, rm_tristrip_report* report)
+{
+	rm_uint64 start_nsecs = rm_time_now();
+
+	rm_tristripper_draws draws;
+	rm_tristripper_pack_draws(strips, strips_count, draws_config, &draws);
+
+	report->pack_nsecs = rm_time_now() - start_nsecs;
+	report->is_packed = true;
+	report->draw_commands_count = draws.commands_count;
+	report->strip_draws_count = draws.strip_commands_count;
+	report->list_tris_count = draws.list_tris_count;
+	report->draw_ids_count = draws.ids_count;
+
+	//The verifier takes strips, so we point them into the index buffer (every triangle of the list is a strip of its own):
+	if (verify)
+	{
+		rm_size views_count = draws.strip_commands_count + draws.list_tris_count;
+		rm_tristripper_strip* views = rm_malloc(rm_max(views_count, (rm_size)1) * sizeof(rm_tristripper_strip));
+
+		for (rm_size i = 0; i < draws.strip_commands_count; i++)
+		{
+			views[i] = (rm_tristripper_strip){ .ids = &draws.ids[draws.commands[i].first_index], .ids_count = draws.commands[i].count };
+		}
+
+		for (rm_size i = 0; i < draws.list_tris_count; i++)
+		{
+			rm_size first_index = draws.commands[draws.strip_commands_count].first_index + (3 * i);
+			views[draws.strip_commands_count + i] = (rm_tristripper_strip){ .ids = &draws.ids[first_index], .ids_count = 3 };
+		}
+
+		rm_tristripper_verifier verifier;
+		rm_tristripper_init_verifier(&verifier, ids, ids_count);
+		report->is_valid = rm_tristripper_verify(&verifier, views, views_count, true) && report->is_valid;
+		rm_tristripper_dispose_verifier(&verifier);
+
+		rm_free(views);
+	}
+
+	rm_tristripper_dispose_draws(&draws);
+}
+
+static rm_double get_codec_decode_gbps(const rm_tristrip_report* report)
+{
+	rm_double bytes = (rm_double)(report->ids_count * sizeof(rm_tristripper_id));
+
+	return bytes / rm_time_to_secs(rm_max(report->codec_decode_nsecs, (rm_uint64)1)) / 1e9;
+}
+
+static rm_void run_hashmap_stats(const rm_tristripper_id* ids, rm_size ids_count, const rm_tristripper_verifier* verifier, rm_tristrip_report* report)
+{
+	//Build the triangles once more, the strips are done already:
+	rm_tristripper_tri* tris;
+	rm_size tris_count;
+
+	rm_tristripper_build_tris_ex(ids, ids_count, &tris, &tris_count, &report->open_edges_hashmap_stats);
+	rm_free(tris);
+
+	if (verifier)
+	{
+		rm_tristripper_tri_occurrence_sharded_hashmap_get_stats(&verifier->occurrences, &report->tri_occurrences_hashmap_stats);
+	}
+	else
+	{
+		rm_tristripper_verifier own_verifier;
+		rm_tristripper_init_verifier(&own_verifier, ids, ids_count);
+		rm_tristripper_tri_occurrence_sharded_hashmap_get_stats(&own_verifier.occurrences, &report->tri_occurrences_hashmap_stats);
+		rm_tristripper_dispose_verifier(&own_verifier);
+	}
+
+	report->has_hashmap_stats = true;
+}
+
+static rm_void print_hashmap_stats_text(const rm_char* name, const rm_hashmap_stats* hashmap_stats)
+{
+	rm_file_print(rm_stdout, "  %-16s %zu entries, %zu / %zu buckets used, %zu resizes, %.1f MiB\n", name, hashmap_stats->count, hashmap_stats->used_buckets_count, hashmap_stats->buckets_count, hashmap_stats->resizes_count, (rm_double)hashmap_stats->allocated_bytes / (1024.0 * 1024.0));
+	rm_file_print(rm_stdout, "  %-16s max %zu, mean %.3f, mean lookup %.3f\n", "  chains", hashmap_stats->max_chain_length, hashmap_stats->mean_chain_length, hashmap_stats->mean_lookup_length);
+	rm_file_print(rm_stdout, "  %-16s", "  by length");
+
+	for (rm_size i = 0; i < RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT; i++)
+	{
+		rm_file_print(rm_stdout, " %zu%s: %zu", i, (i + 1 == RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT) ? "+" : "", hashmap_stats->buckets_by_chain_length[i]);
+	}
+
+	rm_file_print(rm_stdout, "\n  %-16s %zu collision entries, %zu in the supply list\n", "", hashmap_stats->collision_entries_count, hashmap_stats->supply_list_count);
+}
+
+static rm_void print_hashmap_stats_json(const rm_char* name, const rm_hashmap_stats* hashmap_stats, rm_bool is_last)
+{
+	rm_file_print(rm_stdout, "    \"%s\": {\n", name);
+	rm_file_print(rm_stdout, "      \"count\": %zu,\n", hashmap_stats->count);
+	rm_file_print(rm_stdout, "      \"buckets_count\": %zu,\n", hashmap_stats->buckets_count);
+	rm_file_print(rm_stdout, "      \"used_buckets_count\": %zu,\n", hashmap_stats->used_buckets_count);
+	rm_file_print(rm_stdout, "      \"buckets_by_chain_length\": [");
+
+	for (rm_size i = 0; i < RM_HASHMAP_STATS_CHAIN_LENGTHS_COUNT; i++)
+	{
+		rm_file_print(rm_stdout, "%s%zu", (i == 0) ? "" : ", ", hashmap_stats->buckets_by_chain_length[i]);
+	}
+
+	rm_file_print(rm_stdout, "],\n");
+	rm_file_print(rm_stdout, "      \"max_chain_length\": %zu,\n", hashmap_stats->max_chain_length);
+	rm_file_print(rm_stdout, "      \"mean_chain_length\": %.6f,\n", hashmap_stats->mean_chain_length);
+	rm_file_print(rm_stdout, "      \"mean_lookup_length\": %.6f,\n", hashmap_stats->mean_lookup_length);
+	rm_file_print(rm_stdout, "      \"collision_entries_count\": %zu,\n", hashmap_stats->collision_entries_count);
+	rm_file_print(rm_stdout, "      \"supply_list_count\": %zu,\n", hashmap_stats->supply_list_count);
+	rm_file_print(rm_stdout, "      \"resizes_count\": %zu,\n", hashmap_stats->resizes_count);
+	rm_file_print(rm_stdout, "      \"allocated_bytes\": %zu\n", hashmap_stats->allocated_bytes);
+	rm_file_print(rm_stdout, "    }%s\n", is_last ? "" : ",");
+}
+
+static rm_void print_text(const rm_tristrip_report* report, const rm_tristripper_config* config)
+{
+	const rm_tristripper_stats* stats = &report->stats;
+
+	const rm_tristripper_out_of_core_stats* out_of_core_stats = report->out_of_core_stats;
+
+	rm_file_print(rm_stdout, "Input:        %s (%s, %zu triangles)\n", report->path, report->format_name, report->tris_count);
+
+	if (out_of_core_stats)
+	{
+		rm_file_print(rm_stdout, "Chunks:       %zu (%zu for the seams, %zu seam triangles)\n", out_of_core_stats->chunks_count, out_of_core_stats->seam_chunks_count, out_of_core_stats->seam_tris_count);
+	}
+
+	rm_file_print(rm_stdout, "Strips:       %zu\n", stats->strips_count);
+	rm_file_print(rm_stdout, "Valid tris:   %zu\n", stats->valid_tris_count);
+	rm_file_print(rm_stdout, "Swaps:        %zu\n", stats->swaps_count);
+
+	if (report->is_verified)
+	{
+		rm_file_print(rm_stdout, "Verification: %s\n", report->is_valid ? "passed" : "FAILED");
+	}
+
+	//The phases:
+	rm_file_print(rm_stdout, "\nTimings (s):\n");
+	rm_file_print(rm_stdout, "  read             %.6f\n", rm_time_to_secs(report->read_nsecs));
+	rm_file_print(rm_stdout, "  strip            %.6f\n", rm_time_to_secs(report->strip_nsecs));
+
+	if (out_of_core_stats)
+	{
+		rm_file_print(rm_stdout, "    adjacency      %.6f\n", rm_time_to_secs(out_of_core_stats->adjacency_nsecs));
+		rm_file_print(rm_stdout, "    chunks         %.6f\n", rm_time_to_secs(out_of_core_stats->chunks_nsecs));
+		rm_file_print(rm_stdout, "    seams          %.6f\n", rm_time_to_secs(out_of_core_stats->seams_nsecs));
+	}
+
+	print_process_timings(stats, config);
+
+	if (report->is_verified)
+	{
+		rm_file_print(rm_stdout, "  verify           %.6f\n", rm_time_to_secs(report->verify_nsecs));
+	}
+
+	if (report->write_nsecs != 0)
+	{
+		rm_file_print(rm_stdout, "  write            %.6f\n", rm_time_to_secs(report->write_nsecs));
+	}
+
+	if (report->is_encoded)
+	{
+		rm_file_print(rm_stdout, "  encode           %.6f\n", rm_time_to_secs(report->codec_encode_nsecs));
+		rm_file_print(rm_stdout, "  decode           %.6f (average of %zu rounds)\n", rm_time_to_secs(report->codec_decode_nsecs), report->codec_decode_rounds);
+
+		rm_size raw_size = report->ids_count * sizeof(rm_tristripper_id);
+
+		rm_file_print(rm_stdout, "\nCodec:        %zu bytes for %zu%s IDs (%.2f bits per ID, %.2fx smaller than 32-bit IDs)\n", report->codec_size, report->ids_count, report->is_renumbered ? " renumbered" : "", (rm_double)(8 * report->codec_size) / (rm_double)rm_max(report->ids_count, (rm_size)1), (rm_double)raw_size / (rm_double)report->codec_size);
+		rm_file_print(rm_stdout, "Decoding:     %.3f GB/s of IDs\n", get_codec_decode_gbps(report));
+	}
+
+	if (report->is_packed)
+	{
+		rm_file_print(rm_stdout, "\nDraws:        %zu (%zu strips%s), %zu triangles in the list\n", report->draw_commands_count, report->strip_draws_count, (report->draw_commands_count > report->strip_draws_count) ? " and a list" : "", report->list_tris_count);
+		rm_file_print(rm_stdout, "Index buffer: %zu IDs (%zu bytes), %zu bytes of commands, packed in %.6f s\n", report->draw_ids_count, report->draw_ids_count * sizeof(rm_tristripper_id), report->draw_commands_count * sizeof(rm_tristripper_draw_command), rm_time_to_secs(report->pack_nsecs));
+	}
+
+	if (out_of_core_stats)
+	{
+		rm_file_print(rm_stdout, "\nTemp files:   %.1f MiB in %zu sorted runs\n", (rm_double)out_of_core_stats->temp_bytes / (1024.0 * 1024.0), out_of_core_stats->runs_count);
+		rm_file_print(rm_stdout, "Peak memory:  %.1f MiB reserved, %.1f MiB resident\n", (rm_double)out_of_core_stats->peak_memory_bytes / (1024.0 * 1024.0), (rm_double)report->max_resident_bytes / (1024.0 * 1024.0));
+	}
+
+	if (report->has_hashmap_stats)
+	{
+		rm_file_print(rm_stdout, "\nHashmaps:\n");
+		print_hashmap_stats_text("open edges", &report->open_edges_hashmap_stats);
+		print_hashmap_stats_text("verifier", &report->tri_occurrences_hashmap_stats);
+	}
+
+	if (report->has_mem_stats)
+	{
+		rm_file_print(rm_stdout, "\nMemory (MiB):    peak       live  allocations\n");
+
+		for (rm_size i = 0; i <= RM_MEM_TAGS_COUNT; i++)
+		{
+			const rm_mem_stats* mem_stats = &report->mem_stats[i];
+			rm_file_print(rm_stdout, "  %-12s %9.1f  %9.1f  %11zu\n", rm_mem_tag_get_name((rm_mem_tag)i), (rm_double)mem_stats->peak_bytes / (1024.0 * 1024.0), (rm_double)mem_stats->live_bytes / (1024.0 * 1024.0), mem_stats->allocs_count);
+		}
+	}
+
+	print_cost_table(stats);
+}
+
+static rm_void print_json(const rm_tristrip_report* report, const rm_tristripper_config* config)
+{
+	const rm_tristripper_stats* stats = &report->stats;
+
+	rm_file_print(rm_stdout, "{\n  \"input\": ");
+	print_json_string(report->path);
+	rm_file_print(rm_stdout, ",\n");
+	rm_file_print(rm_stdout, "  \"format\": \"%s\",\n", report->format_name);
+	rm_file_print(rm_stdout, "  \"tris_count\": %zu,\n", report->tris_count);
+
+	print_json_config(config);
+	print_json_stats(stats);
+
+	rm_file_print(rm_stdout, "  \"timings_secs\": {\n");
+	rm_file_print(rm_stdout, "    \"read\": %.9f,\n", rm_time_to_secs(report->read_nsecs));
+	rm_file_print(rm_stdout, "    \"strip\": %.9f,\n", rm_time_to_secs(report->strip_nsecs));
+	rm_file_print(rm_stdout, "    \"exact\": %.9f,\n", rm_time_to_secs(stats->process.exact_nsecs));
+	rm_file_print(rm_stdout, "    \"optimize\": %.9f,\n", rm_time_to_secs(stats->process.optimize_nsecs));
+	rm_file_print(rm_stdout, "    \"reduce_swaps\": %.9f,\n", rm_time_to_secs(stats->process.reduce_swaps_nsecs));
+	rm_file_print(rm_stdout, "    \"verify\": %.9f,\n", rm_time_to_secs(report->verify_nsecs));
+	rm_file_print(rm_stdout, "    \"write\": %.9f\n", rm_time_to_secs(report->write_nsecs));
+	rm_file_print(rm_stdout, "  }");
+
+	if (report->out_of_core_stats)
+	{
+		const rm_tristripper_out_of_core_stats* out_of_core_stats = report->out_of_core_stats;
+
+		rm_file_print(rm_stdout, ",\n  \"out_of_core\": {\n");
+		rm_file_print(rm_stdout, "    \"chunks_count\": %zu,\n", out_of_core_stats->chunks_count);
+		rm_file_print(rm_stdout, "    \"seam_chunks_count\": %zu,\n", out_of_core_stats->seam_chunks_count);
+		rm_file_print(rm_stdout, "    \"seam_tris_count\": %zu,\n", out_of_core_stats->seam_tris_count);
+		rm_file_print(rm_stdout, "    \"runs_count\": %zu,\n", out_of_core_stats->runs_count);
+		rm_file_print(rm_stdout, "    \"temp_bytes\": %" PRIu64 ",\n", out_of_core_stats->temp_bytes);
+		rm_file_print(rm_stdout, "    \"peak_memory_bytes\": %zu,\n", out_of_core_stats->peak_memory_bytes);
+		rm_file_print(rm_stdout, "    \"max_resident_bytes\": %zu,\n", report->max_resident_bytes);
+		rm_file_print(rm_stdout, "    \"adjacency_secs\": %.9f,\n", rm_time_to_secs(out_of_core_stats->adjacency_nsecs));
+		rm_file_print(rm_stdout, "    \"chunks_secs\": %.9f,\n", rm_time_to_secs(out_of_core_stats->chunks_nsecs));
+		rm_file_print(rm_stdout, "    \"seams_secs\": %.9f\n", rm_time_to_secs(out_of_core_stats->seams_nsecs));
+		rm_file_print(rm_stdout, "  }");
+	}
+
+	if (report->is_encoded)
+	{
+		rm_file_print(rm_stdout, ",\n  \"codec\": {\n");
+		rm_file_print(rm_stdout, "    \"renumbered\": %s,\n", report->is_renumbered ? "true" : "false");
+		rm_file_print(rm_stdout, "    \"ids_count\": %zu,\n", report->ids_count);
+		rm_file_print(rm_stdout, "    \"size\": %zu,\n", report->codec_size);
+		rm_file_print(rm_stdout, "    \"encode_secs\": %.9f,\n", rm_time_to_secs(report->codec_encode_nsecs));
+		rm_file_print(rm_stdout, "    \"decode_secs\": %.9f,\n", rm_time_to_secs(report->codec_decode_nsecs));
+		rm_file_print(rm_stdout, "    \"decode_rounds\": %zu,\n", report->codec_decode_rounds);
+		rm_file_print(rm_stdout, "    \"decode_gbps\": %.6f\n", get_codec_decode_gbps(report));
+		rm_file_print(rm_stdout, "  }");
+	}
+
+	if (report->is_packed)
+	{
+		rm_file_print(rm_stdout, ",\n  \"draws\": {\n");
+		rm_file_print(rm_stdout, "    \"commands_count\": %zu,\n", report->draw_commands_count);
+		rm_file_print(rm_stdout, "    \"strip_commands_count\": %zu,\n", report->strip_draws_count);
+		rm_file_print(rm_stdout, "    \"list_tris_count\": %zu,\n", report->list_tris_count);
+		rm_file_print(rm_stdout, "    \"ids_count\": %zu,\n", report->draw_ids_count);
+		rm_file_print(rm_stdout, "    \"pack_secs\": %.9f\n", rm_time_to_secs(report->pack_nsecs));
+		rm_file_print(rm_stdout, "  }");
+	}
+
+	if (report->has_hashmap_stats)
+	{
+		rm_file_print(rm_stdout, ",\n  \"hashmaps\": {\n");
+		print_hashmap_stats_json("open_edges", &report->open_edges_hashmap_stats, false);
+		print_hashmap_stats_json("tri_occurrences", &report->tri_occurrences_hashmap_stats, true);
+		rm_file_print(rm_stdout, "  }");
+	}
+
+	if (report->has_mem_stats)
+	{
+		rm_file_print(rm_stdout, ",\n  \"memory\": {\n");
+
+		for (rm_size i = 0; i <= RM_MEM_TAGS_COUNT; i++)
+		{
+			const rm_mem_stats* mem_stats = &report->mem_stats[i];
+			rm_file_print(rm_stdout, "    \"%s\": { \"peak_bytes\": %zu, \"live_bytes\": %zu, \"allocs_count\": %zu }%s\n", rm_mem_tag_get_name((rm_mem_tag)i), mem_stats->peak_bytes, mem_stats->live_bytes, mem_stats->allocs_count, (i < RM_MEM_TAGS_COUNT) ? "," : "");
+		}
+
+		rm_file_print(rm_stdout, "  }");
+	}
+
+	if (report->is_verified)
+	{
+		rm_file_print(rm_stdout, ",\n  \"valid\": %s", report->is_valid ? "true" : "false");
+	}
+
+	rm_file_print(rm_stdout, "\n}\n");
+}
+
+static rm_void read_inputs(const rm_char* list_path, rm_tristrip_input_vec* inputs)
+{
+	rm_file file = rm_file_open(list_path, RM_FILE_MODE_READ, RM_FILE_ENC_TEXT);
+	rm_char line[RM_TRISTRIP_MAX_PATH_LENGTH];
+
+	while (rm_file_read_line(file, line, RM_TRISTRIP_MAX_PATH_LENGTH))
+	{
+		//Strip the line break:
+		rm_size length = strlen(line);
+		rm_precond((length + 1 < RM_TRISTRIP_MAX_PATH_LENGTH) || (line[length - 1] == '\n'), "\"%s\" contains a path that is longer than %zu characters.", list_path, RM_TRISTRIP_MAX_PATH_LENGTH - 2);
+
+		while ((length > 0) && ((line[length - 1] == '\n') || (line[length - 1] == '\r')))
+		{
+			line[--length] = '\0';
+		}
+
+		if (length == 0)
+		{
+			continue;
+		}
+
+		rm_tristripper_batch_input input = { .path = rm_mem_dup(line, length + 1) };
+		rm_vec_push(inputs, input);
+	}
+
+	rm_file_close(file);
+}
+
+static rm_void print_batch_text(const rm_tristripper_batch_stats* batch_stats, const rm_tristripper_batch_config* batch_config, const rm_tristripper_pipeline_config* pipeline_config, const rm_tristripper_pipeline_stats* pipeline_stats)
+{
+	const rm_tristripper_stats* stats = &batch_stats->stats;
+
+	rm_file_print(rm_stdout, "Tiles:        %zu (%zu triangles)\n", batch_stats->tiles_count, batch_stats->tris_count);
+	rm_file_print(rm_stdout, "Strips:       %zu\n", stats->strips_count);
+	rm_file_print(rm_stdout, "Valid tris:   %zu\n", stats->valid_tris_count);
+	rm_file_print(rm_stdout, "Swaps:        %zu\n", stats->swaps_count);
+
+	if (batch_config->verify)
+	{
+		rm_file_print(rm_stdout, "Verification: %s (%zu invalid tiles)\n", (batch_stats->invalid_tiles_count == 0) ? "passed" : "FAILED", batch_stats->invalid_tiles_count);
+	}
+
+	rm_file_print(rm_stdout, "\nTimings (s):\n");
+	rm_file_print(rm_stdout, "  total            %.6f\n", rm_time_to_secs(batch_stats->nsecs));
+	print_process_timings(stats, batch_config->config);
+
+	rm_file_print(rm_stdout, "\nThroughput:   %.1f tiles/s, %.0f triangles/s\n", batch_stats->tiles_per_sec, batch_stats->tris_per_sec);
+	rm_file_print(rm_stdout, "Latency (s):  p50 %.6f, p90 %.6f, p99 %.6f, max %.6f\n", rm_time_to_secs(batch_stats->latency_p50_nsecs), rm_time_to_secs(batch_stats->latency_p90_nsecs), rm_time_to_secs(batch_stats->latency_p99_nsecs), rm_time_to_secs(batch_stats->latency_max_nsecs));
+	rm_file_print(rm_stdout, "Peak memory:  %.1f MiB reserved\n", (rm_double)batch_stats->peak_memory_bytes / (1024.0 * 1024.0));
+
+	//The stage with the least waiting is the bottleneck:
+	if (pipeline_stats)
+	{
+		rm_file_print(rm_stdout, "\nStages (s, queue capacity %zu):\n", pipeline_config->queue_capacity);
+		rm_file_print(rm_stdout, "                   busy        starved     blocked\n");
+
+		for (rm_size i = 0; i < RM_TRISTRIPPER_PIPELINE_STAGES_COUNT; i++)
+		{
+			const rm_tristripper_pipeline_stage_stats* stage_stats = &pipeline_stats->stages[i];
+			rm_file_print(rm_stdout, "  %-16s %-11.6f %-11.6f %.6f\n", rm_tristripper_pipeline_stage_name((rm_tristripper_pipeline_stage)i), rm_time_to_secs(stage_stats->busy_nsecs), rm_time_to_secs(stage_stats->starved_nsecs), rm_time_to_secs(stage_stats->blocked_nsecs));
+		}
+	}
+
+	print_cost_table(stats);
+}
+
+static rm_void print_batch_json(const rm_tristripper_batch_stats* batch_stats, const rm_tristripper_batch_config* batch_config, const rm_tristripper_pipeline_config* pipeline_config, const rm_tristripper_pipeline_stats* pipeline_stats)
+{
+	const rm_tristripper_stats* stats = &batch_stats->stats;
+
+	rm_file_print(rm_stdout, "{\n");
+	rm_file_print(rm_stdout, "  \"tiles_count\": %zu,\n", batch_stats->tiles_count);
+	rm_file_print(rm_stdout, "  \"tris_count\": %zu,\n", batch_stats->tris_count);
+
+	if (pipeline_stats)
+	{
+		rm_file_print(rm_stdout, "  \"queue_capacity\": %zu,\n", pipeline_config->queue_capacity);
+	}
+	else
+	{
+		rm_file_print(rm_stdout, "  \"workers_count\": %zu,\n", batch_config->threads_count);
+		rm_file_print(rm_stdout, "  \"memory_limit\": %zu,\n", batch_config->memory_limit);
+	}
+
+	print_json_config(batch_config->config);
+	print_json_stats(stats);
+
+	rm_file_print(rm_stdout, "  \"timings_secs\": {\n");
+	rm_file_print(rm_stdout, "    \"total\": %.9f,\n", rm_time_to_secs(batch_stats->nsecs));
+	rm_file_print(rm_stdout, "    \"exact\": %.9f,\n", rm_time_to_secs(stats->process.exact_nsecs));
+	rm_file_print(rm_stdout, "    \"optimize\": %.9f,\n", rm_time_to_secs(stats->process.optimize_nsecs));
+	rm_file_print(rm_stdout, "    \"reduce_swaps\": %.9f\n", rm_time_to_secs(stats->process.reduce_swaps_nsecs));
+	rm_file_print(rm_stdout, "  },\n");
+
+	rm_file_print(rm_stdout, "  \"throughput\": {\n");
+	rm_file_print(rm_stdout, "    \"tiles_per_sec\": %.3f,\n", batch_stats->tiles_per_sec);
+	rm_file_print(rm_stdout, "    \"tris_per_sec\": %.3f\n", batch_stats->tris_per_sec);
+	rm_file_print(rm_stdout, "  },\n");
+
+	rm_file_print(rm_stdout, "  \"latency_secs\": {\n");
+	rm_file_print(rm_stdout, "    \"p50\": %.9f,\n", rm_time_to_secs(batch_stats->latency_p50_nsecs));
+	rm_file_print(rm_stdout, "    \"p90\": %.9f,\n", rm_time_to_secs(batch_stats->latency_p90_nsecs));
+	rm_file_print(rm_stdout, "    \"p99\": %.9f,\n", rm_time_to_secs(batch_stats->latency_p99_nsecs));
+	rm_file_print(rm_stdout, "    \"max\": %.9f\n", rm_time_to_secs(batch_stats->latency_max_nsecs));
+	rm_file_print(rm_stdout, "  },\n");
+
+	if (pipeline_stats)
+	{
+		rm_file_print(rm_stdout, "  \"stages_secs\": {\n");
+
+		for (rm_size i = 0; i < RM_TRISTRIPPER_PIPELINE_STAGES_COUNT; i++)
+		{
+			const rm_tristripper_pipeline_stage_stats* stage_stats = &pipeline_stats->stages[i];
+
+			rm_file_print(rm_stdout, "    \"%s\": { \"busy\": %.9f, \"starved\": %.9f, \"blocked\": %.9f }%s\n", rm_tristripper_pipeline_stage_name((rm_tristripper_pipeline_stage)i), rm_time_to_secs(stage_stats->busy_nsecs), rm_time_to_secs(stage_stats->starved_nsecs), rm_time_to_secs(stage_stats->blocked_nsecs), (i + 1 < RM_TRISTRIPPER_PIPELINE_STAGES_COUNT) ? "," : "");
+		}
+
+		rm_file_print(rm_stdout, "  },\n");
+	}
+
+	rm_file_print(rm_stdout, "  \"peak_memory_bytes\": %zu", batch_stats->peak_memory_bytes);
+
+	if (batch_config->verify)
+	{
+		rm_file_print(rm_stdout, ",\n  \"invalid_tiles_count\": %zu", batch_stats->invalid_tiles_count);
+	}
+
+	rm_file_print(rm_stdout, "\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+	//The defaults are a reasonable tunneling setup:
+	rm_tristripper_config config =
+	{
+		.use_tunneling = true,
+		.preserve_orientation = false,
+		.reorder_algorithm = RM_TRISTRIPPER_REORDER_ALGORITHM_NONE,
+		.split_components = false,
+		.threads_count = 1,
+		.cost_per_swap = 0,
+		.cost_per_primitive_restart = 0,
+		.exact_max_count = RM_TRISTRIPPER_NO_EXACT,
+		.preproc_algorithm = RM_TRISTRIPPER_PREPROC_ALGORITHM_STRIPIFY,
+		.max_count = 16,
+		.incremental = true,
+		.loop_limit = 2000,
+		.backtrack_after_loop_limit = true,
+		.dest_count = RM_TRISTRIPPER_NO_DEST_COUNT,
+		.optimize_usecs = RM_TRISTRIPPER_NO_OPTIMIZE,
+		.reduce_swaps = false
+	};
+
+	rm_bool is_raw = false;
+	rm_bool verify = false;
+	rm_bool hashmap_stats = false;
+	rm_bool mem_stats = false;
+	rm_bool json = false;
+
+	rm_mem_large_config large_config;
+	rm_mem_get_large_config(&large_config);
+	const rm_char* output_path = null;
+
+	//Codec:
+	rm_bool codec = false;
+	rm_bool codec_renumber = false;
+	const rm_char* codec_output_path = null;
+
+	//Draws:
+	rm_bool draws = false;
+	rm_tristripper_draws_config draws_config = { .list_max_tris_count = RM_TRISTRIPPER_NO_LIST };
+
+	//Batch mode:
+	rm_bool is_batch = false;
+	rm_bool is_pipeline = false;
+	rm_tristrip_input_vec inputs;
+	rm_tristripper_batch_config batch_config =
+	{
+		.config = &config,
+		.threads_count = RM_TRISTRIPPER_THREADS_COUNT_AUTO,
+		.memory_limit = RM_TRISTRIPPER_BATCH_NO_MEMORY_LIMIT
+	};
+
+	rm_tristripper_pipeline_config pipeline_config =
+	{
+		.config = &config,
+		.queue_capacity = RM_TRISTRIPPER_PIPELINE_DEFAULT_QUEUE_CAPACITY
+	};
+
+	//Out-of-core mode:
+	rm_tristripper_out_of_core_stats out_of_core_stats;
+	rm_tristripper_out_of_core_config out_of_core_config =
+	{
+		.config = &config,
+		.memory_limit = 0,
+		.temp_dir = null
+	};
+
+	rm_vec_init(&inputs);
+
+	//Parse the options:
+	rm_int option;
+	rm_int option_index = 0;
+
+	while ((option = getopt_long(argc, argv, "vo:jh", long_options, &option_index)) != -1)
+	{
+		const rm_char* option_name = (option >= RM_TRISTRIP_OPTION_NO_TUNNELING) ? long_options[option_index].name : "";
+
+		switch (option)
+		{
+		case RM_TRISTRIP_OPTION_NO_TUNNELING: config.use_tunneling = false; break;
+		case RM_TRISTRIP_OPTION_PRESERVE_ORIENTATION: config.preserve_orientation = true; break;
+		case RM_TRISTRIP_OPTION_SPLIT_COMPONENTS: config.split_components = true; break;
+		case RM_TRISTRIP_OPTION_THREADS: config.threads_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_COST_PER_SWAP: config.cost_per_swap = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_COST_PER_PRIMITIVE_RESTART: config.cost_per_primitive_restart = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_EXACT_MAX_COUNT: config.exact_max_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_MAX_COUNT: config.max_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_NO_INCREMENTAL: config.incremental = false; break;
+		case RM_TRISTRIP_OPTION_LOOP_LIMIT: config.loop_limit = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_NO_BACKTRACK: config.backtrack_after_loop_limit = false; break;
+		case RM_TRISTRIP_OPTION_DEST_COUNT: config.dest_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_OPTIMIZE_USECS: config.optimize_usecs = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_REDUCE_SWAPS: config.reduce_swaps = true; break;
+		case RM_TRISTRIP_OPTION_RAW: is_raw = true; break;
+		case RM_TRISTRIP_OPTION_BATCH: is_batch = true; break;
+		case RM_TRISTRIP_OPTION_INPUTS_FROM: is_batch = true; read_inputs(optarg, &inputs); break;
+		case RM_TRISTRIP_OPTION_WORKERS: batch_config.threads_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_MEMORY_LIMIT: batch_config.memory_limit = parse_size(option_name, optarg) * 1024 * 1024; break;
+		case RM_TRISTRIP_OPTION_PIPELINE: is_batch = true; is_pipeline = true; break;
+		case RM_TRISTRIP_OPTION_QUEUE_CAPACITY: pipeline_config.queue_capacity = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_OUT_OF_CORE: out_of_core_config.memory_limit = parse_size(option_name, optarg) * 1024 * 1024; break;
+		case RM_TRISTRIP_OPTION_TEMP_DIR: out_of_core_config.temp_dir = optarg; break;
+		case RM_TRISTRIP_OPTION_CODEC: codec = true; break;
+		case RM_TRISTRIP_OPTION_CODEC_OUTPUT: codec = true; codec_output_path = optarg; break;
+		case RM_TRISTRIP_OPTION_CODEC_RENUMBER: codec = true; codec_renumber = true; break;
+		case RM_TRISTRIP_OPTION_DRAWS: draws = true; break;
+		case RM_TRISTRIP_OPTION_LIST_MAX_TRIS: draws = true; draws_config.list_max_tris_count = parse_size(option_name, optarg); break;
+		case RM_TRISTRIP_OPTION_HASHMAP_STATS: hashmap_stats = true; break;
+		case RM_TRISTRIP_OPTION_MEM_STATS: mem_stats = true; break;
+		case RM_TRISTRIP_OPTION_NO_HUGE_PAGES: large_config.huge_pages = false; break;
+		case RM_TRISTRIP_OPTION_PREFAULT: large_config.prefault = true; break;
+		case RM_TRISTRIP_OPTION_LARGE_THRESHOLD: large_config.threshold = parse_size(option_name, optarg) * 1024; break;
+		case 'v': verify = true; break;
+		case 'o': output_path = optarg; break;
+		case 'j': json = true; break;
+
+		case RM_TRISTRIP_OPTION_REORDER:
+			if (strcmp(optarg, "none") == 0)
+			{
+				config.reorder_algorithm = RM_TRISTRIPPER_REORDER_ALGORITHM_NONE;
+			}
+			else if (strcmp(optarg, "bfs") == 0)
+			{
+				config.reorder_algorithm = RM_TRISTRIPPER_REORDER_ALGORITHM_BFS;
+			}
+			else
+			{
+				rm_exit("Invalid value for \"--reorder\": \"%s\"", optarg);
+			}
+
+			break;
+
+		case RM_TRISTRIP_OPTION_PREPROC:
+			if (strcmp(optarg, "isolated") == 0)
+			{
+				config.preproc_algorithm = RM_TRISTRIPPER_PREPROC_ALGORITHM_ISOLATED;
+			}
+			else if (strcmp(optarg, "pairs") == 0)
+			{
+				config.preproc_algorithm = RM_TRISTRIPPER_PREPROC_ALGORITHM_PAIRS;
+			}
+			else if (strcmp(optarg, "stripify") == 0)
+			{
+				config.preproc_algorithm = RM_TRISTRIPPER_PREPROC_ALGORITHM_STRIPIFY;
+			}
+			else
+			{
+				rm_exit("Invalid value for \"--preproc\": \"%s\"", optarg);
+			}
+
+			break;
+
+		case 'h':
+			print_usage(rm_stdout, argv[0]);
+			return 0;
+
+		default:
+			print_usage(rm_stderr, argv[0]);
+			return 2;
+		}
+	}
+
+	rm_mem_set_large_config(&large_config);
+
+	rm_bool is_out_of_core = (out_of_core_config.memory_limit != 0);
+	rm_precond(!mem_stats || RM_MEM_TRACKING_ENABLED, "\"--mem-stats\" needs a build with -DRM_MEM_TRACKING.");
+
+	if (is_batch)
+	{
+		rm_precond(!is_out_of_core, "\"--out-of-core\" is not supported in batch mode.");
+		rm_precond(!codec, "\"--codec\" is not supported in batch mode.");
+		rm_precond(!draws, "\"--draws\" is not supported in batch mode.");
+		rm_precond(!is_raw, "\"--raw\" is not supported in batch mode (inputs with unknown extensions are raw anyway).");
+		rm_precond(!hashmap_stats, "\"--hashmap-stats\" is not supported in batch mode.");
+		rm_precond(!mem_stats, "\"--mem-stats\" is not supported in batch mode.");
+
+		//The positional arguments follow the listed inputs:
+		for (rm_int i = optind; i < argc; i++)
+		{
+			rm_tristripper_batch_input input = { .path = rm_mem_dup(argv[i], strlen(argv[i]) + 1) };
+			rm_vec_push(&inputs, input);
+		}
+
+		if (inputs.count == 0)
+		{
+			print_usage(rm_stderr, argv[0]);
+			return 2;
+		}
+
+		//Strip all tiles:
+		batch_config.verify = verify;
+		batch_config.output_path = output_path;
+
+		rm_tristripper_batch_stats batch_stats;
+		rm_tristripper_pipeline_stats pipeline_stats;
+
+		if (is_pipeline)
+		{
+			rm_precond(pipeline_config.queue_capacity >= 1, "\"--queue-capacity\" must be at least 1.");
+
+			pipeline_config.verify = verify;
+			pipeline_config.output_path = output_path;
+
+			rm_tristripper_run_pipeline(inputs.data, inputs.count, &pipeline_config, &pipeline_stats);
+			batch_stats = pipeline_stats.batch;
+		}
+		else
+		{
+			rm_tristripper_run_batch(inputs.data, inputs.count, &batch_config, &batch_stats);
+		}
+
+		//Report:
+		if (json)
+		{
+			print_batch_json(&batch_stats, &batch_config, is_pipeline ? &pipeline_config : null, is_pipeline ? &pipeline_stats : null);
+		}
+		else
+		{
+			print_batch_text(&batch_stats, &batch_config, is_pipeline ? &pipeline_config : null, is_pipeline ? &pipeline_stats : null);
+		}
+
+		//Clean up:
+		for (rm_size i = 0; i < inputs.count; i++)
+		{
+			rm_free(rm_vec_at(&inputs, i).path);
+		}
+
+		rm_vec_dispose(&inputs);
+
+		return (batch_stats.invalid_tiles_count == 0) ? 0 : 1;
+	}
+
+	if (optind != argc - 1)
+	{
+		print_usage(rm_stderr, argv[0]);
+		return 2;
+	}
+
+	rm_tristrip_report report = { .path = argv[optind] };
+
+	//Read the input. Raw files are mapped and passed to the tristripper without a copy.
+	//Out of core, the pages are loaded on demand, so they can be dropped again.
+	rm_uint64 start_nsecs = rm_time_now();
+
+	rm_tristripper_mesh_format format;
+	rm_tristripper_id_vec ids_vec;
+	rm_file_mapping mapping = { .data = null, .size = 0 };
+	const rm_tristripper_id* ids;
+	rm_size ids_count;
+
+	rm_vec_init(&ids_vec);
+
+	if (!is_raw && rm_tristripper_mesh_format_from_path(report.path, &format))
+	{
+		rm_tristripper_read_mesh(report.path, format, &ids_vec);
+
+		report.format_name = format_names[format];
+		ids = ids_vec.data;
+		ids_count = ids_vec.count;
+	}
+	else
+	{
+		mapping = is_out_of_core ? rm_file_map(report.path, RM_FILE_MAP_ACCESS_NORMAL, false) : rm_file_map(report.path, RM_FILE_MAP_ACCESS_SEQUENTIAL, true);
+		rm_precond((mapping.size % (3 * sizeof(rm_tristripper_id))) == 0, "The size of \"%s\" is not a multiple of %zu bytes.", report.path, 3 * sizeof(rm_tristripper_id));
+
+		report.format_name = "raw";
+		ids = mapping.data;
+		ids_count = mapping.size / sizeof(rm_tristripper_id);
+	}
+
+	report.read_nsecs = rm_time_now() - start_nsecs;
+	report.tris_count = ids_count / 3;
+	rm_precond(ids_count > 0, "\"%s\" does not contain any triangles.", report.path);
+
+	//Strip:
+	rm_tristripper_strip* strips;
+	config.stats = &report.stats;
+
+	start_nsecs = rm_time_now();
+
+	if (is_out_of_core)
+	{
+		//The strips are written chunk by chunk, we only keep them for verification, encoding and packing:
+		rm_tristripper_strip_vec strips_vec;
+		rm_vec_init(&strips_vec);
+
+		out_of_core_config.output_path = output_path;
+		out_of_core_config.output_func = (verify || codec || draws) ? collect_strips : null;
+		out_of_core_config.output_user_data = &strips_vec;
+
+		rm_tristripper_create_strips_out_of_core(ids, ids_count, &out_of_core_config, &out_of_core_stats);
+
+		report.stats = out_of_core_stats.stats;
+		report.out_of_core_stats = &out_of_core_stats;
+		strips = strips_vec.data;
+		report.strips_count = strips_vec.count;
+
+		struct rusage usage;
+		rm_precond(getrusage(RUSAGE_SELF, &usage) == 0, "getrusage(...) has failed: %s", strerror(errno));
+		report.max_resident_bytes = (rm_size)usage.ru_maxrss * 1024;
+	}
+	else
+	{
+		rm_tristripper_create_strips(ids, ids_count, &config, &strips, &report.strips_count);
+	}
+
+	report.strip_nsecs = rm_time_now() - start_nsecs;
+
+	//Verify:
+	if (verify)
+	{
+		start_nsecs = rm_time_now();
+
+		rm_tristripper_verifier verifier;
+		rm_tristripper_init_verifier_ex(&verifier, ids, ids_count, config.threads_count);
+		report.is_valid = rm_tristripper_verify(&verifier, strips, report.strips_count, true);
+
+		report.verify_nsecs = rm_time_now() - start_nsecs;
+		report.is_verified = true;
+
+		//The verifier hashmap is complete now, so we can take its statistics without another one:
+		if (hashmap_stats)
+		{
+			run_hashmap_stats(ids, ids_count, &verifier, &report);
+		}
+
+		rm_tristripper_dispose_verifier(&verifier);
+	}
+	else if (hashmap_stats)
+	{
+		run_hashmap_stats(ids, ids_count, null, &report);
+	}
+
+	//Write (out of core, this has happened on the way):
+	if (output_path && !is_out_of_core)
+	{
+		start_nsecs = rm_time_now();
+
+		rm_tristripper_strip_file_writer writer;
+		rm_tristripper_strip_file_writer_open(&writer, output_path);
+		rm_tristripper_strip_file_writer_add_tile(&writer, strips, report.strips_count, &report.stats);
+		rm_tristripper_strip_file_writer_close(&writer);
+
+		report.write_nsecs = rm_time_now() - start_nsecs;
+	}
+
+	//Encode:
+	if (codec)
+	{
+		run_codec(strips, report.strips_count, codec_renumber, codec_output_path, &report);
+	}
+
+	//Pack:
+	if (draws)
+	{
+		run_draws(strips, report.strips_count, &draws_config, verify, ids, ids_count, &report);
+	}
+
+	//Take the memory statistics after all phases (the peaks are the ones of the phases):
+	if (mem_stats)
+	{
+		for (rm_size i = 0; i <= RM_MEM_TAGS_COUNT; i++)
+		{
+			rm_mem_get_stats((rm_mem_tag)i, &report.mem_stats[i]);
+		}
+
+		report.has_mem_stats = true;
+	}
+
+	//Report:
+	if (json)
+	{
+		print_json(&report, &config);
+	}
+	else
+	{
+		print_text(&report, &config);
+	}
+
+	//Clean up:
+	rm_tristripper_dispose_strips(strips, report.strips_count);
+	rm_vec_dispose(&ids_vec);
+
+	if (mapping.data)
+	{
+		rm_file_unmap(&mapping);
+	}
+
+	return (report.is_verified && !report.is_valid) ? 1 : 0;
+}
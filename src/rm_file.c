@@ -1,7 +1,47 @@
 #include "rm_file.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//Is the host little endian? Then LE arrays can be written without swapping.
+#define RM_FILE_HOST_IS_LE (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
 #define RM_FILE_ASSERT_OFF_T_64_BIT() rm_assert(sizeof(rm_file_offset) >= 8, "off_t is not sufficient for 64 bit offsets.");
 
+//Translate an access hint for "madvise(...)":
+static rm_int rm_file_map_access_to_advice(rm_file_map_access access);
+
+//Map the file behind a descriptor. "path" is only used in error messages.
+static rm_file_mapping rm_file_map_fd(rm_int fd, const rm_char* path, rm_file_map_access access, rm_bool populate);
+
+static rm_int rm_file_map_access_to_advice(rm_file_map_access access)
+{
+	switch (access)
+	{
+	case RM_FILE_MAP_ACCESS_NORMAL:
+
+		return MADV_NORMAL;
+
+	case RM_FILE_MAP_ACCESS_SEQUENTIAL:
+
+		return MADV_SEQUENTIAL;
+
+	case RM_FILE_MAP_ACCESS_RANDOM:
+
+		return MADV_RANDOM;
+
+	case RM_FILE_MAP_ACCESS_DONE:
+
+		return MADV_DONTNEED;
+
+	default:
+
+		rm_exit("Invalid map access");
+	}
+}
+
 rm_file rm_file_open(const rm_char* path, rm_file_mode mode, rm_file_enc enc)
 {
 	//Build a mode string for fopen:
@@ -70,6 +110,35 @@ rm_file rm_file_open(const rm_char* path, rm_file_mode mode, rm_file_enc enc)
 	return file;
 }
 
+rm_file rm_file_open_temp(const rm_char* dir)
+{
+	if (!dir)
+	{
+		dir = getenv("TMPDIR");
+		dir = (dir && (dir[0] != '\0')) ? dir : "/tmp";
+	}
+
+	//Build a template for "mkstemp(...)":
+	static const rm_char name_template[] = "/rm_temp_XXXXXX";
+	rm_size dir_length = strlen(dir);
+	rm_char* path = rm_malloc(dir_length + sizeof(name_template));
+
+	memcpy(path, dir, dir_length);
+	memcpy(path + dir_length, name_template, sizeof(name_template));
+
+	rm_int fd = mkstemp(path);
+	rm_precond(fd >= 0, "Failed to create a temporary file in %s: %s", dir, strerror(errno));
+
+	//The open descriptor keeps the file alive without a name:
+	unlink(path);
+	rm_free(path);
+
+	rm_file file = fdopen(fd, "w+b");
+	rm_precond(file, "fdopen(...) has failed: %s", strerror(errno));
+
+	return file;
+}
+
 rm_void rm_file_close(rm_file file)
 {
 	//Just delegate to fclose(...):
@@ -129,6 +198,234 @@ rm_void rm_file_flush(rm_file file)
 	rm_precond(result == 0, "fflush(...) has failed.");
 }
 
+rm_bool rm_file_get_size(rm_file file, rm_file_offset* size)
+{
+	rm_assert(size, "Passed size outpointer must be valid.");
+
+	struct stat file_stat;
+	rm_precond(fstat(fileno(file), &file_stat) == 0, "fstat(...) has failed: %s", strerror(errno));
+
+	if (!S_ISREG(file_stat.st_mode))
+	{
+		return false;
+	}
+
+	*size = file_stat.st_size;
+	return true;
+}
+
+static rm_file_mapping rm_file_map_fd(rm_int fd, const rm_char* path, rm_file_map_access access, rm_bool populate)
+{
+	rm_file_mapping mapping = { .data = null, .size = 0 };
+
+	//Determine the size of the file:
+	struct stat file_stat;
+	rm_precond(fstat(fd, &file_stat) == 0, "fstat(...) has failed: %s", strerror(errno));
+
+	mapping.size = (rm_size)file_stat.st_size;
+
+	//Empty files can't be mapped:
+	if (mapping.size > 0)
+	{
+		rm_int flags = MAP_PRIVATE;
+
+#ifdef MAP_POPULATE
+		if (populate)
+		{
+			flags |= MAP_POPULATE;
+		}
+#else
+		rm_unused(populate);
+#endif
+
+		rm_void* data = mmap(null, mapping.size, PROT_READ, flags, fd, 0);
+		rm_precond(data != MAP_FAILED, "Failed to map file: %s (%s)", path, strerror(errno));
+
+		mapping.data = data;
+
+		//The hint is not critical, so we don't care if it fails:
+		madvise(data, mapping.size, rm_file_map_access_to_advice(access));
+	}
+
+	return mapping;
+}
+
+rm_file_mapping rm_file_map(const rm_char* path, rm_file_map_access access, rm_bool populate)
+{
+	rm_int fd = open(path, O_RDONLY);
+	rm_precond(fd >= 0, "Failed to open file: %s", path);
+
+	rm_file_mapping mapping = rm_file_map_fd(fd, path, access, populate);
+
+	//The mapping stays valid without the descriptor:
+	close(fd);
+
+	return mapping;
+}
+
+rm_file_mapping rm_file_map_open(rm_file file, rm_file_map_access access, rm_bool populate)
+{
+	return rm_file_map_fd(fileno(file), "(open file)", access, populate);
+}
+
+rm_void rm_file_map_advise(const rm_file_mapping* mapping, rm_size offset, rm_size size, rm_file_map_access access)
+{
+	rm_assert(mapping, "Passed mapping must be valid.");
+	rm_assert((offset <= mapping->size) && (size <= mapping->size - offset), "Range exceeds the mapping.");
+
+	if (size == 0)
+	{
+		return;
+	}
+
+	//"madvise(...)" needs a page-aligned start:
+	rm_size page_size = (rm_size)sysconf(_SC_PAGESIZE);
+	rm_size aligned_offset = (offset / page_size) * page_size;
+
+	madvise((rm_uint8*)mapping->data + aligned_offset, size + (offset - aligned_offset), rm_file_map_access_to_advice(access));
+}
+
+rm_void rm_file_unmap(const rm_file_mapping* mapping)
+{
+	rm_assert(mapping, "Passed mapping must be valid.");
+
+	if (mapping->data)
+	{
+		munmap((rm_void*)mapping->data, mapping->size);
+	}
+}
+
+rm_size rm_file_read_at(rm_file file, rm_file_offset offset, rm_void* dest_ptr, rm_size size)
+{
+	//Make sure we have 64 bit offsets:
+	RM_FILE_ASSERT_OFF_T_64_BIT();
+
+	rm_int fd = fileno(file);
+	rm_uint8* dest = dest_ptr;
+	rm_size read_size = 0;
+
+	//"pread(...)" might read less than requested, zero means EOF:
+	while (read_size < size)
+	{
+		ssize_t result = pread(fd, dest + read_size, size - read_size, offset + (rm_file_offset)read_size);
+		rm_precond(result >= 0, "pread(...) has failed: %s", strerror(errno));
+
+		if (result == 0)
+		{
+			break;
+		}
+
+		read_size += (rm_size)result;
+	}
+
+	return read_size;
+}
+
+rm_void rm_file_write_at(rm_file file, rm_file_offset offset, const rm_void* src_ptr, rm_size size)
+{
+	//Make sure we have 64 bit offsets:
+	RM_FILE_ASSERT_OFF_T_64_BIT();
+
+	rm_int fd = fileno(file);
+	const rm_uint8* src = src_ptr;
+
+	//"pwrite(...)" might write less than requested:
+	while (size > 0)
+	{
+		ssize_t result = pwrite(fd, src, size, offset);
+		rm_precond(result > 0, "pwrite(...) has failed: %s", strerror(errno));
+
+		src += result;
+		size -= (rm_size)result;
+		offset += (rm_file_offset)result;
+	}
+}
+
+rm_void rm_file_writer_init(rm_file_writer* writer, rm_file file, rm_size capacity)
+{
+	rm_assert(writer, "Passed writer must be valid.");
+	rm_precond(capacity > 0, "The capacity of a writer must be > 0.");
+
+	writer->file = file;
+	writer->buf = rm_malloc(capacity);
+	writer->capacity = capacity;
+	writer->count = 0;
+	writer->is_positioned = false;
+	writer->offset = 0;
+}
+
+rm_void rm_file_writer_init_at(rm_file_writer* writer, rm_file file, rm_file_offset offset, rm_size capacity)
+{
+	rm_file_writer_init(writer, file, capacity);
+
+	writer->is_positioned = true;
+	writer->offset = offset;
+}
+
+rm_void rm_file_writer_flush(rm_file_writer* writer)
+{
+	rm_assert(writer, "Passed writer must be valid.");
+
+	if (writer->is_positioned)
+	{
+		rm_file_write_at(writer->file, writer->offset, writer->buf, writer->count);
+		writer->offset += (rm_file_offset)writer->count;
+	}
+	else
+	{
+		rm_file_write(writer->file, writer->buf, writer->count);
+		rm_file_flush(writer->file);
+	}
+
+	writer->count = 0;
+}
+
+rm_void rm_file_writer_dispose(rm_file_writer* writer)
+{
+	rm_file_writer_flush(writer);
+	rm_free(writer->buf);
+}
+
+//The array writers are identical except for the type and the swap:
+#define RM_FILE_WRITER_DEFINE_ARRAY(bits)                                                                              	\
+rm_void rm_file_writer_write_uint##bits##_array(rm_file_writer* writer, const rm_uint##bits* values, rm_size count)	\
+{                                                                                                                      	\
+	if (RM_FILE_HOST_IS_LE)                                                                                            	\
+	{                                                                                                                  	\
+		rm_file_writer_write(writer, values, count * sizeof(rm_uint##bits));                                           	\
+		return;                                                                                                        	\
+	}                                                                                                                  	\
+                                                                                                                       	\
+	/* Swap as many values into the buffer as fit, then make room: */                                                  	\
+	while (count > 0)                                                                                                  	\
+	{                                                                                                                  	\
+		rm_size chunk_count = rm_min(count, (writer->capacity - writer->count) / sizeof(rm_uint##bits));               	\
+                                                                                                                       	\
+		if (chunk_count == 0)                                                                                          	\
+		{                                                                                                              	\
+			rm_file_writer_flush(writer);                                                                              	\
+			chunk_count = rm_min(count, writer->capacity / sizeof(rm_uint##bits));                                     	\
+			rm_precond(chunk_count > 0, "The buffer of the writer is too small for a single value.");                 	\
+		}                                                                                                              	\
+                                                                                                                       	\
+		rm_uint8* dest = writer->buf + writer->count;                                                                  	\
+                                                                                                                       	\
+		for (rm_size i = 0; i < chunk_count; i++)                                                                      	\
+		{                                                                                                              	\
+			rm_uint##bits value = rm_flip_host_to_le_##bits(values[i]);                                                	\
+			rm_mem_copy(dest + (i * sizeof(rm_uint##bits)), &value, sizeof(rm_uint##bits));                            	\
+		}                                                                                                              	\
+                                                                                                                       	\
+		writer->count += chunk_count * sizeof(rm_uint##bits);                                                          	\
+		values += chunk_count;                                                                                         	\
+		count -= chunk_count;                                                                                          	\
+	}                                                                                                                  	\
+}
+
+RM_FILE_WRITER_DEFINE_ARRAY(16)
+RM_FILE_WRITER_DEFINE_ARRAY(32)
+RM_FILE_WRITER_DEFINE_ARRAY(64)
+
 //Emit non-inline versions:
 extern rm_size rm_file_read(rm_file file, rm_void* dest_ptr, rm_size size);
 extern rm_bool rm_file_read_line(rm_file file, rm_char* buf, rm_size count);
@@ -143,3 +440,12 @@ extern rm_void rm_file_write_uint32(rm_file file, rm_uint32 value);
 extern rm_void rm_file_write_int32(rm_file file, rm_int32 value);
 extern rm_void rm_file_write_uint64(rm_file file, rm_uint64 value);
 extern rm_void rm_file_write_int64(rm_file file, rm_int64 value);
+extern rm_void rm_file_writer_write(rm_file_writer* writer, const rm_void* src_ptr, rm_size size);
+extern rm_void rm_file_writer_write_uint8(rm_file_writer* writer, rm_uint8 value);
+extern rm_void rm_file_writer_write_int8(rm_file_writer* writer, rm_int8 value);
+extern rm_void rm_file_writer_write_uint16(rm_file_writer* writer, rm_uint16 value);
+extern rm_void rm_file_writer_write_int16(rm_file_writer* writer, rm_int16 value);
+extern rm_void rm_file_writer_write_uint32(rm_file_writer* writer, rm_uint32 value);
+extern rm_void rm_file_writer_write_int32(rm_file_writer* writer, rm_int32 value);
+extern rm_void rm_file_writer_write_uint64(rm_file_writer* writer, rm_uint64 value);
+extern rm_void rm_file_writer_write_int64(rm_file_writer* writer, rm_int64 value);
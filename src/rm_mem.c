@@ -1,6 +1,16 @@
 #include "rm_mem.h"
 
+#include "rm_thread.h"
+
 //Emit non-inline versions:
+extern const rm_mem_allocator* rm_mem_push_allocator(const rm_mem_allocator* allocator);
+extern rm_void rm_mem_pop_allocator(const rm_mem_allocator* previous_allocator);
+extern const rm_mem_allocator* rm_mem_get_allocator(rm_void);
+extern rm_void* rm_mem_alloc_block(rm_size alignment, rm_size size, rm_bool zero);
+extern rm_void* rm_mem_realloc_block(rm_void* block, rm_size size);
+extern rm_void rm_mem_free_block(rm_void* block);
+extern rm_mem_tag rm_mem_push_tag(rm_mem_tag tag);
+extern rm_void rm_mem_pop_tag(rm_mem_tag previous_tag);
 extern rm_void* rm_malloc(rm_size size);
 extern rm_void* rm_malloc_zero(rm_size size);
 extern rm_void* rm_realloc(rm_void* ptr, rm_size size);
@@ -18,3 +28,196 @@ extern rm_size rm_mem_get_page_bytes(rm_void);
 extern rm_size rm_mem_get_physical_bytes(rm_void);
 extern rm_void rm_mem_lock(const rm_void* ptr, rm_size size);
 extern rm_void rm_mem_unlock(const rm_void* ptr, rm_size size);
+
+__thread const rm_mem_allocator* rm_mem_current_allocator = null;
+
+static rm_mem_large_config rm_mem_large_current_config =
+{
+	.threshold = RM_MEM_LARGE_DEFAULT_THRESHOLD,
+	.huge_pages = true,
+	.prefault = false
+};
+
+//Advise the kernel about a new large block:
+static rm_void rm_mem_advise_large(rm_void* ptr, rm_size size);
+
+#ifdef RM_MEM_TRACKING
+//The counters for every tag and (at the end) for all of them together.
+//All fields must be accessed atomically.
+static rm_mem_stats rm_mem_tag_stats[RM_MEM_TAGS_COUNT + 1];
+
+__thread rm_mem_tag rm_mem_current_tag = RM_MEM_TAG_OTHER;
+
+//Count an allocation resp. a release for a single counter:
+static rm_void rm_mem_stats_add(rm_mem_stats* stats, rm_size size);
+static rm_void rm_mem_stats_remove(rm_mem_stats* stats, rm_size size);
+
+static rm_void rm_mem_stats_add(rm_mem_stats* stats, rm_size size)
+{
+	rm_size live_bytes = rm_atomic_fetch_add(&stats->live_bytes, size) + size;
+	rm_size peak_bytes = rm_atomic_load(&stats->peak_bytes);
+
+	//Raise the peak unless another thread has raised it even further:
+	while ((live_bytes > peak_bytes) && !rm_atomic_compare_exchange(&stats->peak_bytes, &peak_bytes, live_bytes))
+	{
+	}
+
+	rm_atomic_fetch_add(&stats->allocs_count, 1);
+}
+
+static rm_void rm_mem_stats_remove(rm_mem_stats* stats, rm_size size)
+{
+	rm_atomic_fetch_sub(&stats->live_bytes, size);
+}
+
+rm_void* rm_mem_track(rm_void* block, rm_size offset, rm_size size, rm_mem_tag tag)
+{
+	rm_assert(tag < RM_MEM_TAGS_COUNT, "Invalid memory tag: %d", (rm_int)tag);
+
+	rm_uint8* ptr = (rm_uint8*)block + offset;
+
+	*(rm_mem_header*)(ptr - sizeof(rm_mem_header)) = (rm_mem_header)
+	{
+		.size = size,
+		.tag = (rm_uint32)tag,
+		.offset = (rm_uint32)offset
+	};
+
+	rm_mem_stats_add(&rm_mem_tag_stats[tag], size);
+	rm_mem_stats_add(&rm_mem_tag_stats[RM_MEM_TAGS_COUNT], size);
+
+	return ptr;
+}
+
+rm_void* rm_mem_untrack(const rm_void* ptr, rm_mem_header* header)
+{
+	*header = *(const rm_mem_header*)((const rm_uint8*)ptr - sizeof(rm_mem_header));
+
+	rm_mem_stats_remove(&rm_mem_tag_stats[header->tag], header->size);
+	rm_mem_stats_remove(&rm_mem_tag_stats[RM_MEM_TAGS_COUNT], header->size);
+
+	return (rm_uint8*)ptr - header->offset;
+}
+#endif
+
+rm_void rm_mem_get_stats(rm_mem_tag tag, rm_mem_stats* stats)
+{
+	rm_assert(tag <= RM_MEM_TAGS_COUNT, "Invalid memory tag: %d", (rm_int)tag);
+	rm_assert(stats, "Passed stats must be valid.");
+
+#ifdef RM_MEM_TRACKING
+	*stats = (rm_mem_stats)
+	{
+		.live_bytes = rm_atomic_load(&rm_mem_tag_stats[tag].live_bytes),
+		.peak_bytes = rm_atomic_load(&rm_mem_tag_stats[tag].peak_bytes),
+		.allocs_count = rm_atomic_load(&rm_mem_tag_stats[tag].allocs_count)
+	};
+#else
+	rm_unused(tag);
+	*stats = (rm_mem_stats) { .live_bytes = 0, .peak_bytes = 0, .allocs_count = 0 };
+#endif
+}
+
+rm_void rm_mem_reset_peaks(rm_void)
+{
+#ifdef RM_MEM_TRACKING
+	for (rm_size i = 0; i <= RM_MEM_TAGS_COUNT; i++)
+	{
+		rm_atomic_store(&rm_mem_tag_stats[i].peak_bytes, rm_atomic_load(&rm_mem_tag_stats[i].live_bytes));
+	}
+#endif
+}
+
+const rm_char* rm_mem_tag_get_name(rm_mem_tag tag)
+{
+	switch (tag)
+	{
+	case RM_MEM_TAG_OTHER: return "other";
+	case RM_MEM_TAG_BUILD_TRIS: return "build_tris";
+	case RM_MEM_TAG_HASHMAP: return "hashmap";
+	case RM_MEM_TAG_STRIPS: return "strips";
+	case RM_MEM_TAG_TUNNEL_STACK: return "tunnel_stack";
+	case RM_MEM_TAG_VERIFIER: return "verifier";
+	default: return "total";
+	}
+}
+
+rm_void rm_mem_set_large_config(const rm_mem_large_config* config)
+{
+	rm_assert(config, "Passed config must be valid.");
+	rm_mem_large_current_config = *config;
+}
+
+rm_void rm_mem_get_large_config(rm_mem_large_config* config)
+{
+	rm_assert(config, "Passed config must be valid.");
+	*config = rm_mem_large_current_config;
+}
+
+static rm_void rm_mem_advise_large(rm_void* ptr, rm_size size)
+{
+	//Blocks from an allocator are none of our business:
+	if ((size < rm_mem_large_current_config.threshold) || rm_mem_current_allocator)
+	{
+		return;
+	}
+
+	//madvise(...) works on whole pages, so we advise all the pages the block touches.
+	//The first and last one might be shared with other blocks, but advice does not change any contents.
+	//If we left them out, glibc's mapping would be split in two and realloc(...) could no longer mremap(...) it, but would copy.
+	rm_uword page_bytes = (rm_uword)rm_mem_get_page_bytes();
+	rm_uword start = (rm_uword)ptr & ~(page_bytes - 1);
+	rm_uword end = ((rm_uword)ptr + size + page_bytes - 1) & ~(page_bytes - 1);
+
+	//This is only advice, so failures (e. g. kernels without THP) are fine.
+	//The advice must come first, otherwise the prefault would map small pages.
+	if (rm_mem_large_current_config.huge_pages)
+	{
+		madvise((rm_void*)start, end - start, MADV_HUGEPAGE);
+	}
+
+	if (rm_mem_large_current_config.prefault)
+	{
+		//"RM_MEM_NO_POPULATE_WRITE" forces the fallback below (for testing).
+#if defined(MADV_POPULATE_WRITE) && !defined(RM_MEM_NO_POPULATE_WRITE)
+		if (madvise((rm_void*)start, end - start, MADV_POPULATE_WRITE) == 0)
+		{
+			return;
+		}
+#endif
+		//Older kernels can't populate on request, so we touch every page on our own.
+		//A block from rm_realloc_large(...) holds live data, so every byte is written back as it is.
+		//We stick to the pages that lie completely inside the block, the others might be written by other threads in the meantime.
+		for (rm_uword page = ((rm_uword)ptr + page_bytes - 1) & ~(page_bytes - 1); page + page_bytes <= (rm_uword)ptr + size; page += page_bytes)
+		{
+			volatile rm_uint8* byte = (rm_uint8*)page;
+			*byte = *byte;
+		}
+	}
+}
+
+rm_void* rm_malloc_large(rm_size size)
+{
+	rm_void* ptr = rm_malloc(size);
+	rm_mem_advise_large(ptr, size);
+
+	return ptr;
+}
+
+rm_void* rm_malloc_large_zero(rm_size size)
+{
+	//calloc(...) does not touch fresh mappings, so the advice still comes in time:
+	rm_void* ptr = rm_malloc_zero(size);
+	rm_mem_advise_large(ptr, size);
+
+	return ptr;
+}
+
+rm_void* rm_realloc_large(rm_void* ptr, rm_size size)
+{
+	//The block might have moved to a new mapping or grown into one:
+	ptr = rm_realloc(ptr, size);
+	rm_mem_advise_large(ptr, size);
+
+	return ptr;
+}
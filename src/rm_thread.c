@@ -0,0 +1,117 @@
+#include "rm_thread.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+#include "rm_mem.h"
+
+//The start of a new thread: Its entry point and everything it inherits from its creator.
+typedef struct __rm_thread_start__
+{
+	rm_thread_func func;
+	rm_void* arg;
+	const rm_mem_allocator* allocator;
+} rm_thread_start;
+
+//The actual entry point of all our threads.
+//It installs the inherited state and calls the entry point of the creator.
+static rm_void* rm_thread_run(rm_void* arg);
+
+static rm_void* rm_thread_run(rm_void* arg)
+{
+	rm_thread_start start = *(rm_thread_start*)arg;
+
+	//The start has been allocated with the allocator of the creator, so we can free it right after installing the allocator:
+	rm_mem_push_allocator(start.allocator);
+	rm_free(arg);
+
+	return start.func(start.arg);
+}
+
+rm_void rm_thread_create(rm_thread* thread, rm_thread_func func, rm_void* arg)
+{
+	rm_thread_start* start = rm_malloc(sizeof(rm_thread_start));
+
+	*start = (rm_thread_start)
+	{
+		.func = func,
+		.arg = arg,
+		.allocator = rm_mem_get_allocator()
+	};
+
+	//Delegate to pthread_create(...) with default attributes:
+	rm_int result = pthread_create(thread, null, rm_thread_run, start);
+	rm_precond(result == 0, "pthread_create() has failed: %s", strerror(result));
+}
+
+rm_void* rm_thread_join(rm_thread thread)
+{
+	//Delegate to pthread_join(...) and pass the result through:
+	rm_void* thread_result;
+	rm_int result = pthread_join(thread, &thread_result);
+	rm_precond(result == 0, "pthread_join() has failed: %s", strerror(result));
+
+	return thread_result;
+}
+
+rm_size rm_thread_get_processors_count(rm_void)
+{
+	//sysconf(...) might fail and return -1, so stay >= 1:
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (count < 1) ? 1 : (rm_size)count;
+}
+
+rm_void rm_thread_yield(rm_void)
+{
+	//sched_yield(...) always succeeds on Linux:
+	sched_yield();
+}
+
+rm_void rm_thread_sleep(rm_uint64 nsecs)
+{
+	struct timespec ts =
+	{
+		.tv_sec = (time_t)(nsecs / 1000000000),
+		.tv_nsec = (long)(nsecs % 1000000000)
+	};
+
+	//Continue with the remaining time if a signal interrupts us:
+	while (nanosleep(&ts, &ts) != 0)
+	{
+		rm_precond(errno == EINTR, "nanosleep() has failed: %s", strerror(errno));
+	}
+}
+
+rm_void rm_spsc_queue_init(rm_spsc_queue* queue, rm_size capacity)
+{
+	rm_precond(capacity >= 1, "A queue needs room for at least one pointer.");
+
+	*queue = (rm_spsc_queue)
+	{
+		.slots = rm_malloc(capacity * sizeof(rm_void*)),
+		.capacity = capacity,
+		.head = 0,
+		.tail = 0
+	};
+}
+
+rm_void rm_spsc_queue_dispose(rm_spsc_queue* queue)
+{
+	rm_free(queue->slots);
+	queue->slots = null;
+}
+
+//Emit non-inline versions:
+extern rm_void rm_mutex_init(rm_mutex* mutex);
+extern rm_void rm_mutex_dispose(rm_mutex* mutex);
+extern rm_void rm_mutex_lock(rm_mutex* mutex);
+extern rm_void rm_mutex_unlock(rm_mutex* mutex);
+extern rm_void rm_cond_init(rm_cond* cond);
+extern rm_void rm_cond_dispose(rm_cond* cond);
+extern rm_void rm_cond_wait(rm_cond* cond, rm_mutex* mutex);
+extern rm_void rm_cond_signal(rm_cond* cond);
+extern rm_void rm_cond_broadcast(rm_cond* cond);
+extern rm_bool rm_spsc_queue_try_push(rm_spsc_queue* queue, rm_void* item);
+extern rm_bool rm_spsc_queue_try_pop(rm_spsc_queue* queue, rm_void** item);
@@ -0,0 +1,5 @@
+#include "rm_time.h"
+
+//Emit non-inline versions:
+extern rm_uint64 rm_time_now(rm_void);
+extern rm_double rm_time_to_secs(rm_uint64 nsecs);
@@ -1,8 +1,16 @@
 #include "rm_tristripper.h"
 
+#include "rm_mem.h"
 #include "rm_tristripper_tri.h"
-#include "rm_tristripper_simple.h"
-#include "rm_tristripper_ex.h"
+#include "rm_tristripper_components.h"
+
+//Strip the given triangles.
+//If "context" is not null, "*tris" is its triangle array and its memory is used for everything else.
+static rm_void rm_tristripper_strip_tris(rm_tristripper_context* context, rm_tristripper_tri** tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count);
+
+//Renumber the triangles in BFS order (see "rm_tristripper_reorder_tris(...)").
+//If "context" is not null, its spare array is used instead of a new one.
+static rm_void rm_tristripper_reorder_tris_with_context(rm_tristripper_context* context, rm_tristripper_tri** tris, rm_size tris_count, rm_size_vec* component_offsets);
 
 rm_void rm_tristripper_create_strips(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count)
 {
@@ -22,6 +30,7 @@ rm_void rm_tristripper_create_strips(const rm_tristripper_id* ids, rm_size ids_c
 	//Validate the input parameters:
 	rm_precond(ids, "Passed IDs must be valid.");
 	rm_precond(config, "Passed config must be valid.");
+	rm_precond(config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
 
 	//Build triangles from the given ids:
 	rm_tristripper_tri* tris;
@@ -29,26 +38,144 @@ rm_void rm_tristripper_create_strips(const rm_tristripper_id* ids, rm_size ids_c
 
 	rm_tristripper_build_tris(ids, ids_count, &tris, &tris_count);
 
+	//Strip them:
+	rm_tristripper_create_strips_from_tris(&tris, tris_count, config, strips, strips_count);
+
+	//Free the triangles:
+	rm_free(tris);
+}
+
+rm_void rm_tristripper_create_strips_with_context(rm_tristripper_context* context, const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Validate the output parameters:
+	rm_assert(context, "Passed context must be valid.");
+	rm_assert(strips, "Passed strip outpointer must be valid.");
+	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
+
+	//Catch the trivial cases:
+	if (ids_count < 3)
+	{
+		*strips = null;
+		*strips_count = 0;
+
+		return;
+	}
+
+	//Validate the input parameters:
+	rm_precond(ids, "Passed IDs must be valid.");
+	rm_precond(config, "Passed config must be valid.");
+	rm_precond(config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
+	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
+
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_BUILD_TRIS);
+
+	//Make room for the triangles.
+	//The old ones are garbage, so we don't have to keep them. The spare array is allocated again on demand.
+	rm_size expected_tris_count = ids_count / 3;
+
+	if (expected_tris_count > context->tris_capacity)
+	{
+		rm_free(context->tris);
+		rm_free(context->spare_tris);
+
+		context->tris_capacity = rm_max(expected_tris_count, 2 * context->tris_capacity);
+		context->tris = rm_malloc_large(context->tris_capacity * sizeof(rm_tristripper_tri));
+		context->spare_tris = null;
+	}
+
+	//Reinitialize the hashmap if its buckets are too few for this mesh or far too many (clearing them would cost more than allocating):
+	rm_size bucket_count = rm_hashmap_get_sufficient_bucket_count(ids_count, RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR);
+
+	if ((context->open_edges.buckets_count < bucket_count) || ((context->open_edges.buckets_count / 4) > bucket_count))
+	{
+		rm_mem_push_tag(RM_MEM_TAG_HASHMAP);
+		rm_tristripper_open_edge_hashmap_dispose(&context->open_edges);
+		rm_tristripper_open_edge_hashmap_init_ex(&context->open_edges, bucket_count, RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR);
+	}
+
+	//Build and stitch the triangles, then leave an empty hashmap for the next call:
+	rm_size tris_count = rm_tristripper_build_tris_into(ids, ids_count, context->tris, &context->open_edges, null);
+	rm_tristripper_open_edge_hashmap_clear(&context->open_edges);
+
+	rm_mem_pop_tag(previous_mem_tag);
+
+	//Strip them:
+	rm_tristripper_strip_tris(context, &context->tris, tris_count, config, strips, strips_count);
+}
+
+rm_void rm_tristripper_create_strips_from_tris(rm_tristripper_tri** tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangle pointer must be valid.");
+	rm_assert(strips, "Passed strip outpointer must be valid.");
+	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
+	rm_precond(config, "Passed config must be valid.");
+	rm_precond(config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
+
+	rm_tristripper_strip_tris(null, tris, tris_count, config, strips, strips_count);
+}
+
+static rm_void rm_tristripper_strip_tris(rm_tristripper_context* context, rm_tristripper_tri** tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Without a context, the scratch of the calling thread lives as long as this call:
+	rm_tristripper_scratch local_scratch;
+	rm_tristripper_scratch* scratch = &local_scratch;
+
+	if (context)
+	{
+		scratch = &context->scratch;
+	}
+	else
+	{
+		rm_tristripper_init_scratch(&local_scratch);
+	}
+
+	//Collect statistics about the process on the way:
+	rm_tristripper_process_stats process_stats = { 0 };
+
+	//Everything we allocate from here on is part of the strips (the worker threads of the components tag their memory on their own):
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_STRIPS);
+
 	//Are there triangles at all?
 	if (tris_count > 0)
 	{
-		//Tunneling or stripify-only?
-		if (config->use_tunneling)
+		if (config->split_components)
 		{
-			//We want to perform tunneling.
-			//The maximum size of a tunnel should be limited to the maximum number of triangles (except that is below 2 or above UINT16_MAX).
-			//It is also a stupid idea to use an odd value because all tunnels need an even count.
-			//So let's perform truncation here.
-			config->max_count = rm_min(rm_min(config->max_count, tris_count), (rm_size)UINT16_MAX);
-			config->max_count = rm_max((config->max_count / 2) * 2, (rm_size)2);
-
-			//Apply the extended "tunneling" algorithm:
-			rm_tristripper_create_strips_ex(tris, tris_count, config, strips, strips_count);
+			//Renumber the triangles in BFS order.
+			//This makes the connected components contiguous and tells us where they start.
+			rm_size_vec local_component_offsets;
+			rm_size_vec* component_offsets = &local_component_offsets;
+
+			if (context)
+			{
+				component_offsets = &context->component_offsets;
+				rm_vec_clear(component_offsets);
+			}
+			else
+			{
+				rm_vec_init(&local_component_offsets);
+			}
+
+			rm_tristripper_reorder_tris_with_context(context, tris, tris_count, component_offsets);
+
+			//Strip all the components on their own:
+			rm_tristripper_create_strips_components(*tris, tris_count, component_offsets->data, component_offsets->count, config, &process_stats, scratch, strips, strips_count);
+
+			if (!context)
+			{
+				rm_vec_dispose(&local_component_offsets);
+			}
 		}
 		else
 		{
-			//Apply the simple "stripify" algorithm:
-			rm_tristripper_create_strips_simple(tris, tris_count, config->preserve_orientation, strips, strips_count);
+			//Renumber the triangles for better cache locality if desired:
+			if (config->reorder_algorithm == RM_TRISTRIPPER_REORDER_ALGORITHM_BFS)
+			{
+				rm_tristripper_reorder_tris_with_context(context, tris, tris_count, null);
+			}
+
+			//Strip the whole mesh at once:
+			rm_tristripper_create_strips_component(*tris, tris_count, config, &process_stats, scratch, strips, strips_count);
 		}
 	}
 	else
@@ -57,8 +184,47 @@ rm_void rm_tristripper_create_strips(const rm_tristripper_id* ids, rm_size ids_c
 		*strips_count = 0;
 	}
 
-	//Free the triangles:
-	rm_free(tris);
+	rm_mem_pop_tag(previous_mem_tag);
+
+	if (!context)
+	{
+		rm_tristripper_dispose_scratch(&local_scratch);
+	}
+
+	//Report the statistics if desired:
+	if (config->stats)
+	{
+		rm_tristripper_calculate_stats(*strips, *strips_count, config->stats);
+		config->stats->process = process_stats;
+	}
+}
+
+static rm_void rm_tristripper_reorder_tris_with_context(rm_tristripper_context* context, rm_tristripper_tri** tris, rm_size tris_count, rm_size_vec* component_offsets)
+{
+	if (!context)
+	{
+		rm_tristripper_reorder_tris(tris, tris_count, component_offsets);
+
+		return;
+	}
+
+	rm_assert(*tris == context->tris, "Passed triangles must belong to the context.");
+
+	//Allocate the spare array on first use:
+	if (!context->spare_tris)
+	{
+		rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_BUILD_TRIS);
+		context->spare_tris = rm_malloc_large(context->tris_capacity * sizeof(rm_tristripper_tri));
+		rm_mem_pop_tag(previous_mem_tag);
+	}
+
+	//Reorder into the spare array and swap the two:
+	rm_tristripper_reorder_tris_into(context->tris, tris_count, context->spare_tris, component_offsets);
+
+	rm_tristripper_tri* new_tris = context->spare_tris;
+	context->spare_tris = context->tris;
+	context->tris = new_tris;
+	*tris = new_tris;
 }
 
 rm_void rm_tristripper_dispose_strips(const rm_tristripper_strip* strips, rm_size strips_count)
@@ -0,0 +1,841 @@
+#include "rm_tristripper_batch.h"
+
+#include <stdlib.h>
+
+#include "rm_file.h"
+#include "rm_mem.h"
+#include "rm_thread.h"
+#include "rm_time.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_mesh.h"
+#include "rm_tristripper_strip_file.h"
+
+//The state of a single tile:
+typedef struct __rm_tristripper_batch_result__
+{
+	//The strips (only valid between stripping and output):
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+	rm_tristripper_stats stats;
+	rm_size tris_count;
+
+	//The number of bytes that are reserved for the tile:
+	rm_size memory_bytes;
+
+	rm_uint64 latency_nsecs;
+	rm_bool is_valid;
+	rm_bool is_done;
+} rm_tristripper_batch_result;
+
+//The IDs of a tile and the resources that back them:
+typedef struct __rm_tristripper_batch_ids__
+{
+	const rm_tristripper_id* ids;
+	rm_size ids_count;
+	rm_tristripper_id_vec vec;
+	rm_file_mapping mapping;
+} rm_tristripper_batch_ids;
+
+//Everything the workers share.
+//"next_tile_index" must be accessed atomically, the fields below "mutex" are guarded by it.
+//"output_mutex" is held while outputs are delivered, so they are never delivered concurrently.
+typedef struct __rm_tristripper_batch_job__
+{
+	const rm_tristripper_batch_input* inputs;
+	rm_size inputs_count;
+	const rm_tristripper_batch_config* batch_config;
+	rm_tristripper_batch_result* results;
+	rm_size next_tile_index;
+
+	rm_mutex output_mutex;
+	rm_tristripper_strip_file_writer writer;
+
+	rm_mutex mutex;
+	rm_cond cond;
+	rm_size memory_bytes;
+	rm_size peak_memory_bytes;
+	rm_size next_output_index;
+} rm_tristripper_batch_job;
+
+//A tile on its way through the pipeline.
+//Only one stage at a time owns it, the queues hand it over.
+typedef struct __rm_tristripper_pipeline_tile__
+{
+	rm_size tile_index;
+	rm_tristripper_batch_ids ids;
+	rm_size tris_count;
+
+	//The triangles (only valid between building and stripping):
+	rm_tristripper_tri* tris;
+	rm_size built_tris_count;
+
+	//The strips (only valid between stripping and writing):
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+	rm_tristripper_stats stats;
+
+	rm_size memory_bytes;
+	rm_uint64 start_nsecs;
+	rm_uint64 latency_nsecs;
+	rm_bool is_valid;
+} rm_tristripper_pipeline_tile;
+
+//Everything the stages share.
+//There is one queue behind every stage but the last one.
+//Every stage only writes its own entry in "pipeline_stats->stages", the write stage also owns "pipeline_stats->batch", "writer" and "latencies".
+//"memory_bytes" must be accessed atomically. Only the read stage adds to it, so it also maintains "peak_memory_bytes".
+typedef struct __rm_tristripper_pipeline_job__
+{
+	const rm_tristripper_batch_input* inputs;
+	rm_size inputs_count;
+	const rm_tristripper_pipeline_config* pipeline_config;
+	rm_tristripper_pipeline_stats* pipeline_stats;
+
+	rm_spsc_queue queues[RM_TRISTRIPPER_PIPELINE_STAGES_COUNT - 1];
+
+	rm_tristripper_strip_file_writer writer;
+	rm_uint64* latencies;
+
+	rm_size memory_bytes;
+	rm_size peak_memory_bytes;
+} rm_tristripper_pipeline_job;
+
+//The argument of a stage thread:
+typedef struct __rm_tristripper_pipeline_worker_arg__
+{
+	rm_tristripper_pipeline_job* job;
+	rm_tristripper_pipeline_stage stage;
+} rm_tristripper_pipeline_worker_arg;
+
+//A stage that waits for a queue yields this number of times before it starts to sleep:
+#define RM_TRISTRIPPER_PIPELINE_SPIN_COUNT ((rm_size)64)
+
+//After that, it sleeps this long between two attempts:
+#define RM_TRISTRIPPER_PIPELINE_SLEEP_NSECS ((rm_uint64)50000)
+
+static const rm_char* const rm_tristripper_pipeline_stage_names[RM_TRISTRIPPER_PIPELINE_STAGES_COUNT] = { "read", "build", "strip", "verify", "write" };
+
+//Estimate the number of bytes a tile reserves before it has been read:
+static rm_size rm_tristripper_batch_estimate_memory(const rm_tristripper_batch_input* input);
+
+//Read the IDs of a tile. "rm_tristripper_batch_dispose_ids(...)" releases them.
+static rm_void rm_tristripper_batch_read_ids(const rm_tristripper_batch_input* input, rm_tristripper_batch_ids* ids);
+static rm_void rm_tristripper_batch_dispose_ids(rm_tristripper_batch_ids* ids);
+
+//Change the reservation of a tile (locks the mutex):
+static rm_void rm_tristripper_batch_update_memory(rm_tristripper_batch_job* job, rm_tristripper_batch_result* result, rm_size memory_bytes);
+
+//Deliver the outputs of all tiles that are done and next in order:
+static rm_void rm_tristripper_batch_flush_outputs(rm_tristripper_batch_job* job);
+
+//The entry point of a worker thread.
+//Fetch tiles from the job until all of them have been stripped.
+static rm_void* rm_tristripper_batch_worker(rm_void* arg);
+
+//Compare two latencies for "qsort(...)":
+static rm_int rm_tristripper_batch_compare_latencies(const rm_void* a, const rm_void* b);
+
+//Add the results of a tile to the stats of a batch:
+static rm_void rm_tristripper_batch_add_tile(rm_tristripper_batch_stats* batch_stats, const rm_tristripper_stats* tile_stats, rm_size tris_count, rm_bool is_valid);
+
+//Derive the throughput and the latency percentiles of a non-empty batch whose "nsecs" is set.
+//"latencies" contains one entry per tile and is sorted in place.
+static rm_void rm_tristripper_batch_finish_stats(rm_tristripper_batch_stats* batch_stats, rm_uint64* latencies);
+
+//Wait until a tile can be taken from / put into a queue.
+//The time spent waiting is added to "wait_nsecs".
+static rm_tristripper_pipeline_tile* rm_tristripper_pipeline_pop(rm_spsc_queue* queue, rm_uint64* wait_nsecs);
+static rm_void rm_tristripper_pipeline_push(rm_spsc_queue* queue, rm_tristripper_pipeline_tile* tile, rm_uint64* wait_nsecs);
+
+//Back off after the given number of failed attempts to access a queue:
+static rm_void rm_tristripper_pipeline_back_off(rm_size attempts_count);
+
+//The work of the single stages on a tile:
+static rm_void rm_tristripper_pipeline_read(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile);
+static rm_void rm_tristripper_pipeline_build(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile);
+static rm_void rm_tristripper_pipeline_strip(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile);
+static rm_void rm_tristripper_pipeline_verify(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile);
+static rm_void rm_tristripper_pipeline_write(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile);
+
+//Dispatch to the work of a stage:
+static rm_void rm_tristripper_pipeline_process(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_stage stage, rm_tristripper_pipeline_tile* tile);
+
+//The entry point of a stage thread.
+//Pass tiles from the input queue to the output queue until the end marker (null) arrives.
+static rm_void* rm_tristripper_pipeline_worker(rm_void* arg);
+
+static rm_size rm_tristripper_batch_estimate_memory(const rm_tristripper_batch_input* input)
+{
+	if (!input->path)
+	{
+		return (input->ids_count / 3) * RM_TRISTRIPPER_BATCH_BYTES_PER_TRI;
+	}
+
+	//Raw files contain exactly 12 bytes per triangle, meshes at least that:
+	rm_file file = rm_file_open(input->path, RM_FILE_MODE_READ, RM_FILE_ENC_BINARY);
+	rm_file_seek(file, 0, RM_FILE_SEEK_ORIGIN_END);
+	rm_size file_size = (rm_size)rm_file_tell(file);
+	rm_file_close(file);
+
+	return (file_size / RM_TRISTRIPPER_BATCH_MIN_FILE_BYTES_PER_TRI) * RM_TRISTRIPPER_BATCH_BYTES_PER_TRI;
+}
+
+static rm_void rm_tristripper_batch_read_ids(const rm_tristripper_batch_input* input, rm_tristripper_batch_ids* ids)
+{
+	rm_vec_init(&ids->vec);
+	ids->mapping = (rm_file_mapping) { .data = null, .size = 0 };
+
+	//Tiles in memory are used as they are:
+	if (!input->path)
+	{
+		ids->ids = input->ids;
+		ids->ids_count = input->ids_count;
+
+		return;
+	}
+
+	rm_tristripper_mesh_format format;
+
+	if (rm_tristripper_mesh_format_from_path(input->path, &format))
+	{
+		rm_tristripper_read_mesh(input->path, format, &ids->vec);
+
+		ids->ids = ids->vec.data;
+		ids->ids_count = ids->vec.count;
+	}
+	else
+	{
+		//Raw files are mapped and passed on without a copy:
+		ids->mapping = rm_file_map(input->path, RM_FILE_MAP_ACCESS_SEQUENTIAL, true);
+		rm_precond((ids->mapping.size % (3 * sizeof(rm_tristripper_id))) == 0, "The size of \"%s\" is not a multiple of %zu bytes.", input->path, 3 * sizeof(rm_tristripper_id));
+
+		ids->ids = ids->mapping.data;
+		ids->ids_count = ids->mapping.size / sizeof(rm_tristripper_id);
+	}
+}
+
+static rm_void rm_tristripper_batch_dispose_ids(rm_tristripper_batch_ids* ids)
+{
+	rm_vec_dispose(&ids->vec);
+
+	if (ids->mapping.data)
+	{
+		rm_file_unmap(&ids->mapping);
+	}
+}
+
+static rm_void rm_tristripper_batch_update_memory(rm_tristripper_batch_job* job, rm_tristripper_batch_result* result, rm_size memory_bytes)
+{
+	rm_mutex_lock(&job->mutex);
+
+	job->memory_bytes = job->memory_bytes - result->memory_bytes + memory_bytes;
+	job->peak_memory_bytes = rm_max(job->peak_memory_bytes, job->memory_bytes);
+
+	//Someone might be waiting for the memory we have released:
+	if (memory_bytes < result->memory_bytes)
+	{
+		rm_cond_broadcast(&job->cond);
+	}
+
+	result->memory_bytes = memory_bytes;
+
+	rm_mutex_unlock(&job->mutex);
+}
+
+static rm_void rm_tristripper_batch_flush_outputs(rm_tristripper_batch_job* job)
+{
+	const rm_tristripper_batch_config* batch_config = job->batch_config;
+
+	//Whoever marks a tile as done comes here afterwards, so no output is missed even if another thread is about to leave:
+	rm_mutex_lock(&job->output_mutex);
+
+	while (true)
+	{
+		//Is the next tile in order done?
+		rm_mutex_lock(&job->mutex);
+
+		rm_size tile_index = job->next_output_index;
+		rm_bool is_ready = (tile_index < job->inputs_count) && job->results[tile_index].is_done;
+
+		rm_mutex_unlock(&job->mutex);
+
+		if (!is_ready)
+		{
+			break;
+		}
+
+		//Deliver it:
+		rm_tristripper_batch_result* result = &job->results[tile_index];
+
+		if (batch_config->output_path)
+		{
+			rm_tristripper_strip_file_writer_add_tile(&job->writer, result->strips, result->strips_count, &result->stats);
+		}
+
+		if (batch_config->output_func)
+		{
+			batch_config->output_func(tile_index, result->strips, result->strips_count, &result->stats, batch_config->output_user_data);
+		}
+
+		rm_tristripper_dispose_strips(result->strips, result->strips_count);
+		result->strips = null;
+
+		//Release its memory and let the next tile in order in:
+		rm_mutex_lock(&job->mutex);
+
+		job->memory_bytes -= result->memory_bytes;
+		result->memory_bytes = 0;
+		job->next_output_index++;
+
+		rm_cond_broadcast(&job->cond);
+		rm_mutex_unlock(&job->mutex);
+	}
+
+	rm_mutex_unlock(&job->output_mutex);
+}
+
+static rm_void* rm_tristripper_batch_worker(rm_void* arg)
+{
+	rm_tristripper_batch_job* job = arg;
+	const rm_tristripper_batch_config* batch_config = job->batch_config;
+
+	//Keep the working memory of the stripper between the tiles:
+	rm_tristripper_context context;
+	rm_tristripper_init_context(&context);
+
+	while (true)
+	{
+		//Grab the next tile:
+		rm_size tile_index = rm_atomic_fetch_add(&job->next_tile_index, 1);
+
+		if (tile_index >= job->inputs_count)
+		{
+			break;
+		}
+
+		const rm_tristripper_batch_input* input = &job->inputs[tile_index];
+		rm_tristripper_batch_result* result = &job->results[tile_index];
+
+		//Wait until there is enough memory.
+		//The next tile in output order must always get in, otherwise the tiles that wait for output might hold all the memory forever.
+		rm_size memory_bytes = rm_tristripper_batch_estimate_memory(input);
+
+		rm_mutex_lock(&job->mutex);
+
+		while ((batch_config->memory_limit != RM_TRISTRIPPER_BATCH_NO_MEMORY_LIMIT) &&
+		       (job->memory_bytes + memory_bytes > batch_config->memory_limit) &&
+		       (tile_index != job->next_output_index) &&
+		       (job->memory_bytes != 0))
+		{
+			rm_cond_wait(&job->cond, &job->mutex);
+		}
+
+		job->memory_bytes += memory_bytes;
+		job->peak_memory_bytes = rm_max(job->peak_memory_bytes, job->memory_bytes);
+		result->memory_bytes = memory_bytes;
+
+		rm_mutex_unlock(&job->mutex);
+
+		//Read the tile and correct the reservation:
+		rm_uint64 start_nsecs = rm_time_now();
+
+		rm_tristripper_batch_ids ids;
+		rm_tristripper_batch_read_ids(input, &ids);
+
+		result->tris_count = ids.ids_count / 3;
+		rm_tristripper_batch_update_memory(job, result, result->tris_count * RM_TRISTRIPPER_BATCH_BYTES_PER_TRI);
+
+		//Strip it with a private copy of the config:
+		rm_tristripper_config config = *batch_config->config;
+		config.stats = &result->stats;
+
+		rm_tristripper_create_strips_with_context(&context, ids.ids, ids.ids_count, &config, &result->strips, &result->strips_count);
+
+		//The reservations only cover the tiles in flight, so a memory limit does not allow us to keep anything:
+		if (batch_config->memory_limit != RM_TRISTRIPPER_BATCH_NO_MEMORY_LIMIT)
+		{
+			rm_tristripper_trim_context(&context);
+		}
+
+		//Short inputs do not produce stats:
+		if (ids.ids_count < 3)
+		{
+			rm_tristripper_calculate_stats(result->strips, result->strips_count, &result->stats);
+		}
+
+		//Verify it:
+		result->is_valid = true;
+
+		if (batch_config->verify)
+		{
+			rm_tristripper_verifier verifier;
+			rm_tristripper_init_verifier(&verifier, ids.ids, ids.ids_count);
+			result->is_valid = rm_tristripper_verify(&verifier, result->strips, result->strips_count, false);
+			rm_tristripper_dispose_verifier(&verifier);
+		}
+
+		result->latency_nsecs = rm_time_now() - start_nsecs;
+		rm_tristripper_batch_dispose_ids(&ids);
+
+		//Only the strips are left until the output has been delivered:
+		rm_size strips_bytes = result->strips_count * sizeof(rm_tristripper_strip);
+
+		for (rm_size i = 0; i < result->strips_count; i++)
+		{
+			strips_bytes += result->strips[i].ids_count * sizeof(rm_tristripper_id);
+		}
+
+		rm_mutex_lock(&job->mutex);
+
+		job->memory_bytes = job->memory_bytes - result->memory_bytes + strips_bytes;
+		result->memory_bytes = strips_bytes;
+		result->is_done = true;
+
+		rm_cond_broadcast(&job->cond);
+		rm_mutex_unlock(&job->mutex);
+
+		rm_tristripper_batch_flush_outputs(job);
+	}
+
+	rm_tristripper_dispose_context(&context);
+
+	return null;
+}
+
+static rm_int rm_tristripper_batch_compare_latencies(const rm_void* a, const rm_void* b)
+{
+	rm_uint64 latency_a = *(const rm_uint64*)a;
+	rm_uint64 latency_b = *(const rm_uint64*)b;
+
+	return (latency_a > latency_b) - (latency_a < latency_b);
+}
+
+static rm_void rm_tristripper_batch_add_tile(rm_tristripper_batch_stats* batch_stats, const rm_tristripper_stats* tile_stats, rm_size tris_count, rm_bool is_valid)
+{
+	batch_stats->tris_count += tris_count;
+	batch_stats->invalid_tiles_count += is_valid ? 0 : 1;
+
+	rm_tristripper_add_stats(&batch_stats->stats, tile_stats);
+}
+
+static rm_void rm_tristripper_batch_finish_stats(rm_tristripper_batch_stats* batch_stats, rm_uint64* latencies)
+{
+	rm_size tiles_count = batch_stats->tiles_count;
+
+	//Throughput and latency percentiles (nearest rank):
+	rm_double secs = rm_time_to_secs(rm_max(batch_stats->nsecs, (rm_uint64)1));
+	batch_stats->tiles_per_sec = (rm_double)tiles_count / secs;
+	batch_stats->tris_per_sec = (rm_double)batch_stats->tris_count / secs;
+
+	qsort(latencies, tiles_count, sizeof(rm_uint64), rm_tristripper_batch_compare_latencies);
+
+	batch_stats->latency_p50_nsecs = latencies[((tiles_count * 50) + 99) / 100 - 1];
+	batch_stats->latency_p90_nsecs = latencies[((tiles_count * 90) + 99) / 100 - 1];
+	batch_stats->latency_p99_nsecs = latencies[((tiles_count * 99) + 99) / 100 - 1];
+	batch_stats->latency_max_nsecs = latencies[tiles_count - 1];
+}
+
+static rm_tristripper_pipeline_tile* rm_tristripper_pipeline_pop(rm_spsc_queue* queue, rm_uint64* wait_nsecs)
+{
+	rm_void* tile;
+
+	//Don't bother the clock if there is a tile already:
+	if (rm_spsc_queue_try_pop(queue, &tile))
+	{
+		return tile;
+	}
+
+	rm_uint64 start_nsecs = rm_time_now();
+
+	for (rm_size attempts_count = 1; !rm_spsc_queue_try_pop(queue, &tile); attempts_count++)
+	{
+		rm_tristripper_pipeline_back_off(attempts_count);
+	}
+
+	*wait_nsecs += rm_time_now() - start_nsecs;
+
+	return tile;
+}
+
+static rm_void rm_tristripper_pipeline_push(rm_spsc_queue* queue, rm_tristripper_pipeline_tile* tile, rm_uint64* wait_nsecs)
+{
+	if (rm_spsc_queue_try_push(queue, tile))
+	{
+		return;
+	}
+
+	rm_uint64 start_nsecs = rm_time_now();
+
+	for (rm_size attempts_count = 1; !rm_spsc_queue_try_push(queue, tile); attempts_count++)
+	{
+		rm_tristripper_pipeline_back_off(attempts_count);
+	}
+
+	*wait_nsecs += rm_time_now() - start_nsecs;
+}
+
+static rm_void rm_tristripper_pipeline_back_off(rm_size attempts_count)
+{
+	//Short waits are common (the neighbour is about to finish a tile), long ones should not burn a processor that the strip stage could use:
+	if (attempts_count < RM_TRISTRIPPER_PIPELINE_SPIN_COUNT)
+	{
+		rm_thread_yield();
+	}
+	else
+	{
+		rm_thread_sleep(RM_TRISTRIPPER_PIPELINE_SLEEP_NSECS);
+	}
+}
+
+static rm_void rm_tristripper_pipeline_read(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile)
+{
+	tile->start_nsecs = rm_time_now();
+	rm_tristripper_batch_read_ids(&job->inputs[tile->tile_index], &tile->ids);
+	tile->tris_count = tile->ids.ids_count / 3;
+
+	//The tile is reserved until it has been written:
+	tile->memory_bytes = tile->tris_count * RM_TRISTRIPPER_BATCH_BYTES_PER_TRI;
+	rm_size memory_bytes = rm_atomic_fetch_add(&job->memory_bytes, tile->memory_bytes) + tile->memory_bytes;
+	job->peak_memory_bytes = rm_max(job->peak_memory_bytes, memory_bytes);
+}
+
+static rm_void rm_tristripper_pipeline_build(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile)
+{
+	const rm_tristripper_pipeline_config* pipeline_config = job->pipeline_config;
+
+	//Short inputs have no triangles:
+	if (tile->ids.ids_count >= 3)
+	{
+		rm_tristripper_build_tris(tile->ids.ids, tile->ids.ids_count, &tile->tris, &tile->built_tris_count);
+	}
+
+	//The IDs are only needed for verification from here on:
+	if (!pipeline_config->verify)
+	{
+		rm_tristripper_batch_dispose_ids(&tile->ids);
+	}
+}
+
+static rm_void rm_tristripper_pipeline_strip(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile)
+{
+	const rm_tristripper_pipeline_config* pipeline_config = job->pipeline_config;
+
+	//Strip the tile with a private copy of the config:
+	rm_tristripper_config config = *pipeline_config->config;
+	config.stats = &tile->stats;
+
+	rm_tristripper_create_strips_from_tris(&tile->tris, tile->built_tris_count, &config, &tile->strips, &tile->strips_count);
+
+	rm_free(tile->tris);
+	tile->tris = null;
+}
+
+static rm_void rm_tristripper_pipeline_verify(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile)
+{
+	const rm_tristripper_pipeline_config* pipeline_config = job->pipeline_config;
+
+	tile->is_valid = true;
+
+	if (pipeline_config->verify)
+	{
+		rm_tristripper_verifier verifier;
+		rm_tristripper_init_verifier(&verifier, tile->ids.ids, tile->ids.ids_count);
+		tile->is_valid = rm_tristripper_verify(&verifier, tile->strips, tile->strips_count, false);
+		rm_tristripper_dispose_verifier(&verifier);
+
+		rm_tristripper_batch_dispose_ids(&tile->ids);
+	}
+
+	tile->latency_nsecs = rm_time_now() - tile->start_nsecs;
+}
+
+static rm_void rm_tristripper_pipeline_write(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_tile* tile)
+{
+	const rm_tristripper_pipeline_config* pipeline_config = job->pipeline_config;
+
+	//Tiles arrive in input order, so they can be delivered right away:
+	if (pipeline_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_add_tile(&job->writer, tile->strips, tile->strips_count, &tile->stats);
+	}
+
+	if (pipeline_config->output_func)
+	{
+		pipeline_config->output_func(tile->tile_index, tile->strips, tile->strips_count, &tile->stats, pipeline_config->output_user_data);
+	}
+
+	rm_tristripper_batch_add_tile(&job->pipeline_stats->batch, &tile->stats, tile->tris_count, tile->is_valid);
+	job->latencies[tile->tile_index] = tile->latency_nsecs;
+
+	rm_tristripper_dispose_strips(tile->strips, tile->strips_count);
+	rm_atomic_fetch_sub(&job->memory_bytes, tile->memory_bytes);
+	rm_free(tile);
+}
+
+static rm_void rm_tristripper_pipeline_process(rm_tristripper_pipeline_job* job, rm_tristripper_pipeline_stage stage, rm_tristripper_pipeline_tile* tile)
+{
+	switch (stage)
+	{
+	case RM_TRISTRIPPER_PIPELINE_STAGE_READ:
+
+		rm_tristripper_pipeline_read(job, tile);
+		break;
+
+	case RM_TRISTRIPPER_PIPELINE_STAGE_BUILD:
+
+		rm_tristripper_pipeline_build(job, tile);
+		break;
+
+	case RM_TRISTRIPPER_PIPELINE_STAGE_STRIP:
+
+		rm_tristripper_pipeline_strip(job, tile);
+		break;
+
+	case RM_TRISTRIPPER_PIPELINE_STAGE_VERIFY:
+
+		rm_tristripper_pipeline_verify(job, tile);
+		break;
+
+	case RM_TRISTRIPPER_PIPELINE_STAGE_WRITE:
+
+		rm_tristripper_pipeline_write(job, tile);
+		break;
+
+	default:
+
+		rm_exit("Invalid pipeline stage: %d", (rm_int)stage);
+	}
+}
+
+static rm_void* rm_tristripper_pipeline_worker(rm_void* arg)
+{
+	const rm_tristripper_pipeline_worker_arg* worker_arg = arg;
+	rm_tristripper_pipeline_job* job = worker_arg->job;
+	rm_tristripper_pipeline_stage stage = worker_arg->stage;
+	rm_tristripper_pipeline_stage_stats* stage_stats = &job->pipeline_stats->stages[stage];
+
+	//The first stage has no input queue, the last one no output queue:
+	rm_spsc_queue* input_queue = (stage != RM_TRISTRIPPER_PIPELINE_STAGE_READ) ? &job->queues[stage - 1] : null;
+	rm_spsc_queue* output_queue = (stage != RM_TRISTRIPPER_PIPELINE_STAGE_WRITE) ? &job->queues[stage] : null;
+
+	for (rm_size tile_index = 0; ; tile_index++)
+	{
+		//The first stage creates the tiles in input order, the others receive them:
+		rm_tristripper_pipeline_tile* tile;
+
+		if (input_queue)
+		{
+			tile = rm_tristripper_pipeline_pop(input_queue, &stage_stats->starved_nsecs);
+		}
+		else if (tile_index < job->inputs_count)
+		{
+			tile = rm_malloc_zero(sizeof(rm_tristripper_pipeline_tile));
+			tile->tile_index = tile_index;
+		}
+		else
+		{
+			tile = null;
+		}
+
+		if (!tile)
+		{
+			break;
+		}
+
+		//Work on it and hand it over (the last stage frees it):
+		rm_uint64 start_nsecs = rm_time_now();
+		rm_tristripper_pipeline_process(job, stage, tile);
+
+		stage_stats->busy_nsecs += rm_time_now() - start_nsecs;
+		stage_stats->tiles_count++;
+
+		if (output_queue)
+		{
+			rm_tristripper_pipeline_push(output_queue, tile, &stage_stats->blocked_nsecs);
+		}
+	}
+
+	//Pass the end marker on:
+	if (output_queue)
+	{
+		rm_tristripper_pipeline_push(output_queue, null, &stage_stats->blocked_nsecs);
+	}
+
+	return null;
+}
+
+rm_void rm_tristripper_run_batch(const rm_tristripper_batch_input* inputs, rm_size inputs_count, const rm_tristripper_batch_config* batch_config, rm_tristripper_batch_stats* batch_stats)
+{
+	rm_assert(inputs || (inputs_count == 0), "Passed inputs must be valid.");
+	rm_assert(batch_config, "Passed batch config must be valid.");
+	rm_assert(batch_stats, "Passed batch stats must be valid.");
+	rm_precond(batch_config->config, "Passed batch config must contain a tristripper config.");
+	rm_precond(batch_config->config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
+
+	*batch_stats = (rm_tristripper_batch_stats) { .tiles_count = inputs_count };
+	rm_uint64 start_nsecs = rm_time_now();
+
+	//Prepare the job:
+	rm_tristripper_batch_job job =
+	{
+		.inputs = inputs,
+		.inputs_count = inputs_count,
+		.batch_config = batch_config,
+		.results = (inputs_count > 0) ? rm_malloc_zero(inputs_count * sizeof(rm_tristripper_batch_result)) : null,
+		.next_tile_index = 0,
+		.memory_bytes = 0,
+		.peak_memory_bytes = 0,
+		.next_output_index = 0
+	};
+
+	rm_mutex_init(&job.output_mutex);
+	rm_mutex_init(&job.mutex);
+	rm_cond_init(&job.cond);
+
+	if (batch_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_open(&job.writer, batch_config->output_path);
+	}
+
+	//Determine the number of threads.
+	//There is no point in having more threads than tiles.
+	rm_size threads_count = (batch_config->threads_count == RM_TRISTRIPPER_THREADS_COUNT_AUTO) ? rm_thread_get_processors_count() : batch_config->threads_count;
+	threads_count = rm_min(threads_count, inputs_count);
+
+	//Spawn the additional threads, the calling thread participates as well:
+	rm_thread* threads = (threads_count > 1) ? rm_malloc((threads_count - 1) * sizeof(rm_thread)) : null;
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_create(&threads[i], rm_tristripper_batch_worker, &job);
+	}
+
+	rm_tristripper_batch_worker(&job);
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_join(threads[i]);
+	}
+
+	rm_free(threads);
+	rm_assert(job.next_output_index == inputs_count, "Stripped all %zu tiles, but only %zu outputs have been delivered.", inputs_count, job.next_output_index);
+
+	if (batch_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_close(&job.writer);
+	}
+
+	rm_cond_dispose(&job.cond);
+	rm_mutex_dispose(&job.mutex);
+	rm_mutex_dispose(&job.output_mutex);
+
+	batch_stats->nsecs = rm_time_now() - start_nsecs;
+	batch_stats->peak_memory_bytes = job.peak_memory_bytes;
+
+	if (inputs_count == 0)
+	{
+		return;
+	}
+
+	//Sum up the tiles:
+	rm_uint64* latencies = rm_malloc(inputs_count * sizeof(rm_uint64));
+
+	for (rm_size i = 0; i < inputs_count; i++)
+	{
+		const rm_tristripper_batch_result* result = &job.results[i];
+
+		rm_tristripper_batch_add_tile(batch_stats, &result->stats, result->tris_count, result->is_valid);
+		latencies[i] = result->latency_nsecs;
+	}
+
+	rm_free(job.results);
+
+	rm_tristripper_batch_finish_stats(batch_stats, latencies);
+	rm_free(latencies);
+}
+
+const rm_char* rm_tristripper_pipeline_stage_name(rm_tristripper_pipeline_stage stage)
+{
+	rm_precond(stage < RM_TRISTRIPPER_PIPELINE_STAGES_COUNT, "Invalid pipeline stage: %d", (rm_int)stage);
+
+	return rm_tristripper_pipeline_stage_names[stage];
+}
+
+rm_void rm_tristripper_run_pipeline(const rm_tristripper_batch_input* inputs, rm_size inputs_count, const rm_tristripper_pipeline_config* pipeline_config, rm_tristripper_pipeline_stats* pipeline_stats)
+{
+	rm_assert(inputs || (inputs_count == 0), "Passed inputs must be valid.");
+	rm_assert(pipeline_config, "Passed pipeline config must be valid.");
+	rm_assert(pipeline_stats, "Passed pipeline stats must be valid.");
+	rm_precond(pipeline_config->config, "Passed pipeline config must contain a tristripper config.");
+	rm_precond(pipeline_config->config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
+	rm_precond(pipeline_config->queue_capacity >= 1, "The queues of a pipeline need room for at least one tile.");
+
+	*pipeline_stats = (rm_tristripper_pipeline_stats) { .batch = { .tiles_count = inputs_count } };
+	rm_uint64 start_nsecs = rm_time_now();
+
+	//Prepare the job:
+	rm_tristripper_pipeline_job job =
+	{
+		.inputs = inputs,
+		.inputs_count = inputs_count,
+		.pipeline_config = pipeline_config,
+		.pipeline_stats = pipeline_stats,
+		.latencies = (inputs_count > 0) ? rm_malloc(inputs_count * sizeof(rm_uint64)) : null,
+		.memory_bytes = 0,
+		.peak_memory_bytes = 0
+	};
+
+	for (rm_size i = 0; i < rm_array_count(job.queues); i++)
+	{
+		rm_spsc_queue_init(&job.queues[i], pipeline_config->queue_capacity);
+	}
+
+	if (pipeline_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_open(&job.writer, pipeline_config->output_path);
+	}
+
+	//Spawn a thread per stage, the calling thread writes:
+	rm_tristripper_pipeline_worker_arg worker_args[RM_TRISTRIPPER_PIPELINE_STAGES_COUNT];
+	rm_thread threads[RM_TRISTRIPPER_PIPELINE_STAGES_COUNT - 1];
+
+	for (rm_size i = 0; i < RM_TRISTRIPPER_PIPELINE_STAGES_COUNT; i++)
+	{
+		worker_args[i] = (rm_tristripper_pipeline_worker_arg) { .job = &job, .stage = (rm_tristripper_pipeline_stage)i };
+	}
+
+	for (rm_size i = 0; i < rm_array_count(threads); i++)
+	{
+		rm_thread_create(&threads[i], rm_tristripper_pipeline_worker, &worker_args[i]);
+	}
+
+	rm_tristripper_pipeline_worker(&worker_args[RM_TRISTRIPPER_PIPELINE_STAGE_WRITE]);
+
+	for (rm_size i = 0; i < rm_array_count(threads); i++)
+	{
+		rm_thread_join(threads[i]);
+	}
+
+	rm_assert(pipeline_stats->stages[RM_TRISTRIPPER_PIPELINE_STAGE_WRITE].tiles_count == inputs_count, "Read %zu tiles, but only %zu have been written.", inputs_count, pipeline_stats->stages[RM_TRISTRIPPER_PIPELINE_STAGE_WRITE].tiles_count);
+
+	if (pipeline_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_close(&job.writer);
+	}
+
+	for (rm_size i = 0; i < rm_array_count(job.queues); i++)
+	{
+		rm_spsc_queue_dispose(&job.queues[i]);
+	}
+
+	rm_tristripper_batch_stats* batch_stats = &pipeline_stats->batch;
+	batch_stats->nsecs = rm_time_now() - start_nsecs;
+	batch_stats->peak_memory_bytes = job.peak_memory_bytes;
+
+	if (inputs_count > 0)
+	{
+		rm_tristripper_batch_finish_stats(batch_stats, job.latencies);
+	}
+
+	rm_free(job.latencies);
+}
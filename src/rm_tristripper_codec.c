@@ -0,0 +1,476 @@
+#include "rm_tristripper_codec.h"
+
+#include "rm_mem.h"
+
+//The parts of a tag byte:
+#define RM_TRISTRIPPER_CODEC_SWAP_FLAG ((rm_uint8)0x80)
+#define RM_TRISTRIPPER_CODEC_TYPE_SHIFT 5
+#define RM_TRISTRIPPER_CODEC_PAYLOAD_MASK ((rm_uint32)0x1f)
+
+//NEW and LITERAL keep the low bits of their value in the payload, the rest follows as varint if needed:
+#define RM_TRISTRIPPER_CODEC_VALUE_MASK ((rm_uint32)0x0f)
+#define RM_TRISTRIPPER_CODEC_VALUE_SHIFT 4
+#define RM_TRISTRIPPER_CODEC_MORE_FLAG ((rm_uint32)0x10)
+
+//A varint needs at most five bytes for 32 bits and ten bytes for 64 bits:
+#define RM_TRISTRIPPER_CODEC_MAX_VARINT_32_SIZE ((rm_size)5)
+#define RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE ((rm_size)10)
+
+//A code consists of the tag and an optional varint:
+#define RM_TRISTRIPPER_CODEC_MAX_CODE_SIZE ((rm_size)1 + RM_TRISTRIPPER_CODEC_MAX_VARINT_32_SIZE)
+
+//The types of the codes (see "rm_tristripper_codec.h"):
+typedef enum __rm_tristripper_codec_type__
+{
+	RM_TRISTRIPPER_CODEC_TYPE_NEW,
+	RM_TRISTRIPPER_CODEC_TYPE_CACHE,
+	RM_TRISTRIPPER_CODEC_TYPE_LITERAL,
+	RM_TRISTRIPPER_CODEC_TYPE_SWAP
+} rm_tristripper_codec_type;
+
+//The state of the encoder (the decoder keeps the same state in local variables):
+typedef struct __rm_tristripper_codec_state__
+{
+	//The next ID a NEW code with a zero payload stands for (the high water mark + 1):
+	rm_uint64 next_new_id;
+
+	//The ID of the last LITERAL code.
+	//Strips alternate between new vertices and vertices of a neighbouring strip, which are often visited in order.
+	rm_tristripper_id prev_literal_id;
+
+	//The ring of recent IDs and the number of IDs that have been pushed to it:
+	rm_tristripper_id ring[RM_TRISTRIPPER_CODEC_RING_SIZE];
+	rm_size ring_head;
+} rm_tristripper_codec_state;
+
+//Prepare the state for the first strip:
+static inline rm_void init_state(rm_tristripper_codec_state* state);
+
+//Push an ID to the ring:
+static inline rm_void push_to_ring(rm_tristripper_codec_state* state, rm_tristripper_id id);
+
+//Find an ID in the ring and return its distance from the most recent entry (or RM_TRISTRIPPER_CODEC_RING_SIZE if it is not there):
+static inline rm_size find_in_ring(const rm_tristripper_codec_state* state, rm_tristripper_id id);
+
+//Write a varint and return the pointer behind it:
+static inline rm_uint8* write_varint(rm_uint8* ptr, rm_uint64 value);
+
+//Get the number of bytes a NEW or LITERAL code with the given value takes:
+static inline rm_size get_code_size(rm_uint32 value);
+
+//Write a NEW, LITERAL or SWAP code:
+static inline rm_uint8* write_code(rm_uint8* ptr, rm_uint8 flags, rm_tristripper_codec_type type, rm_uint32 value);
+
+//Read a varint of at most "max_size" bytes.
+//If "is_bounded" is "false", every byte is checked against "end".
+static inline rm_uint64 read_varint(const rm_uint8** ptr, const rm_uint8* end, rm_bool is_bounded, rm_size max_size);
+
+//Zigzag coding: Small negative deltas become small positive values.
+static inline rm_uint32 zigzag_encode(rm_uint32 delta);
+static inline rm_uint32 zigzag_decode(rm_uint32 value);
+
+//Parse the header and return the pointer to the first strip length:
+static const rm_uint8* parse_header(const rm_uint8* data, rm_size size, rm_tristripper_codec_header* header);
+
+static inline rm_void init_state(rm_tristripper_codec_state* state)
+{
+	state->next_new_id = 0;
+	state->prev_literal_id = 0;
+	state->ring_head = 0;
+
+	rm_mem_set(state->ring, 0, sizeof(state->ring));
+}
+
+static inline rm_void push_to_ring(rm_tristripper_codec_state* state, rm_tristripper_id id)
+{
+	state->ring[state->ring_head++ % RM_TRISTRIPPER_CODEC_RING_SIZE] = id;
+}
+
+static inline rm_size find_in_ring(const rm_tristripper_codec_state* state, rm_tristripper_id id)
+{
+	//Compare against all slots without an early exit, so the compiler can vectorize the loop.
+	//Duplicates in the ring are possible (e.g. the initial zeros), but they decode to the same ID anyway.
+	rm_size slot = RM_TRISTRIPPER_CODEC_RING_SIZE;
+
+	for (rm_size i = 0; i < RM_TRISTRIPPER_CODEC_RING_SIZE; i++)
+	{
+		slot = (state->ring[i] == id) ? i : slot;
+	}
+
+	if (slot == RM_TRISTRIPPER_CODEC_RING_SIZE)
+	{
+		return RM_TRISTRIPPER_CODEC_RING_SIZE;
+	}
+
+	return (state->ring_head - 1 - slot) % RM_TRISTRIPPER_CODEC_RING_SIZE;
+}
+
+static inline rm_uint8* write_varint(rm_uint8* ptr, rm_uint64 value)
+{
+	while (value >= 0x80)
+	{
+		*ptr++ = (rm_uint8)(value | 0x80);
+		value >>= 7;
+	}
+
+	*ptr++ = (rm_uint8)value;
+
+	return ptr;
+}
+
+static inline rm_size get_code_size(rm_uint32 value)
+{
+	rm_size size = 1;
+
+	for (value >>= RM_TRISTRIPPER_CODEC_VALUE_SHIFT; value > 0; value >>= 7)
+	{
+		size++;
+	}
+
+	return size;
+}
+
+static inline rm_uint8* write_code(rm_uint8* ptr, rm_uint8 flags, rm_tristripper_codec_type type, rm_uint32 value)
+{
+	rm_uint8 tag = (rm_uint8)(flags | ((rm_uint8)type << RM_TRISTRIPPER_CODEC_TYPE_SHIFT) | (value & RM_TRISTRIPPER_CODEC_VALUE_MASK));
+
+	if (value <= RM_TRISTRIPPER_CODEC_VALUE_MASK)
+	{
+		*ptr++ = tag;
+
+		return ptr;
+	}
+
+	*ptr++ = (rm_uint8)(tag | RM_TRISTRIPPER_CODEC_MORE_FLAG);
+
+	return write_varint(ptr, value >> RM_TRISTRIPPER_CODEC_VALUE_SHIFT);
+}
+
+static inline rm_uint64 read_varint(const rm_uint8** ptr, const rm_uint8* end, rm_bool is_bounded, rm_size max_size)
+{
+	const rm_uint8* curr_ptr = *ptr;
+	rm_uint64 value = 0;
+	rm_uint32 shift = 0;
+	rm_uint8 byte;
+
+	do
+	{
+		rm_precond(is_bounded || (curr_ptr < end), "The encoded strips run over the end of the data.");
+		rm_precond(shift < (7 * max_size), "The encoded strips contain an invalid varint.");
+
+		byte = *curr_ptr++;
+		value |= (rm_uint64)(byte & 0x7f) << shift;
+		shift += 7;
+	}
+	while (byte & 0x80);
+
+	*ptr = curr_ptr;
+
+	return value;
+}
+
+static inline rm_uint32 zigzag_encode(rm_uint32 delta)
+{
+	return (delta << 1) ^ (rm_uint32)(-(rm_int32)(delta >> 31));
+}
+
+static inline rm_uint32 zigzag_decode(rm_uint32 value)
+{
+	return (value >> 1) ^ (rm_uint32)(-(rm_int32)(value & 1));
+}
+
+static const rm_uint8* parse_header(const rm_uint8* data, rm_size size, rm_tristripper_codec_header* header)
+{
+	rm_precond(data || (size == 0), "Passed data must be valid.");
+	rm_precond(size >= sizeof(rm_uint32), "The encoded strips are too short for a header.");
+
+	rm_uint32 magic;
+	rm_mem_copy(&magic, data, sizeof(rm_uint32));
+	rm_precond(rm_flip_le_to_host_32(magic) == RM_TRISTRIPPER_CODEC_MAGIC, "The encoded strips have an invalid magic number.");
+
+	const rm_uint8* ptr = data + sizeof(rm_uint32);
+	const rm_uint8* end = data + size;
+
+	rm_uint64 strips_count = read_varint(&ptr, end, false, RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE);
+	rm_uint64 ids_count = read_varint(&ptr, end, false, RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE);
+
+	//Every strip has at least one ID and every length takes at least one byte:
+	rm_precond((strips_count <= ids_count) && (strips_count <= (rm_uint64)(end - ptr)), "The header of the encoded strips is invalid.");
+
+	header->strips_count = (rm_size)strips_count;
+	header->ids_count = (rm_size)ids_count;
+
+	return ptr;
+}
+
+rm_size rm_tristripper_codec_renumber(rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_id* remap, rm_size remap_count)
+{
+	rm_assert(strips || (strips_count == 0), "Passed strips must be valid.");
+	rm_assert(remap || (remap_count == 0), "Passed remap table must be valid.");
+
+	for (rm_size i = 0; i < remap_count; i++)
+	{
+		remap[i] = RM_TRISTRIPPER_CODEC_UNUSED_ID;
+	}
+
+	rm_size used_count = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		for (rm_size j = 0; j < strips[i].ids_count; j++)
+		{
+			rm_tristripper_id* id = &strips[i].ids[j];
+			rm_precond(*id < remap_count, "ID %" PRIu32 " is out of the range of the remap table (%zu entries).", *id, remap_count);
+
+			if (remap[*id] == RM_TRISTRIPPER_CODEC_UNUSED_ID)
+			{
+				remap[*id] = (rm_tristripper_id)used_count++;
+			}
+
+			*id = remap[*id];
+		}
+	}
+
+	return used_count;
+}
+
+rm_size rm_tristripper_codec_max_size(const rm_tristripper_strip* strips, rm_size strips_count)
+{
+	rm_assert(strips || (strips_count == 0), "Passed strips must be valid.");
+
+	rm_size size = sizeof(rm_uint32) + (2 * RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE) + (strips_count * RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE);
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		size += strips[i].ids_count * RM_TRISTRIPPER_CODEC_MAX_CODE_SIZE;
+	}
+
+	return size;
+}
+
+rm_size rm_tristripper_codec_encode(const rm_tristripper_strip* strips, rm_size strips_count, rm_uint8* data)
+{
+	rm_assert(strips || (strips_count == 0), "Passed strips must be valid.");
+	rm_assert(data, "Passed data must be valid.");
+
+	//Header:
+	rm_size ids_count = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		rm_precond(strips[i].ids_count > 0, "Strips must not be empty.");
+		ids_count += strips[i].ids_count;
+	}
+
+	rm_uint32 magic = rm_flip_host_to_le_32(RM_TRISTRIPPER_CODEC_MAGIC);
+	rm_mem_copy(data, &magic, sizeof(rm_uint32));
+
+	rm_uint8* ptr = data + sizeof(rm_uint32);
+	ptr = write_varint(ptr, strips_count);
+	ptr = write_varint(ptr, ids_count);
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		ptr = write_varint(ptr, strips[i].ids_count);
+	}
+
+	//Codes:
+	rm_tristripper_codec_state state;
+	init_state(&state);
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		const rm_tristripper_id* ids = strips[i].ids;
+		rm_size count = strips[i].ids_count;
+		rm_uint8 flags = 0;
+
+		for (rm_size j = 0; j < count; j++)
+		{
+			rm_tristripper_id id = ids[j];
+
+			//A swap repeats the ID two positions before.
+			//It becomes a flag of the next code, unless that one is a swap on its own (or there is no next code).
+			if ((j >= 2) && (id == ids[j - 2]))
+			{
+				if (!flags && (j + 1 < count) && (ids[j + 1] != ids[j - 1]))
+				{
+					flags = RM_TRISTRIPPER_CODEC_SWAP_FLAG;
+				}
+				else
+				{
+					ptr = write_code(ptr, flags, RM_TRISTRIPPER_CODEC_TYPE_SWAP, 0);
+					flags = 0;
+				}
+
+				continue;
+			}
+
+			//Prefer the cheapest code.
+			//IDs above the high water mark are usually NEW, but if the mesh has not been renumbered, a LITERAL might be cheaper.
+			rm_uint32 literal_value = zigzag_encode(id - state.prev_literal_id);
+			rm_size distance = find_in_ring(&state, id);
+
+			if (((rm_uint64)id >= state.next_new_id) && (get_code_size((rm_uint32)((rm_uint64)id - state.next_new_id)) <= get_code_size(literal_value)))
+			{
+				ptr = write_code(ptr, flags, RM_TRISTRIPPER_CODEC_TYPE_NEW, (rm_uint32)((rm_uint64)id - state.next_new_id));
+
+				state.next_new_id = (rm_uint64)id + 1;
+				push_to_ring(&state, id);
+			}
+			else if (distance < RM_TRISTRIPPER_CODEC_RING_SIZE)
+			{
+				*ptr++ = (rm_uint8)(flags | ((rm_uint8)RM_TRISTRIPPER_CODEC_TYPE_CACHE << RM_TRISTRIPPER_CODEC_TYPE_SHIFT) | (rm_uint8)distance);
+			}
+			else
+			{
+				ptr = write_code(ptr, flags, RM_TRISTRIPPER_CODEC_TYPE_LITERAL, literal_value);
+
+				state.prev_literal_id = id;
+				push_to_ring(&state, id);
+			}
+
+			flags = 0;
+		}
+	}
+
+	return (rm_size)(ptr - data);
+}
+
+rm_void rm_tristripper_codec_read_header(const rm_uint8* data, rm_size size, rm_tristripper_codec_header* header)
+{
+	rm_assert(header, "Passed header must be valid.");
+
+	parse_header(data, size, header);
+}
+
+rm_void rm_tristripper_codec_decode_ids(const rm_uint8* data, rm_size size, rm_tristripper_id* ids, rm_size* strip_ids_counts)
+{
+	rm_tristripper_codec_header header;
+	const rm_uint8* lengths_ptr = parse_header(data, size, &header);
+	const rm_uint8* end = data + size;
+
+	rm_assert(ids || (header.ids_count == 0), "Passed IDs must be valid.");
+
+	//The codes follow the strip lengths, so we walk both at the same time:
+	const rm_uint8* ptr = lengths_ptr;
+
+	for (rm_size i = 0; i < header.strips_count; i++)
+	{
+		read_varint(&ptr, end, false, RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE);
+	}
+
+	//The decoder state lives in locals, so it stays in registers.
+	//The ring has twice the slots a CACHE code can address, so it can be written after every code (see below).
+	rm_tristripper_id ring[2 * RM_TRISTRIPPER_CODEC_RING_SIZE] = { 0 };
+	rm_size ring_head = 0;
+	rm_tristripper_id next_new_id = 0;
+	rm_tristripper_id prev_literal_id = 0;
+
+	rm_size ids_index = 0;
+
+	for (rm_size i = 0; i < header.strips_count; i++)
+	{
+		rm_uint64 count = read_varint(&lengths_ptr, end, true, RM_TRISTRIPPER_CODEC_MAX_VARINT_64_SIZE);
+		rm_precond((count > 0) && (count <= (rm_uint64)(header.ids_count - ids_index)), "Strip %zu of the encoded strips has an invalid length.", i);
+
+		if (strip_ids_counts)
+		{
+			strip_ids_counts[i] = (rm_size)count;
+		}
+
+		rm_tristripper_id* strip_ids = &ids[ids_index];
+		rm_size strip_count = (rm_size)count;
+		ids_index += strip_count;
+
+		//If the strip cannot run over the end of the data, we can skip the bounds checks:
+		rm_bool is_bounded = (rm_size)(end - ptr) >= (strip_count * RM_TRISTRIPPER_CODEC_MAX_CODE_SIZE);
+
+		for (rm_size j = 0; j < strip_count; j++)
+		{
+			rm_precond(is_bounded || (ptr < end), "The encoded strips run over the end of the data.");
+
+			rm_uint8 tag = *ptr++;
+			rm_tristripper_codec_type type = (rm_tristripper_codec_type)((tag >> RM_TRISTRIPPER_CODEC_TYPE_SHIFT) & 3);
+
+			//Insert the swap in front of the ID:
+			if (rm_unlikely(tag & RM_TRISTRIPPER_CODEC_SWAP_FLAG))
+			{
+				rm_precond((j >= 2) && (j + 1 < strip_count) && (type != RM_TRISTRIPPER_CODEC_TYPE_SWAP), "Strip %zu of the encoded strips contains an invalid swap.", i);
+
+				strip_ids[j] = strip_ids[j - 2];
+				j++;
+			}
+
+			//A swap on its own:
+			if (rm_unlikely(type == RM_TRISTRIPPER_CODEC_TYPE_SWAP))
+			{
+				rm_precond(((tag & RM_TRISTRIPPER_CODEC_PAYLOAD_MASK) == 0) && (j >= 2), "Strip %zu of the encoded strips contains an invalid swap.", i);
+
+				strip_ids[j] = strip_ids[j - 2];
+				continue;
+			}
+
+			//NEW, CACHE and LITERAL are decoded without branches (except for the varint of large values).
+			//All three candidates are computed and the type selects one of them.
+			rm_uint32 payload = tag & RM_TRISTRIPPER_CODEC_PAYLOAD_MASK;
+			rm_uint32 value = payload & RM_TRISTRIPPER_CODEC_VALUE_MASK;
+			rm_bool is_cache = (type == RM_TRISTRIPPER_CODEC_TYPE_CACHE);
+
+			if (rm_unlikely((tag & RM_TRISTRIPPER_CODEC_MORE_FLAG) && !is_cache))
+			{
+				value |= (rm_uint32)read_varint(&ptr, end, is_bounded, RM_TRISTRIPPER_CODEC_MAX_VARINT_32_SIZE) << RM_TRISTRIPPER_CODEC_VALUE_SHIFT;
+			}
+
+			rm_tristripper_id new_id = next_new_id + value;
+			rm_tristripper_id literal_id = prev_literal_id + zigzag_decode(value);
+			rm_tristripper_id cache_id = ring[(ring_head - 1 - payload) % (2 * RM_TRISTRIPPER_CODEC_RING_SIZE)];
+
+			rm_tristripper_id id = is_cache ? cache_id : ((type == RM_TRISTRIPPER_CODEC_TYPE_NEW) ? new_id : literal_id);
+
+			//NEW and LITERAL push to the ring.
+			//For CACHE, the write goes to a slot that cannot be addressed and is overwritten later.
+			ring[ring_head % (2 * RM_TRISTRIPPER_CODEC_RING_SIZE)] = id;
+			ring_head += is_cache ? 0 : 1;
+
+			next_new_id = (type == RM_TRISTRIPPER_CODEC_TYPE_NEW) ? (id + 1) : next_new_id;
+			prev_literal_id = (type == RM_TRISTRIPPER_CODEC_TYPE_LITERAL) ? id : prev_literal_id;
+
+			strip_ids[j] = id;
+		}
+	}
+
+	rm_precond(ids_index == header.ids_count, "The encoded strips contain fewer IDs than their header states.");
+}
+
+rm_void rm_tristripper_codec_decode(const rm_uint8* data, rm_size size, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	rm_assert(strips, "Passed strips pointer must be valid.");
+	rm_assert(strips_count, "Passed strips count pointer must be valid.");
+
+	rm_tristripper_codec_header header;
+	rm_tristripper_codec_read_header(data, size, &header);
+
+	//Decode into a single buffer first:
+	rm_tristripper_id* ids = (header.ids_count == 0) ? null : rm_malloc(header.ids_count * sizeof(rm_tristripper_id));
+	rm_size* strip_ids_counts = (header.strips_count == 0) ? null : rm_malloc(header.strips_count * sizeof(rm_size));
+
+	rm_tristripper_codec_decode_ids(data, size, ids, strip_ids_counts);
+
+	//Use the same layout as "rm_tristripper_create_strips(...)" to share the dispose function:
+	*strips = (header.strips_count == 0) ? null : rm_malloc(header.strips_count * sizeof(rm_tristripper_strip));
+	*strips_count = header.strips_count;
+
+	rm_size ids_index = 0;
+
+	for (rm_size i = 0; i < header.strips_count; i++)
+	{
+		rm_tristripper_strip* strip = &(*strips)[i];
+		strip->ids_count = strip_ids_counts[i];
+		strip->ids = rm_mem_dup(&ids[ids_index], strip->ids_count * sizeof(rm_tristripper_id));
+
+		ids_index += strip->ids_count;
+	}
+
+	rm_free(strip_ids_counts);
+	rm_free(ids);
+}
@@ -0,0 +1,351 @@
+#include "rm_tristripper_components.h"
+
+#include "rm_mem.h"
+#include "rm_thread.h"
+#include "rm_time.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_simple.h"
+#include "rm_tristripper_ex.h"
+#include "rm_tristripper_exact.h"
+
+//Components with up to this number of triangles always form a single strip and take the fast path:
+#define RM_TRISTRIPPER_TINY_COMPONENT_MAX_COUNT ((rm_size)3)
+
+//The strips of a single component:
+typedef struct __rm_tristripper_component_result__
+{
+	//Tiny components produce exactly one strip.
+	//We store it in "tiny_strip" and let "strips" point there to avoid another malloc.
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+	rm_tristripper_strip tiny_strip;
+} rm_tristripper_component_result;
+
+//Everything the workers share.
+//"next_component_index" is the only mutable field and must be accessed atomically.
+typedef struct __rm_tristripper_components_job__
+{
+	rm_tristripper_tri* tris;
+	rm_size tris_count;
+	const rm_size* component_offsets;
+	rm_size components_count;
+	const rm_tristripper_config* config;
+	rm_tristripper_process_stats* process_stats;
+	rm_tristripper_component_result* results;
+	rm_size next_component_index;
+} rm_tristripper_components_job;
+
+//Create the strip for a connected component of 1, 2 or 3 triangles.
+//Such a component is always a path (or a cycle of three), so the result is a single strip without swaps.
+//We can read it directly from the neighbour pointers without sorting anything into adjacency lists.
+static rm_void rm_tristripper_create_strip_tiny(const rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_strip* strip);
+
+//Fetch components from the job until all of them have been stripped:
+static rm_void rm_tristripper_components_work(rm_tristripper_components_job* job, rm_tristripper_scratch* scratch);
+
+//The entry point of an additional worker thread.
+//It works with a scratch of its own.
+static rm_void* rm_tristripper_components_worker(rm_void* arg);
+
+static rm_void rm_tristripper_create_strip_tiny(const rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_strip* strip)
+{
+	rm_assert((tris_count > 0) && (tris_count <= RM_TRISTRIPPER_TINY_COMPONENT_MAX_COUNT), "Invalid tiny component size: %zu", tris_count);
+
+	//A single triangle is a strip on its own:
+	if (tris_count == 1)
+	{
+		strip->ids_count = 3;
+		strip->ids = rm_mem_dup(tris[0].vertices, 3 * sizeof(rm_tristripper_id));
+
+		return;
+	}
+
+	//Look for a middle triangle (the one with the most neighbours).
+	//For two triangles, this is simply the first one and there is only one neighbour.
+	const rm_tristripper_tri* middle_tri = null;
+	rm_size middle_neighbour_indices[2] = { 0 };
+	rm_size middle_neighbours_count = 0;
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_size neighbours_count = 0;
+
+		for (rm_size j = 0; j < rm_array_count(tris[i].neighbours); j++)
+		{
+			if (tris[i].neighbours[j])
+			{
+				neighbours_count++;
+			}
+		}
+
+		if (neighbours_count > middle_neighbours_count)
+		{
+			middle_tri = &tris[i];
+			middle_neighbours_count = neighbours_count;
+		}
+	}
+
+	rm_assert(middle_tri && (middle_neighbours_count >= tris_count - 1), "Tiny component is not connected.");
+
+	//Collect the indices of the (first two) neighbours of the middle triangle:
+	for (rm_size i = 0, j = 0; (i < rm_array_count(middle_tri->neighbours)) && (j < tris_count - 1); i++)
+	{
+		if (middle_tri->neighbours[i])
+		{
+			middle_neighbour_indices[j++] = i;
+		}
+	}
+
+	//Two triangles: Start with the middle one and append the opposite vertex of the other one.
+	//This is identical to what stripify and tunneling produce.
+	if (tris_count == 2)
+	{
+		rm_size index_first_to_second = middle_neighbour_indices[0];
+		rm_size index_second_to_first = (rm_size)middle_tri->indices_at_neighbours[index_first_to_second];
+
+		strip->ids_count = 4;
+		strip->ids = rm_malloc(4 * sizeof(rm_tristripper_id));
+
+		strip->ids[0] = middle_tri->vertices[(index_first_to_second + 2) % 3];
+		strip->ids[1] = middle_tri->vertices[index_first_to_second];
+		strip->ids[2] = middle_tri->vertices[(index_first_to_second + 1) % 3];
+		strip->ids[3] = middle_tri->neighbours[index_first_to_second]->vertices[(index_second_to_first + 2) % 3];
+
+		return;
+	}
+
+	//Three triangles: The middle one becomes the second core triangle, its neighbours the first and the third one.
+	const rm_tristripper_tri* first_tri = middle_tri->neighbours[middle_neighbour_indices[0]];
+	const rm_tristripper_tri* third_tri = middle_tri->neighbours[middle_neighbour_indices[1]];
+
+	rm_size index_first_to_middle = (rm_size)middle_tri->indices_at_neighbours[middle_neighbour_indices[0]];
+	rm_size index_third_to_middle = (rm_size)middle_tri->indices_at_neighbours[middle_neighbour_indices[1]];
+
+	//Get the shared edges as seen from the first resp. the middle triangle and derive the core entrances from them:
+	rm_tristripper_id first_shared_edge[2] = { first_tri->vertices[index_first_to_middle], first_tri->vertices[(index_first_to_middle + 1) % 3] };
+	rm_tristripper_id second_shared_edge[2] = { middle_tri->vertices[middle_neighbour_indices[1]], middle_tri->vertices[(middle_neighbour_indices[1] + 1) % 3] };
+	rm_tristripper_id core_entrance_vertex_ids[3];
+
+	rm_tristripper_determine_core_entrance_vertex_ids(first_shared_edge, second_shared_edge, core_entrance_vertex_ids);
+
+	//If we have to fix the orientation, the first vertex ID must be repeated:
+	rm_bool is_duplication_required = preserve_orientation && (first_tri->vertices[index_first_to_middle] != core_entrance_vertex_ids[0]);
+
+	strip->ids_count = is_duplication_required ? 6 : 5;
+	strip->ids = rm_malloc(strip->ids_count * sizeof(rm_tristripper_id));
+
+	rm_size ids_index = 0;
+	rm_tristripper_id first_vertex_id = first_tri->vertices[(index_first_to_middle + 2) % 3];
+
+	strip->ids[ids_index++] = first_vertex_id;
+
+	if (is_duplication_required)
+	{
+		strip->ids[ids_index++] = first_vertex_id;
+	}
+
+	for (rm_size i = 0; i < rm_array_count(core_entrance_vertex_ids); i++)
+	{
+		strip->ids[ids_index++] = core_entrance_vertex_ids[i];
+	}
+
+	//Complete the third triangle with its opposite vertex:
+	strip->ids[ids_index] = third_tri->vertices[(index_third_to_middle + 2) % 3];
+}
+
+static rm_void rm_tristripper_components_work(rm_tristripper_components_job* job, rm_tristripper_scratch* scratch)
+{
+	//The tag of the memory is thread-local, so we have to set it here as well:
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_STRIPS);
+
+	while (true)
+	{
+		//Grab the next component:
+		rm_size component_index = rm_atomic_fetch_add(&job->next_component_index, 1);
+
+		if (component_index >= job->components_count)
+		{
+			break;
+		}
+
+		//Determine its range:
+		rm_size first_tri_index = job->component_offsets[component_index];
+		rm_size last_tri_index = (component_index + 1 < job->components_count) ? job->component_offsets[component_index + 1] : job->tris_count;
+		rm_size tris_count = last_tri_index - first_tri_index;
+
+		rm_tristripper_component_result* result = &job->results[component_index];
+
+		if (tris_count <= RM_TRISTRIPPER_TINY_COMPONENT_MAX_COUNT)
+		{
+			//Fast path:
+			rm_tristripper_create_strip_tiny(&job->tris[first_tri_index], tris_count, job->config->preserve_orientation, &result->tiny_strip);
+
+			result->strips = &result->tiny_strip;
+			result->strips_count = 1;
+		}
+		else
+		{
+			//Every component gets its own copy of the config because "max_count" is truncated per component:
+			rm_tristripper_config config = *job->config;
+
+			//The time budget of the local search is divided among the components by size:
+			config.optimize_usecs = (job->config->optimize_usecs * tris_count) / job->tris_count;
+			rm_tristripper_create_strips_component(&job->tris[first_tri_index], tris_count, &config, job->process_stats, scratch, &result->strips, &result->strips_count);
+		}
+	}
+
+	rm_mem_pop_tag(previous_mem_tag);
+}
+
+static rm_void* rm_tristripper_components_worker(rm_void* arg)
+{
+	rm_tristripper_scratch scratch;
+	rm_tristripper_init_scratch(&scratch);
+
+	rm_tristripper_components_work(arg, &scratch);
+
+	rm_tristripper_dispose_scratch(&scratch);
+
+	return null;
+}
+
+rm_void rm_tristripper_create_strips_component(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_assert(config, "Passed config must be valid.");
+	rm_assert(process_stats, "Passed process stats must be valid.");
+	rm_assert(scratch, "Passed scratch must be valid.");
+
+	//Tunneling or stripify-only?
+	if (config->use_tunneling)
+	{
+		//We want to perform tunneling.
+		//The maximum size of a tunnel should be limited to the maximum number of triangles (except that is below 2 or above UINT16_MAX).
+		//It is also a stupid idea to use an odd value because all tunnels need an even count.
+		//So let's perform truncation here.
+		config->max_count = rm_min(rm_min(config->max_count, tris_count), (rm_size)UINT16_MAX);
+		config->max_count = rm_max((config->max_count / 2) * 2, (rm_size)2);
+
+		//Apply the extended "tunneling" algorithm:
+		rm_tristripper_create_strips_ex(tris, tris_count, config, process_stats, scratch, strips, strips_count);
+	}
+	else
+	{
+		//Apply the simple "stripify" algorithm:
+		rm_tristripper_create_strips_simple(tris, tris_count, config->preserve_orientation, scratch, strips, strips_count);
+	}
+
+	//Small enough for the exact solver?
+	if (tris_count <= config->exact_max_count)
+	{
+		rm_uint64 start_nsecs = rm_time_now();
+
+		//The heuristic solution is our incumbent:
+		rm_size incumbent_cost = rm_tristripper_calculate_cost(*strips, *strips_count, tris_count, config);
+
+		rm_tristripper_strip* exact_strips;
+		rm_size exact_strips_count;
+
+		rm_tristripper_exact_result result = rm_tristripper_create_strips_exact(tris, tris_count, config, incumbent_cost, scratch, &exact_strips, &exact_strips_count);
+
+		if ((result == RM_TRISTRIPPER_EXACT_RESULT_OPTIMAL) || (result == RM_TRISTRIPPER_EXACT_RESULT_IMPROVED_ABORTED))
+		{
+			//Replace the heuristic strips:
+			rm_tristripper_dispose_strips(*strips, *strips_count);
+
+			*strips = exact_strips;
+			*strips_count = exact_strips_count;
+
+			rm_atomic_fetch_add(&process_stats->exact_improvements_count, 1);
+		}
+
+		if ((result == RM_TRISTRIPPER_EXACT_RESULT_IMPROVED_ABORTED) || (result == RM_TRISTRIPPER_EXACT_RESULT_NO_IMPROVEMENT_ABORTED))
+		{
+			rm_atomic_fetch_add(&process_stats->exact_aborts_count, 1);
+		}
+
+		rm_atomic_fetch_add(&process_stats->exact_components_count, 1);
+		rm_atomic_fetch_add(&process_stats->exact_nsecs, rm_time_now() - start_nsecs);
+	}
+}
+
+rm_void rm_tristripper_create_strips_components(rm_tristripper_tri* tris, rm_size tris_count, const rm_size* component_offsets, rm_size components_count, const rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_assert(component_offsets, "Passed component offsets must be valid.");
+	rm_assert((components_count > 0) && (components_count <= tris_count), "Invalid number of components: %zu", components_count);
+	rm_assert(config, "Passed config must be valid.");
+	rm_assert(scratch, "Passed scratch must be valid.");
+	rm_assert(strips, "Passed strip outpointer must be valid.");
+	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
+
+	//Prepare the job:
+	rm_tristripper_components_job job =
+	{
+		.tris = tris,
+		.tris_count = tris_count,
+		.component_offsets = component_offsets,
+		.components_count = components_count,
+		.config = config,
+		.process_stats = process_stats,
+		.results = rm_malloc(components_count * sizeof(rm_tristripper_component_result)),
+		.next_component_index = 0
+	};
+
+	//Determine the number of threads.
+	//There is no point in having more threads than components.
+	rm_size threads_count = (config->threads_count == RM_TRISTRIPPER_THREADS_COUNT_AUTO) ? rm_thread_get_processors_count() : config->threads_count;
+	threads_count = rm_min(threads_count, components_count);
+
+	//Spawn the additional threads, the calling thread participates as well:
+	rm_thread* threads = (threads_count > 1) ? rm_malloc((threads_count - 1) * sizeof(rm_thread)) : null;
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_create(&threads[i], rm_tristripper_components_worker, &job);
+	}
+
+	rm_tristripper_components_work(&job, scratch);
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_join(threads[i]);
+	}
+
+	rm_free(threads);
+
+	//Merge the results in component order:
+	rm_size result_strips_count = 0;
+
+	for (rm_size i = 0; i < components_count; i++)
+	{
+		result_strips_count += job.results[i].strips_count;
+	}
+
+	rm_tristripper_strip* result_strips = rm_malloc(result_strips_count * sizeof(rm_tristripper_strip));
+	rm_size result_strips_index = 0;
+
+	for (rm_size i = 0; i < components_count; i++)
+	{
+		rm_tristripper_component_result* result = &job.results[i];
+
+		//The strips themselves are moved, only the arrays are freed:
+		rm_mem_copy(&result_strips[result_strips_index], result->strips, result->strips_count * sizeof(rm_tristripper_strip));
+		result_strips_index += result->strips_count;
+
+		if (result->strips != &result->tiny_strip)
+		{
+			rm_free(result->strips);
+		}
+	}
+
+	rm_free(job.results);
+
+	//Assign the resulting tristrips:
+	*strips = result_strips;
+	*strips_count = result_strips_count;
+}
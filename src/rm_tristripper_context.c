@@ -0,0 +1,70 @@
+#include "rm_tristripper_context.h"
+
+#include "rm_mem.h"
+
+rm_void rm_tristripper_init_context(rm_tristripper_context* context)
+{
+	rm_assert(context, "Passed context must be valid.");
+
+	context->tris = null;
+	context->spare_tris = null;
+	context->tris_capacity = 0;
+
+	//The buckets are allocated on the first call, when we know how many edges to expect:
+	rm_tristripper_open_edge_hashmap_init_ex(&context->open_edges, 0, RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR);
+
+	rm_vec_init(&context->component_offsets);
+	rm_tristripper_init_scratch(&context->scratch);
+}
+
+rm_void rm_tristripper_trim_context(rm_tristripper_context* context)
+{
+	//Everything is rebuilt on the next call, so we can start from scratch:
+	rm_tristripper_dispose_context(context);
+	rm_tristripper_init_context(context);
+}
+
+rm_void rm_tristripper_dispose_context(rm_tristripper_context* context)
+{
+	rm_assert(context, "Passed context must be valid.");
+
+	rm_free(context->tris);
+	rm_free(context->spare_tris);
+	rm_tristripper_open_edge_hashmap_dispose(&context->open_edges);
+	rm_vec_dispose(&context->component_offsets);
+	rm_tristripper_dispose_scratch(&context->scratch);
+}
+
+rm_void rm_tristripper_init_scratch(rm_tristripper_scratch* scratch)
+{
+	rm_assert(scratch, "Passed scratch must be valid.");
+
+	scratch->tunnel = null;
+	scratch->tunnel_capacity = 0;
+	rm_vec_init(&scratch->strip_ids);
+}
+
+rm_void rm_tristripper_dispose_scratch(rm_tristripper_scratch* scratch)
+{
+	rm_assert(scratch, "Passed scratch must be valid.");
+
+	rm_free(scratch->tunnel);
+	rm_vec_dispose(&scratch->strip_ids);
+}
+
+rm_tristripper_tri** rm_tristripper_reserve_tunnel(rm_tristripper_scratch* scratch, rm_size count)
+{
+	rm_assert(scratch, "Passed scratch must be valid.");
+
+	if (count > scratch->tunnel_capacity)
+	{
+		//The stack is empty between two tunnels, so there is nothing to keep:
+		rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_TUNNEL_STACK);
+		rm_free(scratch->tunnel);
+		scratch->tunnel = rm_malloc(count * sizeof(rm_tristripper_tri*));
+		scratch->tunnel_capacity = count;
+		rm_mem_pop_tag(previous_mem_tag);
+	}
+
+	return scratch->tunnel;
+}
@@ -0,0 +1,140 @@
+#include "rm_tristripper_draws.h"
+
+#include "rm_mem.h"
+
+#include "rm_tristripper.h"
+
+//Is the strip merged into the list?
+static inline rm_bool rm_tristripper_draws_is_list_strip(const rm_tristripper_strip* strip, const rm_tristripper_draws_config* draws_config);
+
+static inline rm_bool rm_tristripper_draws_is_list_strip(const rm_tristripper_strip* strip, const rm_tristripper_draws_config* draws_config)
+{
+	return (strip->ids_count < 3) || ((strip->ids_count - 2) <= draws_config->list_max_tris_count);
+}
+
+rm_void rm_tristripper_pack_draws(const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_draws_config* draws_config, rm_tristripper_draws* draws)
+{
+	rm_assert(strips || (strips_count == 0), "Passed strips must be valid.");
+	rm_assert(draws_config, "Passed draws config must be valid.");
+	rm_assert(draws, "Passed draws must be valid.");
+
+	//The sizes follow from the counts alone, so we can allocate before we touch any ID.
+	//Swaps in the list are dropped, so its part of the index buffer might end up a bit shorter.
+	rm_size strip_commands_count = 0;
+	rm_size strip_ids_count = 0;
+	rm_size max_list_ids_count = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		const rm_tristripper_strip* strip = &strips[i];
+		rm_precond(strip->ids_count <= UINT32_MAX, "Strips must have at most %" PRIu32 " IDs.", UINT32_MAX);
+
+		if (rm_tristripper_draws_is_list_strip(strip, draws_config))
+		{
+			max_list_ids_count += (strip->ids_count < 3) ? 0 : (3 * (strip->ids_count - 2));
+		}
+		else
+		{
+			strip_commands_count++;
+			strip_ids_count += strip->ids_count;
+		}
+	}
+
+	rm_size max_ids_count = strip_ids_count + max_list_ids_count;
+	rm_size max_commands_count = strip_commands_count + ((max_list_ids_count > 0) ? 1 : 0);
+	rm_precond(max_ids_count <= UINT32_MAX, "The index buffer must have at most %" PRIu32 " IDs.", UINT32_MAX);
+
+	//The commands come first, so they are aligned:
+	rm_size size = (max_commands_count * sizeof(rm_tristripper_draw_command)) + (max_ids_count * sizeof(rm_tristripper_id));
+	rm_uint8* memory = (size == 0) ? null : rm_malloc(size);
+
+	draws->commands = (max_commands_count == 0) ? null : (rm_tristripper_draw_command*)memory;
+	draws->ids = (max_ids_count == 0) ? null : (rm_tristripper_id*)(memory + (max_commands_count * sizeof(rm_tristripper_draw_command)));
+	draws->strip_commands_count = strip_commands_count;
+	draws->list_tris_count = 0;
+
+	//Copy the strips to the front of the index buffer and write the list behind them:
+	rm_size strip_command_index = 0;
+	rm_size strip_ids_index = 0;
+	rm_size list_ids_index = strip_ids_count;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		const rm_tristripper_strip* strip = &strips[i];
+
+		if (!rm_tristripper_draws_is_list_strip(strip, draws_config))
+		{
+			draws->commands[strip_command_index++] = (rm_tristripper_draw_command)
+			{
+				.count = (rm_uint32)strip->ids_count,
+				.instance_count = 1,
+				.first_index = (rm_uint32)strip_ids_index,
+				.base_vertex = 0,
+				.base_instance = 0
+			};
+
+			rm_mem_copy(&draws->ids[strip_ids_index], strip->ids, strip->ids_count * sizeof(rm_tristripper_id));
+			strip_ids_index += strip->ids_count;
+
+			continue;
+		}
+
+		for (rm_size j = 0; j + 2 < strip->ids_count; j++)
+		{
+			//Every odd triangle of a strip is flipped:
+			rm_tristripper_id a = strip->ids[j + (j & 1)];
+			rm_tristripper_id b = strip->ids[j + 1 - (j & 1)];
+			rm_tristripper_id c = strip->ids[j + 2];
+
+			if ((a == b) || (b == c) || (c == a))
+			{
+				continue;
+			}
+
+			draws->ids[list_ids_index++] = a;
+			draws->ids[list_ids_index++] = b;
+			draws->ids[list_ids_index++] = c;
+			draws->list_tris_count++;
+		}
+	}
+
+	draws->ids_count = list_ids_index;
+	draws->commands_count = strip_commands_count;
+
+	if (draws->list_tris_count > 0)
+	{
+		draws->commands[draws->commands_count++] = (rm_tristripper_draw_command)
+		{
+			.count = (rm_uint32)(3 * draws->list_tris_count),
+			.instance_count = 1,
+			.first_index = (rm_uint32)strip_ids_count,
+			.base_vertex = 0,
+			.base_instance = 0
+		};
+	}
+}
+
+rm_void rm_tristripper_create_draws(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_config* config, const rm_tristripper_draws_config* draws_config, rm_tristripper_draws* draws)
+{
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+
+	rm_tristripper_create_strips(ids, ids_count, config, &strips, &strips_count);
+	rm_tristripper_pack_draws(strips, strips_count, draws_config, draws);
+	rm_tristripper_dispose_strips(strips, strips_count);
+}
+
+rm_void rm_tristripper_dispose_draws(rm_tristripper_draws* draws)
+{
+	rm_assert(draws, "Passed draws must be valid.");
+
+	//The commands are at the start of the allocation (if there are none, the IDs are empty as well):
+	rm_free(draws->commands);
+
+	draws->ids = null;
+	draws->ids_count = 0;
+	draws->commands = null;
+	draws->commands_count = 0;
+	draws->strip_commands_count = 0;
+	draws->list_tris_count = 0;
+}
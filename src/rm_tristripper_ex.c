@@ -1,6 +1,7 @@
 #include "rm_tristripper_ex.h"
 
 #include "rm_mem.h"
+#include "rm_tristripper_optimize.h"
 
 //Logging?
 //#define RM_TRISTRIPPER_EX_LOG
@@ -34,8 +35,9 @@ static rm_void rm_tristripper_delineate_strip_stripify(rm_tristripper_tri* first
 static rm_tristripper_tri* rm_tristripper_delineate_strip_stripify_loop(rm_tristripper_tri* prev_tri, rm_tristripper_tri* tri, rm_size index_to_prev, rm_tristripper_id entrance_vertex_id, rm_tristripper_tri** tris_adjacency_lists);
 
 //Take a list of endpoints and create strips from them via "rm_tristripper_tunnel_all_the_strips(...)".
+//If requested, improve the result with "rm_tristripper_optimize_links(...)" and "rm_tristripper_reduce_swaps(...)".
 //Then, follow all those strips across the graph and write them to the output via "rm_tristripper_collect_strip(...)".
-static rm_void rm_tristripper_tri_create_strips_from_endpoints(rm_tristripper_tri** tris_endpoint_list, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count_inout);
+static rm_void rm_tristripper_tri_create_strips_from_endpoints(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count_inout);
 
 //Try to move from one triangle in the graph to the next one of its associated strip.
 //Yes, each inner strip triangle has two tunnel neighbours, but "*index_to_prev_inout" denotes in which direction we *don't* want to move.
@@ -45,13 +47,15 @@ static rm_bool rm_tristripper_traverse_strip(rm_tristripper_tri** tri_inout, rm_
 
 //Collect a tristrip starting at "first_tri" (which must be an endpoint).
 //Write it to the given output pointer and return the second endpoint.
-static rm_tristripper_tri* rm_tristripper_collect_strip(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation, rm_tristripper_strip* strip);
+//The IDs are gathered in "strip_ids_vec" first (its contents are replaced).
+static rm_tristripper_tri* rm_tristripper_collect_strip(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation, rm_tristripper_id_vec* strip_ids_vec, rm_tristripper_strip* strip);
 static rm_tristripper_tri* rm_tristripper_collect_strip_loop(rm_tristripper_tri* curr_tri, rm_size curr_index_to_prev, rm_tristripper_id prev_entrance_vertex_id, rm_tristripper_id curr_entrance_vertex_id, rm_tristripper_id_vec* strip_ids_vec);
 
 //Apply the tunneling algorithm to all the passed tristrips.
 //For each tunnel, up to two endpoints are returned from the endpoint list.
+//The tunnel stack is taken from "scratch".
 //Return how many strips are left.
-static rm_size rm_tristripper_tunnel_all_the_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, const rm_tristripper_config* config);
+static rm_size rm_tristripper_tunnel_all_the_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, const rm_tristripper_config* config, rm_tristripper_scratch* scratch);
 
 //Dig a tunnel starting at "first_endpoint" (which must be an endpoint).
 //Use the provided config.
@@ -346,7 +350,7 @@ static rm_tristripper_tri* rm_tristripper_delineate_strip_stripify_loop(rm_trist
 	}
 }
 
-static rm_void rm_tristripper_tri_create_strips_from_endpoints(rm_tristripper_tri** tris_endpoint_list, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count_inout)
+static rm_void rm_tristripper_tri_create_strips_from_endpoints(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count_inout)
 {
 	//Get the current number of strips:
 	rm_size result_strips_count = *strips_count_inout;
@@ -360,44 +364,31 @@ static rm_void rm_tristripper_tri_create_strips_from_endpoints(rm_tristripper_tr
 		for (rm_size i = 2; i <= max_count; i += 2)
 		{
 			config->max_count = i;
-			result_strips_count = rm_tristripper_tunnel_all_the_strips(tris_endpoint_list, result_strips_count, config);
+			result_strips_count = rm_tristripper_tunnel_all_the_strips(tris_endpoint_list, result_strips_count, config, scratch);
 		}
 	}
 	else
 	{
 		//Try the maximum length immediately:
-		result_strips_count = rm_tristripper_tunnel_all_the_strips(tris_endpoint_list, result_strips_count, config);
+		result_strips_count = rm_tristripper_tunnel_all_the_strips(tris_endpoint_list, result_strips_count, config, scratch);
 	}
 
-	//Allocate the result array:
-	rm_tristripper_strip* result_strips = rm_malloc(result_strips_count * sizeof(rm_tristripper_strip));
-
-	//Spin through the list of endpoints. Create one strip from each endpoint we encounter.
-	rm_tristripper_tri* first_endpoint = *tris_endpoint_list;
-
-	for (rm_size i = 0; i < result_strips_count; i++)
+	//Local search on top?
+	if (config->optimize_usecs != RM_TRISTRIPPER_NO_OPTIMIZE)
 	{
-		//Collect the strip that starts at "first_endpoint" and prepare it for output.
-		//The return value of this call is the other endpoint of the strip if there is one (it could also be isolated).
-		//We should remove it from the linked list.
-		//Otherwise, we would build the same strip a second time in the other direction as soon as we encouter it.
-		rm_tristripper_tri* second_endpoint = rm_tristripper_collect_strip(first_endpoint, config->preserve_orientation, &result_strips[i]);
-
-		if (second_endpoint)
-		{
-			rm_tristripper_tri_remove_from_list(second_endpoint, tris_endpoint_list);
-		}
+		rm_tristripper_optimize_links(tris, tris_count, tris_endpoint_list, &result_strips_count, config, process_stats);
+	}
 
-		//Get the next first endpoint:
-		first_endpoint = first_endpoint->next_tri;
+	if (config->reduce_swaps)
+	{
+		rm_tristripper_reduce_swaps(tris, tris_count, tris_endpoint_list, config->preserve_orientation, process_stats);
 	}
 
-	//By definition, we must have reached the end of the list now:
-	rm_assert(!first_endpoint, "Created all %zu tristrips, but there are still endpoints left.", result_strips_count);
+	//Follow the links and build the strips:
+	rm_tristripper_collect_strips(tris_endpoint_list, result_strips_count, config->preserve_orientation, scratch, strips);
 
 	//Assign the resulting tristrips:
 	*strips_count_inout = result_strips_count;
-	*strips = result_strips;
 }
 
 static rm_bool rm_tristripper_traverse_strip(rm_tristripper_tri** tri_inout, rm_size* index_to_prev_inout)
@@ -442,7 +433,7 @@ static rm_bool rm_tristripper_traverse_strip(rm_tristripper_tri** tri_inout, rm_
 	rm_exit("Stranded at a non-endpoint triangle without linked neighbours.");
 }
 
-static rm_tristripper_tri* rm_tristripper_collect_strip(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation, rm_tristripper_strip* strip)
+static rm_tristripper_tri* rm_tristripper_collect_strip(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation, rm_tristripper_id_vec* strip_ids_vec, rm_tristripper_strip* strip)
 {
 	//At this point, the first triangle must always be an endpoint:
 	rm_assert(rm_tristripper_tri_is_endpoint(first_tri), "rm_tristripper_collect_strip(...) must be called with an endpoint.");
@@ -535,34 +526,30 @@ static rm_tristripper_tri* rm_tristripper_collect_strip(const rm_tristripper_tri
 	rm_tristripper_id core_entrance_vertex_ids[3];
 	rm_tristripper_determine_core_entrance_vertex_ids(first_shared_edge, second_shared_edge, core_entrance_vertex_ids);
 
-	//Initialize a vector of vertex IDs for the result:
-	rm_tristripper_id_vec strip_ids_vec;
-	rm_vec_init(&strip_ids_vec);
-
-	//TODO: Bench and optimize!
-	rm_vec_ensure_capacity(&strip_ids_vec, 32);
+	//Start over with the vector of vertex IDs:
+	rm_vec_clear(strip_ids_vec);
 
 	//Push the first vertex ID:
-	rm_vec_push(&strip_ids_vec, first_vertex_id);
+	rm_vec_push(strip_ids_vec, first_vertex_id);
 
 	//If we have to fix the orientation, the first vertex ID must be repeated:
 	if (preserve_orientation && (first_tri->vertices[index_first_to_second] != core_entrance_vertex_ids[0]))
 	{
-		rm_vec_push(&strip_ids_vec, first_vertex_id);
+		rm_vec_push(strip_ids_vec, first_vertex_id);
 	}
 
 	//Push the entrance vertex IDs of the core:
 	for (rm_size i = 0; i < rm_array_count(core_entrance_vertex_ids); i++)
 	{
-		rm_vec_push(&strip_ids_vec, core_entrance_vertex_ids[i]);
+		rm_vec_push(strip_ids_vec, core_entrance_vertex_ids[i]);
 	}
 
 	//Keep traversing until we reach an endpoint:
-	rm_tristripper_tri* last_tri = rm_tristripper_collect_strip_loop(third_tri, curr_index_to_prev, core_entrance_vertex_ids[1], core_entrance_vertex_ids[2], &strip_ids_vec);
+	rm_tristripper_tri* last_tri = rm_tristripper_collect_strip_loop(third_tri, curr_index_to_prev, core_entrance_vertex_ids[1], core_entrance_vertex_ids[2], strip_ids_vec);
 
-	//Build the strip by unwrapping the vector:
-	strip->ids_count = strip_ids_vec.count;
-	strip->ids = rm_vec_unwrap(&strip_ids_vec);
+	//Build the strip from a copy of the vector, it is reused for the next one:
+	strip->ids_count = strip_ids_vec->count;
+	strip->ids = rm_mem_dup(strip_ids_vec->data, strip_ids_vec->count * sizeof(rm_tristripper_id));
 
 	//Return the second endpoint of the strip:
 	return last_tri;
@@ -613,10 +600,10 @@ static rm_tristripper_tri* rm_tristripper_collect_strip_loop(rm_tristripper_tri*
 	return curr_tri;
 }
 
-static rm_size rm_tristripper_tunnel_all_the_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, const rm_tristripper_config* config)
+static rm_size rm_tristripper_tunnel_all_the_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, const rm_tristripper_config* config, rm_tristripper_scratch* scratch)
 {
-	//Allocate the stack for the tunnel DFS:
-	rm_tristripper_tri** tunnel = rm_malloc(config->max_count * sizeof(rm_tristripper_tri*));
+	//Get the stack for the tunnel DFS:
+	rm_tristripper_tri** tunnel = rm_tristripper_reserve_tunnel(scratch, config->max_count);
 
 	//Iterate through the remaining endpoints until only one strip is left or we have found no new tunnel:
 	rm_bool has_found_tunnel;
@@ -679,9 +666,6 @@ static rm_size rm_tristripper_tunnel_all_the_strips(rm_tristripper_tri** tris_en
 		} while (first_endpoint && (strips_count > 1));
 	} while (has_found_tunnel && (strips_count > 1));
 
-	//Free the tunnel stack:
-	rm_free(tunnel);
-
 	//Return the (hopefully) reduced number of strips:
 	return strips_count;
 }
@@ -1103,12 +1087,45 @@ static rm_tristripper_cement_tunnel_result rm_tristripper_cement_tunnel(rm_trist
 	}
 }
 
-rm_void rm_tristripper_create_strips_ex(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_strip** strips, rm_size* strips_count)
+rm_void rm_tristripper_collect_strips(rm_tristripper_tri** tris_endpoint_list, rm_size strips_count, rm_bool preserve_orientation, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips)
+{
+	//Allocate the result array:
+	rm_tristripper_strip* result_strips = rm_malloc(strips_count * sizeof(rm_tristripper_strip));
+
+	//Spin through the list of endpoints. Create one strip from each endpoint we encounter.
+	rm_tristripper_tri* first_endpoint = *tris_endpoint_list;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		//Collect the strip that starts at "first_endpoint" and prepare it for output.
+		//The return value of this call is the other endpoint of the strip if there is one (it could also be isolated).
+		//We should remove it from the linked list.
+		//Otherwise, we would build the same strip a second time in the other direction as soon as we encouter it.
+		rm_tristripper_tri* second_endpoint = rm_tristripper_collect_strip(first_endpoint, preserve_orientation, &scratch->strip_ids, &result_strips[i]);
+
+		if (second_endpoint)
+		{
+			rm_tristripper_tri_remove_from_list(second_endpoint, tris_endpoint_list);
+		}
+
+		//Get the next first endpoint:
+		first_endpoint = first_endpoint->next_tri;
+	}
+
+	//By definition, we must have reached the end of the list now:
+	rm_assert(!first_endpoint, "Created all %zu tristrips, but there are still endpoints left.", strips_count);
+
+	*strips = result_strips;
+}
+
+rm_void rm_tristripper_create_strips_ex(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_config* config, rm_tristripper_process_stats* process_stats, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count)
 {
 	//Validate the parameters:
 	rm_assert(tris, "Passed triangles must be valid.");
 	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
 	rm_assert(config, "Passed config must be valid.");
+	rm_assert(process_stats, "Passed process stats must be valid.");
+	rm_assert(scratch, "Passed scratch must be valid.");
 	rm_assert(strips, "Passed strip outpointer must be valid.");
 	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
 
@@ -1142,5 +1159,5 @@ rm_void rm_tristripper_create_strips_ex(rm_tristripper_tri* tris, rm_size tris_c
 	//Note: "strips_count" is an inout parameter!
 	//We have initialized it with the number of strips the preprocessing algorithm has created.
 	//Tunneling might (and hopefully will) reduce that number.
-	rm_tristripper_tri_create_strips_from_endpoints(&tris_endpoint_list, config, strips, strips_count);
+	rm_tristripper_tri_create_strips_from_endpoints(tris, tris_count, &tris_endpoint_list, config, process_stats, scratch, strips, strips_count);
 }
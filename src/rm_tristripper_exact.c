@@ -0,0 +1,440 @@
+#include "rm_tristripper_exact.h"
+
+#include "rm_tristripper_ex.h"
+#include "rm_tristripper_stats.h"
+
+//Every triangle has up to three neighbours, so this is the maximum number of edges in the dual graph:
+#define RM_TRISTRIPPER_EXACT_MAX_EDGES_COUNT ((RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT * 3) / 2)
+
+//The complete state of a search.
+//Triangles are referenced by their index in the passed array, so they fit into a byte.
+typedef struct __rm_tristripper_exact_state__
+{
+	//The input:
+	rm_tristripper_tri* tris;
+	rm_size tris_count;
+	const rm_tristripper_config* config;
+
+	//The edges of the dual graph.
+	//We store the indices of both triangles and the index of the second triangle in the neighbours array of the first one.
+	rm_size edges_count;
+	rm_uint8 edge_tri_indices[RM_TRISTRIPPER_EXACT_MAX_EDGES_COUNT][2];
+	rm_uint8 edge_neighbour_indices[RM_TRISTRIPPER_EXACT_MAX_EDGES_COUNT];
+
+	//For every triangle: The number of links, the number of edges we have not decided on yet
+	// and (only valid for endpoints) the other endpoint of its path.
+	rm_uint8 degrees[RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT];
+	rm_uint8 undecided_edges_counts[RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT];
+	rm_uint8 path_ends[RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT];
+
+	//The current number of links and the number of links that could still be added at most, times two.
+	//The latter is the sum of "min(2 - degree, undecided edges)" over all triangles.
+	rm_size links_count;
+	rm_size free_capacity;
+
+	//The best solution so far: Its cost, the link states of all triangles and the endpoints the strips should start at.
+	rm_size best_cost;
+	rm_tristripper_tri_link_state best_link_states[RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT];
+	rm_uint64 best_starts;
+	rm_bool is_improved;
+
+	//Keep track of the effort:
+	rm_size nodes_count;
+	rm_bool is_aborted;
+} rm_tristripper_exact_state;
+
+//Calculate the cost of a solution with the given number of strips and swaps (see "rm_tristripper_calculate_cost(...)"):
+static inline rm_size rm_tristripper_exact_cost(const rm_tristripper_exact_state* state, rm_size strips_count, rm_size swaps_count);
+
+//How many links could a triangle get at most from the undecided edges?
+static inline rm_size rm_tristripper_exact_capacity(const rm_tristripper_exact_state* state, rm_size tri_index);
+
+//Count the IDs that "rm_tristripper_collect_strip(...)" would emit for the path starting at "first_tri".
+//Unlike the collector, we don't rely on endpoint flags here, but stop as soon as there are no further links.
+static rm_size rm_tristripper_exact_count_strip_ids(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation);
+
+//Evaluate a complete decision (= all edges are either linked or not) and remember it if it is the best one so far:
+static rm_void rm_tristripper_exact_evaluate(rm_tristripper_exact_state* state);
+
+//Decide on the edge with the given index (first link, then skip) and recurse:
+static rm_void rm_tristripper_exact_search(rm_tristripper_exact_state* state, rm_size edge_index);
+
+static inline rm_size rm_tristripper_exact_cost(const rm_tristripper_exact_state* state, rm_size strips_count, rm_size swaps_count)
+{
+	return (strips_count * 2) + state->tris_count + (swaps_count * state->config->cost_per_swap) + ((strips_count - 1) * state->config->cost_per_primitive_restart);
+}
+
+static inline rm_size rm_tristripper_exact_capacity(const rm_tristripper_exact_state* state, rm_size tri_index)
+{
+	return rm_min((rm_size)(2 - state->degrees[tri_index]), (rm_size)state->undecided_edges_counts[tri_index]);
+}
+
+static rm_size rm_tristripper_exact_count_strip_ids(const rm_tristripper_tri* first_tri, rm_bool preserve_orientation)
+{
+	//Find the second triangle:
+	rm_size index_first_to_second = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	for (rm_size i = 0; i < rm_array_count(first_tri->neighbours); i++)
+	{
+		if (rm_tristripper_tri_is_linked_to_neighbour(first_tri, i))
+		{
+			index_first_to_second = i;
+			break;
+		}
+	}
+
+	//Isolated triangle:
+	if (index_first_to_second == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+	{
+		return 3;
+	}
+
+	const rm_tristripper_tri* second_tri = first_tri->neighbours[index_first_to_second];
+	rm_size curr_index_to_prev = (rm_size)first_tri->indices_at_neighbours[index_first_to_second];
+
+	//Find the third triangle:
+	rm_size index_second_to_third = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_size curr_neighbour_index = rm_tristripper_tri_remaining_index(curr_index_to_prev, i);
+
+		if (rm_tristripper_tri_is_linked_to_neighbour(second_tri, curr_neighbour_index))
+		{
+			index_second_to_third = curr_neighbour_index;
+			break;
+		}
+	}
+
+	//Two triangles:
+	if (index_second_to_third == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+	{
+		return 4;
+	}
+
+	//Determine the entrance vertices of the core just like the collector does:
+	rm_tristripper_id first_shared_edge[2] = { first_tri->vertices[index_first_to_second], first_tri->vertices[(index_first_to_second + 1) % 3] };
+	rm_tristripper_id second_shared_edge[2] = { second_tri->vertices[index_second_to_third], second_tri->vertices[(index_second_to_third + 1) % 3] };
+	rm_tristripper_id core_entrance_vertex_ids[3];
+
+	rm_tristripper_determine_core_entrance_vertex_ids(first_shared_edge, second_shared_edge, core_entrance_vertex_ids);
+
+	//First vertex, optional orientation fix and the core entrances:
+	rm_size ids_count = 4;
+
+	if (preserve_orientation && (first_tri->vertices[index_first_to_second] != core_entrance_vertex_ids[0]))
+	{
+		ids_count++;
+	}
+
+	//Follow the strip and count the swaps (see "rm_tristripper_collect_strip_loop(...)"):
+	const rm_tristripper_tri* curr_tri = second_tri->neighbours[index_second_to_third];
+	curr_index_to_prev = (rm_size)second_tri->indices_at_neighbours[index_second_to_third];
+
+	//Note: The previous entrance only matters for the emitted IDs, not for their count.
+	rm_tristripper_id curr_entrance_vertex_id = core_entrance_vertex_ids[2];
+
+	while (true)
+	{
+		rm_tristripper_id next_entrance_vertex_id = curr_tri->vertices[(curr_index_to_prev + 2) % 3];
+		rm_size next_neighbour_index = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+		for (rm_size i = 0; i < 2; i++)
+		{
+			rm_size curr_neighbour_index = rm_tristripper_tri_remaining_index(curr_index_to_prev, i);
+
+			if (rm_tristripper_tri_is_linked_to_neighbour(curr_tri, curr_neighbour_index))
+			{
+				next_neighbour_index = curr_neighbour_index;
+				break;
+			}
+		}
+
+		//The next entrance completes the current triangle:
+		ids_count++;
+
+		if (next_neighbour_index == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+		{
+			return ids_count;
+		}
+
+		//Move on and check for near / far neighbours:
+		rm_size next_index_to_prev = (rm_size)curr_tri->indices_at_neighbours[next_neighbour_index];
+		curr_tri = curr_tri->neighbours[next_neighbour_index];
+		curr_index_to_prev = next_index_to_prev;
+
+		if ((curr_tri->vertices[curr_index_to_prev] != curr_entrance_vertex_id) && (curr_tri->vertices[(curr_index_to_prev + 1) % 3] != curr_entrance_vertex_id))
+		{
+			//Swap!
+			ids_count++;
+		}
+
+		curr_entrance_vertex_id = next_entrance_vertex_id;
+	}
+}
+
+static rm_void rm_tristripper_exact_evaluate(rm_tristripper_exact_state* state)
+{
+	rm_size strips_count = state->tris_count - state->links_count;
+	rm_size ids_count = 0;
+	rm_uint64 starts = 0;
+
+	//Look at every path once (from its endpoint with the lower index) and pick the cheaper direction.
+	//If swaps are free, the direction does not matter at all.
+	rm_bool is_counting_required = (state->config->cost_per_swap > 0);
+	rm_uint64 visited_endpoints = 0;
+
+	for (rm_size i = 0; i < state->tris_count; i++)
+	{
+		if ((state->degrees[i] == 2) || (visited_endpoints & ((rm_uint64)1 << i)))
+		{
+			continue;
+		}
+
+		rm_size other_end_index = (state->degrees[i] == 0) ? i : (rm_size)state->path_ends[i];
+		visited_endpoints |= ((rm_uint64)1 << i) | ((rm_uint64)1 << other_end_index);
+
+		rm_size start_index = i;
+
+		if (is_counting_required)
+		{
+			rm_size curr_ids_count = rm_tristripper_exact_count_strip_ids(&state->tris[i], state->config->preserve_orientation);
+
+			if (other_end_index != i)
+			{
+				rm_size other_ids_count = rm_tristripper_exact_count_strip_ids(&state->tris[other_end_index], state->config->preserve_orientation);
+
+				if (other_ids_count < curr_ids_count)
+				{
+					curr_ids_count = other_ids_count;
+					start_index = other_end_index;
+				}
+			}
+
+			ids_count += curr_ids_count;
+		}
+
+		starts |= ((rm_uint64)1 << start_index);
+	}
+
+	//Every ID that neither opens a strip nor completes a triangle belongs to a swap:
+	rm_size swaps_count = is_counting_required ? (ids_count - (strips_count * 2) - state->tris_count) : 0;
+	rm_size cost = rm_tristripper_exact_cost(state, strips_count, swaps_count);
+
+	if (cost < state->best_cost)
+	{
+		state->best_cost = cost;
+		state->best_starts = starts;
+		state->is_improved = true;
+
+		for (rm_size i = 0; i < state->tris_count; i++)
+		{
+			state->best_link_states[i] = state->tris[i].link_state & 7;
+		}
+	}
+}
+
+static rm_void rm_tristripper_exact_search(rm_tristripper_exact_state* state, rm_size edge_index)
+{
+	//Stop if we have spent enough effort:
+	if (state->is_aborted || (++state->nodes_count > RM_TRISTRIPPER_EXACT_MAX_NODES_COUNT))
+	{
+		state->is_aborted = true;
+		return;
+	}
+
+	//Bound: Assume we could add as many links as the capacity allows and none of the strips had swaps.
+	//If that is still not cheaper than the best solution, this branch is not worth it.
+	rm_size max_links_count = rm_min(state->links_count + (state->free_capacity / 2), state->tris_count - 1);
+
+	if (rm_tristripper_exact_cost(state, state->tris_count - max_links_count, 0) >= state->best_cost)
+	{
+		return;
+	}
+
+	//Are all edges decided?
+	if (edge_index == state->edges_count)
+	{
+		rm_tristripper_exact_evaluate(state);
+		return;
+	}
+
+	//Get the edge:
+	rm_size first_index = (rm_size)state->edge_tri_indices[edge_index][0];
+	rm_size second_index = (rm_size)state->edge_tri_indices[edge_index][1];
+	rm_size first_to_second_index = (rm_size)state->edge_neighbour_indices[edge_index];
+
+	rm_tristripper_tri* first_tri = &state->tris[first_index];
+	rm_tristripper_tri* second_tri = &state->tris[second_index];
+	rm_size second_to_first_index = (rm_size)first_tri->indices_at_neighbours[first_to_second_index];
+
+	//The edge is decided now, so both triangles lose capacity:
+	rm_size prev_free_capacity = state->free_capacity;
+	rm_size prev_capacity = rm_tristripper_exact_capacity(state, first_index) + rm_tristripper_exact_capacity(state, second_index);
+
+	state->undecided_edges_counts[first_index]--;
+	state->undecided_edges_counts[second_index]--;
+
+	//First option: Link the two triangles.
+	//Both must have a free slot and must not be the two ends of the same path (that would close a cycle).
+	if ((state->degrees[first_index] < 2) && (state->degrees[second_index] < 2) && ((rm_size)state->path_ends[first_index] != second_index))
+	{
+		state->degrees[first_index]++;
+		state->degrees[second_index]++;
+		state->links_count++;
+		state->free_capacity = prev_free_capacity - prev_capacity + rm_tristripper_exact_capacity(state, first_index) + rm_tristripper_exact_capacity(state, second_index);
+
+		//Join the two paths:
+		rm_uint8 first_end_index = state->path_ends[first_index];
+		rm_uint8 second_end_index = state->path_ends[second_index];
+
+		state->path_ends[first_end_index] = second_end_index;
+		state->path_ends[second_end_index] = first_end_index;
+
+		rm_tristripper_tri_link_to_neighbour(first_tri, first_to_second_index);
+		rm_tristripper_tri_link_to_neighbour(second_tri, second_to_first_index);
+
+		rm_tristripper_exact_search(state, edge_index + 1);
+
+		//Undo everything:
+		rm_tristripper_tri_unlink_from_neighbour(first_tri, first_to_second_index);
+		rm_tristripper_tri_unlink_from_neighbour(second_tri, second_to_first_index);
+
+		state->path_ends[first_end_index] = (rm_uint8)first_index;
+		state->path_ends[second_end_index] = (rm_uint8)second_index;
+
+		state->degrees[first_index]--;
+		state->degrees[second_index]--;
+		state->links_count--;
+	}
+
+	//Second option: Don't link them.
+	state->free_capacity = prev_free_capacity - prev_capacity + rm_tristripper_exact_capacity(state, first_index) + rm_tristripper_exact_capacity(state, second_index);
+	rm_tristripper_exact_search(state, edge_index + 1);
+
+	//Undo:
+	state->undecided_edges_counts[first_index]++;
+	state->undecided_edges_counts[second_index]++;
+	state->free_capacity = prev_free_capacity;
+}
+
+rm_tristripper_exact_result rm_tristripper_create_strips_exact(rm_tristripper_tri* tris, rm_size tris_count, const rm_tristripper_config* config, rm_size incumbent_cost, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_precond(tris_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles, but %zu have been passed.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, tris_count);
+	rm_assert(config, "Passed config must be valid.");
+	rm_assert(strips, "Passed strip outpointer must be valid.");
+	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
+
+	//The state is small enough to live on the stack:
+	rm_tristripper_exact_state state;
+
+	state.tris = tris;
+	state.tris_count = tris_count;
+	state.config = config;
+	state.edges_count = 0;
+	state.links_count = 0;
+	state.free_capacity = 0;
+	state.best_cost = incumbent_cost;
+	state.best_starts = 0;
+	state.is_improved = false;
+	state.nodes_count = 0;
+	state.is_aborted = false;
+
+	//Collect the edges (each one from the triangle with the lower index) and start without any links:
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		tri->link_state = 0;
+		state.degrees[i] = 0;
+		state.undecided_edges_counts[i] = 0;
+		state.path_ends[i] = (rm_uint8)i;
+
+		for (rm_size j = 0; j < rm_array_count(tri->neighbours); j++)
+		{
+			if (!tri->neighbours[j])
+			{
+				continue;
+			}
+
+			rm_size neighbour_index = (rm_size)(tri->neighbours[j] - tris);
+			rm_assert(neighbour_index < tris_count, "Triangles must not have neighbours outside of the passed range.");
+
+			state.undecided_edges_counts[i]++;
+
+			if (neighbour_index > i)
+			{
+				state.edge_tri_indices[state.edges_count][0] = (rm_uint8)i;
+				state.edge_tri_indices[state.edges_count][1] = (rm_uint8)neighbour_index;
+				state.edge_neighbour_indices[state.edges_count] = (rm_uint8)j;
+				state.edges_count++;
+			}
+		}
+	}
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		state.free_capacity += rm_tristripper_exact_capacity(&state, i);
+	}
+
+	//Search:
+	rm_tristripper_exact_search(&state, 0);
+
+	if (!state.is_improved)
+	{
+		return state.is_aborted ? RM_TRISTRIPPER_EXACT_RESULT_NO_IMPROVEMENT_ABORTED : RM_TRISTRIPPER_EXACT_RESULT_NO_IMPROVEMENT;
+	}
+
+	//Restore the best solution and flag the endpoints:
+	rm_size result_strips_count = 0;
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		tri->link_state = state.best_link_states[i];
+		tri->flags = 0;
+
+		rm_size degree = (rm_size)__builtin_popcount((rm_uint)tri->link_state);
+
+		if (degree < 2)
+		{
+			rm_tristripper_tri_set_endpoint(tri);
+		}
+
+		if (state.best_starts & ((rm_uint64)1 << i))
+		{
+			result_strips_count++;
+		}
+	}
+
+	//Build the endpoint list: The chosen starts must come before the other ends.
+	rm_tristripper_tri* tris_endpoint_list = null;
+
+	for (rm_size i = tris_count; i-- > 0;)
+	{
+		if (rm_tristripper_tri_is_endpoint(&tris[i]) && !(state.best_starts & ((rm_uint64)1 << i)))
+		{
+			rm_tristripper_tri_prepend_to_list(&tris[i], &tris_endpoint_list);
+		}
+	}
+
+	for (rm_size i = tris_count; i-- > 0;)
+	{
+		if (state.best_starts & ((rm_uint64)1 << i))
+		{
+			rm_tristripper_tri_prepend_to_list(&tris[i], &tris_endpoint_list);
+		}
+	}
+
+	//Collect the strips:
+	rm_tristripper_collect_strips(&tris_endpoint_list, result_strips_count, config->preserve_orientation, scratch, strips);
+	*strips_count = result_strips_count;
+
+	rm_assert(rm_tristripper_calculate_cost(*strips, *strips_count, tris_count, config) == state.best_cost, "The collected strips don't match the predicted cost.");
+
+	return state.is_aborted ? RM_TRISTRIPPER_EXACT_RESULT_IMPROVED_ABORTED : RM_TRISTRIPPER_EXACT_RESULT_OPTIMAL;
+}
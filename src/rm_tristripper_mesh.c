@@ -0,0 +1,893 @@
+#include "rm_tristripper_mesh.h"
+
+#include <strings.h>
+
+#include "rm_file.h"
+#include "rm_hashmap.h"
+#include "rm_mem.h"
+
+//A buffered reader on top of "rm_file" that hands out bytes and lines without copying them:
+typedef struct __rm_tristripper_mesh_reader__
+{
+	rm_file file;
+	rm_uint8* buf;
+	rm_size capacity;
+	rm_size pos;
+	rm_size end;
+	rm_bool is_eof;
+} rm_tristripper_mesh_reader;
+
+//A polygon that is triangulated as a fan while its vertices arrive:
+typedef struct __rm_tristripper_mesh_polygon__
+{
+	rm_tristripper_id first_id;
+	rm_tristripper_id prev_id;
+	rm_size ids_count;
+} rm_tristripper_mesh_polygon;
+
+//The scalar types of PLY properties:
+typedef enum __rm_tristripper_ply_type__
+{
+	RM_TRISTRIPPER_PLY_TYPE_INT8,
+	RM_TRISTRIPPER_PLY_TYPE_UINT8,
+	RM_TRISTRIPPER_PLY_TYPE_INT16,
+	RM_TRISTRIPPER_PLY_TYPE_UINT16,
+	RM_TRISTRIPPER_PLY_TYPE_INT32,
+	RM_TRISTRIPPER_PLY_TYPE_UINT32,
+	RM_TRISTRIPPER_PLY_TYPE_FLOAT32,
+	RM_TRISTRIPPER_PLY_TYPE_FLOAT64
+} rm_tristripper_ply_type;
+
+typedef enum __rm_tristripper_ply_encoding__
+{
+	RM_TRISTRIPPER_PLY_ENCODING_ASCII,
+	RM_TRISTRIPPER_PLY_ENCODING_BINARY_LE,
+	RM_TRISTRIPPER_PLY_ENCODING_BINARY_BE
+} rm_tristripper_ply_encoding;
+
+//A property of a PLY element. Lists have a count type and a value type, scalars only a value type.
+typedef struct __rm_tristripper_ply_property__
+{
+	rm_bool is_list;
+	rm_bool is_vertex_indices;
+	rm_tristripper_ply_type count_type;
+	rm_tristripper_ply_type value_type;
+} rm_tristripper_ply_property;
+
+typedef rm_vec(rm_tristripper_ply_property) rm_tristripper_ply_property_vec;
+
+//A PLY element (e.g. "vertex" or "face") with its number of instances:
+typedef struct __rm_tristripper_ply_element__
+{
+	rm_bool is_face;
+	rm_size count;
+	rm_tristripper_ply_property_vec properties;
+} rm_tristripper_ply_element;
+
+typedef rm_vec(rm_tristripper_ply_element) rm_tristripper_ply_element_vec;
+
+//STL vertices are identified by the bits of their coordinates:
+typedef struct __rm_tristripper_stl_vertex_key__
+{
+	rm_uint32 coords[3];
+} rm_tristripper_stl_vertex_key;
+
+RM_HASHMAP_DECLARE(tristripper_stl_vertex, rm_tristripper_stl_vertex_key, rm_tristripper_id, KVS)
+#define RM_TRISTRIPPER_STL_VERTEX_HASHMAP_LOAD_FACTOR 0.75
+
+//The sizes of the binary STL header and of a binary STL triangle (normal, three vertices, attribute):
+#define RM_TRISTRIPPER_STL_HEADER_SIZE ((rm_size)80)
+#define RM_TRISTRIPPER_STL_TRI_SIZE ((rm_size)50)
+
+//Open, refill and close a reader.
+//"rm_tristripper_mesh_reader_fill(...)" makes sure that at least "count" bytes are buffered.
+//It returns "false" if the file ends before that.
+static rm_void rm_tristripper_mesh_reader_init(rm_tristripper_mesh_reader* reader, const rm_char* path);
+static rm_bool rm_tristripper_mesh_reader_fill(rm_tristripper_mesh_reader* reader, rm_size count);
+static rm_void rm_tristripper_mesh_reader_dispose(rm_tristripper_mesh_reader* reader);
+
+//Consume "size" bytes. The file must not end before.
+static inline rm_void rm_tristripper_mesh_reader_read(rm_tristripper_mesh_reader* reader, rm_void* dest_ptr, rm_size size);
+
+//Hand out the next line (without the line break) that stays valid until the next call.
+//Return "false" at the end of the file.
+static rm_bool rm_tristripper_mesh_reader_next_line(rm_tristripper_mesh_reader* reader, const rm_char** line, const rm_char** line_end);
+
+//Scanning helpers for ASCII lines. They advance "*cursor", but never beyond "end".
+static inline rm_void rm_tristripper_mesh_skip_spaces(const rm_char** cursor, const rm_char* end);
+static inline rm_bool rm_tristripper_mesh_skip_token(const rm_char** cursor, const rm_char* end);
+static inline rm_bool rm_tristripper_mesh_parse_int(const rm_char** cursor, const rm_char* end, rm_int64* value);
+static inline rm_bool rm_tristripper_mesh_token_equals(const rm_char* token, const rm_char* token_end, const rm_char* str);
+
+//Add the next vertex to a polygon and emit a triangle as soon as there are three of them:
+static inline rm_void rm_tristripper_mesh_polygon_add(rm_tristripper_mesh_polygon* polygon, rm_int64 id, rm_tristripper_id_vec* ids);
+
+//The readers for the different formats:
+static rm_void rm_tristripper_read_ply(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids);
+static rm_void rm_tristripper_read_obj(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids);
+static rm_void rm_tristripper_read_stl(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids);
+
+//PLY helpers: Parse a type name, get the size of a type and read a binary integer (or skip a binary value).
+static rm_tristripper_ply_type rm_tristripper_ply_parse_type(const rm_char* token, const rm_char* token_end);
+static inline rm_size rm_tristripper_ply_type_size(rm_tristripper_ply_type type);
+static inline rm_int64 rm_tristripper_ply_read_binary_int(rm_tristripper_mesh_reader* reader, rm_tristripper_ply_type type, rm_bool is_big_endian);
+
+//Read the instances of a PLY element. Non-face elements are skipped.
+static rm_void rm_tristripper_ply_read_element_ascii(rm_tristripper_mesh_reader* reader, const rm_tristripper_ply_element* element, rm_tristripper_id_vec* ids);
+static rm_void rm_tristripper_ply_read_element_binary(rm_tristripper_mesh_reader* reader, const rm_tristripper_ply_element* element, rm_bool is_big_endian, rm_tristripper_id_vec* ids);
+
+//Hashing and comparing for the STL vertex hashmap:
+static inline rm_hashmap_hash rm_tristripper_stl_vertex_hashmap_hash(rm_tristripper_stl_vertex_key key);
+static inline rm_bool rm_tristripper_stl_vertex_hashmap_compare(rm_tristripper_stl_vertex_key key0, rm_tristripper_stl_vertex_key key1);
+
+static rm_void rm_tristripper_mesh_reader_init(rm_tristripper_mesh_reader* reader, const rm_char* path)
+{
+	reader->file = rm_file_open(path, RM_FILE_MODE_READ, RM_FILE_ENC_BINARY);
+	reader->buf = rm_malloc(RM_TRISTRIPPER_MESH_CHUNK_SIZE);
+	reader->capacity = RM_TRISTRIPPER_MESH_CHUNK_SIZE;
+	reader->pos = 0;
+	reader->end = 0;
+	reader->is_eof = false;
+}
+
+static rm_bool rm_tristripper_mesh_reader_fill(rm_tristripper_mesh_reader* reader, rm_size count)
+{
+	//Fast path: Everything is there.
+	if ((reader->end - reader->pos) >= count)
+	{
+		return true;
+	}
+
+	//Move the rest to the front and make room:
+	rm_size rest_count = reader->end - reader->pos;
+
+	if ((rest_count > 0) && (reader->pos > 0))
+	{
+		rm_mem_move(reader->buf, reader->buf + reader->pos, rest_count);
+	}
+
+	reader->pos = 0;
+	reader->end = rest_count;
+
+	if (count > reader->capacity)
+	{
+		reader->capacity = rm_max(count, 2 * reader->capacity);
+		reader->buf = rm_realloc(reader->buf, reader->capacity);
+	}
+
+	//Read whole chunks until we have enough:
+	while (!reader->is_eof && ((reader->end - reader->pos) < count))
+	{
+		rm_size requested_count = reader->capacity - reader->end;
+		rm_size read_count = rm_file_read(reader->file, reader->buf + reader->end, requested_count);
+
+		reader->end += read_count;
+		reader->is_eof = (read_count < requested_count);
+	}
+
+	return (reader->end - reader->pos) >= count;
+}
+
+static rm_void rm_tristripper_mesh_reader_dispose(rm_tristripper_mesh_reader* reader)
+{
+	rm_file_close(reader->file);
+	rm_free(reader->buf);
+}
+
+static inline rm_void rm_tristripper_mesh_reader_read(rm_tristripper_mesh_reader* reader, rm_void* dest_ptr, rm_size size)
+{
+	rm_precond(rm_tristripper_mesh_reader_fill(reader, size), "Unexpected end of mesh file.");
+
+	rm_mem_copy(dest_ptr, reader->buf + reader->pos, size);
+	reader->pos += size;
+}
+
+static rm_bool rm_tristripper_mesh_reader_next_line(rm_tristripper_mesh_reader* reader, const rm_char** line, const rm_char** line_end)
+{
+	while (true)
+	{
+		const rm_char* start = (const rm_char*)(reader->buf + reader->pos);
+		rm_size available_count = reader->end - reader->pos;
+		const rm_char* newline = memchr(start, '\n', available_count);
+
+		if (newline || (reader->is_eof && (available_count > 0)))
+		{
+			//We have a line (or the last one without a line break):
+			const rm_char* end = newline ? newline : (start + available_count);
+			reader->pos += (rm_size)(end - start) + (newline ? 1 : 0);
+
+			//Strip a carriage return:
+			if ((end > start) && (end[-1] == '\r'))
+			{
+				end--;
+			}
+
+			*line = start;
+			*line_end = end;
+
+			return true;
+		}
+
+		if (reader->is_eof)
+		{
+			return false;
+		}
+
+		//Get more bytes (this grows the buffer for very long lines):
+		rm_tristripper_mesh_reader_fill(reader, available_count + 1);
+	}
+}
+
+static inline rm_void rm_tristripper_mesh_skip_spaces(const rm_char** cursor, const rm_char* end)
+{
+	const rm_char* c = *cursor;
+
+	while ((c < end) && ((*c == ' ') || (*c == '\t')))
+	{
+		c++;
+	}
+
+	*cursor = c;
+}
+
+static inline rm_bool rm_tristripper_mesh_skip_token(const rm_char** cursor, const rm_char* end)
+{
+	rm_tristripper_mesh_skip_spaces(cursor, end);
+
+	const rm_char* c = *cursor;
+
+	while ((c < end) && (*c != ' ') && (*c != '\t'))
+	{
+		c++;
+	}
+
+	rm_bool has_token = (c != *cursor);
+	*cursor = c;
+
+	return has_token;
+}
+
+static inline rm_bool rm_tristripper_mesh_parse_int(const rm_char** cursor, const rm_char* end, rm_int64* value)
+{
+	rm_tristripper_mesh_skip_spaces(cursor, end);
+
+	const rm_char* c = *cursor;
+	rm_bool is_negative = false;
+
+	if ((c < end) && ((*c == '-') || (*c == '+')))
+	{
+		is_negative = (*c == '-');
+		c++;
+	}
+
+	//No strtol(...): We know the bounds, we don't need a locale and this is the hot loop for ASCII files.
+	const rm_char* digits_start = c;
+	rm_uint64 result = 0;
+
+	while ((c < end) && ((rm_uint8)(*c - '0') < 10))
+	{
+		result = (result * 10) + (rm_uint64)(*c - '0');
+		c++;
+	}
+
+	if ((c == digits_start) || ((c - digits_start) > 18))
+	{
+		return false;
+	}
+
+	*value = is_negative ? -(rm_int64)result : (rm_int64)result;
+	*cursor = c;
+
+	return true;
+}
+
+static inline rm_bool rm_tristripper_mesh_token_equals(const rm_char* token, const rm_char* token_end, const rm_char* str)
+{
+	rm_size length = strlen(str);
+	return ((rm_size)(token_end - token) == length) && (memcmp(token, str, length) == 0);
+}
+
+static inline rm_void rm_tristripper_mesh_polygon_add(rm_tristripper_mesh_polygon* polygon, rm_int64 id, rm_tristripper_id_vec* ids)
+{
+	rm_precond((id >= 0) && (id <= (rm_int64)UINT32_MAX), "Invalid vertex index in mesh file: %" PRId64, id);
+	rm_tristripper_id vertex_id = (rm_tristripper_id)id;
+
+	if (polygon->ids_count == 0)
+	{
+		polygon->first_id = vertex_id;
+	}
+	else if (polygon->ids_count >= 2)
+	{
+		rm_tristripper_id tri_ids[3] = { polygon->first_id, polygon->prev_id, vertex_id };
+		rm_vec_push_mult(ids, tri_ids, 3);
+	}
+
+	polygon->prev_id = vertex_id;
+	polygon->ids_count++;
+}
+
+static rm_tristripper_ply_type rm_tristripper_ply_parse_type(const rm_char* token, const rm_char* token_end)
+{
+	//Both the old and the new names are allowed:
+	static const struct
+	{
+		const rm_char* name;
+		rm_tristripper_ply_type type;
+	} types[] =
+	{
+		{ "char", RM_TRISTRIPPER_PLY_TYPE_INT8 },
+		{ "int8", RM_TRISTRIPPER_PLY_TYPE_INT8 },
+		{ "uchar", RM_TRISTRIPPER_PLY_TYPE_UINT8 },
+		{ "uint8", RM_TRISTRIPPER_PLY_TYPE_UINT8 },
+		{ "short", RM_TRISTRIPPER_PLY_TYPE_INT16 },
+		{ "int16", RM_TRISTRIPPER_PLY_TYPE_INT16 },
+		{ "ushort", RM_TRISTRIPPER_PLY_TYPE_UINT16 },
+		{ "uint16", RM_TRISTRIPPER_PLY_TYPE_UINT16 },
+		{ "int", RM_TRISTRIPPER_PLY_TYPE_INT32 },
+		{ "int32", RM_TRISTRIPPER_PLY_TYPE_INT32 },
+		{ "uint", RM_TRISTRIPPER_PLY_TYPE_UINT32 },
+		{ "uint32", RM_TRISTRIPPER_PLY_TYPE_UINT32 },
+		{ "float", RM_TRISTRIPPER_PLY_TYPE_FLOAT32 },
+		{ "float32", RM_TRISTRIPPER_PLY_TYPE_FLOAT32 },
+		{ "double", RM_TRISTRIPPER_PLY_TYPE_FLOAT64 },
+		{ "float64", RM_TRISTRIPPER_PLY_TYPE_FLOAT64 }
+	};
+
+	for (rm_size i = 0; i < rm_array_count(types); i++)
+	{
+		if (rm_tristripper_mesh_token_equals(token, token_end, types[i].name))
+		{
+			return types[i].type;
+		}
+	}
+
+	rm_exit("Unknown PLY property type: %.*s", (rm_int)(token_end - token), token);
+}
+
+static inline rm_size rm_tristripper_ply_type_size(rm_tristripper_ply_type type)
+{
+	switch (type)
+	{
+	case RM_TRISTRIPPER_PLY_TYPE_INT8:
+	case RM_TRISTRIPPER_PLY_TYPE_UINT8:
+
+		return 1;
+
+	case RM_TRISTRIPPER_PLY_TYPE_INT16:
+	case RM_TRISTRIPPER_PLY_TYPE_UINT16:
+
+		return 2;
+
+	case RM_TRISTRIPPER_PLY_TYPE_INT32:
+	case RM_TRISTRIPPER_PLY_TYPE_UINT32:
+	case RM_TRISTRIPPER_PLY_TYPE_FLOAT32:
+
+		return 4;
+
+	case RM_TRISTRIPPER_PLY_TYPE_FLOAT64:
+
+		return 8;
+
+	default:
+
+		rm_exit("Invalid PLY type");
+	}
+}
+
+static inline rm_int64 rm_tristripper_ply_read_binary_int(rm_tristripper_mesh_reader* reader, rm_tristripper_ply_type type, rm_bool is_big_endian)
+{
+	switch (type)
+	{
+	case RM_TRISTRIPPER_PLY_TYPE_INT8:
+	{
+		rm_int8 value;
+		rm_tristripper_mesh_reader_read(reader, &value, sizeof(value));
+
+		return value;
+	}
+
+	case RM_TRISTRIPPER_PLY_TYPE_UINT8:
+	{
+		rm_uint8 value;
+		rm_tristripper_mesh_reader_read(reader, &value, sizeof(value));
+
+		return value;
+	}
+
+	case RM_TRISTRIPPER_PLY_TYPE_INT16:
+	case RM_TRISTRIPPER_PLY_TYPE_UINT16:
+	{
+		rm_uint16 value;
+		rm_tristripper_mesh_reader_read(reader, &value, sizeof(value));
+		value = is_big_endian ? rm_flip_be_to_host_16(value) : rm_flip_le_to_host_16(value);
+
+		return (type == RM_TRISTRIPPER_PLY_TYPE_INT16) ? (rm_int64)(rm_int16)value : (rm_int64)value;
+	}
+
+	case RM_TRISTRIPPER_PLY_TYPE_INT32:
+	case RM_TRISTRIPPER_PLY_TYPE_UINT32:
+	{
+		rm_uint32 value;
+		rm_tristripper_mesh_reader_read(reader, &value, sizeof(value));
+		value = is_big_endian ? rm_flip_be_to_host_32(value) : rm_flip_le_to_host_32(value);
+
+		return (type == RM_TRISTRIPPER_PLY_TYPE_INT32) ? (rm_int64)(rm_int32)value : (rm_int64)value;
+	}
+
+	default:
+
+		rm_exit("PLY counts and vertex indices must be integers.");
+	}
+}
+
+static rm_void rm_tristripper_ply_read_element_ascii(rm_tristripper_mesh_reader* reader, const rm_tristripper_ply_element* element, rm_tristripper_id_vec* ids)
+{
+	//By convention, every instance is on its own line:
+	for (rm_size i = 0; i < element->count; i++)
+	{
+		const rm_char* line;
+		const rm_char* line_end;
+
+		rm_precond(rm_tristripper_mesh_reader_next_line(reader, &line, &line_end), "Unexpected end of PLY file.");
+
+		if (!element->is_face)
+		{
+			continue;
+		}
+
+		for (rm_size j = 0; j < element->properties.count; j++)
+		{
+			const rm_tristripper_ply_property* property = rm_vec_ptr_at(&element->properties, j);
+
+			if (!property->is_list)
+			{
+				rm_precond(rm_tristripper_mesh_skip_token(&line, line_end), "Missing PLY property value.");
+				continue;
+			}
+
+			rm_int64 count;
+			rm_precond(rm_tristripper_mesh_parse_int(&line, line_end, &count) && (count >= 0), "Invalid PLY list count.");
+
+			rm_tristripper_mesh_polygon polygon = { .ids_count = 0 };
+
+			for (rm_int64 k = 0; k < count; k++)
+			{
+				if (property->is_vertex_indices)
+				{
+					rm_int64 id;
+					rm_precond(rm_tristripper_mesh_parse_int(&line, line_end, &id), "Invalid PLY vertex index.");
+
+					rm_tristripper_mesh_polygon_add(&polygon, id, ids);
+				}
+				else
+				{
+					rm_precond(rm_tristripper_mesh_skip_token(&line, line_end), "Missing PLY list value.");
+				}
+			}
+		}
+	}
+}
+
+static rm_void rm_tristripper_ply_read_element_binary(rm_tristripper_mesh_reader* reader, const rm_tristripper_ply_element* element, rm_bool is_big_endian, rm_tristripper_id_vec* ids)
+{
+	//Elements without lists have a fixed size. If we are not interested in them, we can skip them in one go.
+	rm_size instance_size = 0;
+	rm_bool has_lists = false;
+
+	for (rm_size i = 0; i < element->properties.count; i++)
+	{
+		const rm_tristripper_ply_property* property = rm_vec_ptr_at(&element->properties, i);
+
+		has_lists |= property->is_list;
+		instance_size += rm_tristripper_ply_type_size(property->value_type);
+	}
+
+	if (!element->is_face && !has_lists)
+	{
+		for (rm_size i = 0; i < element->count; i++)
+		{
+			rm_precond(rm_tristripper_mesh_reader_fill(reader, instance_size), "Unexpected end of PLY file.");
+			reader->pos += instance_size;
+		}
+
+		return;
+	}
+
+	for (rm_size i = 0; i < element->count; i++)
+	{
+		for (rm_size j = 0; j < element->properties.count; j++)
+		{
+			const rm_tristripper_ply_property* property = rm_vec_ptr_at(&element->properties, j);
+			rm_size value_size = rm_tristripper_ply_type_size(property->value_type);
+
+			if (!property->is_list)
+			{
+				rm_precond(rm_tristripper_mesh_reader_fill(reader, value_size), "Unexpected end of PLY file.");
+				reader->pos += value_size;
+
+				continue;
+			}
+
+			rm_int64 count = rm_tristripper_ply_read_binary_int(reader, property->count_type, is_big_endian);
+			rm_precond(count >= 0, "Invalid PLY list count.");
+
+			if (!element->is_face || !property->is_vertex_indices)
+			{
+				rm_size list_size = (rm_size)count * value_size;
+
+				rm_precond(rm_tristripper_mesh_reader_fill(reader, list_size), "Unexpected end of PLY file.");
+				reader->pos += list_size;
+
+				continue;
+			}
+
+			rm_tristripper_mesh_polygon polygon = { .ids_count = 0 };
+
+			for (rm_int64 k = 0; k < count; k++)
+			{
+				rm_tristripper_mesh_polygon_add(&polygon, rm_tristripper_ply_read_binary_int(reader, property->value_type, is_big_endian), ids);
+			}
+		}
+	}
+}
+
+static rm_void rm_tristripper_read_ply(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids)
+{
+	const rm_char* line;
+	const rm_char* line_end;
+
+	//Check the magic:
+	rm_precond(rm_tristripper_mesh_reader_next_line(reader, &line, &line_end) && rm_tristripper_mesh_token_equals(line, line_end, "ply"), "Not a PLY file.");
+
+	//Parse the header:
+	rm_tristripper_ply_encoding encoding = RM_TRISTRIPPER_PLY_ENCODING_ASCII;
+	rm_bool has_format = false;
+
+	rm_tristripper_ply_element_vec elements;
+	rm_vec_init(&elements);
+
+	while (true)
+	{
+		rm_precond(rm_tristripper_mesh_reader_next_line(reader, &line, &line_end), "Unexpected end of PLY header.");
+
+		//Split the keyword:
+		rm_tristripper_mesh_skip_spaces(&line, line_end);
+
+		const rm_char* keyword = line;
+		rm_tristripper_mesh_skip_token(&line, line_end);
+		const rm_char* keyword_end = line;
+
+		if (rm_tristripper_mesh_token_equals(keyword, keyword_end, "end_header"))
+		{
+			break;
+		}
+
+		//Collect the next token for all the other keywords:
+		rm_tristripper_mesh_skip_spaces(&line, line_end);
+
+		const rm_char* token = line;
+		rm_tristripper_mesh_skip_token(&line, line_end);
+		const rm_char* token_end = line;
+
+		if (rm_tristripper_mesh_token_equals(keyword, keyword_end, "format"))
+		{
+			if (rm_tristripper_mesh_token_equals(token, token_end, "ascii"))
+			{
+				encoding = RM_TRISTRIPPER_PLY_ENCODING_ASCII;
+			}
+			else if (rm_tristripper_mesh_token_equals(token, token_end, "binary_little_endian"))
+			{
+				encoding = RM_TRISTRIPPER_PLY_ENCODING_BINARY_LE;
+			}
+			else if (rm_tristripper_mesh_token_equals(token, token_end, "binary_big_endian"))
+			{
+				encoding = RM_TRISTRIPPER_PLY_ENCODING_BINARY_BE;
+			}
+			else
+			{
+				rm_exit("Unknown PLY format: %.*s", (rm_int)(token_end - token), token);
+			}
+
+			has_format = true;
+		}
+		else if (rm_tristripper_mesh_token_equals(keyword, keyword_end, "element"))
+		{
+			rm_int64 count;
+			rm_precond(rm_tristripper_mesh_parse_int(&line, line_end, &count) && (count >= 0), "Invalid PLY element count.");
+
+			rm_tristripper_ply_element element =
+			{
+				.is_face = rm_tristripper_mesh_token_equals(token, token_end, "face"),
+				.count = (rm_size)count
+			};
+
+			rm_vec_init(&element.properties);
+			rm_vec_push(&elements, element);
+		}
+		else if (rm_tristripper_mesh_token_equals(keyword, keyword_end, "property"))
+		{
+			rm_precond(elements.count > 0, "PLY property without element.");
+
+			rm_tristripper_ply_property property = { .is_list = false, .is_vertex_indices = false };
+
+			if (rm_tristripper_mesh_token_equals(token, token_end, "list"))
+			{
+				//"property list <count type> <value type> <name>":
+				property.is_list = true;
+
+				rm_tristripper_mesh_skip_spaces(&line, line_end);
+				token = line;
+				rm_tristripper_mesh_skip_token(&line, line_end);
+				property.count_type = rm_tristripper_ply_parse_type(token, line);
+
+				rm_tristripper_mesh_skip_spaces(&line, line_end);
+				token = line;
+				rm_tristripper_mesh_skip_token(&line, line_end);
+				property.value_type = rm_tristripper_ply_parse_type(token, line);
+
+				rm_tristripper_mesh_skip_spaces(&line, line_end);
+				token = line;
+				rm_tristripper_mesh_skip_token(&line, line_end);
+				property.is_vertex_indices = rm_tristripper_mesh_token_equals(token, line, "vertex_indices") || rm_tristripper_mesh_token_equals(token, line, "vertex_index");
+			}
+			else
+			{
+				//"property <type> <name>":
+				property.value_type = rm_tristripper_ply_parse_type(token, token_end);
+			}
+
+			rm_tristripper_ply_element* element = rm_vec_ptr_at(&elements, elements.count - 1);
+			rm_vec_push(&element->properties, property);
+		}
+
+		//Everything else ("comment", "obj_info", ...) is ignored.
+	}
+
+	rm_precond(has_format, "PLY file without format.");
+
+	//Read the elements in order. We can stop after the faces.
+	for (rm_size i = 0; i < elements.count; i++)
+	{
+		const rm_tristripper_ply_element* element = rm_vec_ptr_at(&elements, i);
+
+		if (encoding == RM_TRISTRIPPER_PLY_ENCODING_ASCII)
+		{
+			rm_tristripper_ply_read_element_ascii(reader, element, ids);
+		}
+		else
+		{
+			rm_tristripper_ply_read_element_binary(reader, element, encoding == RM_TRISTRIPPER_PLY_ENCODING_BINARY_BE, ids);
+		}
+
+		if (element->is_face)
+		{
+			break;
+		}
+	}
+
+	for (rm_size i = 0; i < elements.count; i++)
+	{
+		rm_vec_dispose(&rm_vec_ptr_at(&elements, i)->properties);
+	}
+
+	rm_vec_dispose(&elements);
+}
+
+static rm_void rm_tristripper_read_obj(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids)
+{
+	//The number of vertices so far (negative indices are relative to it):
+	rm_int64 vertices_count = 0;
+
+	const rm_char* line;
+	const rm_char* line_end;
+
+	while (rm_tristripper_mesh_reader_next_line(reader, &line, &line_end))
+	{
+		rm_tristripper_mesh_skip_spaces(&line, line_end);
+
+		//We need at least the keyword and a separator:
+		if (((line_end - line) < 2) || ((line[1] != ' ') && (line[1] != '\t')))
+		{
+			continue;
+		}
+
+		if (line[0] == 'v')
+		{
+			vertices_count++;
+			continue;
+		}
+
+		if (line[0] != 'f')
+		{
+			continue;
+		}
+
+		//Every vertex looks like "v", "v/vt", "v//vn" or "v/vt/vn". We only need "v".
+		const rm_char* cursor = line + 2;
+		rm_tristripper_mesh_polygon polygon = { .ids_count = 0 };
+
+		while (true)
+		{
+			rm_tristripper_mesh_skip_spaces(&cursor, line_end);
+
+			if (cursor == line_end)
+			{
+				break;
+			}
+
+			rm_int64 index;
+			rm_precond(rm_tristripper_mesh_parse_int(&cursor, line_end, &index) && (index != 0), "Invalid OBJ vertex index.");
+
+			rm_tristripper_mesh_polygon_add(&polygon, (index > 0) ? (index - 1) : (vertices_count + index), ids);
+
+			//Skip texture coordinate and normal:
+			if ((cursor < line_end) && (*cursor == '/'))
+			{
+				rm_tristripper_mesh_skip_token(&cursor, line_end);
+			}
+		}
+	}
+}
+
+static inline rm_hashmap_hash rm_tristripper_stl_vertex_hashmap_hash(rm_tristripper_stl_vertex_key key)
+{
+	//The hashmap uses the lower bits, so mix everything down there:
+	rm_uint64 hash = ((rm_uint64)key.coords[0] * 0x9E3779B97F4A7C15ull) ^ ((rm_uint64)key.coords[1] * 0xC2B2AE3D27D4EB4Full) ^ ((rm_uint64)key.coords[2] * 0x165667B19E3779F9ull);
+	hash ^= hash >> 32;
+
+	return (rm_hashmap_hash)hash;
+}
+
+static inline rm_bool rm_tristripper_stl_vertex_hashmap_compare(rm_tristripper_stl_vertex_key key0, rm_tristripper_stl_vertex_key key1)
+{
+	return (key0.coords[0] == key1.coords[0]) && (key0.coords[1] == key1.coords[1]) && (key0.coords[2] == key1.coords[2]);
+}
+
+//Spawn the implementation of all the hashmap functions:
+RM_HASHMAP_DEFINE(tristripper_stl_vertex, rm_tristripper_stl_vertex_hashmap_hash, rm_tristripper_stl_vertex_hashmap_compare, null, null, null, null, null)
+
+static rm_void rm_tristripper_read_stl(rm_tristripper_mesh_reader* reader, rm_tristripper_id_vec* ids)
+{
+	//ASCII files start with "solid" and have a "facet" soon. Sadly, some binary files start with "solid" as well.
+	rm_precond(rm_tristripper_mesh_reader_fill(reader, RM_TRISTRIPPER_STL_HEADER_SIZE + sizeof(rm_uint32)), "Unexpected end of STL file.");
+
+	if (!memcmp(reader->buf + reader->pos, "solid", 5))
+	{
+		rm_bool has_facet = false;
+
+		for (rm_size i = reader->pos; !has_facet && (i + 5 <= reader->pos + RM_TRISTRIPPER_STL_HEADER_SIZE + sizeof(rm_uint32)); i++)
+		{
+			has_facet = !memcmp(reader->buf + i, "facet", 5);
+		}
+
+		rm_precond(!has_facet, "ASCII STL files are not supported.");
+	}
+
+	//Skip the header and get the number of triangles:
+	reader->pos += RM_TRISTRIPPER_STL_HEADER_SIZE;
+
+	rm_uint32 tris_count;
+	rm_tristripper_mesh_reader_read(reader, &tris_count, sizeof(tris_count));
+	tris_count = rm_flip_le_to_host_32(tris_count);
+
+	//Don't trust the count before the size of the file confirms it, a broken header would make us reserve gigabytes for nothing.
+	//Pipes have no size, there the vector and the hashmap simply grow:
+	rm_size expected_tris_count = 0;
+	rm_file_offset file_size;
+
+	if (rm_file_get_size(reader->file, &file_size))
+	{
+		rm_uint64 expected_file_size = RM_TRISTRIPPER_STL_HEADER_SIZE + sizeof(rm_uint32) + ((rm_uint64)tris_count * RM_TRISTRIPPER_STL_TRI_SIZE);
+		rm_precond((rm_uint64)file_size >= expected_file_size, "The STL file claims %" PRIu32 " triangles, but has only %" PRIu64 " of the %" PRIu64 " bytes they need.", tris_count, (rm_uint64)file_size, expected_file_size);
+
+		expected_tris_count = (rm_size)tris_count;
+	}
+
+	//Most closed meshes have about half as many vertices as triangles:
+	rm_tristripper_stl_vertex_hashmap vertices;
+	rm_tristripper_stl_vertex_hashmap_init_ex(&vertices, rm_hashmap_get_sufficient_bucket_count((expected_tris_count / 2) + 1, RM_TRISTRIPPER_STL_VERTEX_HASHMAP_LOAD_FACTOR), RM_TRISTRIPPER_STL_VERTEX_HASHMAP_LOAD_FACTOR);
+
+	rm_tristripper_id next_id = 0;
+	rm_vec_ensure_capacity(ids, ids->count + (3 * expected_tris_count));
+
+	for (rm_uint32 i = 0; i < tris_count; i++)
+	{
+		rm_uint8 tri[RM_TRISTRIPPER_STL_TRI_SIZE];
+		rm_tristripper_mesh_reader_read(reader, tri, sizeof(tri));
+
+		//Skip the normal:
+		for (rm_size j = 0; j < 3; j++)
+		{
+			rm_tristripper_stl_vertex_key key;
+			rm_mem_copy(key.coords, &tri[12 + (12 * j)], sizeof(key.coords));
+
+			for (rm_size k = 0; k < 3; k++)
+			{
+				key.coords[k] = rm_flip_le_to_host_32(key.coords[k]);
+
+				//-0.0 is the same position as 0.0:
+				if (key.coords[k] == 0x80000000u)
+				{
+					key.coords[k] = 0;
+				}
+			}
+
+			//Insert the next ID or take the existing one:
+			rm_tristripper_id id = next_id;
+
+			if (!rm_tristripper_stl_vertex_hashmap_update(&vertices, key, next_id, RM_HASHMAP_UPDATE_MODE_INSERT, &id))
+			{
+				next_id++;
+			}
+
+			rm_vec_push(ids, id);
+		}
+	}
+
+	rm_tristripper_stl_vertex_hashmap_dispose(&vertices);
+}
+
+rm_bool rm_tristripper_mesh_format_from_path(const rm_char* path, rm_tristripper_mesh_format* format)
+{
+	rm_assert(path, "Passed path must be valid.");
+	rm_assert(format, "Passed format outpointer must be valid.");
+
+	const rm_char* extension = strrchr(path, '.');
+
+	if (!extension)
+	{
+		return false;
+	}
+
+	if (!strcasecmp(extension, ".ply"))
+	{
+		*format = RM_TRISTRIPPER_MESH_FORMAT_PLY;
+	}
+	else if (!strcasecmp(extension, ".obj"))
+	{
+		*format = RM_TRISTRIPPER_MESH_FORMAT_OBJ;
+	}
+	else if (!strcasecmp(extension, ".stl"))
+	{
+		*format = RM_TRISTRIPPER_MESH_FORMAT_STL;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+rm_void rm_tristripper_read_mesh(const rm_char* path, rm_tristripper_mesh_format format, rm_tristripper_id_vec* ids)
+{
+	rm_precond(path, "Passed path must be valid.");
+	rm_precond(ids, "Passed ID vector must be valid.");
+
+	rm_tristripper_mesh_reader reader;
+	rm_tristripper_mesh_reader_init(&reader, path);
+
+	switch (format)
+	{
+	case RM_TRISTRIPPER_MESH_FORMAT_PLY:
+
+		rm_tristripper_read_ply(&reader, ids);
+		break;
+
+	case RM_TRISTRIPPER_MESH_FORMAT_OBJ:
+
+		rm_tristripper_read_obj(&reader, ids);
+		break;
+
+	case RM_TRISTRIPPER_MESH_FORMAT_STL:
+
+		rm_tristripper_read_stl(&reader, ids);
+		break;
+
+	default:
+
+		rm_exit("Invalid mesh format.");
+	}
+
+	rm_tristripper_mesh_reader_dispose(&reader);
+}
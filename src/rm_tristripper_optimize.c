@@ -0,0 +1,1395 @@
+#include "rm_tristripper_optimize.h"
+
+#include "rm_thread.h"
+#include "rm_time.h"
+#include "rm_vec.h"
+
+//Check the clock only every few iterations:
+#define RM_TRISTRIPPER_OPTIMIZE_CLOCK_INTERVAL ((rm_size)256)
+
+//A missing node of a path treap and the flag in the size of a node that marks a flipped subtree:
+#define RM_TRISTRIPPER_OPTIMIZE_NO_NODE ((rm_uint32)-1)
+#define RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG ((rm_uint32)1 << 31)
+
+//An entry of the undo log that leads back to the best state:
+typedef struct __rm_tristripper_optimize_undo__
+{
+	rm_tristripper_tri* tri;
+	rm_tristripper_tri_link_state link_state;
+} rm_tristripper_optimize_undo;
+
+typedef rm_vec(rm_tristripper_optimize_undo) rm_tristripper_optimize_undo_vec;
+
+//A move of the swap reduction: Link "tri" to its neighbour and drop the given links at both of them (or none).
+//If both of them drop a link, "repair_tri" is linked to its neighbour "repair_index" to keep the number of strips.
+typedef struct __rm_tristripper_reduce_swaps_move__
+{
+	rm_tristripper_tri* tri;
+	rm_size neighbour_index;
+	rm_size dropped_indices[2];
+	rm_tristripper_tri* repair_tri;
+	rm_size repair_index;
+} rm_tristripper_reduce_swaps_move;
+
+//A triangle in the treap of its path (see "rm_tristripper_optimize_paths").
+//Nodes are referenced by the indices of their triangles, so four of them fit into a cache line.
+//The children are in path order, unless "RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG" is set in "size": Then the whole subtree is flipped, but that has not been passed down yet.
+typedef struct __rm_tristripper_optimize_path_node__
+{
+	rm_uint32 parent;
+	rm_uint32 children[2];
+	rm_uint32 size;
+} rm_tristripper_optimize_path_node;
+
+//Every path of the linked graph state as a treap that is ordered along the path.
+//Dropping a link splits a treap, adding one joins two (flipping one of them if needed), all in O(log n) expected.
+//So we know if two triangles are on the same path and where its ends are without walking along it.
+typedef struct __rm_tristripper_optimize_paths__
+{
+	rm_tristripper_tri* tris;
+	rm_tristripper_optimize_path_node* nodes;
+} rm_tristripper_optimize_paths;
+
+//The triangles touched by a move of the swap reduction and their previous link states.
+//With paths, the dropped and added links are logged as well, so the paths can be reverted, too.
+typedef struct __rm_tristripper_reduce_swaps_log__
+{
+	rm_tristripper_tri* tris[6];
+	rm_tristripper_tri_link_state link_states[6];
+	rm_size count;
+
+	rm_tristripper_optimize_paths* paths;
+	rm_tristripper_tri* dropped_links[2][2];
+	rm_size dropped_links_count;
+	rm_tristripper_tri* added_links[2][2];
+	rm_size added_links_count;
+} rm_tristripper_reduce_swaps_log;
+
+//A tiny xorshift generator, we want reproducible sequences and no global state:
+static inline rm_uint64 rm_tristripper_optimize_random(rm_uint64* state);
+
+//The number of links of a triangle:
+static inline rm_size rm_tristripper_optimize_degree(const rm_tristripper_tri* tri);
+
+//The pivot of a triangle with two links is the vertex that is shared by both linked edges.
+//Two consecutive inner triangles of a strip produce a swap if and only if they have the same pivot.
+static inline rm_tristripper_id rm_tristripper_optimize_pivot(const rm_tristripper_tri* tri);
+static inline rm_bool rm_tristripper_optimize_is_swap(const rm_tristripper_tri* tri, const rm_tristripper_tri* neighbour);
+
+//Count the swaps on all links that touch at least one of the given (distinct) triangles:
+static rm_size rm_tristripper_optimize_count_local_swaps(rm_tristripper_tri* const* tris, rm_size tris_count);
+
+//Count all swaps of the current linking:
+static rm_size rm_tristripper_optimize_count_swaps(rm_tristripper_tri* tris, rm_size tris_count);
+
+//Does the strip that is collected from "first_tri" (the end of a path) start with an orientation fix (see "rm_tristripper_collect_strip(...)")?
+//Only strips with three or more triangles can need one.
+static rm_bool rm_tristripper_optimize_needs_orientation_fix(const rm_tristripper_tri* first_tri);
+
+//Walk from the end of a path to its other end (only for full passes, see "rm_tristripper_optimize_paths" for single lookups):
+static rm_tristripper_tri* rm_tristripper_optimize_other_end(rm_tristripper_tri* end_tri);
+
+//Should the strip be collected from "end_tri" rather than from "other_end_tri"?
+//We prefer the end without an orientation fix, the lower address breaks ties.
+static rm_bool rm_tristripper_optimize_is_start(const rm_tristripper_tri* end_tri, const rm_tristripper_tri* other_end_tri);
+
+//Count the orientation fixes of the strips the given (at most 4) triangles belong to.
+//A strip is collected from its start (see "rm_tristripper_optimize_rebuild_endpoints(...)"), so it only needs a fix if both its ends do.
+static rm_size rm_tristripper_optimize_count_local_orientation_fixes(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* const* tris, rm_size tris_count);
+
+//Count all orientation fixes of the current linking (in the same way):
+static rm_size rm_tristripper_optimize_count_orientation_fixes(rm_tristripper_tri* tris, rm_size tris_count);
+
+//Count all orientation fixes if the strips are collected in the order of the given endpoint list:
+static rm_size rm_tristripper_optimize_count_listed_orientation_fixes(rm_tristripper_tri* tris_endpoint_list);
+
+//Check if the given triangles are linked via another edge than "neighbour_index" (possible in degenerated meshes):
+static inline rm_bool rm_tristripper_optimize_is_linked_elsewhere(const rm_tristripper_tri* tri, rm_size neighbour_index);
+
+//Rebuild the endpoint flags and the endpoint list from the link states.
+//The list is ascending. If "preserve_orientation" is set, the starts of all strips come first, so the collector begins every strip there.
+static rm_void rm_tristripper_optimize_rebuild_endpoints(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_bool preserve_orientation);
+
+//Move one step along a path. "*index_to_prev_inout" is RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND at the start.
+//Return "false" if we are at the end of the path.
+static inline rm_bool rm_tristripper_optimize_walk(rm_tristripper_tri** tri_inout, rm_size* index_to_prev_inout);
+
+//Build the paths from the current linking (it must not contain cycles) and release them:
+static rm_void rm_tristripper_optimize_paths_init(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tris, rm_size tris_count);
+static rm_void rm_tristripper_optimize_paths_dispose(rm_tristripper_optimize_paths* paths);
+
+//Treap primitives on the node indices. Merging and splitting leave the parent of the resulting roots untouched.
+//The priorities are hashes of the indices, paths are built in index order quite often.
+static inline rm_uint32 rm_tristripper_optimize_paths_priority(rm_uint32 index);
+static inline rm_size rm_tristripper_optimize_paths_size(const rm_tristripper_optimize_paths* paths, rm_uint32 index);
+static inline rm_bool rm_tristripper_optimize_paths_is_reversed(const rm_tristripper_optimize_paths* paths, rm_uint32 index);
+static inline rm_void rm_tristripper_optimize_paths_push(rm_tristripper_optimize_paths* paths, rm_uint32 index);
+static inline rm_void rm_tristripper_optimize_paths_update(rm_tristripper_optimize_paths* paths, rm_uint32 index);
+static rm_uint32 rm_tristripper_optimize_paths_merge(rm_tristripper_optimize_paths* paths, rm_uint32 left, rm_uint32 right);
+static rm_void rm_tristripper_optimize_paths_split(rm_tristripper_optimize_paths* paths, rm_uint32 index, rm_size count, rm_uint32* left_out, rm_uint32* right_out);
+static rm_uint32 rm_tristripper_optimize_paths_root(const rm_tristripper_optimize_paths* paths, rm_uint32 index);
+static rm_size rm_tristripper_optimize_paths_position(const rm_tristripper_optimize_paths* paths, rm_uint32 index);
+
+//Are the two triangles on the same path?
+//Linking two ends of the same path would close a cycle.
+static inline rm_bool rm_tristripper_optimize_paths_are_connected(const rm_tristripper_optimize_paths* paths, const rm_tristripper_tri* tri, const rm_tristripper_tri* other_tri);
+
+//Follow a link that has been dropped between "tri" and "other_tri" or one that has been added between two ends of different paths:
+static rm_void rm_tristripper_optimize_paths_drop_link(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* other_tri);
+static rm_void rm_tristripper_optimize_paths_add_link(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* other_tri);
+
+//Find the two ends of the path of a triangle:
+static rm_void rm_tristripper_optimize_paths_find_ends(const rm_tristripper_optimize_paths* paths, const rm_tristripper_tri* tri, rm_tristripper_tri** ends_out);
+
+//Check if linking "tri" and "neighbour" would close a cycle once they have dropped their links to "partners" (null for none).
+//The links must have been dropped, but the paths must not have followed yet.
+//We walk a few steps from both sides at once, that answers it for short paths. Otherwise, the paths know: Both are on the same one and no dropped link lies between them.
+static rm_bool rm_tristripper_optimize_would_close_cycle(const rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* neighbour, rm_tristripper_tri* const* partners);
+
+//Select a random link of a triangle with two links and return its index:
+static inline rm_size rm_tristripper_optimize_random_link(const rm_tristripper_tri* tri, rm_uint64* random_state);
+
+//Record the link state of a triangle before the swap reduction changes it:
+static inline rm_void rm_tristripper_reduce_swaps_touch(rm_tristripper_reduce_swaps_log* log, rm_tristripper_tri* tri);
+
+//Apply or revert a move of the swap reduction. Applying fails if the move is not valid (the log must be reverted anyway).
+//Cycles are only checked (and the paths are only kept up to date) if "paths" is not null. Pass null to rate a move.
+static rm_bool rm_tristripper_reduce_swaps_apply(const rm_tristripper_reduce_swaps_move* move, rm_tristripper_optimize_paths* paths, rm_tristripper_reduce_swaps_log* log);
+static rm_void rm_tristripper_reduce_swaps_revert(rm_tristripper_reduce_swaps_log* log);
+
+//Does the triangle take part in a swap?
+static inline rm_bool rm_tristripper_reduce_swaps_has_swap(const rm_tristripper_tri* tri);
+
+//The part of the cost model that depends on the linking (orientation fixes count as swaps):
+static inline rm_size rm_tristripper_optimize_cost(rm_size strips_count, rm_size swaps_count, const rm_tristripper_config* config);
+
+static inline rm_uint64 rm_tristripper_optimize_random(rm_uint64* state)
+{
+	rm_uint64 x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+
+	*state = x;
+	return x;
+}
+
+static inline rm_size rm_tristripper_optimize_degree(const rm_tristripper_tri* tri)
+{
+	return (rm_size)__builtin_popcount((rm_uint)(tri->link_state & 7));
+}
+
+static inline rm_tristripper_id rm_tristripper_optimize_pivot(const rm_tristripper_tri* tri)
+{
+	rm_assert(rm_tristripper_optimize_degree(tri) == 2, "Only triangles with two links have a pivot.");
+
+	//The linked edges (i, i + 1) and (j, j + 1) share the vertex in front of the unlinked edge k: (k + 2) % 3.
+	rm_size unlinked_index = !rm_tristripper_tri_is_linked_to_neighbour(tri, 0) ? 0 : (!rm_tristripper_tri_is_linked_to_neighbour(tri, 1) ? 1 : 2);
+	return tri->vertices[(unlinked_index + 2) % 3];
+}
+
+static inline rm_bool rm_tristripper_optimize_is_swap(const rm_tristripper_tri* tri, const rm_tristripper_tri* neighbour)
+{
+	return (rm_tristripper_optimize_degree(tri) == 2) && (rm_tristripper_optimize_degree(neighbour) == 2) && (rm_tristripper_optimize_pivot(tri) == rm_tristripper_optimize_pivot(neighbour));
+}
+
+static rm_size rm_tristripper_optimize_count_local_swaps(rm_tristripper_tri* const* tris, rm_size tris_count)
+{
+	rm_size swaps_count = 0;
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		const rm_tristripper_tri* tri = tris[i];
+
+		for (rm_size j = 0; j < rm_array_count(tri->neighbours); j++)
+		{
+			if (!rm_tristripper_tri_is_linked_to_neighbour(tri, j))
+			{
+				continue;
+			}
+
+			//Links between two of the given triangles are only counted from the one that comes first:
+			const rm_tristripper_tri* neighbour = tri->neighbours[j];
+			rm_bool is_counted_elsewhere = false;
+
+			for (rm_size k = 0; k < i; k++)
+			{
+				is_counted_elsewhere |= (tris[k] == neighbour);
+			}
+
+			if (!is_counted_elsewhere && rm_tristripper_optimize_is_swap(tri, neighbour))
+			{
+				swaps_count++;
+			}
+		}
+	}
+
+	return swaps_count;
+}
+
+static rm_size rm_tristripper_optimize_count_swaps(rm_tristripper_tri* tris, rm_size tris_count)
+{
+	rm_size swaps_count = 0;
+
+	//Count every link from the triangle with the lower address:
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		for (rm_size j = 0; j < rm_array_count(tri->neighbours); j++)
+		{
+			if (rm_tristripper_tri_is_linked_to_neighbour(tri, j) && (tri->neighbours[j] > tri) && rm_tristripper_optimize_is_swap(tri, tri->neighbours[j]))
+			{
+				swaps_count++;
+			}
+		}
+	}
+
+	return swaps_count;
+}
+
+static rm_bool rm_tristripper_optimize_needs_orientation_fix(const rm_tristripper_tri* first_tri)
+{
+	//Find the second triangle:
+	rm_size index_first_to_second = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	for (rm_size i = 0; i < rm_array_count(first_tri->neighbours); i++)
+	{
+		if (rm_tristripper_tri_is_linked_to_neighbour(first_tri, i))
+		{
+			index_first_to_second = i;
+			break;
+		}
+	}
+
+	if (index_first_to_second == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+	{
+		return false;
+	}
+
+	//Find the third triangle:
+	const rm_tristripper_tri* second_tri = first_tri->neighbours[index_first_to_second];
+	rm_size index_to_prev = (rm_size)first_tri->indices_at_neighbours[index_first_to_second];
+	rm_size index_second_to_third = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_size curr_neighbour_index = rm_tristripper_tri_remaining_index(index_to_prev, i);
+
+		if (rm_tristripper_tri_is_linked_to_neighbour(second_tri, curr_neighbour_index))
+		{
+			index_second_to_third = curr_neighbour_index;
+			break;
+		}
+	}
+
+	if (index_second_to_third == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+	{
+		return false;
+	}
+
+	//Determine the entrance vertices of the core just like the collector does:
+	rm_tristripper_id first_shared_edge[2] = { first_tri->vertices[index_first_to_second], first_tri->vertices[(index_first_to_second + 1) % 3] };
+	rm_tristripper_id second_shared_edge[2] = { second_tri->vertices[index_second_to_third], second_tri->vertices[(index_second_to_third + 1) % 3] };
+	rm_tristripper_id core_entrance_vertex_ids[3];
+
+	rm_tristripper_determine_core_entrance_vertex_ids(first_shared_edge, second_shared_edge, core_entrance_vertex_ids);
+
+	return (first_tri->vertices[index_first_to_second] != core_entrance_vertex_ids[0]);
+}
+
+static rm_tristripper_tri* rm_tristripper_optimize_other_end(rm_tristripper_tri* end_tri)
+{
+	rm_assert(rm_tristripper_optimize_degree(end_tri) < 2, "Only the end of a path has another end.");
+
+	rm_size index_to_prev = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	while (rm_tristripper_optimize_walk(&end_tri, &index_to_prev));
+
+	return end_tri;
+}
+
+static rm_bool rm_tristripper_optimize_is_start(const rm_tristripper_tri* end_tri, const rm_tristripper_tri* other_end_tri)
+{
+	rm_bool needs_fix = rm_tristripper_optimize_needs_orientation_fix(end_tri);
+	rm_bool other_needs_fix = rm_tristripper_optimize_needs_orientation_fix(other_end_tri);
+
+	return (needs_fix == other_needs_fix) ? (end_tri <= other_end_tri) : !needs_fix;
+}
+
+static rm_size rm_tristripper_optimize_count_local_orientation_fixes(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* const* tris, rm_size tris_count)
+{
+	rm_tristripper_tri* first_tris[4];
+	rm_size first_tris_count = 0;
+	rm_size orientation_fixes_count = 0;
+
+	rm_assert(tris_count <= rm_array_count(first_tris), "Too many triangles for a local count.");
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* ends[2];
+		rm_tristripper_optimize_paths_find_ends(paths, tris[i], ends);
+
+		//Count every strip only once (it is known by its end with the lower address):
+		rm_tristripper_tri* first_tri = rm_min(ends[0], ends[1]);
+		rm_bool is_counted = false;
+
+		for (rm_size j = 0; j < first_tris_count; j++)
+		{
+			is_counted |= (first_tris[j] == first_tri);
+		}
+
+		if (!is_counted)
+		{
+			first_tris[first_tris_count++] = first_tri;
+			orientation_fixes_count += (rm_tristripper_optimize_needs_orientation_fix(ends[0]) && rm_tristripper_optimize_needs_orientation_fix(ends[1]));
+		}
+	}
+
+	return orientation_fixes_count;
+}
+
+static rm_size rm_tristripper_optimize_count_orientation_fixes(rm_tristripper_tri* tris, rm_size tris_count)
+{
+	rm_size orientation_fixes_count = 0;
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		if (rm_tristripper_optimize_degree(tri) == 2)
+		{
+			continue;
+		}
+
+		rm_tristripper_tri* other_end_tri = rm_tristripper_optimize_other_end(tri);
+
+		if (tri < other_end_tri)
+		{
+			orientation_fixes_count += (rm_tristripper_optimize_needs_orientation_fix(tri) && rm_tristripper_optimize_needs_orientation_fix(other_end_tri));
+		}
+	}
+
+	return orientation_fixes_count;
+}
+
+static rm_size rm_tristripper_optimize_count_listed_orientation_fixes(rm_tristripper_tri* tris_endpoint_list)
+{
+	rm_size orientation_fixes_count = 0;
+
+	//Like the collector, we start a strip at every endpoint that has not been reached from the other end before.
+	//The second endpoints are marked as visited in the meantime.
+	for (rm_tristripper_tri* tri = tris_endpoint_list; tri; tri = tri->next_tri)
+	{
+		if (rm_tristripper_tri_is_visited(tri))
+		{
+			continue;
+		}
+
+		orientation_fixes_count += rm_tristripper_optimize_needs_orientation_fix(tri);
+		rm_tristripper_tri_set_visited(rm_tristripper_optimize_other_end(tri), 0);
+	}
+
+	for (rm_tristripper_tri* tri = tris_endpoint_list; tri; tri = tri->next_tri)
+	{
+		rm_tristripper_tri_set_unvisited(tri);
+	}
+
+	return orientation_fixes_count;
+}
+
+static inline rm_bool rm_tristripper_optimize_is_linked_elsewhere(const rm_tristripper_tri* tri, rm_size neighbour_index)
+{
+	for (rm_size i = 0; i < rm_array_count(tri->neighbours); i++)
+	{
+		if ((i != neighbour_index) && rm_tristripper_tri_is_linked_to_neighbour(tri, i) && (tri->neighbours[i] == tri->neighbours[neighbour_index]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static rm_void rm_tristripper_optimize_rebuild_endpoints(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_bool preserve_orientation)
+{
+	//Prepend in reverse order, so the list is ascending.
+	//The starts are only marked as visited in the first pass and prepended in the second one, so they end up in front of the other ends.
+	*tris_endpoint_list = null;
+
+	for (rm_size i = tris_count; i-- > 0;)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		if (rm_tristripper_optimize_degree(tri) == 2)
+		{
+			rm_tristripper_tri_set_non_endpoint(tri);
+			continue;
+		}
+
+		rm_tristripper_tri_set_endpoint(tri);
+
+		if (preserve_orientation && rm_tristripper_optimize_is_start(tri, rm_tristripper_optimize_other_end(tri)))
+		{
+			rm_tristripper_tri_set_visited(tri, 0);
+		}
+		else
+		{
+			rm_tristripper_tri_prepend_to_list(tri, tris_endpoint_list);
+		}
+	}
+
+	if (!preserve_orientation)
+	{
+		return;
+	}
+
+	for (rm_size i = tris_count; i-- > 0;)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		if (rm_tristripper_tri_is_visited(tri))
+		{
+			rm_tristripper_tri_set_unvisited(tri);
+			rm_tristripper_tri_prepend_to_list(tri, tris_endpoint_list);
+		}
+	}
+}
+
+static inline rm_bool rm_tristripper_optimize_walk(rm_tristripper_tri** tri_inout, rm_size* index_to_prev_inout)
+{
+	rm_tristripper_tri* tri = *tri_inout;
+
+	for (rm_size i = 0; i < rm_array_count(tri->neighbours); i++)
+	{
+		if ((i == *index_to_prev_inout) || !rm_tristripper_tri_is_linked_to_neighbour(tri, i))
+		{
+			continue;
+		}
+
+		*tri_inout = tri->neighbours[i];
+		*index_to_prev_inout = (rm_size)tri->indices_at_neighbours[i];
+
+		return true;
+	}
+
+	return false;
+}
+
+static rm_void rm_tristripper_optimize_paths_init(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tris, rm_size tris_count)
+{
+	rm_precond(tris_count < RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG, "The local search is limited to %zu triangles.", (rm_size)RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG - 1);
+
+	paths->tris = tris;
+	paths->nodes = rm_malloc(tris_count * sizeof(rm_tristripper_optimize_path_node));
+
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		paths->nodes[i] = (rm_tristripper_optimize_path_node)
+		{
+			.parent = RM_TRISTRIPPER_OPTIMIZE_NO_NODE,
+			.children = { RM_TRISTRIPPER_OPTIMIZE_NO_NODE, RM_TRISTRIPPER_OPTIMIZE_NO_NODE },
+			.size = 0
+		};
+	}
+
+	//Append the triangles of every path from one of its ends (a size of 0 marks the triangles we haven't seen yet):
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* tri = &tris[i];
+
+		if ((rm_tristripper_optimize_degree(tri) == 2) || (paths->nodes[i].size > 0))
+		{
+			continue;
+		}
+
+		rm_uint32 root = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+		rm_size index_to_prev = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+		do
+		{
+			rm_uint32 index = (rm_uint32)(tri - tris);
+			paths->nodes[index].size = 1;
+
+			root = rm_tristripper_optimize_paths_merge(paths, root, index);
+			paths->nodes[root].parent = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+		} while (rm_tristripper_optimize_walk(&tri, &index_to_prev));
+	}
+
+#ifdef DEBUG_BUILD
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_assert(paths->nodes[i].size > 0, "Triangle %zu is part of a cycle.", i);
+	}
+#endif
+}
+
+static rm_void rm_tristripper_optimize_paths_dispose(rm_tristripper_optimize_paths* paths)
+{
+	rm_free(paths->nodes);
+}
+
+static inline rm_uint32 rm_tristripper_optimize_paths_priority(rm_uint32 index)
+{
+	//The finalizer of MurmurHash3:
+	index ^= index >> 16;
+	index *= 0x85EBCA6Bu;
+	index ^= index >> 13;
+	index *= 0xC2B2AE35u;
+	index ^= index >> 16;
+
+	return index;
+}
+
+static inline rm_size rm_tristripper_optimize_paths_size(const rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	return (index != RM_TRISTRIPPER_OPTIMIZE_NO_NODE) ? (rm_size)(paths->nodes[index].size & ~RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG) : 0;
+}
+
+static inline rm_bool rm_tristripper_optimize_paths_is_reversed(const rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	return (paths->nodes[index].size & RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG) != 0;
+}
+
+static inline rm_void rm_tristripper_optimize_paths_push(rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	rm_tristripper_optimize_path_node* node = &paths->nodes[index];
+
+	if (!(node->size & RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG))
+	{
+		return;
+	}
+
+	rm_swap(&node->children[0], &node->children[1]);
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		if (node->children[i] != RM_TRISTRIPPER_OPTIMIZE_NO_NODE)
+		{
+			paths->nodes[node->children[i]].size ^= RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG;
+		}
+	}
+
+	node->size &= ~RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG;
+}
+
+static inline rm_void rm_tristripper_optimize_paths_update(rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	rm_tristripper_optimize_path_node* node = &paths->nodes[index];
+	rm_size size = 1;
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		if (node->children[i] != RM_TRISTRIPPER_OPTIMIZE_NO_NODE)
+		{
+			size += rm_tristripper_optimize_paths_size(paths, node->children[i]);
+			paths->nodes[node->children[i]].parent = index;
+		}
+	}
+
+	node->size = (node->size & RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG) | (rm_uint32)size;
+}
+
+static rm_uint32 rm_tristripper_optimize_paths_merge(rm_tristripper_optimize_paths* paths, rm_uint32 left, rm_uint32 right)
+{
+	if ((left == RM_TRISTRIPPER_OPTIMIZE_NO_NODE) || (right == RM_TRISTRIPPER_OPTIMIZE_NO_NODE))
+	{
+		return (left != RM_TRISTRIPPER_OPTIMIZE_NO_NODE) ? left : right;
+	}
+
+	if (rm_tristripper_optimize_paths_priority(left) > rm_tristripper_optimize_paths_priority(right))
+	{
+		rm_tristripper_optimize_paths_push(paths, left);
+		paths->nodes[left].children[1] = rm_tristripper_optimize_paths_merge(paths, paths->nodes[left].children[1], right);
+		rm_tristripper_optimize_paths_update(paths, left);
+
+		return left;
+	}
+
+	rm_tristripper_optimize_paths_push(paths, right);
+	paths->nodes[right].children[0] = rm_tristripper_optimize_paths_merge(paths, left, paths->nodes[right].children[0]);
+	rm_tristripper_optimize_paths_update(paths, right);
+
+	return right;
+}
+
+static rm_void rm_tristripper_optimize_paths_split(rm_tristripper_optimize_paths* paths, rm_uint32 index, rm_size count, rm_uint32* left_out, rm_uint32* right_out)
+{
+	if (index == RM_TRISTRIPPER_OPTIMIZE_NO_NODE)
+	{
+		*left_out = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+		*right_out = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+
+		return;
+	}
+
+	rm_tristripper_optimize_paths_push(paths, index);
+
+	//The first "count" nodes go to the left:
+	rm_tristripper_optimize_path_node* node = &paths->nodes[index];
+	rm_size left_size = rm_tristripper_optimize_paths_size(paths, node->children[0]);
+
+	if (left_size < count)
+	{
+		rm_tristripper_optimize_paths_split(paths, node->children[1], count - left_size - 1, &node->children[1], right_out);
+		rm_tristripper_optimize_paths_update(paths, index);
+		*left_out = index;
+	}
+	else
+	{
+		rm_tristripper_optimize_paths_split(paths, node->children[0], count, left_out, &node->children[0]);
+		rm_tristripper_optimize_paths_update(paths, index);
+		*right_out = index;
+	}
+}
+
+static rm_uint32 rm_tristripper_optimize_paths_root(const rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	while (paths->nodes[index].parent != RM_TRISTRIPPER_OPTIMIZE_NO_NODE)
+	{
+		index = paths->nodes[index].parent;
+	}
+
+	return index;
+}
+
+static rm_size rm_tristripper_optimize_paths_position(const rm_tristripper_optimize_paths* paths, rm_uint32 index)
+{
+	//The children of a node are flipped if an odd number of the flags on its way to the root (including its own) is set.
+	//We collect all of them first and drop them one after another on the way up:
+	rm_bool is_flipped = false;
+
+	for (rm_uint32 curr_index = index; curr_index != RM_TRISTRIPPER_OPTIMIZE_NO_NODE; curr_index = paths->nodes[curr_index].parent)
+	{
+		is_flipped ^= rm_tristripper_optimize_paths_is_reversed(paths, curr_index);
+	}
+
+	rm_size position = rm_tristripper_optimize_paths_size(paths, paths->nodes[index].children[is_flipped]);
+
+	for (; paths->nodes[index].parent != RM_TRISTRIPPER_OPTIMIZE_NO_NODE; index = paths->nodes[index].parent)
+	{
+		const rm_tristripper_optimize_path_node* parent = &paths->nodes[paths->nodes[index].parent];
+		is_flipped ^= rm_tristripper_optimize_paths_is_reversed(paths, index);
+
+		//Are we the right child in path order?
+		if (parent->children[!is_flipped] == index)
+		{
+			position += rm_tristripper_optimize_paths_size(paths, parent->children[is_flipped]) + 1;
+		}
+	}
+
+	return position;
+}
+
+static inline rm_bool rm_tristripper_optimize_paths_are_connected(const rm_tristripper_optimize_paths* paths, const rm_tristripper_tri* tri, const rm_tristripper_tri* other_tri)
+{
+	return (rm_tristripper_optimize_paths_root(paths, (rm_uint32)(tri - paths->tris)) == rm_tristripper_optimize_paths_root(paths, (rm_uint32)(other_tri - paths->tris)));
+}
+
+static rm_void rm_tristripper_optimize_paths_drop_link(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* other_tri)
+{
+	rm_uint32 index = (rm_uint32)(tri - paths->tris);
+	rm_uint32 root = rm_tristripper_optimize_paths_root(paths, index);
+
+	rm_size position = rm_tristripper_optimize_paths_position(paths, index);
+	rm_size other_position = rm_tristripper_optimize_paths_position(paths, (rm_uint32)(other_tri - paths->tris));
+
+	rm_assert((position + 1 == other_position) || (other_position + 1 == position), "Dropped link is not part of a path.");
+
+	//Split between the two:
+	rm_uint32 left;
+	rm_uint32 right;
+
+	rm_tristripper_optimize_paths_split(paths, root, rm_max(position, other_position), &left, &right);
+
+	paths->nodes[left].parent = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+	paths->nodes[right].parent = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+}
+
+static rm_void rm_tristripper_optimize_paths_add_link(rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* other_tri)
+{
+	rm_uint32 index = (rm_uint32)(tri - paths->tris);
+	rm_uint32 other_index = (rm_uint32)(other_tri - paths->tris);
+	rm_uint32 root = rm_tristripper_optimize_paths_root(paths, index);
+	rm_uint32 other_root = rm_tristripper_optimize_paths_root(paths, other_index);
+
+	rm_assert(root != other_root, "Added link closes a cycle.");
+
+	//The triangle must become the last one of its path and the other triangle the first one of its path.
+	//Both are ends, so flipping the paths is enough:
+	if (rm_tristripper_optimize_paths_position(paths, index) != rm_tristripper_optimize_paths_size(paths, root) - 1)
+	{
+		paths->nodes[root].size ^= RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG;
+	}
+
+	if (rm_tristripper_optimize_paths_position(paths, other_index) != 0)
+	{
+		paths->nodes[other_root].size ^= RM_TRISTRIPPER_OPTIMIZE_REVERSED_FLAG;
+	}
+
+	root = rm_tristripper_optimize_paths_merge(paths, root, other_root);
+	paths->nodes[root].parent = RM_TRISTRIPPER_OPTIMIZE_NO_NODE;
+}
+
+static rm_void rm_tristripper_optimize_paths_find_ends(const rm_tristripper_optimize_paths* paths, const rm_tristripper_tri* tri, rm_tristripper_tri** ends_out)
+{
+	rm_uint32 root = rm_tristripper_optimize_paths_root(paths, (rm_uint32)(tri - paths->tris));
+
+	//Descend to the first and the last node, we keep track of the flags instead of passing them down:
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_uint32 index = root;
+		rm_bool is_flipped = rm_tristripper_optimize_paths_is_reversed(paths, index);
+
+		while (paths->nodes[index].children[i ^ is_flipped] != RM_TRISTRIPPER_OPTIMIZE_NO_NODE)
+		{
+			index = paths->nodes[index].children[i ^ is_flipped];
+			is_flipped ^= rm_tristripper_optimize_paths_is_reversed(paths, index);
+		}
+
+		ends_out[i] = &paths->tris[index];
+	}
+}
+
+static rm_bool rm_tristripper_optimize_would_close_cycle(const rm_tristripper_optimize_paths* paths, rm_tristripper_tri* tri, rm_tristripper_tri* neighbour, rm_tristripper_tri* const* partners)
+{
+	rm_tristripper_tri* tri_walker = tri;
+	rm_tristripper_tri* neighbour_walker = neighbour;
+	rm_size tri_index_to_prev = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+	rm_size neighbour_index_to_prev = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+
+	for (rm_size i = 0; i < RM_TRISTRIPPER_OPTIMIZE_MAX_WALK_COUNT; i++)
+	{
+		if (!rm_tristripper_optimize_walk(&tri_walker, &tri_index_to_prev))
+		{
+			return (tri_walker == neighbour);
+		}
+
+		if (!rm_tristripper_optimize_walk(&neighbour_walker, &neighbour_index_to_prev))
+		{
+			return (neighbour_walker == tri);
+		}
+	}
+
+	if (!rm_tristripper_optimize_paths_are_connected(paths, tri, neighbour))
+	{
+		return false;
+	}
+
+	//A dropped link lies between them if the partner is on the side of the other triangle:
+	rm_size positions[2] =
+	{
+		rm_tristripper_optimize_paths_position(paths, (rm_uint32)(tri - paths->tris)),
+		rm_tristripper_optimize_paths_position(paths, (rm_uint32)(neighbour - paths->tris))
+	};
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		if (!partners[i])
+		{
+			continue;
+		}
+
+		rm_size partner_position = rm_tristripper_optimize_paths_position(paths, (rm_uint32)(partners[i] - paths->tris));
+
+		if ((partner_position > positions[i]) == (positions[1 - i] > positions[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static inline rm_size rm_tristripper_optimize_random_link(const rm_tristripper_tri* tri, rm_uint64* random_state)
+{
+	//Skip the first link with a probability of 50%:
+	rm_size skip_count = (rm_size)(rm_tristripper_optimize_random(random_state) & 1);
+
+	for (rm_size i = 0; i < rm_array_count(tri->neighbours); i++)
+	{
+		if (!rm_tristripper_tri_is_linked_to_neighbour(tri, i))
+		{
+			continue;
+		}
+
+		if (skip_count == 0)
+		{
+			return i;
+		}
+
+		skip_count--;
+	}
+
+	rm_exit("Triangle does not have two links.");
+}
+
+static inline rm_void rm_tristripper_reduce_swaps_touch(rm_tristripper_reduce_swaps_log* log, rm_tristripper_tri* tri)
+{
+	for (rm_size i = 0; i < log->count; i++)
+	{
+		if (log->tris[i] == tri)
+		{
+			return;
+		}
+	}
+
+	rm_precond(log->count < rm_array_count(log->tris), "Swap reduction log overflow.");
+
+	log->tris[log->count] = tri;
+	log->link_states[log->count] = (rm_tristripper_tri_link_state)(tri->link_state & 7);
+	log->count++;
+}
+
+static rm_bool rm_tristripper_reduce_swaps_apply(const rm_tristripper_reduce_swaps_move* move, rm_tristripper_optimize_paths* paths, rm_tristripper_reduce_swaps_log* log)
+{
+	rm_tristripper_tri* tris[2] = { move->tri, move->tri->neighbours[move->neighbour_index] };
+	rm_size neighbour_indices[2] = { move->neighbour_index, (rm_size)move->tri->indices_at_neighbours[move->neighbour_index] };
+
+	rm_tristripper_reduce_swaps_touch(log, tris[0]);
+	rm_tristripper_reduce_swaps_touch(log, tris[1]);
+	log->paths = paths;
+
+	//Drop the links:
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_size dropped_index = move->dropped_indices[i];
+
+		if (dropped_index == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+		{
+			continue;
+		}
+
+		rm_tristripper_tri* partner = tris[i]->neighbours[dropped_index];
+		rm_tristripper_reduce_swaps_touch(log, partner);
+
+		rm_tristripper_tri_unlink_from_neighbour(partner, (rm_size)tris[i]->indices_at_neighbours[dropped_index]);
+		rm_tristripper_tri_unlink_from_neighbour(tris[i], dropped_index);
+
+		if (paths)
+		{
+			rm_tristripper_optimize_paths_drop_link(paths, tris[i], partner);
+
+			log->dropped_links[log->dropped_links_count][0] = tris[i];
+			log->dropped_links[log->dropped_links_count][1] = partner;
+			log->dropped_links_count++;
+		}
+	}
+
+	//Establish the new link:
+	if (paths && rm_tristripper_optimize_paths_are_connected(paths, tris[0], tris[1]))
+	{
+		return false;
+	}
+
+	rm_tristripper_tri_link_to_neighbour(tris[0], neighbour_indices[0]);
+	rm_tristripper_tri_link_to_neighbour(tris[1], neighbour_indices[1]);
+
+	if (paths)
+	{
+		rm_tristripper_optimize_paths_add_link(paths, tris[0], tris[1]);
+
+		log->added_links[log->added_links_count][0] = tris[0];
+		log->added_links[log->added_links_count][1] = tris[1];
+		log->added_links_count++;
+	}
+
+	//Repair the number of strips:
+	if (move->repair_tri)
+	{
+		rm_tristripper_tri* repair_tri = move->repair_tri;
+		rm_tristripper_tri* repair_neighbour = repair_tri->neighbours[move->repair_index];
+
+		if (!repair_neighbour ||
+			rm_tristripper_tri_is_linked_to_neighbour(repair_tri, move->repair_index) ||
+			(rm_tristripper_optimize_degree(repair_tri) == 2) ||
+			(rm_tristripper_optimize_degree(repair_neighbour) == 2) ||
+			rm_tristripper_optimize_is_linked_elsewhere(repair_tri, move->repair_index) ||
+			(paths && rm_tristripper_optimize_paths_are_connected(paths, repair_tri, repair_neighbour)))
+		{
+			return false;
+		}
+
+		rm_tristripper_reduce_swaps_touch(log, repair_neighbour);
+
+		rm_tristripper_tri_link_to_neighbour(repair_tri, move->repair_index);
+		rm_tristripper_tri_link_to_neighbour(repair_neighbour, (rm_size)repair_tri->indices_at_neighbours[move->repair_index]);
+
+		if (paths)
+		{
+			rm_tristripper_optimize_paths_add_link(paths, repair_tri, repair_neighbour);
+
+			log->added_links[log->added_links_count][0] = repair_tri;
+			log->added_links[log->added_links_count][1] = repair_neighbour;
+			log->added_links_count++;
+		}
+	}
+
+	return true;
+}
+
+static rm_void rm_tristripper_reduce_swaps_revert(rm_tristripper_reduce_swaps_log* log)
+{
+	for (rm_size i = 0; i < log->count; i++)
+	{
+		log->tris[i]->link_state = log->link_states[i];
+	}
+
+	//All links have been dropped before the first one has been added, so we undo them the other way round:
+	for (rm_size i = log->added_links_count; i-- > 0;)
+	{
+		rm_tristripper_optimize_paths_drop_link(log->paths, log->added_links[i][0], log->added_links[i][1]);
+	}
+
+	for (rm_size i = log->dropped_links_count; i-- > 0;)
+	{
+		rm_tristripper_optimize_paths_add_link(log->paths, log->dropped_links[i][0], log->dropped_links[i][1]);
+	}
+}
+
+static inline rm_bool rm_tristripper_reduce_swaps_has_swap(const rm_tristripper_tri* tri)
+{
+	for (rm_size i = 0; i < rm_array_count(tri->neighbours); i++)
+	{
+		if (rm_tristripper_tri_is_linked_to_neighbour(tri, i) && rm_tristripper_optimize_is_swap(tri, tri->neighbours[i]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static inline rm_size rm_tristripper_optimize_cost(rm_size strips_count, rm_size swaps_count, const rm_tristripper_config* config)
+{
+	return (strips_count * (2 + config->cost_per_primitive_restart)) + (swaps_count * config->cost_per_swap);
+}
+
+rm_void rm_tristripper_optimize_links(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_size* strips_count_inout, const rm_tristripper_config* config, rm_tristripper_process_stats* process_stats)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_assert(tris_endpoint_list, "Passed endpoint list must be valid.");
+	rm_assert(strips_count_inout, "Passed strip count inoutpointer must be valid.");
+	rm_assert(config, "Passed config must be valid.");
+	rm_assert(process_stats, "Passed process stats must be valid.");
+
+	rm_uint64 start_nsecs = rm_time_now();
+	rm_uint64 end_nsecs = start_nsecs + ((rm_uint64)config->optimize_usecs * 1000);
+
+	//Rate the initial state.
+	//The search assumes that every strip is collected from its start (see "rm_tristripper_optimize_rebuild_endpoints(...)").
+	//The initial state keeps its endpoint list if nothing beats it, so its real cost counts the fixes in list order.
+	rm_bool preserve_orientation = config->preserve_orientation;
+
+	rm_size strips_count = *strips_count_inout;
+	rm_size swaps_count = rm_tristripper_optimize_count_swaps(tris, tris_count);
+	rm_size orientation_fixes_count = preserve_orientation ? rm_tristripper_optimize_count_orientation_fixes(tris, tris_count) : 0;
+
+	rm_size cost = rm_tristripper_optimize_cost(strips_count, swaps_count + orientation_fixes_count, config);
+
+	rm_size initial_orientation_fixes_count = preserve_orientation ? rm_tristripper_optimize_count_listed_orientation_fixes(*tris_endpoint_list) : 0;
+	rm_size initial_cost = rm_tristripper_optimize_cost(strips_count, swaps_count + initial_orientation_fixes_count, config);
+
+	rm_size initial_strips_count = strips_count;
+	//Collecting the strips from their starts might already be cheaper:
+	rm_size best_strips_count = strips_count;
+	rm_size best_cost = rm_min(initial_cost, cost);
+
+	//Late acceptance: A move is accepted if it is not worse than the current state or the state from "RM_TRISTRIPPER_OPTIMIZE_HISTORY_COUNT" iterations ago.
+	rm_size history[RM_TRISTRIPPER_OPTIMIZE_HISTORY_COUNT];
+
+	for (rm_size i = 0; i < RM_TRISTRIPPER_OPTIMIZE_HISTORY_COUNT; i++)
+	{
+		history[i] = cost;
+	}
+
+	//Everything we change after the best state is logged, so we can return to it:
+	rm_tristripper_optimize_undo_vec undo_vec;
+	rm_vec_init(&undo_vec);
+
+	//The paths follow every accepted move, so cycles and the ends of the strips are found without walking along them:
+	rm_tristripper_optimize_paths paths;
+	rm_tristripper_optimize_paths_init(&paths, tris, tris_count);
+
+	rm_uint64 random_state = 0x9E3779B97F4A7C15ull ^ (rm_uint64)tris_count;
+	rm_size iterations_count = 0;
+	rm_size accepted_moves_count = 0;
+
+	while (true)
+	{
+		//Time is up?
+		if (((iterations_count % RM_TRISTRIPPER_OPTIMIZE_CLOCK_INTERVAL) == 0) && (rm_time_now() >= end_nsecs))
+		{
+			break;
+		}
+
+		iterations_count++;
+
+		//Select a random triangle and one of its neighbours we are not linked to:
+		rm_tristripper_tri* tri = &tris[rm_tristripper_optimize_random(&random_state) % tris_count];
+		rm_size neighbour_index = (rm_size)(rm_tristripper_optimize_random(&random_state) % 3);
+		rm_tristripper_tri* neighbour = tri->neighbours[neighbour_index];
+
+		if (!neighbour || rm_tristripper_tri_is_linked_to_neighbour(tri, neighbour_index))
+		{
+			continue;
+		}
+
+		//Two triangles can share more than one edge in degenerated meshes. We must not link them twice.
+		if (rm_tristripper_optimize_is_linked_elsewhere(tri, neighbour_index))
+		{
+			continue;
+		}
+
+		rm_size index_at_neighbour = (rm_size)tri->indices_at_neighbours[neighbour_index];
+
+		//Both triangles might have to drop a link to make room:
+		rm_tristripper_tri* touched_tris[4] = { tri, neighbour };
+		rm_size touched_tris_count = 2;
+
+		rm_size dropped_indices[2] = { RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND, RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND };
+		rm_size dropped_count = 0;
+
+		for (rm_size i = 0; i < 2; i++)
+		{
+			rm_tristripper_tri* curr_tri = touched_tris[i];
+
+			if (rm_tristripper_optimize_degree(curr_tri) < 2)
+			{
+				continue;
+			}
+
+			dropped_indices[i] = rm_tristripper_optimize_random_link(curr_tri, &random_state);
+			dropped_count++;
+
+			//Remember the partner (only once):
+			rm_tristripper_tri* partner = curr_tri->neighbours[dropped_indices[i]];
+
+			if ((touched_tris_count < 3) || (touched_tris[2] != partner))
+			{
+				touched_tris[touched_tris_count++] = partner;
+			}
+		}
+
+		//Rate the neighbourhood before the move and back it up:
+		rm_size local_swaps_count = rm_tristripper_optimize_count_local_swaps(touched_tris, touched_tris_count);
+		rm_size local_orientation_fixes_count = preserve_orientation ? rm_tristripper_optimize_count_local_orientation_fixes(&paths, touched_tris, touched_tris_count) : 0;
+
+		for (rm_size i = 0; i < touched_tris_count; i++)
+		{
+			rm_tristripper_tri_save_link_state(touched_tris[i]);
+		}
+
+		//Drop the links (the paths only follow if the move is accepted):
+		rm_tristripper_tri* partners[2] = { null, null };
+
+		for (rm_size i = 0; i < 2; i++)
+		{
+			if (dropped_indices[i] == RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND)
+			{
+				continue;
+			}
+
+			rm_tristripper_tri* curr_tri = touched_tris[i];
+			partners[i] = curr_tri->neighbours[dropped_indices[i]];
+
+			rm_tristripper_tri_unlink_from_neighbour(partners[i], (rm_size)curr_tri->indices_at_neighbours[dropped_indices[i]]);
+			rm_tristripper_tri_unlink_from_neighbour(curr_tri, dropped_indices[i]);
+		}
+
+		//Link the two triangles unless that would close a cycle:
+		if (rm_tristripper_optimize_would_close_cycle(&paths, tri, neighbour, partners))
+		{
+			for (rm_size i = 0; i < touched_tris_count; i++)
+			{
+				rm_tristripper_tri_restore_link_state(touched_tris[i]);
+			}
+
+			continue;
+		}
+
+		rm_tristripper_tri_link_to_neighbour(tri, neighbour_index);
+		rm_tristripper_tri_link_to_neighbour(neighbour, index_at_neighbour);
+
+		//Rate the result.
+		//The orientation fixes of the touched strips are added once the paths have followed, so we only update them for a move that might be accepted.
+		rm_size new_strips_count = strips_count + dropped_count - 1;
+		rm_size new_swaps_count = swaps_count - local_swaps_count + rm_tristripper_optimize_count_local_swaps(touched_tris, touched_tris_count);
+		rm_size new_orientation_fixes_count = orientation_fixes_count - local_orientation_fixes_count;
+		rm_size new_cost = rm_tristripper_optimize_cost(new_strips_count, new_swaps_count + new_orientation_fixes_count, config);
+
+		rm_size history_index = iterations_count % RM_TRISTRIPPER_OPTIMIZE_HISTORY_COUNT;
+		rm_size max_cost = rm_max(cost, history[history_index]);
+		rm_bool is_accepted = (new_cost <= max_cost);
+
+		if (is_accepted)
+		{
+			for (rm_size i = 0; i < 2; i++)
+			{
+				if (partners[i])
+				{
+					rm_tristripper_optimize_paths_drop_link(&paths, touched_tris[i], partners[i]);
+				}
+			}
+
+			rm_tristripper_optimize_paths_add_link(&paths, tri, neighbour);
+
+			if (preserve_orientation)
+			{
+				new_orientation_fixes_count += rm_tristripper_optimize_count_local_orientation_fixes(&paths, touched_tris, touched_tris_count);
+				new_cost = rm_tristripper_optimize_cost(new_strips_count, new_swaps_count + new_orientation_fixes_count, config);
+				is_accepted = (new_cost <= max_cost);
+
+				//Take the paths back:
+				if (!is_accepted)
+				{
+					rm_tristripper_optimize_paths_drop_link(&paths, tri, neighbour);
+
+					for (rm_size i = 2; i-- > 0;)
+					{
+						if (partners[i])
+						{
+							rm_tristripper_optimize_paths_add_link(&paths, touched_tris[i], partners[i]);
+						}
+					}
+				}
+			}
+		}
+
+		if (is_accepted)
+		{
+			//Accept the move and log the old states (they have been saved in the upper bits):
+			for (rm_size i = 0; i < touched_tris_count; i++)
+			{
+				rm_tristripper_optimize_undo undo = { .tri = touched_tris[i], .link_state = (rm_tristripper_tri_link_state)((touched_tris[i]->link_state >> 3) & 7) };
+				rm_vec_push(&undo_vec, undo);
+			}
+
+			strips_count = new_strips_count;
+			swaps_count = new_swaps_count;
+			orientation_fixes_count = new_orientation_fixes_count;
+			cost = new_cost;
+			accepted_moves_count++;
+
+			//New best state? Then we don't need the log anymore.
+			if (cost < best_cost)
+			{
+				best_strips_count = strips_count;
+				best_cost = cost;
+
+				rm_vec_clear(&undo_vec);
+			}
+		}
+		else
+		{
+			for (rm_size i = 0; i < touched_tris_count; i++)
+			{
+				rm_tristripper_tri_restore_link_state(touched_tris[i]);
+			}
+		}
+
+		history[history_index] = cost;
+	}
+
+	//The undo log does not go through the paths, we don't need them anymore:
+	rm_tristripper_optimize_paths_dispose(&paths);
+
+	//Return to the best state:
+	for (rm_size i = undo_vec.count; i-- > 0;)
+	{
+		rm_tristripper_optimize_undo* undo = rm_vec_ptr_at(&undo_vec, i);
+		undo->tri->link_state = undo->link_state;
+	}
+
+	rm_vec_dispose(&undo_vec);
+
+	//Without an improvement, we are back at the initial state and keep its endpoint list (the order decides about the orientation fixes):
+	if (best_cost < initial_cost)
+	{
+		rm_tristripper_optimize_rebuild_endpoints(tris, tris_count, tris_endpoint_list, preserve_orientation);
+		*strips_count_inout = best_strips_count;
+
+		rm_assert(best_cost == rm_tristripper_optimize_cost(best_strips_count, rm_tristripper_optimize_count_swaps(tris, tris_count) + (preserve_orientation ? rm_tristripper_optimize_count_orientation_fixes(tris, tris_count) : 0), config), "Local search has lost track of the cost.");
+	}
+
+	//Report what we have achieved:
+	rm_atomic_fetch_add(&process_stats->optimize_iterations_count, iterations_count);
+	rm_atomic_fetch_add(&process_stats->optimize_accepted_moves_count, accepted_moves_count);
+	rm_atomic_fetch_add(&process_stats->optimize_initial_strips_count, initial_strips_count);
+	rm_atomic_fetch_add(&process_stats->optimize_final_strips_count, best_strips_count);
+	rm_atomic_fetch_add(&process_stats->optimize_saved_cost, initial_cost - best_cost);
+	rm_atomic_fetch_add(&process_stats->optimize_nsecs, rm_time_now() - start_nsecs);
+}
+
+rm_void rm_tristripper_reduce_swaps(rm_tristripper_tri* tris, rm_size tris_count, rm_tristripper_tri** tris_endpoint_list, rm_bool preserve_orientation, rm_tristripper_process_stats* process_stats)
+{
+	//Validate the parameters:
+	rm_assert(tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_assert(tris_endpoint_list, "Passed endpoint list must be valid.");
+	rm_assert(process_stats, "Passed process stats must be valid.");
+
+	rm_uint64 start_nsecs = rm_time_now();
+
+	rm_size initial_swaps_count = rm_tristripper_optimize_count_swaps(tris, tris_count);
+	rm_size swaps_count = initial_swaps_count;
+
+	//We need the paths for the cycle checks:
+	rm_tristripper_optimize_paths paths;
+	rm_tristripper_optimize_paths_init(&paths, tris, tris_count);
+
+	//Every applied move removes at least one swap, so this terminates:
+	rm_bool has_improved = true;
+
+	while (has_improved && (swaps_count > 0))
+	{
+		has_improved = false;
+
+		for (rm_size i = 0; i < tris_count; i++)
+		{
+			rm_tristripper_tri* tri = &tris[i];
+
+			for (rm_size j = 0; j < rm_array_count(tri->neighbours); j++)
+			{
+				rm_tristripper_tri* neighbour = tri->neighbours[j];
+
+				//We need an unlinked neighbour and one of the two must take part in a swap:
+				if (!neighbour ||
+					rm_tristripper_tri_is_linked_to_neighbour(tri, j) ||
+					rm_tristripper_optimize_is_linked_elsewhere(tri, j) ||
+					(!rm_tristripper_reduce_swaps_has_swap(tri) && !rm_tristripper_reduce_swaps_has_swap(neighbour)))
+				{
+					continue;
+				}
+
+				//Collect the links both of them might drop:
+				rm_tristripper_tri* move_tris[2] = { tri, neighbour };
+				rm_size dropped_options[2][2];
+				rm_size dropped_options_counts[2];
+
+				for (rm_size k = 0; k < 2; k++)
+				{
+					dropped_options_counts[k] = 0;
+
+					if (rm_tristripper_optimize_degree(move_tris[k]) < 2)
+					{
+						dropped_options[k][dropped_options_counts[k]++] = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND;
+						continue;
+					}
+
+					for (rm_size l = 0; l < rm_array_count(move_tris[k]->neighbours); l++)
+					{
+						if (rm_tristripper_tri_is_linked_to_neighbour(move_tris[k], l))
+						{
+							dropped_options[k][dropped_options_counts[k]++] = l;
+						}
+					}
+				}
+
+				//Rate all moves that keep the number of strips and remember the best one:
+				rm_tristripper_reduce_swaps_move best_move = { .tri = null };
+				rm_int64 best_delta = 0;
+
+				for (rm_size k = 0; k < dropped_options_counts[0]; k++)
+				{
+					for (rm_size l = 0; l < dropped_options_counts[1]; l++)
+					{
+						rm_tristripper_reduce_swaps_move move =
+						{
+							.tri = tri,
+							.neighbour_index = j,
+							.dropped_indices = { dropped_options[0][k], dropped_options[1][l] },
+							.repair_tri = null,
+							.repair_index = RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND
+						};
+
+						rm_bool drops_first = (move.dropped_indices[0] != RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND);
+						rm_bool drops_second = (move.dropped_indices[1] != RM_TRISTRIPPER_NEIGHBOUR_INDEX_NOT_FOUND);
+
+						//Without any drop, we would save a strip. That's the job of tunneling.
+						if (!drops_first && !drops_second)
+						{
+							continue;
+						}
+
+						//With two drops, one of the dropped partners must be linked elsewhere:
+						rm_tristripper_tri* repair_tris[2] = { null, null };
+
+						if (drops_first && drops_second)
+						{
+							repair_tris[0] = tri->neighbours[move.dropped_indices[0]];
+							repair_tris[1] = neighbour->neighbours[move.dropped_indices[1]];
+						}
+
+						for (rm_size m = 0; m < (repair_tris[0] ? 6 : 1); m++)
+						{
+							if (repair_tris[0])
+							{
+								move.repair_tri = repair_tris[m / 3];
+								move.repair_index = m % 3;
+							}
+
+							rm_tristripper_reduce_swaps_log log = { .count = 0 };
+
+							if (!rm_tristripper_reduce_swaps_apply(&move, null, &log))
+							{
+								rm_tristripper_reduce_swaps_revert(&log);
+								continue;
+							}
+
+							//The log is complete now. Rate the move by counting before and after:
+							rm_size new_local_swaps_count = rm_tristripper_optimize_count_local_swaps(log.tris, log.count);
+							rm_tristripper_reduce_swaps_revert(&log);
+							rm_size old_local_swaps_count = rm_tristripper_optimize_count_local_swaps(log.tris, log.count);
+
+							rm_int64 delta = (rm_int64)new_local_swaps_count - (rm_int64)old_local_swaps_count;
+
+							if (delta >= best_delta)
+							{
+								continue;
+							}
+
+							//Only promising moves are checked for cycles:
+							log = (rm_tristripper_reduce_swaps_log) { .count = 0 };
+							rm_bool is_valid = rm_tristripper_reduce_swaps_apply(&move, &paths, &log);
+							rm_tristripper_reduce_swaps_revert(&log);
+
+							if (is_valid)
+							{
+								best_move = move;
+								best_delta = delta;
+							}
+						}
+					}
+				}
+
+				//Apply the best move (it must still be valid because we have reverted everything):
+				if (best_delta < 0)
+				{
+					rm_tristripper_reduce_swaps_log log = { .count = 0 };
+					rm_bool is_valid = rm_tristripper_reduce_swaps_apply(&best_move, &paths, &log);
+
+					rm_assert(is_valid, "Best move of the swap reduction has become invalid.");
+					rm_unused(is_valid);
+
+					swaps_count -= (rm_size)(-best_delta);
+					has_improved = true;
+				}
+			}
+		}
+	}
+
+	rm_assert(swaps_count == rm_tristripper_optimize_count_swaps(tris, tris_count), "Swap reduction has lost track of the swaps.");
+
+	rm_tristripper_optimize_paths_dispose(&paths);
+
+	//The number of strips has not changed, but the endpoints have:
+	rm_tristripper_optimize_rebuild_endpoints(tris, tris_count, tris_endpoint_list, preserve_orientation);
+
+	rm_atomic_fetch_add(&process_stats->reduce_swaps_initial_swaps_count, initial_swaps_count);
+	rm_atomic_fetch_add(&process_stats->reduce_swaps_final_swaps_count, swaps_count);
+	rm_atomic_fetch_add(&process_stats->reduce_swaps_nsecs, rm_time_now() - start_nsecs);
+}
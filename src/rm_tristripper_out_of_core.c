@@ -0,0 +1,887 @@
+#include "rm_tristripper_out_of_core.h"
+
+#include <stdlib.h>
+
+#include "rm_file.h"
+#include "rm_mem.h"
+#include "rm_time.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_strip_file.h"
+
+//A neighbour is coded as "(triangle << 2) | edge index", this marks a missing one:
+#define RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR ((rm_uint64)-1)
+
+//This marks a chunk member without a local index:
+#define RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX ((rm_size)-1)
+
+//A record of the external sort.
+//Records are ordered by key first, then by value.
+typedef struct __rm_tristripper_out_of_core_record__
+{
+	rm_uint64 key;
+	rm_uint64 value;
+} rm_tristripper_out_of_core_record;
+
+//A sorted run on disk while it is merged:
+typedef struct __rm_tristripper_out_of_core_run__
+{
+	//The next record to load and the end of the run (in bytes):
+	rm_file_offset offset;
+	rm_file_offset end_offset;
+
+	//The loaded part of the run:
+	rm_tristripper_out_of_core_record* block;
+	rm_size block_count;
+	rm_size block_index;
+} rm_tristripper_out_of_core_run;
+
+//An external sort.
+//Records are collected in memory. Whenever the buffer is full, it is sorted and written to a temporary file as a run.
+//Merging the runs yields all records in order. If the records fit into the buffer, nothing is written at all.
+typedef struct __rm_tristripper_out_of_core_sorter__
+{
+	const rm_char* temp_dir;
+	rm_file file;
+	rm_file_offset file_size;
+
+	rm_tristripper_out_of_core_record* records;
+	rm_size capacity;
+	rm_size count;
+
+	//The end offsets of the runs in the file:
+	rm_vec(rm_file_offset) run_end_offsets;
+
+	//While merging: The runs and a min-heap of their indices, ordered by their current records.
+	//Without runs, "next_index" walks the sorted buffer instead.
+	rm_tristripper_out_of_core_run* runs;
+	rm_size* heap;
+	rm_size heap_count;
+	rm_size next_index;
+
+	rm_tristripper_out_of_core_stats* out_of_core_stats;
+} rm_tristripper_out_of_core_sorter;
+
+//Everything the phases share:
+typedef struct __rm_tristripper_out_of_core_job__
+{
+	const rm_tristripper_id* ids;
+	rm_size tris_count;
+	const rm_tristripper_out_of_core_config* out_of_core_config;
+	rm_tristripper_out_of_core_stats* out_of_core_stats;
+
+	//Three neighbour codes per triangle (inside the adjacency mapping):
+	const rm_uint64* adjacency;
+
+	//One bit per triangle each: Has it been assigned to a chunk? Is it held back for the seams?
+	rm_uint8* assigned_bits;
+	rm_uint8* seam_bits;
+
+	//The members of the current chunk (in BFS order, sorted afterwards) and their local indices:
+	rm_size* members;
+	rm_size* local_indices;
+	rm_size members_count;
+	rm_size max_members_count;
+
+	rm_tristripper_strip_file_writer writer;
+} rm_tristripper_out_of_core_job;
+
+//Manage a bit in a bit array:
+static inline rm_bool rm_tristripper_out_of_core_get_bit(const rm_uint8* bits, rm_size index);
+static inline rm_void rm_tristripper_out_of_core_set_bit(rm_uint8* bits, rm_size index);
+static inline rm_void rm_tristripper_out_of_core_clear_bit(rm_uint8* bits, rm_size index);
+
+//Compare two records / two triangle indices (the latter for "bsearch(...)"):
+static rm_int rm_tristripper_out_of_core_compare_records(const rm_void* a, const rm_void* b);
+static rm_int rm_tristripper_out_of_core_compare_indices(const rm_void* a, const rm_void* b);
+
+//Sort records / triangle indices in place.
+//We use heapsort, because glibc's "qsort(...)" allocates a copy of the array, which would double the memory outside the limit.
+static rm_void rm_tristripper_out_of_core_sort_records(rm_tristripper_out_of_core_record* records, rm_size count);
+static rm_void rm_tristripper_out_of_core_sort_indices(rm_size* indices, rm_size count);
+
+//Restore the max-heap property of the first "count" records / indices below "index":
+static rm_void rm_tristripper_out_of_core_sift_down_records(rm_tristripper_out_of_core_record* records, rm_size count, rm_size index);
+static rm_void rm_tristripper_out_of_core_sift_down_indices(rm_size* indices, rm_size count, rm_size index);
+
+//Manage an external sort.
+//Push all records, then call "rm_tristripper_out_of_core_sorter_start_merge(...)" and pop them in order.
+static rm_void rm_tristripper_out_of_core_sorter_init(rm_tristripper_out_of_core_sorter* sorter, rm_size capacity, const rm_char* temp_dir, rm_tristripper_out_of_core_stats* out_of_core_stats);
+static rm_void rm_tristripper_out_of_core_sorter_dispose(rm_tristripper_out_of_core_sorter* sorter);
+static rm_void rm_tristripper_out_of_core_sorter_push(rm_tristripper_out_of_core_sorter* sorter, rm_uint64 key, rm_uint64 value);
+static rm_void rm_tristripper_out_of_core_sorter_spill(rm_tristripper_out_of_core_sorter* sorter);
+static rm_void rm_tristripper_out_of_core_sorter_start_merge(rm_tristripper_out_of_core_sorter* sorter);
+static rm_bool rm_tristripper_out_of_core_sorter_pop(rm_tristripper_out_of_core_sorter* sorter, rm_tristripper_out_of_core_record* record);
+
+//Load the next block of a run. Return false if the run is exhausted.
+static rm_bool rm_tristripper_out_of_core_sorter_load_block(rm_tristripper_out_of_core_sorter* sorter, rm_tristripper_out_of_core_run* run);
+
+//Restore the heap property below "heap_index":
+static rm_void rm_tristripper_out_of_core_sorter_sift_down(rm_tristripper_out_of_core_sorter* sorter, rm_size heap_index);
+
+//Build the adjacency file and map it:
+static rm_void rm_tristripper_out_of_core_build_adjacency(rm_tristripper_out_of_core_job* job, rm_size sorter_capacity, rm_file* adjacency_file, rm_file_mapping* adjacency_mapping);
+
+//Can a triangle still join a chunk? Take it.
+//In the seam pass, only the held back triangles are available.
+static inline rm_bool rm_tristripper_out_of_core_is_available(const rm_tristripper_out_of_core_job* job, rm_size tri_index, rm_bool is_seam_pass);
+static inline rm_void rm_tristripper_out_of_core_take(rm_tristripper_out_of_core_job* job, rm_size tri_index, rm_bool is_seam_pass);
+
+//Partition the available triangles into chunks and strip them:
+static rm_void rm_tristripper_out_of_core_strip_chunks(rm_tristripper_out_of_core_job* job, rm_bool is_seam_pass);
+
+//Strip the current chunk.
+//Outside the seam pass, members with a neighbour outside the chunk are held back for the seams.
+static rm_void rm_tristripper_out_of_core_strip_chunk(rm_tristripper_out_of_core_job* job, rm_bool is_seam_pass);
+
+//Find the local index of a triangle in the current chunk (or RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX):
+static rm_size rm_tristripper_out_of_core_find_local_index(const rm_tristripper_out_of_core_job* job, rm_size tri_index);
+
+static inline rm_bool rm_tristripper_out_of_core_get_bit(const rm_uint8* bits, rm_size index)
+{
+	return (bits[index >> 3] & (1 << (index & 7))) != 0;
+}
+
+static inline rm_void rm_tristripper_out_of_core_set_bit(rm_uint8* bits, rm_size index)
+{
+	bits[index >> 3] |= (rm_uint8)(1 << (index & 7));
+}
+
+static inline rm_void rm_tristripper_out_of_core_clear_bit(rm_uint8* bits, rm_size index)
+{
+	bits[index >> 3] &= (rm_uint8)~(1 << (index & 7));
+}
+
+static rm_int rm_tristripper_out_of_core_compare_records(const rm_void* a, const rm_void* b)
+{
+	const rm_tristripper_out_of_core_record* record_a = a;
+	const rm_tristripper_out_of_core_record* record_b = b;
+
+	if (record_a->key != record_b->key)
+	{
+		return (record_a->key > record_b->key) ? 1 : -1;
+	}
+
+	return (record_a->value > record_b->value) - (record_a->value < record_b->value);
+}
+
+static rm_int rm_tristripper_out_of_core_compare_indices(const rm_void* a, const rm_void* b)
+{
+	rm_size index_a = *(const rm_size*)a;
+	rm_size index_b = *(const rm_size*)b;
+
+	return (index_a > index_b) - (index_a < index_b);
+}
+
+static rm_void rm_tristripper_out_of_core_sort_records(rm_tristripper_out_of_core_record* records, rm_size count)
+{
+	//Build the heap bottom-up, then move the largest record behind the heap one after another:
+	for (rm_size i = count / 2; i > 0; i--)
+	{
+		rm_tristripper_out_of_core_sift_down_records(records, count, i - 1);
+	}
+
+	for (rm_size i = count; i > 1; i--)
+	{
+		rm_swap(&records[0], &records[i - 1]);
+		rm_tristripper_out_of_core_sift_down_records(records, i - 1, 0);
+	}
+}
+
+static rm_void rm_tristripper_out_of_core_sort_indices(rm_size* indices, rm_size count)
+{
+	for (rm_size i = count / 2; i > 0; i--)
+	{
+		rm_tristripper_out_of_core_sift_down_indices(indices, count, i - 1);
+	}
+
+	for (rm_size i = count; i > 1; i--)
+	{
+		rm_swap(&indices[0], &indices[i - 1]);
+		rm_tristripper_out_of_core_sift_down_indices(indices, i - 1, 0);
+	}
+}
+
+static rm_void rm_tristripper_out_of_core_sift_down_records(rm_tristripper_out_of_core_record* records, rm_size count, rm_size index)
+{
+	rm_tristripper_out_of_core_record record = records[index];
+
+	//Move the larger child up until the record fits in:
+	while ((2 * index) + 1 < count)
+	{
+		rm_size child_index = (2 * index) + 1;
+
+		if ((child_index + 1 < count) && (rm_tristripper_out_of_core_compare_records(&records[child_index], &records[child_index + 1]) < 0))
+		{
+			child_index++;
+		}
+
+		if (rm_tristripper_out_of_core_compare_records(&record, &records[child_index]) >= 0)
+		{
+			break;
+		}
+
+		records[index] = records[child_index];
+		index = child_index;
+	}
+
+	records[index] = record;
+}
+
+static rm_void rm_tristripper_out_of_core_sift_down_indices(rm_size* indices, rm_size count, rm_size index)
+{
+	rm_size value = indices[index];
+
+	while ((2 * index) + 1 < count)
+	{
+		rm_size child_index = (2 * index) + 1;
+
+		if ((child_index + 1 < count) && (indices[child_index] < indices[child_index + 1]))
+		{
+			child_index++;
+		}
+
+		if (value >= indices[child_index])
+		{
+			break;
+		}
+
+		indices[index] = indices[child_index];
+		index = child_index;
+	}
+
+	indices[index] = value;
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_init(rm_tristripper_out_of_core_sorter* sorter, rm_size capacity, const rm_char* temp_dir, rm_tristripper_out_of_core_stats* out_of_core_stats)
+{
+	*sorter = (rm_tristripper_out_of_core_sorter)
+	{
+		.temp_dir = temp_dir,
+		.file = null,
+		.file_size = 0,
+		.records = rm_malloc(capacity * sizeof(rm_tristripper_out_of_core_record)),
+		.capacity = capacity,
+		.count = 0,
+		.runs = null,
+		.heap = null,
+		.heap_count = 0,
+		.next_index = 0,
+		.out_of_core_stats = out_of_core_stats
+	};
+
+	rm_vec_init(&sorter->run_end_offsets);
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_dispose(rm_tristripper_out_of_core_sorter* sorter)
+{
+	rm_free(sorter->records);
+	rm_free(sorter->runs);
+	rm_free(sorter->heap);
+	rm_vec_dispose(&sorter->run_end_offsets);
+
+	if (sorter->file)
+	{
+		rm_file_close(sorter->file);
+	}
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_push(rm_tristripper_out_of_core_sorter* sorter, rm_uint64 key, rm_uint64 value)
+{
+	if (sorter->count == sorter->capacity)
+	{
+		rm_tristripper_out_of_core_sorter_spill(sorter);
+	}
+
+	sorter->records[sorter->count++] = (rm_tristripper_out_of_core_record) { .key = key, .value = value };
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_spill(rm_tristripper_out_of_core_sorter* sorter)
+{
+	//The file is only created once it is needed:
+	if (!sorter->file)
+	{
+		sorter->file = rm_file_open_temp(sorter->temp_dir);
+	}
+
+	//Sort the buffer and append it as a new run:
+	rm_tristripper_out_of_core_sort_records(sorter->records, sorter->count);
+
+	rm_size size = sorter->count * sizeof(rm_tristripper_out_of_core_record);
+	rm_file_write_at(sorter->file, sorter->file_size, sorter->records, size);
+
+	sorter->file_size += (rm_file_offset)size;
+	rm_vec_push(&sorter->run_end_offsets, sorter->file_size);
+	sorter->count = 0;
+
+	sorter->out_of_core_stats->runs_count++;
+	sorter->out_of_core_stats->temp_bytes += size;
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_start_merge(rm_tristripper_out_of_core_sorter* sorter)
+{
+	//Everything fits into the buffer? Then we don't need the disk at all:
+	if (sorter->run_end_offsets.count == 0)
+	{
+		rm_tristripper_out_of_core_sort_records(sorter->records, sorter->count);
+		sorter->next_index = 0;
+
+		return;
+	}
+
+	if (sorter->count > 0)
+	{
+		rm_tristripper_out_of_core_sorter_spill(sorter);
+	}
+
+	//Split the buffer into one block per run:
+	rm_size runs_count = sorter->run_end_offsets.count;
+	rm_size block_capacity = sorter->capacity / runs_count;
+
+	rm_assert(block_capacity >= RM_TRISTRIPPER_OUT_OF_CORE_MIN_MERGE_BLOCK_COUNT, "%zu sorted runs are too many to merge them within the memory limit.", runs_count);
+
+	sorter->runs = rm_malloc(runs_count * sizeof(rm_tristripper_out_of_core_run));
+	sorter->heap = rm_malloc(runs_count * sizeof(rm_size));
+	sorter->heap_count = 0;
+
+	for (rm_size i = 0; i < runs_count; i++)
+	{
+		rm_tristripper_out_of_core_run* run = &sorter->runs[i];
+
+		*run = (rm_tristripper_out_of_core_run)
+		{
+			.offset = (i > 0) ? rm_vec_at(&sorter->run_end_offsets, i - 1) : 0,
+			.end_offset = rm_vec_at(&sorter->run_end_offsets, i),
+			.block = &sorter->records[i * block_capacity],
+			.block_count = block_capacity,
+			.block_index = 0
+		};
+
+		//Runs are never empty:
+		rm_bool is_loaded = rm_tristripper_out_of_core_sorter_load_block(sorter, run);
+		rm_assert(is_loaded, "Run %zu is empty.", i);
+		rm_unused(is_loaded);
+
+		sorter->heap[sorter->heap_count++] = i;
+	}
+
+	//Build the heap bottom-up:
+	for (rm_size i = sorter->heap_count / 2; i > 0; i--)
+	{
+		rm_tristripper_out_of_core_sorter_sift_down(sorter, i - 1);
+	}
+}
+
+static rm_bool rm_tristripper_out_of_core_sorter_load_block(rm_tristripper_out_of_core_sorter* sorter, rm_tristripper_out_of_core_run* run)
+{
+	if (run->offset == run->end_offset)
+	{
+		return false;
+	}
+
+	//All blocks have the same capacity, the last one of a run might be shorter:
+	rm_size block_capacity = sorter->capacity / sorter->run_end_offsets.count;
+	rm_size size = rm_min(block_capacity * sizeof(rm_tristripper_out_of_core_record), (rm_size)(run->end_offset - run->offset));
+
+	rm_size read_size = rm_file_read_at(sorter->file, run->offset, run->block, size);
+	rm_precond(read_size == size, "A temporary file has been truncated.");
+
+	run->offset += (rm_file_offset)size;
+	run->block_count = size / sizeof(rm_tristripper_out_of_core_record);
+	run->block_index = 0;
+
+	return true;
+}
+
+static rm_void rm_tristripper_out_of_core_sorter_sift_down(rm_tristripper_out_of_core_sorter* sorter, rm_size heap_index)
+{
+	rm_size* heap = sorter->heap;
+
+	while (true)
+	{
+		//Find the smallest of the node and its children:
+		rm_size smallest_index = heap_index;
+
+		for (rm_size child_index = (2 * heap_index) + 1; (child_index <= (2 * heap_index) + 2) && (child_index < sorter->heap_count); child_index++)
+		{
+			const rm_tristripper_out_of_core_run* child_run = &sorter->runs[heap[child_index]];
+			const rm_tristripper_out_of_core_run* smallest_run = &sorter->runs[heap[smallest_index]];
+
+			if (rm_tristripper_out_of_core_compare_records(&child_run->block[child_run->block_index], &smallest_run->block[smallest_run->block_index]) < 0)
+			{
+				smallest_index = child_index;
+			}
+		}
+
+		if (smallest_index == heap_index)
+		{
+			break;
+		}
+
+		rm_swap(&heap[heap_index], &heap[smallest_index]);
+		heap_index = smallest_index;
+	}
+}
+
+static rm_bool rm_tristripper_out_of_core_sorter_pop(rm_tristripper_out_of_core_sorter* sorter, rm_tristripper_out_of_core_record* record)
+{
+	//Without runs, we just walk the buffer:
+	if (!sorter->runs)
+	{
+		if (sorter->next_index == sorter->count)
+		{
+			return false;
+		}
+
+		*record = sorter->records[sorter->next_index++];
+
+		return true;
+	}
+
+	if (sorter->heap_count == 0)
+	{
+		return false;
+	}
+
+	//The smallest record is at the head of the run on top of the heap:
+	rm_tristripper_out_of_core_run* run = &sorter->runs[sorter->heap[0]];
+	*record = run->block[run->block_index++];
+
+	//Drop the run from the heap once it is exhausted:
+	if ((run->block_index == run->block_count) && !rm_tristripper_out_of_core_sorter_load_block(sorter, run))
+	{
+		sorter->heap[0] = sorter->heap[--sorter->heap_count];
+	}
+
+	rm_tristripper_out_of_core_sorter_sift_down(sorter, 0);
+
+	return true;
+}
+
+static rm_void rm_tristripper_out_of_core_build_adjacency(rm_tristripper_out_of_core_job* job, rm_size sorter_capacity, rm_file* adjacency_file, rm_file_mapping* adjacency_mapping)
+{
+	const rm_tristripper_out_of_core_config* out_of_core_config = job->out_of_core_config;
+	const rm_tristripper_id* ids = job->ids;
+
+	//Emit every edge of every triangle with the same key the open edge hashmap uses.
+	//Degenerated triangles are ignored, we mark them as assigned, so they never join a chunk.
+	rm_tristripper_out_of_core_sorter edges_sorter;
+	rm_tristripper_out_of_core_sorter_init(&edges_sorter, sorter_capacity, out_of_core_config->temp_dir, job->out_of_core_stats);
+
+	for (rm_size i = 0; i < job->tris_count; i++)
+	{
+		const rm_tristripper_id* vertices = &ids[3 * i];
+
+		if (rm_unlikely((vertices[0] == vertices[1]) || (vertices[1] == vertices[2]) || (vertices[2] == vertices[0])))
+		{
+			rm_tristripper_out_of_core_set_bit(job->assigned_bits, i);
+			continue;
+		}
+
+		for (rm_size j = 0; j < 3; j++)
+		{
+			rm_tristripper_id v0 = vertices[j];
+			rm_tristripper_id v1 = vertices[(j + 1) % 3];
+			rm_uint64 edge_key = ((rm_uint64)rm_min(v0, v1) << 32) | (rm_uint64)rm_max(v0, v1);
+
+			rm_tristripper_out_of_core_sorter_push(&edges_sorter, edge_key, ((rm_uint64)i << 2) | j);
+		}
+	}
+
+	//Equal edges are adjacent now and ordered by triangle and edge index, just like they are inserted into the hashmap.
+	//Pairing them one after another yields the same neighbours: If A, B, C and D share an edge, (A, B) and (C, D) are paired.
+	//Every pair is emitted in both directions, keyed by the triangle and edge it belongs to.
+	rm_tristripper_out_of_core_sorter neighbours_sorter;
+	rm_tristripper_out_of_core_sorter_init(&neighbours_sorter, sorter_capacity, out_of_core_config->temp_dir, job->out_of_core_stats);
+	rm_tristripper_out_of_core_sorter_start_merge(&edges_sorter);
+
+	rm_tristripper_out_of_core_record open_edge;
+	rm_bool has_open_edge = false;
+	rm_tristripper_out_of_core_record edge;
+
+	while (rm_tristripper_out_of_core_sorter_pop(&edges_sorter, &edge))
+	{
+		if (has_open_edge && (open_edge.key == edge.key))
+		{
+			rm_tristripper_out_of_core_sorter_push(&neighbours_sorter, open_edge.value, edge.value);
+			rm_tristripper_out_of_core_sorter_push(&neighbours_sorter, edge.value, open_edge.value);
+
+			has_open_edge = false;
+		}
+		else
+		{
+			open_edge = edge;
+			has_open_edge = true;
+		}
+	}
+
+	rm_tristripper_out_of_core_sorter_dispose(&edges_sorter);
+
+	//Now the pairs are ordered by triangle, so the adjacency file can be written front to back:
+	rm_tristripper_out_of_core_sorter_start_merge(&neighbours_sorter);
+
+	*adjacency_file = rm_file_open_temp(out_of_core_config->temp_dir);
+
+	rm_file_writer writer;
+	rm_file_writer_init(&writer, *adjacency_file, RM_FILE_WRITER_DEFAULT_CAPACITY);
+
+	rm_tristripper_out_of_core_record neighbour;
+	rm_bool has_neighbour = rm_tristripper_out_of_core_sorter_pop(&neighbours_sorter, &neighbour);
+
+	for (rm_size i = 0; i < job->tris_count; i++)
+	{
+		rm_uint64 codes[3] = { RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR, RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR, RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR };
+
+		while (has_neighbour && ((neighbour.key >> 2) == i))
+		{
+			codes[neighbour.key & 3] = neighbour.value;
+			has_neighbour = rm_tristripper_out_of_core_sorter_pop(&neighbours_sorter, &neighbour);
+		}
+
+		//The file never leaves this process, so host byte order is fine:
+		rm_file_writer_write(&writer, codes, sizeof(codes));
+	}
+
+	rm_file_writer_dispose(&writer);
+	rm_tristripper_out_of_core_sorter_dispose(&neighbours_sorter);
+
+	job->out_of_core_stats->temp_bytes += job->tris_count * 3 * sizeof(rm_uint64);
+
+	//Chunks are gathered by BFS, so the accesses are local, but not sequential:
+	*adjacency_mapping = rm_file_map_open(*adjacency_file, RM_FILE_MAP_ACCESS_NORMAL, false);
+	job->adjacency = adjacency_mapping->data;
+}
+
+static inline rm_bool rm_tristripper_out_of_core_is_available(const rm_tristripper_out_of_core_job* job, rm_size tri_index, rm_bool is_seam_pass)
+{
+	return is_seam_pass ? rm_tristripper_out_of_core_get_bit(job->seam_bits, tri_index) : !rm_tristripper_out_of_core_get_bit(job->assigned_bits, tri_index);
+}
+
+static inline rm_void rm_tristripper_out_of_core_take(rm_tristripper_out_of_core_job* job, rm_size tri_index, rm_bool is_seam_pass)
+{
+	if (is_seam_pass)
+	{
+		rm_tristripper_out_of_core_clear_bit(job->seam_bits, tri_index);
+	}
+	else
+	{
+		rm_tristripper_out_of_core_set_bit(job->assigned_bits, tri_index);
+	}
+
+	job->members[job->members_count++] = tri_index;
+}
+
+static rm_void rm_tristripper_out_of_core_strip_chunks(rm_tristripper_out_of_core_job* job, rm_bool is_seam_pass)
+{
+	//Roots are searched in input order.
+	//If a chunk has run full, the next one continues at its border, so chunks stay compact.
+	rm_size next_root_index = 0;
+	rm_size border_index = RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX;
+
+	while (true)
+	{
+		job->members_count = 0;
+
+		//Fill the chunk with BFS trees.
+		//Small components share a chunk.
+		while (job->members_count < job->max_members_count)
+		{
+			rm_size root_index;
+
+			if ((border_index != RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX) && rm_tristripper_out_of_core_is_available(job, border_index, is_seam_pass))
+			{
+				root_index = border_index;
+			}
+			else
+			{
+				while ((next_root_index < job->tris_count) && !rm_tristripper_out_of_core_is_available(job, next_root_index, is_seam_pass))
+				{
+					next_root_index++;
+				}
+
+				if (next_root_index == job->tris_count)
+				{
+					break;
+				}
+
+				root_index = next_root_index;
+			}
+
+			border_index = RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX;
+
+			//The member array doubles as BFS queue:
+			rm_size head = job->members_count;
+			rm_tristripper_out_of_core_take(job, root_index, is_seam_pass);
+
+			for (; (head < job->members_count) && (border_index == RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX); head++)
+			{
+				const rm_uint64* codes = &job->adjacency[3 * job->members[head]];
+
+				for (rm_size i = 0; i < 3; i++)
+				{
+					if (codes[i] == RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR)
+					{
+						continue;
+					}
+
+					rm_size neighbour_index = (rm_size)(codes[i] >> 2);
+
+					if (!rm_tristripper_out_of_core_is_available(job, neighbour_index, is_seam_pass))
+					{
+						continue;
+					}
+
+					//The chunk is full? Then the next one starts here:
+					if (job->members_count == job->max_members_count)
+					{
+						border_index = neighbour_index;
+						break;
+					}
+
+					rm_tristripper_out_of_core_take(job, neighbour_index, is_seam_pass);
+				}
+			}
+		}
+
+		if (job->members_count == 0)
+		{
+			break;
+		}
+
+		rm_tristripper_out_of_core_strip_chunk(job, is_seam_pass);
+	}
+}
+
+static rm_size rm_tristripper_out_of_core_find_local_index(const rm_tristripper_out_of_core_job* job, rm_size tri_index)
+{
+	const rm_size* member = bsearch(&tri_index, job->members, job->members_count, sizeof(rm_size), rm_tristripper_out_of_core_compare_indices);
+
+	return member ? job->local_indices[member - job->members] : RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX;
+}
+
+static rm_void rm_tristripper_out_of_core_strip_chunk(rm_tristripper_out_of_core_job* job, rm_bool is_seam_pass)
+{
+	const rm_tristripper_out_of_core_config* out_of_core_config = job->out_of_core_config;
+	rm_tristripper_out_of_core_stats* out_of_core_stats = job->out_of_core_stats;
+
+	//The triangles keep their input order within the chunk:
+	rm_tristripper_out_of_core_sort_indices(job->members, job->members_count);
+
+	//Every member is found by the lookup at first:
+	for (rm_size i = 0; i < job->members_count; i++)
+	{
+		job->local_indices[i] = 0;
+	}
+
+	//Hold back the members at the border.
+	//Their neighbours in other chunks are held back as well (now or when their chunk comes), so the seams are two triangles wide.
+	if (!is_seam_pass)
+	{
+		for (rm_size i = 0; i < job->members_count; i++)
+		{
+			const rm_uint64* codes = &job->adjacency[3 * job->members[i]];
+
+			for (rm_size j = 0; j < 3; j++)
+			{
+				if ((codes[j] != RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR) && (rm_tristripper_out_of_core_find_local_index(job, (rm_size)(codes[j] >> 2)) == RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX))
+				{
+					rm_tristripper_out_of_core_set_bit(job->seam_bits, job->members[i]);
+					out_of_core_stats->seam_tris_count++;
+
+					break;
+				}
+			}
+		}
+	}
+
+	//Assign the local indices:
+	rm_size tris_count = 0;
+
+	for (rm_size i = 0; i < job->members_count; i++)
+	{
+		job->local_indices[i] = (!is_seam_pass && rm_tristripper_out_of_core_get_bit(job->seam_bits, job->members[i])) ? RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX : tris_count++;
+	}
+
+	//A chunk might consist of seams only:
+	if (tris_count == 0)
+	{
+		return;
+	}
+
+	//Build the triangles like "rm_tristripper_build_tris(...)", but take the neighbours from the adjacency file.
+	//Neighbours outside the chunk (or held back) are left out.
+	rm_tristripper_tri* tris = rm_malloc_large(tris_count * sizeof(rm_tristripper_tri));
+
+	for (rm_size i = 0; i < job->members_count; i++)
+	{
+		rm_size local_index = job->local_indices[i];
+
+		if (local_index == RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX)
+		{
+			continue;
+		}
+
+		rm_tristripper_tri* tri = &tris[local_index];
+		rm_size tri_index = job->members[i];
+		const rm_uint64* codes = &job->adjacency[3 * tri_index];
+
+		tri->unstripped_neighbours_count = 0;
+		tri->flags = 0;
+		tri->link_state = 0;
+
+		for (rm_size j = 0; j < 3; j++)
+		{
+			tri->vertices[j] = job->ids[(3 * tri_index) + j];
+			tri->neighbours[j] = null;
+			tri->indices_at_neighbours[j] = 0;
+
+			if (codes[j] == RM_TRISTRIPPER_OUT_OF_CORE_NO_NEIGHBOUR)
+			{
+				continue;
+			}
+
+			rm_size neighbour_local_index = rm_tristripper_out_of_core_find_local_index(job, (rm_size)(codes[j] >> 2));
+
+			if (neighbour_local_index != RM_TRISTRIPPER_OUT_OF_CORE_NO_INDEX)
+			{
+				tri->neighbours[j] = &tris[neighbour_local_index];
+				tri->indices_at_neighbours[j] = (rm_uint8)(codes[j] & 3);
+				tri->unstripped_neighbours_count++;
+			}
+		}
+	}
+
+	//Strip the chunk with a private copy of the config:
+	rm_tristripper_stats stats;
+	rm_tristripper_config config = *out_of_core_config->config;
+	config.stats = &stats;
+
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+
+	rm_tristripper_create_strips_from_tris(&tris, tris_count, &config, &strips, &strips_count);
+	rm_free(tris);
+
+	//Stream the strips out:
+	rm_size tile_index = out_of_core_stats->chunks_count++;
+	out_of_core_stats->seam_chunks_count += is_seam_pass ? 1 : 0;
+
+	if (out_of_core_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_add_tile(&job->writer, strips, strips_count, &stats);
+	}
+
+	if (out_of_core_config->output_func)
+	{
+		out_of_core_config->output_func(tile_index, strips, strips_count, &stats, out_of_core_config->output_user_data);
+	}
+
+	rm_tristripper_add_stats(&out_of_core_stats->stats, &stats);
+	rm_tristripper_dispose_strips(strips, strips_count);
+}
+
+rm_void rm_tristripper_create_strips_out_of_core(const rm_tristripper_id* ids, rm_size ids_count, const rm_tristripper_out_of_core_config* out_of_core_config, rm_tristripper_out_of_core_stats* out_of_core_stats)
+{
+	rm_assert(out_of_core_config, "Passed out-of-core config must be valid.");
+	rm_assert(out_of_core_stats, "Passed out-of-core stats must be valid.");
+	rm_precond(ids || (ids_count == 0), "Passed IDs must be valid.");
+	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
+	rm_precond(out_of_core_config->config, "Passed out-of-core config must contain a tristripper config.");
+	rm_precond(out_of_core_config->config->exact_max_count <= RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT, "The exact solver is limited to %zu triangles.", RM_TRISTRIPPER_EXACT_MAX_COUNT_LIMIT);
+
+	*out_of_core_stats = (rm_tristripper_out_of_core_stats) { .chunks_count = 0 };
+
+	//Split the memory:
+	//The bits stay, the sort buffers of both sorts and later the chunks get the rest.
+	rm_size tris_count = ids_count / 3;
+	rm_size bits_size = rm_max((tris_count + 7) / 8, (rm_size)1);
+	rm_size fixed_bytes = (2 * bits_size) + RM_TRISTRIPPER_OUT_OF_CORE_FIXED_BYTES;
+
+	rm_precond(out_of_core_config->memory_limit > fixed_bytes, "The memory limit of %zu bytes does not even cover the %zu bytes that are always needed.", out_of_core_config->memory_limit, fixed_bytes);
+
+	//Nothing needs more room than the whole mesh (three edges per triangle):
+	rm_size free_bytes = out_of_core_config->memory_limit - fixed_bytes;
+	rm_size max_records_count = rm_max(3 * tris_count, (rm_size)1);
+	rm_size sorter_capacity = rm_min(free_bytes / (2 * sizeof(rm_tristripper_out_of_core_record)), max_records_count);
+	rm_size max_members_count = rm_min(free_bytes / RM_TRISTRIPPER_OUT_OF_CORE_BYTES_PER_TRI, rm_max(tris_count, (rm_size)1));
+
+	rm_precond(max_members_count >= rm_min(RM_TRISTRIPPER_OUT_OF_CORE_MIN_CHUNK_TRIS_COUNT, rm_max(tris_count, (rm_size)1)), "The memory limit of %zu bytes is too small for chunks of %zu triangles.", out_of_core_config->memory_limit, RM_TRISTRIPPER_OUT_OF_CORE_MIN_CHUNK_TRIS_COUNT);
+
+	//Both sorts get at most "max_records_count" records (every edge is paired once at most, and a pair yields two records).
+	//Merging splits the buffer into one block per run, so we check the number of runs before anything is written:
+	if (sorter_capacity < max_records_count)
+	{
+		rm_size runs_count = (max_records_count + sorter_capacity - 1) / sorter_capacity;
+		rm_precond((sorter_capacity / runs_count) >= RM_TRISTRIPPER_OUT_OF_CORE_MIN_MERGE_BLOCK_COUNT, "The memory limit of %zu bytes is too small for sorting, %zu sorted runs could not be merged.", out_of_core_config->memory_limit, runs_count);
+	}
+
+	rm_tristripper_out_of_core_job job =
+	{
+		.ids = ids,
+		.tris_count = tris_count,
+		.out_of_core_config = out_of_core_config,
+		.out_of_core_stats = out_of_core_stats,
+		.adjacency = null,
+		.assigned_bits = rm_malloc_zero(bits_size),
+		.seam_bits = rm_malloc_zero(bits_size),
+		.members = null,
+		.local_indices = null,
+		.members_count = 0,
+		.max_members_count = max_members_count
+	};
+
+	if (out_of_core_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_open(&job.writer, out_of_core_config->output_path);
+	}
+
+	//Build the adjacency:
+	rm_uint64 start_nsecs = rm_time_now();
+
+	rm_file adjacency_file = null;
+	rm_file_mapping adjacency_mapping = { .data = null, .size = 0 };
+
+	if (tris_count > 0)
+	{
+		rm_tristripper_out_of_core_build_adjacency(&job, sorter_capacity, &adjacency_file, &adjacency_mapping);
+	}
+
+	out_of_core_stats->adjacency_nsecs = rm_time_now() - start_nsecs;
+
+	//The sort buffers are gone, the chunks take their place:
+	job.members = rm_malloc(max_members_count * sizeof(rm_size));
+	job.local_indices = rm_malloc(max_members_count * sizeof(rm_size));
+
+	//Strip the chunks:
+	start_nsecs = rm_time_now();
+	rm_tristripper_out_of_core_strip_chunks(&job, false);
+	out_of_core_stats->chunks_nsecs = rm_time_now() - start_nsecs;
+
+	//Strip the seams:
+	start_nsecs = rm_time_now();
+	rm_tristripper_out_of_core_strip_chunks(&job, true);
+	out_of_core_stats->seams_nsecs = rm_time_now() - start_nsecs;
+
+	//Clean up:
+	if (out_of_core_config->output_path)
+	{
+		rm_tristripper_strip_file_writer_close(&job.writer);
+	}
+
+	rm_file_unmap(&adjacency_mapping);
+
+	if (adjacency_file)
+	{
+		rm_file_close(adjacency_file);
+	}
+
+	rm_free(job.members);
+	rm_free(job.local_indices);
+	rm_free(job.assigned_bits);
+	rm_free(job.seam_bits);
+
+	//Sorting takes both buffers, a chunk takes its triangles:
+	rm_size sort_bytes = 2 * sorter_capacity * sizeof(rm_tristripper_out_of_core_record);
+	rm_size chunk_bytes = max_members_count * RM_TRISTRIPPER_OUT_OF_CORE_BYTES_PER_TRI;
+
+	out_of_core_stats->peak_memory_bytes = fixed_bytes + rm_max(sort_bytes, chunk_bytes);
+}
@@ -212,11 +212,12 @@ static inline rm_void rm_tristripper_build_strip_loop(rm_tristripper_tri* prev_t
 	}
 }
 
-rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_strip** strips, rm_size* strips_count)
+rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tris_count, rm_bool preserve_orientation, rm_tristripper_scratch* scratch, rm_tristripper_strip** strips, rm_size* strips_count)
 {
 	//Validate the parameters:
 	rm_assert(tris, "Passed triangles must be valid.");
 	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+	rm_assert(scratch, "Passed scratch must be valid.");
 	rm_assert(strips, "Passed strip outpointer must be valid.");
 	rm_assert(strips_count, "Passed strip count outpointer must be valid.");
 
@@ -234,15 +235,15 @@ rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tr
 	rm_vec_init(&result_strips_vec);
 	rm_vec_ensure_capacity(&result_strips_vec, strips_count_estimation);
 
-	//Create a vector to collect the tristrip IDs into.
+	//Collect the tristrip IDs into the vector of the scratch.
 	//We reuse it for every strip to save some mallocs.
-	rm_tristripper_id_vec ids_vec;
+	rm_tristripper_id_vec* ids_vec = &scratch->strip_ids;
 
 	//TODO: Bench and optimize!
 	rm_size ids_count_estimation = rm_max(2 + tris_count, (rm_size)32);
 
-	rm_vec_init(&ids_vec);
-	rm_vec_ensure_capacity(&ids_vec, ids_count_estimation);
+	rm_vec_clear(ids_vec);
+	rm_vec_ensure_capacity(ids_vec, ids_count_estimation);
 
 	//Spin through the lists in ascending order (=> prefer triangles with less neighbours) until all of them are empty.
 	//Build exactly one tristrip in each iteration.
@@ -262,16 +263,13 @@ rm_void rm_tristripper_create_strips_simple(rm_tristripper_tri* tris, rm_size tr
 
 				//Make space for a new tristrip and build it:
 				rm_tristripper_strip* curr_strip = rm_vec_push_empty(&result_strips_vec);
-				rm_tristripper_build_strip(first_core_tri, preserve_orientation, tris_adjacency_lists, &ids_vec, curr_strip);
+				rm_tristripper_build_strip(first_core_tri, preserve_orientation, tris_adjacency_lists, ids_vec, curr_strip);
 
 				break;
 			}
 		}
 	} while (first_core_tri);
 
-	//Dispose the ID vector:
-	rm_vec_dispose(&ids_vec);
-
 	//Assign the resulting tristrips:
 	*strips_count = result_strips_vec.count;
 	*strips = rm_vec_unwrap(&result_strips_vec);
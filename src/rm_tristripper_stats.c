@@ -1,6 +1,6 @@
 #include "rm_tristripper_stats.h"
 
-rm_void rm_tristripper_calculate_stats(rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_stats* stats)
+rm_void rm_tristripper_calculate_stats(const rm_tristripper_strip* strips, rm_size strips_count, rm_tristripper_stats* stats)
 {
 	//The number of strips has already been passed:
 	stats->strips_count = strips_count;
@@ -12,7 +12,7 @@ rm_void rm_tristripper_calculate_stats(rm_tristripper_strip* strips, rm_size str
 	for (rm_size i = 0; i < strips_count; i++)
 	{
 		//Get the current strip:
-		rm_tristripper_strip* curr_strip = &strips[i];
+		const rm_tristripper_strip* curr_strip = &strips[i];
 
 		//Iterate over its triangles:
 		for (rm_size j = 0; j < curr_strip->ids_count - 2; j++)
@@ -48,4 +48,56 @@ rm_void rm_tristripper_calculate_stats(rm_tristripper_strip* strips, rm_size str
 			stats->vertex_cost_models[cost_per_swap][cost_per_primitive_restart] = strips_vertex_count + (stats->swaps_count * cost_per_swap) + (primitive_restarts_count * cost_per_primitive_restart);
 		}
 	}
+
+	//We know nothing about the process:
+	stats->process = (rm_tristripper_process_stats) { 0 };
+}
+
+rm_size rm_tristripper_calculate_cost(const rm_tristripper_strip* strips, rm_size strips_count, rm_size valid_tris_count, const rm_tristripper_config* config)
+{
+	if (strips_count == 0)
+	{
+		return 0;
+	}
+
+	//Every ID that does not open a strip or complete a valid triangle belongs to a degenerated one:
+	rm_size ids_count = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		ids_count += strips[i].ids_count;
+	}
+
+	rm_size swaps_count = ids_count - (strips_count * 2) - valid_tris_count;
+
+	return (strips_count * 2) + valid_tris_count + (swaps_count * config->cost_per_swap) + ((strips_count - 1) * config->cost_per_primitive_restart);
+}
+
+rm_void rm_tristripper_add_stats(rm_tristripper_stats* sum, const rm_tristripper_stats* stats)
+{
+	sum->strips_count += stats->strips_count;
+	sum->valid_tris_count += stats->valid_tris_count;
+	sum->swaps_count += stats->swaps_count;
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		for (rm_size j = 0; j < 3; j++)
+		{
+			sum->vertex_cost_models[i][j] += stats->vertex_cost_models[i][j];
+		}
+	}
+
+	sum->process.exact_components_count += stats->process.exact_components_count;
+	sum->process.exact_improvements_count += stats->process.exact_improvements_count;
+	sum->process.exact_aborts_count += stats->process.exact_aborts_count;
+	sum->process.exact_nsecs += stats->process.exact_nsecs;
+	sum->process.optimize_iterations_count += stats->process.optimize_iterations_count;
+	sum->process.optimize_accepted_moves_count += stats->process.optimize_accepted_moves_count;
+	sum->process.optimize_initial_strips_count += stats->process.optimize_initial_strips_count;
+	sum->process.optimize_final_strips_count += stats->process.optimize_final_strips_count;
+	sum->process.optimize_saved_cost += stats->process.optimize_saved_cost;
+	sum->process.optimize_nsecs += stats->process.optimize_nsecs;
+	sum->process.reduce_swaps_initial_swaps_count += stats->process.reduce_swaps_initial_swaps_count;
+	sum->process.reduce_swaps_final_swaps_count += stats->process.reduce_swaps_final_swaps_count;
+	sum->process.reduce_swaps_nsecs += stats->process.reduce_swaps_nsecs;
 }
@@ -0,0 +1,352 @@
+#include "rm_tristripper_strip_file.h"
+
+#include "rm_mem.h"
+
+#include "rm_tristripper.h"
+
+//A zigzag-coded 32 bit delta needs at most five varint bytes:
+#define RM_TRISTRIPPER_STRIP_FILE_MAX_VARINT_SIZE ((rm_size)5)
+
+//Write the delta between two IDs and return the number of bytes.
+//Deltas wrap around at 32 bits, so every pair of IDs can be coded.
+static inline rm_size rm_tristripper_strip_file_encode_delta(rm_file_writer* writer, rm_tristripper_id prev_id, rm_tristripper_id id);
+
+//Load little endian integers from a mapping:
+static inline rm_uint32 rm_tristripper_strip_file_load_uint32(const rm_uint8* ptr);
+static inline rm_uint64 rm_tristripper_strip_file_load_uint64(const rm_uint8* ptr);
+
+//Write the header with the given counts and table offsets:
+static rm_void rm_tristripper_strip_file_write_header(rm_file_writer* writer, rm_uint64 tiles_count, rm_uint64 strips_count, rm_uint64 tile_table_offset, rm_uint64 strip_table_offset, rm_uint64 file_size);
+
+static inline rm_size rm_tristripper_strip_file_encode_delta(rm_file_writer* writer, rm_tristripper_id prev_id, rm_tristripper_id id)
+{
+	//Zigzag: Small negative deltas become small positive values.
+	rm_uint32 delta = id - prev_id;
+	rm_uint32 value = (delta << 1) ^ (rm_uint32)(-(rm_int32)(delta >> 31));
+
+	//Varint: Seven bits per byte, the high bit marks that there are more.
+	rm_uint8 bytes[RM_TRISTRIPPER_STRIP_FILE_MAX_VARINT_SIZE];
+	rm_size bytes_count = 0;
+
+	while (value >= 0x80)
+	{
+		bytes[bytes_count++] = (rm_uint8)(value | 0x80);
+		value >>= 7;
+	}
+
+	bytes[bytes_count++] = (rm_uint8)value;
+	rm_file_writer_write(writer, bytes, bytes_count);
+
+	return bytes_count;
+}
+
+static inline rm_uint32 rm_tristripper_strip_file_load_uint32(const rm_uint8* ptr)
+{
+	rm_uint32 value;
+	rm_mem_copy(&value, ptr, sizeof(rm_uint32));
+
+	return rm_flip_le_to_host_32(value);
+}
+
+static inline rm_uint64 rm_tristripper_strip_file_load_uint64(const rm_uint8* ptr)
+{
+	rm_uint64 value;
+	rm_mem_copy(&value, ptr, sizeof(rm_uint64));
+
+	return rm_flip_le_to_host_64(value);
+}
+
+static rm_void rm_tristripper_strip_file_write_header(rm_file_writer* writer, rm_uint64 tiles_count, rm_uint64 strips_count, rm_uint64 tile_table_offset, rm_uint64 strip_table_offset, rm_uint64 file_size)
+{
+	rm_file_writer_write_uint32(writer, RM_TRISTRIPPER_STRIP_FILE_MAGIC);
+	rm_file_writer_write_uint32(writer, RM_TRISTRIPPER_STRIP_FILE_VERSION);
+	rm_file_writer_write_uint64(writer, tiles_count);
+	rm_file_writer_write_uint64(writer, strips_count);
+	rm_file_writer_write_uint64(writer, tile_table_offset);
+	rm_file_writer_write_uint64(writer, strip_table_offset);
+	rm_file_writer_write_uint64(writer, file_size);
+	rm_file_writer_write_uint64(writer, 0);
+	rm_file_writer_write_uint64(writer, 0);
+}
+
+rm_void rm_tristripper_strip_file_writer_open(rm_tristripper_strip_file_writer* writer, const rm_char* path)
+{
+	rm_assert(writer, "Passed writer must be valid.");
+	rm_assert(path, "Passed path must be valid.");
+
+	writer->file = rm_file_open(path, RM_FILE_MODE_WRITE, RM_FILE_ENC_BINARY);
+	rm_file_writer_init(&writer->writer, writer->file, RM_FILE_WRITER_DEFAULT_CAPACITY);
+	writer->data_offset = RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE;
+
+	rm_vec_init(&writer->tiles);
+	rm_vec_init(&writer->strips);
+
+	//Reserve the header, it is written again as soon as we know the tables:
+	rm_tristripper_strip_file_write_header(&writer->writer, 0, 0, 0, 0, 0);
+}
+
+rm_void rm_tristripper_strip_file_writer_add_tile(rm_tristripper_strip_file_writer* writer, const rm_tristripper_strip* strips, rm_size strips_count, const rm_tristripper_stats* stats)
+{
+	rm_assert(writer, "Passed writer must be valid.");
+	rm_assert(strips || (strips_count == 0), "Passed strips must be valid.");
+
+	rm_tristripper_strip_file_tile_entry tile =
+	{
+		.first_strip_index = writer->strips.count,
+		.strips_count = strips_count,
+		.ids_count = 0
+	};
+
+	//Calculate the stats if they have not been passed:
+	if (stats)
+	{
+		tile.stats = *stats;
+	}
+	else
+	{
+		rm_tristripper_calculate_stats(strips, strips_count, &tile.stats);
+	}
+
+	//Encode the strips of the tile:
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		const rm_tristripper_strip* strip = &strips[i];
+		rm_precond((strip->ids_count > 0) && (strip->ids_count <= UINT32_MAX), "Strips must have 1 ... %" PRIu32 " IDs.", UINT32_MAX);
+
+		rm_tristripper_strip_file_strip_entry entry =
+		{
+			.data_offset = writer->data_offset,
+			.ids_count = (rm_uint32)strip->ids_count,
+			.first_id = strip->ids[0]
+		};
+
+		rm_vec_push(&writer->strips, entry);
+
+		for (rm_size j = 1; j < strip->ids_count; j++)
+		{
+			writer->data_offset += (rm_uint64)rm_tristripper_strip_file_encode_delta(&writer->writer, strip->ids[j - 1], strip->ids[j]);
+		}
+
+		tile.ids_count += strip->ids_count;
+	}
+
+	rm_vec_push(&writer->tiles, tile);
+}
+
+rm_void rm_tristripper_strip_file_writer_close(rm_tristripper_strip_file_writer* writer)
+{
+	rm_assert(writer, "Passed writer must be valid.");
+
+	//Pad the data to keep the tables aligned:
+	while ((writer->data_offset % 8) != 0)
+	{
+		rm_file_writer_write_uint8(&writer->writer, 0);
+		writer->data_offset++;
+	}
+
+	//Write the tile table:
+	rm_uint64 tile_table_offset = writer->data_offset;
+
+	for (rm_size i = 0; i < writer->tiles.count; i++)
+	{
+		const rm_tristripper_strip_file_tile_entry* tile = rm_vec_ptr_at(&writer->tiles, i);
+
+		rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->first_strip_index);
+		rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->strips_count);
+		rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->ids_count);
+		rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->stats.valid_tris_count);
+		rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->stats.swaps_count);
+
+		for (rm_size j = 0; j < 2; j++)
+		{
+			for (rm_size k = 0; k < 3; k++)
+			{
+				rm_file_writer_write_uint64(&writer->writer, (rm_uint64)tile->stats.vertex_cost_models[j][k]);
+			}
+		}
+	}
+
+	//Write the strip table:
+	rm_uint64 strip_table_offset = tile_table_offset + ((rm_uint64)writer->tiles.count * RM_TRISTRIPPER_STRIP_FILE_TILE_ENTRY_SIZE);
+
+	for (rm_size i = 0; i < writer->strips.count; i++)
+	{
+		const rm_tristripper_strip_file_strip_entry* strip = rm_vec_ptr_at(&writer->strips, i);
+
+		rm_file_writer_write_uint64(&writer->writer, strip->data_offset);
+		rm_file_writer_write_uint32(&writer->writer, strip->ids_count);
+		rm_file_writer_write_uint32(&writer->writer, strip->first_id);
+	}
+
+	rm_uint64 file_size = strip_table_offset + ((rm_uint64)writer->strips.count * RM_TRISTRIPPER_STRIP_FILE_STRIP_ENTRY_SIZE);
+
+	rm_file_writer_dispose(&writer->writer);
+
+	//Now we know everything to fill the header:
+	rm_file_writer header_writer;
+	rm_file_writer_init_at(&header_writer, writer->file, 0, RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE);
+	rm_tristripper_strip_file_write_header(&header_writer, (rm_uint64)writer->tiles.count, (rm_uint64)writer->strips.count, tile_table_offset, strip_table_offset, file_size);
+	rm_file_writer_dispose(&header_writer);
+
+	rm_file_close(writer->file);
+
+	rm_vec_dispose(&writer->tiles);
+	rm_vec_dispose(&writer->strips);
+}
+
+rm_void rm_tristripper_strip_file_open(rm_tristripper_strip_file* file, const rm_char* path, rm_file_map_access access)
+{
+	rm_assert(file, "Passed file must be valid.");
+	rm_assert(path, "Passed path must be valid.");
+
+	file->mapping = rm_file_map(path, access, false);
+
+	const rm_uint8* data = file->mapping.data;
+	rm_size size = file->mapping.size;
+
+	//Validate the header:
+	rm_precond(size >= RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE, "\"%s\" is too small to be a strip file.", path);
+	rm_precond(rm_tristripper_strip_file_load_uint32(data) == RM_TRISTRIPPER_STRIP_FILE_MAGIC, "\"%s\" is not a strip file.", path);
+	rm_precond(rm_tristripper_strip_file_load_uint32(data + 4) == RM_TRISTRIPPER_STRIP_FILE_VERSION, "\"%s\" has an unsupported version.", path);
+
+	rm_uint64 tiles_count = rm_tristripper_strip_file_load_uint64(data + 8);
+	rm_uint64 strips_count = rm_tristripper_strip_file_load_uint64(data + 16);
+	rm_uint64 tile_table_offset = rm_tristripper_strip_file_load_uint64(data + 24);
+	rm_uint64 strip_table_offset = rm_tristripper_strip_file_load_uint64(data + 32);
+	rm_uint64 file_size = rm_tristripper_strip_file_load_uint64(data + 40);
+
+	rm_precond(file_size == (rm_uint64)size, "\"%s\" is truncated.", path);
+	rm_precond((tile_table_offset >= RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE) && ((tile_table_offset % 8) == 0), "\"%s\" has an invalid tile table offset.", path);
+	rm_precond((tiles_count <= ((rm_uint64)size - tile_table_offset) / RM_TRISTRIPPER_STRIP_FILE_TILE_ENTRY_SIZE) && (strip_table_offset == tile_table_offset + (tiles_count * RM_TRISTRIPPER_STRIP_FILE_TILE_ENTRY_SIZE)), "\"%s\" has an invalid tile table.", path);
+	rm_precond(strips_count == ((rm_uint64)size - strip_table_offset) / RM_TRISTRIPPER_STRIP_FILE_STRIP_ENTRY_SIZE, "\"%s\" has an invalid strip table.", path);
+
+	file->tiles_count = (rm_size)tiles_count;
+	file->strips_count = (rm_size)strips_count;
+	file->tile_table = data + tile_table_offset;
+	file->strip_table = data + strip_table_offset;
+	file->data_end = (rm_size)tile_table_offset;
+}
+
+rm_void rm_tristripper_strip_file_close(rm_tristripper_strip_file* file)
+{
+	rm_assert(file, "Passed file must be valid.");
+
+	rm_file_unmap(&file->mapping);
+}
+
+rm_void rm_tristripper_strip_file_get_tile(const rm_tristripper_strip_file* file, rm_size tile_index, rm_tristripper_strip_file_tile* tile)
+{
+	rm_assert(file, "Passed file must be valid.");
+	rm_assert(tile, "Passed tile must be valid.");
+	rm_precond(tile_index < file->tiles_count, "Tile index %zu is out of range (%zu tiles).", tile_index, file->tiles_count);
+
+	const rm_uint8* entry = file->tile_table + (tile_index * RM_TRISTRIPPER_STRIP_FILE_TILE_ENTRY_SIZE);
+
+	rm_uint64 first_strip_index = rm_tristripper_strip_file_load_uint64(entry);
+	rm_uint64 strips_count = rm_tristripper_strip_file_load_uint64(entry + 8);
+	rm_precond((first_strip_index <= file->strips_count) && (strips_count <= file->strips_count - first_strip_index), "Tile %zu has an invalid strip range.", tile_index);
+
+	tile->first_strip_index = (rm_size)first_strip_index;
+	tile->strips_count = (rm_size)strips_count;
+	tile->ids_count = (rm_size)rm_tristripper_strip_file_load_uint64(entry + 16);
+
+	//The strips count of the stats is not stored twice:
+	tile->stats.strips_count = (rm_size)strips_count;
+	tile->stats.valid_tris_count = (rm_size)rm_tristripper_strip_file_load_uint64(entry + 24);
+	tile->stats.swaps_count = (rm_size)rm_tristripper_strip_file_load_uint64(entry + 32);
+
+	for (rm_size j = 0; j < 2; j++)
+	{
+		for (rm_size k = 0; k < 3; k++)
+		{
+			tile->stats.vertex_cost_models[j][k] = (rm_size)rm_tristripper_strip_file_load_uint64(entry + 40 + (((j * 3) + k) * 8));
+		}
+	}
+
+	tile->stats.process = (rm_tristripper_process_stats) { 0 };
+}
+
+rm_size rm_tristripper_strip_file_get_strip_ids_count(const rm_tristripper_strip_file* file, rm_size strip_index)
+{
+	rm_assert(file, "Passed file must be valid.");
+	rm_precond(strip_index < file->strips_count, "Strip index %zu is out of range (%zu strips).", strip_index, file->strips_count);
+
+	return (rm_size)rm_tristripper_strip_file_load_uint32(file->strip_table + (strip_index * RM_TRISTRIPPER_STRIP_FILE_STRIP_ENTRY_SIZE) + 8);
+}
+
+rm_void rm_tristripper_strip_file_decode_strip(const rm_tristripper_strip_file* file, rm_size strip_index, rm_tristripper_id* ids)
+{
+	rm_assert(file, "Passed file must be valid.");
+	rm_assert(ids, "Passed IDs must be valid.");
+	rm_precond(strip_index < file->strips_count, "Strip index %zu is out of range (%zu strips).", strip_index, file->strips_count);
+
+	const rm_uint8* entry = file->strip_table + (strip_index * RM_TRISTRIPPER_STRIP_FILE_STRIP_ENTRY_SIZE);
+
+	rm_uint64 data_offset = rm_tristripper_strip_file_load_uint64(entry);
+	rm_size ids_count = (rm_size)rm_tristripper_strip_file_load_uint32(entry + 8);
+	rm_precond((data_offset >= RM_TRISTRIPPER_STRIP_FILE_HEADER_SIZE) && (data_offset <= file->data_end), "Strip %zu has an invalid data offset.", strip_index);
+
+	if (ids_count == 0)
+	{
+		return;
+	}
+
+	const rm_uint8* data = file->mapping.data;
+	const rm_uint8* ptr = data + data_offset;
+	const rm_uint8* end = data + file->data_end;
+
+	//If the strip cannot run over the end of the data, we can skip the bounds checks:
+	rm_bool is_bounded = (rm_size)(end - ptr) >= ((ids_count - 1) * RM_TRISTRIPPER_STRIP_FILE_MAX_VARINT_SIZE);
+
+	rm_tristripper_id id = rm_tristripper_strip_file_load_uint32(entry + 12);
+	ids[0] = id;
+
+	for (rm_size i = 1; i < ids_count; i++)
+	{
+		//Read the varint:
+		rm_uint32 value = 0;
+		rm_uint32 shift = 0;
+		rm_uint8 byte;
+
+		do
+		{
+			rm_precond(is_bounded || (ptr < end), "Strip %zu runs over the end of the data.", strip_index);
+			rm_precond(shift < 35, "Strip %zu contains an invalid varint.", strip_index);
+
+			byte = *ptr++;
+			value |= (rm_uint32)(byte & 0x7f) << shift;
+			shift += 7;
+		}
+		while (byte & 0x80);
+
+		//Undo the zigzag coding and apply the delta:
+		id += (value >> 1) ^ (rm_uint32)(-(rm_int32)(value & 1));
+		ids[i] = id;
+	}
+}
+
+rm_void rm_tristripper_strip_file_read_tile(const rm_tristripper_strip_file* file, rm_size tile_index, rm_tristripper_strip** strips, rm_size* strips_count)
+{
+	rm_assert(file, "Passed file must be valid.");
+	rm_assert(strips, "Passed strips pointer must be valid.");
+	rm_assert(strips_count, "Passed strips count pointer must be valid.");
+
+	rm_tristripper_strip_file_tile tile;
+	rm_tristripper_strip_file_get_tile(file, tile_index, &tile);
+
+	//Use the same layout as "rm_tristripper_create_strips(...)" to share the dispose function:
+	*strips = (tile.strips_count == 0) ? null : rm_malloc(tile.strips_count * sizeof(rm_tristripper_strip));
+	*strips_count = tile.strips_count;
+
+	for (rm_size i = 0; i < tile.strips_count; i++)
+	{
+		rm_size strip_index = tile.first_strip_index + i;
+		rm_size ids_count = rm_tristripper_strip_file_get_strip_ids_count(file, strip_index);
+
+		rm_tristripper_strip* strip = &(*strips)[i];
+		strip->ids_count = ids_count;
+		strip->ids = rm_malloc(ids_count * sizeof(rm_tristripper_id));
+
+		rm_tristripper_strip_file_decode_strip(file, strip_index, strip->ids);
+	}
+}
@@ -3,21 +3,14 @@
 #include "rm_hashmap.h"
 #include "rm_mem.h"
 
-//An edge key is formed by two vertices that form an edge.
-//The vertex indices are stuffed in one numeric value twice the size (lower one to the lower bits).
-typedef rm_uint64 rm_tristripper_edge_key;
+//The number of triangles whose edges are inserted into the hashmap as one batch:
+#define RM_TRISTRIPPER_BUILD_TRIS_BATCH_COUNT 128
 
-//A triangle pointer in combination with an edge index (0, 1 or 2) that represents a free neighbour position.
-typedef struct __rm_tristripper_open_edge__
-{
-	rm_tristripper_tri* tri;
-	rm_uint8 edge_index;
-} rm_tristripper_open_edge;
-
-//We need a hashmap monomorphization that maps edge keys to open edges.
-//It will be used to stitch triangles to their neighbours.
-RM_HASHMAP_DECLARE(tristripper_open_edge, rm_tristripper_edge_key, rm_tristripper_open_edge, SKV)
-#define RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR 0.75
+//The mixer for the edge key hashes (see "rm_hashmap.h"), it can be replaced at build time to compare them.
+//The identity keeps the edges of nearby vertices in nearby buckets, the key packs both vertices, so the low bits still differ.
+#ifndef RM_TRISTRIPPER_OPEN_EDGE_HASH_MIXER
+#define RM_TRISTRIPPER_OPEN_EDGE_HASH_MIXER rm_hashmap_mix_identity
+#endif
 
 //Hashing and comparing for our hashmap:
 static inline rm_hashmap_hash rm_tristripper_open_edge_hashmap_hash(rm_tristripper_edge_key key);
@@ -28,8 +21,8 @@ static inline rm_tristripper_edge_key rm_tristripper_open_edge_hashmap_make_key(
 
 static inline rm_hashmap_hash rm_tristripper_open_edge_hashmap_hash(rm_tristripper_edge_key key)
 {
-	//Use the key itself as hash:
-	return (rm_hashmap_hash)key;
+	//Use the key itself as hash (mixed if requested):
+	return RM_TRISTRIPPER_OPEN_EDGE_HASH_MIXER((rm_hashmap_hash)key);
 }
 
 static inline rm_bool rm_tristripper_open_edge_hashmap_compare(rm_tristripper_edge_key key0, rm_tristripper_edge_key key1)
@@ -87,110 +80,252 @@ extern rm_void rm_tristripper_order_tris(rm_tristripper_tri* tris, rm_size tris_
 extern rm_void rm_tristripper_determine_core_entrance_vertex_ids(const rm_tristripper_id* first_shared_edge, const rm_tristripper_id* second_shared_edge, rm_tristripper_id* core_entrance_vertix_ids);;
 
 rm_void rm_tristripper_build_tris(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri** tris, rm_size* tris_count)
+{
+	rm_tristripper_build_tris_ex(ids, ids_count, tris, tris_count, null);
+}
+
+rm_void rm_tristripper_build_tris_ex(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri** tris, rm_size* tris_count, rm_hashmap_stats* open_edges_stats)
 {
 	//Make sure we don't get rubbish as input:
 	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
 
-	//Create a hashmap for the open edges:
+	//Allocate memory for the triangles.
+	//We allocate the maximal amount and expect no triangles to be degenerated.
+	//If there are actually some of them, there will be unused, "overhanging" memory.
+	rm_size expected_tris_count = ids_count / 3;
+
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_BUILD_TRIS);
+	rm_tristripper_tri* result_tris = rm_malloc_large(expected_tris_count * sizeof(rm_tristripper_tri));
+
+	//Create a hashmap for the open edges.
+	//Its memory is tracked on its own (see "rm_mem.h"), everything else we allocate from here on belongs to it.
 	rm_tristripper_open_edge_hashmap open_edges;
+	rm_mem_push_tag(RM_MEM_TAG_HASHMAP);
 
 	//Initialize it with a (hopefully) sufficient bucket count:
     rm_size bucket_count = rm_hashmap_get_sufficient_bucket_count(ids_count, RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR);
     rm_tristripper_open_edge_hashmap_init_ex(&open_edges, bucket_count, RM_TRISTRIPPER_OPEN_EDGE_HASHMAP_LOAD_FACTOR);
 
-	//Allocate memory for the triangles.
-	//We allocate the maximal amount and expect no triangles to be degenerated.
-	//If there are actually some of them, there will be unused, "overhanging" memory.
+	//Build and stitch the triangles:
+	rm_size result_tris_count = rm_tristripper_build_tris_into(ids, ids_count, result_tris, &open_edges, open_edges_stats);
+
+	rm_tristripper_open_edge_hashmap_dispose(&open_edges);
+	rm_mem_pop_tag(previous_mem_tag);
+
+	//Assign the result:
+	*tris = result_tris;
+	*tris_count = result_tris_count;
+}
+
+rm_size rm_tristripper_build_tris_into(const rm_tristripper_id* ids, rm_size ids_count, rm_tristripper_tri* tris, rm_tristripper_open_edge_hashmap* open_edges, rm_hashmap_stats* open_edges_stats)
+{
+	//Make sure we don't get rubbish as input:
+	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
+	rm_assert(tris || (ids_count == 0), "Passed triangles must be valid.");
+	rm_assert(open_edges && (open_edges->count == 0), "Passed hashmap for the open edges must be empty.");
+
+	//Degenerated triangles are skipped, so we might not fill all the room:
 	rm_size expected_tris_count = ids_count / 3;
-    rm_size result_tris_count = 0;
+	rm_size result_tris_count = 0;
+
+	//Iterate over all of them.
+	//The edges of a whole batch of triangles are inserted into the hashmap at once, so the bucket misses overlap.
+	for (rm_size i = 0; i < expected_tris_count;)
+	{
+		rm_tristripper_edge_key edge_keys[3 * RM_TRISTRIPPER_BUILD_TRIS_BATCH_COUNT];
+		rm_tristripper_open_edge new_open_edges[3 * RM_TRISTRIPPER_BUILD_TRIS_BATCH_COUNT];
+		rm_size edges_count = 0;
+
+		for (; (i < expected_tris_count) && (edges_count < rm_array_count(edge_keys)); i++)
+		{
+			//Get the current triangle:
+			rm_tristripper_tri* tri = &tris[result_tris_count];
+
+			//Start without any neighbours:
+			tri->neighbours[0] = null;
+			tri->neighbours[1] = null;
+			tri->neighbours[2] = null;
+
+			tri->unstripped_neighbours_count = 0;
+
+			//Null all the flags (but only the necessary stuff):
+			tri->flags = 0;
+			tri->link_state = 0;
+
+			//Insert the vertices (keep the winding order):
+			tri->vertices[0] = ids[3 * i];
+			tri->vertices[1] = ids[(3 * i) + 1];
+			tri->vertices[2] = ids[(3 * i) + 2];
+
+			//Ignore degenerated triangles:
+			if (rm_unlikely((tri->vertices[0] == tri->vertices[1]) || (tri->vertices[1] == tri->vertices[2]) || (tri->vertices[2] == tri->vertices[0])))
+			{
+				continue;
+			}
+
+			//Increment the actual triangle count:
+			result_tris_count++;
+
+			//Add the three edges to the batch:
+			for (rm_size j = 0; j < 3; j++)
+			{
+				edge_keys[edges_count] = rm_tristripper_open_edge_hashmap_make_key(tri->vertices[j], tri->vertices[(j + 1) % 3]);
+
+				new_open_edges[edges_count] = (rm_tristripper_open_edge)
+				{
+					.tri = tri,
+					.edge_index = (rm_uint8)j
+				};
+
+				edges_count++;
+			}
+		}
+
+		//Try to insert the open edges into the hashmap.
+		//If a spot is already occupied, we *instead* retrieve the existing open edge.
+		rm_tristripper_open_edge old_open_edges[3 * RM_TRISTRIPPER_BUILD_TRIS_BATCH_COUNT];
+		rm_bool are_edges_occupied[3 * RM_TRISTRIPPER_BUILD_TRIS_BATCH_COUNT];
 
-	rm_tristripper_tri* result_tris = rm_malloc(expected_tris_count * sizeof(rm_tristripper_tri));
+		rm_tristripper_open_edge_hashmap_update_batch(open_edges, edge_keys, new_open_edges, edges_count, RM_HASHMAP_UPDATE_MODE_INSERT, old_open_edges, are_edges_occupied);
 
-	//Iterate over all of them:
-	for (rm_size i = 0; i < expected_tris_count; i++)
+		//Stitch the triangles in the order of their edges:
+		for (rm_size j = 0; j < edges_count; j++)
+		{
+			if (!are_edges_occupied[j])
+			{
+				continue;
+			}
+
+			rm_tristripper_edge_key curr_edge_key = edge_keys[j];
+			rm_tristripper_open_edge new_open_edge = new_open_edges[j];
+			rm_tristripper_open_edge old_open_edge = old_open_edges[j];
+
+			//The batch does not remove open edges, so an earlier edge of it might already have taken this one.
+			//In that case, we repeat the insertion on its own to get the same result as without the batch (this is rare, more than two triangles must share the edge).
+			if (rm_unlikely(old_open_edge.tri->neighbours[(rm_size)old_open_edge.edge_index] != null) && !rm_tristripper_open_edge_hashmap_update(open_edges, curr_edge_key, new_open_edge, RM_HASHMAP_UPDATE_MODE_INSERT, &old_open_edge))
+			{
+				continue;
+			}
+
+			//Get our triangle and its neighbour triangle:
+			rm_tristripper_tri* tri = new_open_edge.tri;
+			rm_tristripper_tri* neighbour = old_open_edge.tri;
+
+			//Stich the two triangles together:
+			tri->neighbours[(rm_size)new_open_edge.edge_index] = neighbour;
+			tri->indices_at_neighbours[(rm_size)new_open_edge.edge_index] = old_open_edge.edge_index;
+			tri->unstripped_neighbours_count++;
+
+			neighbour->neighbours[(rm_size)old_open_edge.edge_index] = tri;
+			neighbour->indices_at_neighbours[(rm_size)old_open_edge.edge_index] = new_open_edge.edge_index;
+			neighbour->unstripped_neighbours_count++;
+
+			//Remove the open edge from the hashmap.
+			//This allows more than two triangles to share an edge.
+			//Example: If triangles A, B, C, and D share an edge and are inserted in that order,
+			// (A, B) and (C, D) will become neighbours without interference.
+			//Of course, this should only be a three-dimensional issue ...
+			rm_tristripper_open_edge_hashmap_remove(open_edges, curr_edge_key);
+		}
+	}
+
+	//Report the hashmap layout if requested:
+	if (open_edges_stats)
 	{
-		//Get the current triangle:
-		rm_tristripper_tri* tri = &result_tris[result_tris_count];
+		rm_tristripper_open_edge_hashmap_get_stats(open_edges, open_edges_stats);
+	}
+
+	return result_tris_count;
+}
+
+rm_void rm_tristripper_reorder_tris(rm_tristripper_tri** tris, rm_size tris_count, rm_size_vec* component_offsets)
+{
+	//Validate the parameters:
+	rm_assert(tris && *tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
+
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_BUILD_TRIS);
+	rm_tristripper_tri* new_tris = rm_malloc_large(tris_count * sizeof(rm_tristripper_tri));
 
-		//Start without any neighbours:
-		tri->neighbours[0] = null;
-		tri->neighbours[1] = null;
-		tri->neighbours[2] = null;
+	rm_tristripper_reorder_tris_into(*tris, tris_count, new_tris, component_offsets);
 
-		tri->unstripped_neighbours_count = 0;
+	//Replace the old array:
+	rm_free(*tris);
+	*tris = new_tris;
 
-		//Null all the flags (but only the necessary stuff):
-		tri->flags = 0;
-		tri->link_state = 0;
+	rm_mem_pop_tag(previous_mem_tag);
+}
+
+rm_void rm_tristripper_reorder_tris_into(rm_tristripper_tri* old_tris, rm_size tris_count, rm_tristripper_tri* new_tris, rm_size_vec* component_offsets)
+{
+	//Validate the parameters:
+	rm_assert(old_tris && new_tris, "Passed triangles must be valid.");
+	rm_assert(tris_count > 0, "Number of passed triangles must be > 0.");
 
-		//Insert the vertices (keep the winding order):
-		tri->vertices[0] = ids[3 * i];
-		tri->vertices[1] = ids[(3 * i) + 1];
-		tri->vertices[2] = ids[(3 * i) + 2];
+	//The new triangle array doubles as BFS queue:
+	//Everything in front of "head" has been expanded, everything behind it is still waiting.
+	rm_size new_tris_count = 0;
 
-		//Ignore degenerated triangles:
-		if (rm_unlikely((tri->vertices[0] == tri->vertices[1]) || (tri->vertices[1] == tri->vertices[2]) || (tri->vertices[2] == tri->vertices[0])))
+	//Start a new BFS at every triangle that has not been reached yet (one per connected component):
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* root_tri = &old_tris[i];
+
+		if (rm_tristripper_tri_is_visited(root_tri))
 		{
 			continue;
 		}
 
-		//Increment the actual triangle count:
-		result_tris_count++;
-
-		//Build the three edge keys:
-		rm_tristripper_edge_key edge_keys[3] =
+		//A new component starts here:
+		if (component_offsets)
 		{
-			rm_tristripper_open_edge_hashmap_make_key(tri->vertices[0], tri->vertices[1]),
-			rm_tristripper_open_edge_hashmap_make_key(tri->vertices[1], tri->vertices[2]),
-			rm_tristripper_open_edge_hashmap_make_key(tri->vertices[2], tri->vertices[0])
-		};
+			rm_vec_push(component_offsets, new_tris_count);
+		}
+
+		//Enqueue the root.
+		//The copy is taken *before* the flag is set, so the new triangle starts unvisited.
+		//The "prev_tri" pointer of the old triangle is not in use yet, so we abuse it to remember the new location.
+		new_tris[new_tris_count] = *root_tri;
+		root_tri->prev_tri = &new_tris[new_tris_count++];
+		rm_tristripper_tri_set_visited(root_tri, 0);
 
-		//Iterate through the three edges:
-		for (rm_size j = 0; j < rm_array_count(edge_keys); j++)
+		for (rm_size head = new_tris_count - 1; head < new_tris_count; head++)
 		{
-			rm_tristripper_edge_key curr_edge_key = edge_keys[j];
+			//At this point, the neighbour pointers of the queued triangle still point into the old array:
+			rm_tristripper_tri* curr_tri = &new_tris[head];
 
-			//Create an open edge struct:
-			rm_tristripper_open_edge new_open_edge =
+			for (rm_size j = 0; j < rm_array_count(curr_tri->neighbours); j++)
 			{
-				.tri = tri,
-				.edge_index = (rm_uint8)j
-			};
+				rm_tristripper_tri* neighbour = curr_tri->neighbours[j];
 
-			//Try to insert the open edge into the hashmap.
-			//If the spot is already occupied, we *instead* retrieve the existing open edge.
-			rm_tristripper_open_edge old_open_edge;
+				if (!neighbour || rm_tristripper_tri_is_visited(neighbour))
+				{
+					continue;
+				}
 
-			if (rm_tristripper_open_edge_hashmap_update(&open_edges, curr_edge_key, new_open_edge, RM_HASHMAP_UPDATE_MODE_INSERT, &old_open_edge))
-			{
-				//Get our neighbour triangle:
-				rm_tristripper_tri* neighbour = old_open_edge.tri;
-
-				//Stich the two triangles together:
-				tri->neighbours[j] = neighbour;
-				tri->indices_at_neighbours[j] = old_open_edge.edge_index;
-				tri->unstripped_neighbours_count++;
-
-				neighbour->neighbours[(rm_size)old_open_edge.edge_index] = tri;
-				neighbour->indices_at_neighbours[(rm_size)old_open_edge.edge_index] = (rm_uint8)j;
-				neighbour->unstripped_neighbours_count++;
-
-				//Remove the open edge from the hashmap.
-				//This allows more than two triangles to share an edge.
-				//Example: If triangles A, B, C, and D share an edge and are inserted in that order,
-				// (A, B) and (C, D) will become neighbours without interference.
-				//Of course, this should only be a three-dimensional issue ...
-				rm_tristripper_open_edge_hashmap_remove(&open_edges, curr_edge_key);
+				//Enqueue the neighbour:
+				new_tris[new_tris_count] = *neighbour;
+				neighbour->prev_tri = &new_tris[new_tris_count++];
+				rm_tristripper_tri_set_visited(neighbour, 0);
 			}
 		}
 	}
 
-	//Dispose the hashmap:
-	rm_tristripper_open_edge_hashmap_dispose(&open_edges);
+	rm_assert(new_tris_count == tris_count, "BFS has reached %zu of %zu triangles.", new_tris_count, tris_count);
 
-	//Assign the result:
-	*tris = result_tris;
-	*tris_count = result_tris_count;
+	//Now that every triangle has its final location, remap the neighbour pointers:
+	for (rm_size i = 0; i < tris_count; i++)
+	{
+		rm_tristripper_tri* curr_tri = &new_tris[i];
+
+		for (rm_size j = 0; j < rm_array_count(curr_tri->neighbours); j++)
+		{
+			if (curr_tri->neighbours[j])
+			{
+				curr_tri->neighbours[j] = curr_tri->neighbours[j]->prev_tri;
+			}
+		}
+	}
 }
 
 rm_tristripper_tri* rm_tristripper_select_next_core_tri(rm_tristripper_tri* tri, rm_tristripper_tri** tris_adjacency_lists, rm_tristripper_id* shared_edge, rm_size* index_from_tri)
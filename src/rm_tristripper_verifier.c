@@ -4,10 +4,22 @@
 #include "rm_log.h"
 #include "rm_macro.h"
 #include "rm_mem.h"
+#include "rm_thread.h"
 
 //The load factor for our hashmap:
 #define RM_TRISTRIPPER_TRI_OCCURRENCE_HASHMAP_LOAD_FACTOR 0.75
 
+//The number of triangles that are looked up in the hashmap as one batch:
+#define RM_TRISTRIPPER_VERIFIER_BATCH_COUNT 256
+
+//The number of input triangles a thread takes at once while the verifier is built:
+#define RM_TRISTRIPPER_VERIFIER_CHUNK_TRIS_COUNT ((rm_size)65536)
+
+//The mixer for the triangle key hashes (see "rm_hashmap.h"), it can be replaced at build time to compare them:
+#ifndef RM_TRISTRIPPER_TRI_OCCURRENCE_HASH_MIXER
+#define RM_TRISTRIPPER_TRI_OCCURRENCE_HASH_MIXER rm_hashmap_mix_identity
+#endif
+
 //Hashing, comparing and merging for our hashmap:
 static inline rm_hashmap_hash rm_tristripper_tri_occurrence_hashmap_hash(rm_tristripper_tri_key key);
 static inline rm_bool rm_tristripper_tri_occurrence_hashmap_compare(rm_tristripper_tri_key key1, rm_tristripper_tri_key key2);
@@ -19,10 +31,29 @@ static inline rm_tristripper_tri_key rm_tristripper_tri_occurrence_hashmap_make_
 //This is a helper function to log all the triangles that are missing from a strip:
 static rm_bool rm_tristripper_verifier_log_missing_tris(const rm_tristripper_tri_occurrence_hashmap* occurrences, rm_tristripper_tri_key key, rm_tristripper_tri_occurrence occurrence, rm_void* context);
 
+//The shared state of the threads that build a verifier.
+//"next_chunk_index", "valid_tris_count" and "merged_tris_count" must be accessed atomically.
+typedef struct __rm_tristripper_verifier_job__
+{
+	const rm_tristripper_id* ids;
+	rm_size tris_count;
+	rm_size chunks_count;
+
+	rm_tristripper_tri_occurrence_sharded_hashmap* occurrences;
+
+	rm_size next_chunk_index;
+	rm_size valid_tris_count;
+	rm_size merged_tris_count;
+} rm_tristripper_verifier_job;
+
+//The entry point of a worker thread.
+//Fetch chunks of triangles from the job and insert them into the hashmap until all of them are done.
+static rm_void* rm_tristripper_verifier_worker(rm_void* arg);
+
 static inline rm_hashmap_hash rm_tristripper_tri_occurrence_hashmap_hash(rm_tristripper_tri_key key)
 {
-	//XOR them all together:
-	return (rm_hashmap_hash)(key.vertex_ids[0] ^ key.vertex_ids[1] ^ key.vertex_ids[2]);
+	//XOR them all together (and mix the result if requested):
+	return RM_TRISTRIPPER_TRI_OCCURRENCE_HASH_MIXER((rm_hashmap_hash)(key.vertex_ids[0] ^ key.vertex_ids[1] ^ key.vertex_ids[2]));
 }
 
 static inline rm_bool rm_tristripper_tri_occurrence_hashmap_compare(rm_tristripper_tri_key key0, rm_tristripper_tri_key key1)
@@ -119,84 +150,183 @@ static rm_bool rm_tristripper_verifier_log_missing_tris(const rm_tristripper_tri
 
 //Spawn the implementation of all the hashmap functions:
 RM_HASHMAP_DEFINE(tristripper_tri_occurrence, rm_tristripper_tri_occurrence_hashmap_hash, rm_tristripper_tri_occurrence_hashmap_compare, null, null, null, null, rm_tristripper_tri_occurrence_hashmap_merge)
+RM_HASHMAP_SHARDED_DEFINE(tristripper_tri_occurrence)
 
-rm_void rm_tristripper_init_verifier(rm_tristripper_verifier* verifier, rm_tristripper_id* ids, rm_size ids_count)
+static rm_void* rm_tristripper_verifier_worker(rm_void* arg)
 {
-	//Make sure we don't get rubbish as input:
-	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
+	rm_tristripper_verifier_job* job = arg;
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_VERIFIER);
 
-	//Initialize the hashmap with a (hopefully) sufficient bucket count:
-    rm_size bucket_count = rm_hashmap_get_sufficient_bucket_count(ids_count, RM_TRISTRIPPER_TRI_OCCURRENCE_HASHMAP_LOAD_FACTOR);
-    rm_tristripper_tri_occurrence_hashmap_init_ex(&verifier->occurrences, bucket_count, RM_TRISTRIPPER_TRI_OCCURRENCE_HASHMAP_LOAD_FACTOR);
+	//Our updates are collected per shard, so the shard locks are taken once per bunch instead of once per triangle:
+	rm_tristripper_tri_occurrence_sharded_hashmap_buffer buffer;
+	rm_tristripper_tri_occurrence_sharded_hashmap_buffer_init(&buffer, job->occurrences, RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE);
 
-    //Iterate over the triangles that are formed by the IDs:
-    verifier->valid_tris_count = 0;
-	verifier->distinct_valid_tris_count = 0;
+	rm_size valid_tris_count = 0;
 
-	for (rm_size i = 0; i < ids_count; i += 3)
+	while (true)
 	{
-		//Get the IDs for the current triangle:
-		rm_tristripper_id curr_ids[] = { ids[i], ids[i + 1], ids[i + 2] };
+		//Fetch the next chunk:
+		rm_size chunk_index = rm_atomic_fetch_add(&job->next_chunk_index, 1);
 
-		//Ignore degenerated triangles:
-		if (rm_unlikely((curr_ids[0] == curr_ids[1]) || (curr_ids[1] == curr_ids[2]) || (curr_ids[2] == curr_ids[0])))
+		if (chunk_index >= job->chunks_count)
 		{
-			continue;
+			break;
 		}
 
-		//Build a triangle key:
-		rm_tristripper_tri_key curr_tri_key = rm_tristripper_tri_occurrence_hashmap_make_key(curr_ids[0], curr_ids[1], curr_ids[2]);
+		rm_size first_tri_index = chunk_index * RM_TRISTRIPPER_VERIFIER_CHUNK_TRIS_COUNT;
+		rm_size last_tri_index = rm_min(first_tri_index + RM_TRISTRIPPER_VERIFIER_CHUNK_TRIS_COUNT, job->tris_count);
 
-		//Build an initial value struct:
-		rm_tristripper_tri_occurrence new_occurrence =
+		for (rm_size i = first_tri_index; i < last_tri_index; i++)
 		{
-			.multiplicity = 1,
-			.index = verifier->distinct_valid_tris_count
-		};
+			//Get the IDs for the current triangle:
+			const rm_tristripper_id* curr_ids = &job->ids[3 * i];
+
+			//Ignore degenerated triangles:
+			if (rm_unlikely((curr_ids[0] == curr_ids[1]) || (curr_ids[1] == curr_ids[2]) || (curr_ids[2] == curr_ids[0])))
+			{
+				continue;
+			}
 
-		//Insert or merge the triangle into the hashmap.
-		//If the key-value pair already exists, the value's multiplicity will be increased by 1.
-		rm_tristripper_tri_occurrence dummy_occurrence;
+			//Insert or merge the triangle into the hashmap.
+			//If a key-value pair already exists, the value's multiplicity will be increased by 1.
+			//The index is the position of the triangle in the input, so it is unique and does not depend on the other threads.
+			rm_tristripper_tri_occurrence occurrence =
+			{
+				.multiplicity = 1,
+				.index = i
+			};
 
-		if (!rm_tristripper_tri_occurrence_hashmap_update(&verifier->occurrences, curr_tri_key, new_occurrence, RM_HASHMAP_UPDATE_MODE_INSERT_OR_MERGE, &dummy_occurrence))
-		{
-			//This is the first occurrence of the current triangle!
-			//Increase the number of distinct valid triangles.
-			verifier->distinct_valid_tris_count++;
+			rm_tristripper_tri_occurrence_sharded_hashmap_buffer_update(&buffer, rm_tristripper_tri_occurrence_hashmap_make_key(curr_ids[0], curr_ids[1], curr_ids[2]), occurrence);
+			valid_tris_count++;
 		}
+	}
+
+	//Apply the rest of our updates. Every update that has found an existing triangle was merged.
+	rm_tristripper_tri_occurrence_sharded_hashmap_buffer_dispose(&buffer);
+
+	rm_atomic_fetch_add(&job->valid_tris_count, valid_tris_count);
+	rm_atomic_fetch_add(&job->merged_tris_count, buffer.found_count);
+	rm_mem_pop_tag(previous_mem_tag);
 
-		//We have added a new valid triangle:
-		verifier->valid_tris_count++;
+	return null;
+}
+
+rm_void rm_tristripper_init_verifier(rm_tristripper_verifier* verifier, const rm_tristripper_id* ids, rm_size ids_count)
+{
+	rm_tristripper_init_verifier_ex(verifier, ids, ids_count, 1);
+}
+
+rm_void rm_tristripper_init_verifier_ex(rm_tristripper_verifier* verifier, const rm_tristripper_id* ids, rm_size ids_count, rm_size threads_count)
+{
+	//Make sure we don't get rubbish as input:
+	rm_precond((ids_count % 3) == 0, "Number of vertex IDs must be divisible by 3.");
+
+	verifier->tris_count = ids_count / 3;
+
+	//The memory of the verifier is tracked on its own (see "rm_mem.h"):
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_VERIFIER);
+
+	//Determine the number of threads.
+	//There is no point in having more threads than chunks.
+	rm_size chunks_count = (verifier->tris_count + RM_TRISTRIPPER_VERIFIER_CHUNK_TRIS_COUNT - 1) / RM_TRISTRIPPER_VERIFIER_CHUNK_TRIS_COUNT;
+
+	threads_count = (threads_count == RM_TRISTRIPPER_THREADS_COUNT_AUTO) ? rm_thread_get_processors_count() : threads_count;
+	threads_count = rm_max(rm_min(threads_count, chunks_count), (rm_size)1);
+
+	//Initialize the hashmap with a (hopefully) sufficient bucket count.
+	//A single thread does not need to share, so it gets a single shard (and the iteration order of a plain hashmap).
+	rm_size shards_count = (threads_count == 1) ? 1 : rm_hashmap_sharded_get_shards_count(threads_count);
+	rm_size bucket_count = rm_hashmap_get_sufficient_bucket_count(ids_count, RM_TRISTRIPPER_TRI_OCCURRENCE_HASHMAP_LOAD_FACTOR);
+	rm_tristripper_tri_occurrence_sharded_hashmap_init(&verifier->occurrences, shards_count, bucket_count, RM_TRISTRIPPER_TRI_OCCURRENCE_HASHMAP_LOAD_FACTOR);
+
+	//Prepare the job:
+	rm_tristripper_verifier_job job =
+	{
+		.ids = ids,
+		.tris_count = verifier->tris_count,
+		.chunks_count = chunks_count,
+		.occurrences = &verifier->occurrences,
+		.next_chunk_index = 0,
+		.valid_tris_count = 0,
+		.merged_tris_count = 0
+	};
+
+	//Spawn the additional threads, the calling thread participates as well:
+	rm_thread* threads = (threads_count > 1) ? rm_malloc((threads_count - 1) * sizeof(rm_thread)) : null;
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_create(&threads[i], rm_tristripper_verifier_worker, &job);
+	}
+
+	rm_tristripper_verifier_worker(&job);
+
+	for (rm_size i = 0; i + 1 < threads_count; i++)
+	{
+		rm_thread_join(threads[i]);
 	}
+
+	rm_free(threads);
+
+	//All the triangles that have not been merged are first occurrences:
+	verifier->valid_tris_count = job.valid_tris_count;
+	verifier->distinct_valid_tris_count = job.valid_tris_count - job.merged_tris_count;
+
+	rm_mem_pop_tag(previous_mem_tag);
 }
 
 rm_void rm_tristripper_dispose_verifier(rm_tristripper_verifier* verifier)
 {
 	//Dispose the hashmap:
-	rm_tristripper_tri_occurrence_hashmap_dispose(&verifier->occurrences);
+	rm_tristripper_tri_occurrence_sharded_hashmap_dispose(&verifier->occurrences);
 }
 
 rm_bool rm_tristripper_verify(const rm_tristripper_verifier* verifier, const rm_tristripper_strip* strips, rm_size strips_count, rm_bool log_errors)
 {
-	//Allocate an array of multiplicities for the valid, distinct triangles.
+	//Allocate an array of multiplicities for the valid, distinct triangles (indexed by the position of one of their occurrences in the input).
 	//Initialize all of them with 0.
-	rm_size* distinct_valid_tris_multiplicities = (verifier->distinct_valid_tris_count > 0) ? rm_malloc_zero(verifier->distinct_valid_tris_count * sizeof(rm_size)) : null;
+	rm_mem_tag previous_mem_tag = rm_mem_push_tag(RM_MEM_TAG_VERIFIER);
+	rm_size* distinct_valid_tris_multiplicities = (verifier->valid_tris_count > 0) ? rm_malloc_large_zero(verifier->tris_count * sizeof(rm_size)) : null;
+	rm_mem_pop_tag(previous_mem_tag);
 
 	//Iterate over the strips.
 	//Count the total number of valid triangles we have matched.
 	rm_size valid_tris_count = 0;
 	rm_bool has_found_error = false;
 
-	for (rm_size i = 0; i < strips_count; i++)
+	//The triangles are looked up in batches, so the bucket misses in the hashmap overlap.
+	//A batch can span multiple strips, we remember where to continue.
+	rm_size strip_index = 0;
+	rm_size strip_tri_index = 0;
+
+	while (strip_index < strips_count)
 	{
-		//Get the current strip:
-		const rm_tristripper_strip* curr_strip = &strips[i];
+		rm_tristripper_id tris_ids[RM_TRISTRIPPER_VERIFIER_BATCH_COUNT][3];
+		rm_tristripper_tri_key tri_keys[RM_TRISTRIPPER_VERIFIER_BATCH_COUNT];
+		rm_size tris_count = 0;
 
-		//Iterate over the IDs:
-		for (rm_size j = 0; j < (curr_strip->ids_count - 2); j++)
+		while ((strip_index < strips_count) && (tris_count < RM_TRISTRIPPER_VERIFIER_BATCH_COUNT))
 		{
+			//Get the current strip:
+			const rm_tristripper_strip* curr_strip = &strips[strip_index];
+
+			//Go on with the next one if we are through:
+			if (strip_tri_index >= (curr_strip->ids_count - 2))
+			{
+				strip_index++;
+				strip_tri_index = 0;
+
+				continue;
+			}
+
 			//Get the IDs for the current triangle:
-			rm_tristripper_id curr_ids[] = { curr_strip->ids[j], curr_strip->ids[j + 1], curr_strip->ids[j + 2] };
+			rm_tristripper_id* curr_ids = tris_ids[tris_count];
+
+			curr_ids[0] = curr_strip->ids[strip_tri_index];
+			curr_ids[1] = curr_strip->ids[strip_tri_index + 1];
+			curr_ids[2] = curr_strip->ids[strip_tri_index + 2];
+
+			strip_tri_index++;
 
 			//Ignore degenerated triangles:
 			if (rm_unlikely((curr_ids[0] == curr_ids[1]) || (curr_ids[1] == curr_ids[2]) || (curr_ids[2] == curr_ids[0])))
@@ -205,13 +335,22 @@ rm_bool rm_tristripper_verify(const rm_tristripper_verifier* verifier, const rm_
 			}
 
 			//Build a triangle key:
-			rm_tristripper_tri_key curr_tri_key = rm_tristripper_tri_occurrence_hashmap_make_key(curr_ids[0], curr_ids[1], curr_ids[2]);
+			tri_keys[tris_count] = rm_tristripper_tri_occurrence_hashmap_make_key(curr_ids[0], curr_ids[1], curr_ids[2]);
+			tris_count++;
+		}
 
-			//Try to query the corresponding triangle.
-			//If that fails, we have found an error.
-			rm_tristripper_tri_occurrence curr_tri_occurrence;
+		//Try to query the corresponding triangles:
+		rm_tristripper_tri_occurrence tri_occurrences[RM_TRISTRIPPER_VERIFIER_BATCH_COUNT];
+		rm_bool are_tris_found[RM_TRISTRIPPER_VERIFIER_BATCH_COUNT];
+
+		rm_tristripper_tri_occurrence_sharded_hashmap_get_batch(&verifier->occurrences, tri_keys, tris_count, tri_occurrences, are_tris_found);
+
+		for (rm_size j = 0; j < tris_count; j++)
+		{
+			const rm_tristripper_id* curr_ids = tris_ids[j];
 
-			if (rm_unlikely(!rm_tristripper_tri_occurrence_hashmap_get_ex(&verifier->occurrences, curr_tri_key, &curr_tri_occurrence)))
+			//If the query has failed, we have found an error.
+			if (rm_unlikely(!are_tris_found[j]))
 			{
 				if (log_errors)
 				{
@@ -225,6 +364,7 @@ rm_bool rm_tristripper_verify(const rm_tristripper_verifier* verifier, const rm_
 			}
 
 			//Increment the multiplicity:
+			rm_tristripper_tri_occurrence curr_tri_occurrence = tri_occurrences[j];
 			rm_size new_multiplicity = ++(distinct_valid_tris_multiplicities[curr_tri_occurrence.index]);
 
 			if (rm_unlikely(new_multiplicity > curr_tri_occurrence.multiplicity))
@@ -252,7 +392,7 @@ rm_bool rm_tristripper_verify(const rm_tristripper_verifier* verifier, const rm_
 		//Oh no :( find the missing triangles to provide a helpful error message:
 		if (log_errors)
 		{
-			rm_tristripper_tri_occurrence_hashmap_for_each(&verifier->occurrences, rm_tristripper_verifier_log_missing_tris, (rm_void*)distinct_valid_tris_multiplicities);
+			rm_tristripper_tri_occurrence_sharded_hashmap_for_each(&verifier->occurrences, rm_tristripper_verifier_log_missing_tris, (rm_void*)distinct_valid_tris_multiplicities);
 		}
 
 		//That's an error, too.
@@ -0,0 +1,137 @@
+#include "rm_hashmap.h"
+#include "rm_hashmap_oa.h"
+
+#include <stdio.h>
+
+//Run random operations on an open addressing hashmap and a chained one side by side and compare every result.
+//Weak hashes (only a few bits set) and tiny load factors are part of the mix.
+
+static rm_uint64 random_state;
+static rm_uint64 hash_mask;
+
+static rm_uint64 next_random(rm_void);
+static rm_hashmap_hash hash_key(rm_uint64 key);
+static rm_bool are_keys_equal(rm_uint64 a, rm_uint64 b);
+static rm_uint64 merge_values(rm_uint64 key, rm_uint64 old_value, rm_uint64 new_value);
+
+RM_HASHMAP_DECLARE(test_chained, rm_uint64, rm_uint64, SKV)
+RM_HASHMAP_DEFINE(test_chained, hash_key, are_keys_equal, null, null, null, null, merge_values)
+
+RM_HASHMAP_OA_DECLARE(test_oa, rm_uint64, rm_uint64, SKV)
+RM_HASHMAP_OA_DEFINE(test_oa, hash_key, are_keys_equal, null, null, null, null, merge_values)
+
+static rm_uint64 next_random(rm_void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+
+	return random_state;
+}
+
+static rm_hashmap_hash hash_key(rm_uint64 key)
+{
+	return (rm_hashmap_hash)(key & hash_mask);
+}
+
+static rm_bool are_keys_equal(rm_uint64 a, rm_uint64 b)
+{
+	return (a == b);
+}
+
+static rm_uint64 merge_values(rm_uint64 key, rm_uint64 old_value, rm_uint64 new_value)
+{
+	return (old_value * 31) + new_value + key;
+}
+
+int main(void)
+{
+	const rm_double load_factors[] = { 0.001, 0.01, 0.3, 0.75, 0.875, 2.0 };
+	const rm_uint64 hash_masks[] = { ~(rm_uint64)0, 0xf, 0xffff0000 };
+
+	for (rm_size round = 0; round < 60; round++)
+	{
+		random_state = 0x9E3779B97F4A7C15ull * (round + 1);
+		hash_mask = hash_masks[round % rm_array_count(hash_masks)];
+
+		rm_double load_factor = load_factors[round % rm_array_count(load_factors)];
+		rm_size initial_buckets_count = (round % 4 == 0) ? 0 : (rm_size)(next_random() % 300);
+		rm_uint64 keys_range = 1 + (next_random() % 3000);
+
+		rm_test_chained_hashmap chained;
+		rm_test_oa_hashmap oa;
+
+		rm_test_chained_hashmap_init_ex(&chained, initial_buckets_count, load_factor);
+		rm_test_oa_hashmap_init_ex(&oa, initial_buckets_count, load_factor);
+
+		for (rm_size i = 0; i < 20000; i++)
+		{
+			rm_uint64 key = next_random() % keys_range;
+			rm_uint64 value = next_random();
+
+			rm_bool chained_result;
+			rm_bool oa_result;
+			rm_uint64 chained_value = 1;
+			rm_uint64 oa_value = 1;
+
+			switch (next_random() % 8)
+			{
+				case 0:
+				case 1:
+				case 2:
+				case 3:
+				{
+					rm_hashmap_update_mode mode = (rm_hashmap_update_mode)(next_random() % 5);
+					chained_result = rm_test_chained_hashmap_update(&chained, key, value, mode, &chained_value);
+					oa_result = rm_test_oa_hashmap_update(&oa, key, value, mode, &oa_value);
+					break;
+				}
+
+				case 4:
+				case 5:
+					chained_result = rm_test_chained_hashmap_remove(&chained, key);
+					oa_result = rm_test_oa_hashmap_remove(&oa, key);
+					break;
+
+				case 6:
+					chained_result = rm_test_chained_hashmap_get_ex(&chained, key, &chained_value);
+					oa_result = rm_test_oa_hashmap_get_ex(&oa, key, &oa_value);
+					break;
+
+				default:
+					chained_result = rm_test_chained_hashmap_set(&chained, key, value);
+					oa_result = rm_test_oa_hashmap_set(&oa, key, value);
+					break;
+			}
+
+			if ((chained_result != oa_result) || (chained_value != oa_value) || (chained.count != oa.count))
+			{
+				printf("FAILED: Round %zu, operation %zu differs.\n", round, i);
+				return 1;
+			}
+
+			//Start over every now and then:
+			if ((next_random() % 5000) == 0)
+			{
+				rm_test_chained_hashmap_clear(&chained);
+				rm_test_oa_hashmap_clear(&oa);
+			}
+		}
+
+		//Compare the final contents:
+		for (rm_uint64 key = 0; key < keys_range; key++)
+		{
+			if (rm_test_chained_hashmap_get(&chained, key, 5) != rm_test_oa_hashmap_get(&oa, key, 5))
+			{
+				printf("FAILED: Round %zu, key %llu differs.\n", round, (unsigned long long)key);
+				return 1;
+			}
+		}
+
+		rm_test_chained_hashmap_dispose(&chained);
+		rm_test_oa_hashmap_dispose(&oa);
+	}
+
+	printf("OK\n");
+	return 0;
+}
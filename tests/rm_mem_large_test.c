@@ -0,0 +1,52 @@
+#include "rm_mem.h"
+#include "rm_vec.h"
+
+#include <stdio.h>
+
+//Grow a vector across the large threshold with prefaulting enabled and check that no element has been overwritten.
+//Build this with "RM_MEM_NO_POPULATE_WRITE" (see "make test"), so the pages are touched by hand.
+int main(void)
+{
+	//Advise everything from 64 KiB on and fault it in right away:
+	rm_mem_large_config config =
+	{
+		.threshold = (rm_size)64 << 10,
+		.huge_pages = true,
+		.prefault = true
+	};
+
+	rm_mem_set_large_config(&config);
+
+	//Push enough elements for many reallocations of the large path:
+	rm_vec(rm_uint32) vec;
+	rm_vec_init(&vec);
+
+	rm_size count = (rm_size)1 << 24;
+
+	for (rm_size i = 0; i < count; i++)
+	{
+		rm_vec_push(&vec, (rm_uint32)(i * 2654435761u) | 1);
+	}
+
+	//Check the contents:
+	rm_size broken_count = 0;
+
+	for (rm_size i = 0; i < count; i++)
+	{
+		if (vec.data[i] != ((rm_uint32)(i * 2654435761u) | 1))
+		{
+			broken_count++;
+		}
+	}
+
+	rm_vec_dispose(&vec);
+
+	if (broken_count > 0)
+	{
+		printf("FAILED: %zu of %zu elements have been overwritten.\n", broken_count, count);
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include "rm_mem.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_codec.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//Encode strips, decode them both ways and compare the result with the input.
+//The random strips mix all kinds of codes (new vertices, recent ones, far jumps near the end of the ID range and swaps),
+// the stripped grid is the common case before and after renumbering.
+
+static rm_uint64 random_state;
+
+static rm_uint64 next_random(rm_void);
+
+//Create strips that hit every type of code:
+static rm_void create_random_strips(rm_size strips_count, rm_tristripper_strip** strips);
+
+//Encode the strips, decode them into a buffer and into separate strips, and compare both with the input.
+//Return "false" (after printing why) if anything differs.
+static rm_bool check_round_trip(const rm_char* name, const rm_tristripper_strip* strips, rm_size strips_count);
+
+static rm_uint64 next_random(rm_void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+
+	return random_state;
+}
+
+static rm_void create_random_strips(rm_size strips_count, rm_tristripper_strip** strips)
+{
+	*strips = (strips_count == 0) ? null : rm_malloc(strips_count * sizeof(rm_tristripper_strip));
+
+	rm_tristripper_id high_id = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		rm_tristripper_strip* strip = &(*strips)[i];
+		strip->ids_count = 1 + (rm_size)(next_random() % 40);
+		strip->ids = rm_malloc(strip->ids_count * sizeof(rm_tristripper_id));
+
+		for (rm_size j = 0; j < strip->ids_count; j++)
+		{
+			rm_tristripper_id id;
+
+			switch (next_random() % 6)
+			{
+				case 0:
+				case 1:
+					//New, sometimes with a gap:
+					high_id += 1 + (((next_random() % 4) == 0) ? (rm_tristripper_id)(next_random() % 100000) : 0);
+					id = high_id;
+					break;
+
+				case 2:
+					//Recent:
+					id = (j > 0) ? strip->ids[(rm_size)(next_random() % j)] : high_id;
+					break;
+
+				case 3:
+					//Swap:
+					id = (j > 1) ? strip->ids[j - 2] : 0;
+					break;
+
+				case 4:
+					//Far away (up to the largest ID a strip can use):
+					id = (rm_tristripper_id)(UINT32_MAX - 1 - (next_random() % 1000));
+					break;
+
+				default:
+					id = (rm_tristripper_id)(next_random() % (rm_uint64)(high_id + 1));
+					break;
+			}
+
+			strip->ids[j] = id;
+		}
+	}
+}
+
+static rm_bool check_round_trip(const rm_char* name, const rm_tristripper_strip* strips, rm_size strips_count)
+{
+	rm_uint8* data = rm_malloc(rm_tristripper_codec_max_size(strips, strips_count));
+	rm_size size = rm_tristripper_codec_encode(strips, strips_count, data);
+
+	rm_tristripper_codec_header header;
+	rm_tristripper_codec_read_header(data, size, &header);
+
+	rm_size ids_count = 0;
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		ids_count += strips[i].ids_count;
+	}
+
+	if ((header.strips_count != strips_count) || (header.ids_count != ids_count))
+	{
+		printf("FAILED: %s: The header has %zu strips and %zu IDs instead of %zu and %zu.\n", name, header.strips_count, header.ids_count, strips_count, ids_count);
+		return false;
+	}
+
+	//Into a single buffer:
+	rm_tristripper_id* ids = rm_malloc(rm_max(ids_count, (rm_size)1) * sizeof(rm_tristripper_id));
+	rm_size* strip_ids_counts = rm_malloc(rm_max(strips_count, (rm_size)1) * sizeof(rm_size));
+
+	rm_tristripper_codec_decode_ids(data, size, ids, strip_ids_counts);
+
+	//Into separate strips:
+	rm_tristripper_strip* decoded_strips;
+	rm_size decoded_strips_count;
+
+	rm_tristripper_codec_decode(data, size, &decoded_strips, &decoded_strips_count);
+
+	rm_bool result = (decoded_strips_count == strips_count);
+	rm_size ids_index = 0;
+
+	for (rm_size i = 0; result && (i < strips_count); i++)
+	{
+		rm_size strip_size = strips[i].ids_count * sizeof(rm_tristripper_id);
+
+		result = (strip_ids_counts[i] == strips[i].ids_count) && (memcmp(&ids[ids_index], strips[i].ids, strip_size) == 0) &&
+			(decoded_strips[i].ids_count == strips[i].ids_count) && (memcmp(decoded_strips[i].ids, strips[i].ids, strip_size) == 0);
+
+		if (!result)
+		{
+			printf("FAILED: %s: Strip %zu has not survived the round trip.\n", name, i);
+		}
+
+		ids_index += strips[i].ids_count;
+	}
+
+	rm_tristripper_dispose_strips(decoded_strips, decoded_strips_count);
+	rm_free(strip_ids_counts);
+	rm_free(ids);
+	rm_free(data);
+
+	return result;
+}
+
+int main(void)
+{
+	//Nothing at all:
+	if (!check_round_trip("empty", null, 0))
+	{
+		return 1;
+	}
+
+	//Random strips:
+	for (rm_size round = 0; round < 200; round++)
+	{
+		random_state = 0x9E3779B97F4A7C15ull * (round + 1);
+
+		rm_tristripper_strip* strips;
+		rm_size strips_count = 1 + (rm_size)(next_random() % 50);
+
+		create_random_strips(strips_count, &strips);
+
+		rm_char name[64];
+		snprintf(name, sizeof(name), "random round %zu", round);
+
+		if (!check_round_trip(name, strips, strips_count))
+		{
+			return 1;
+		}
+
+		rm_tristripper_dispose_strips(strips, strips_count);
+	}
+
+	//Strips of a grid with shuffled vertex IDs:
+	const rm_size grid_size = 40;
+	rm_size vertices_count = (grid_size + 1) * (grid_size + 1);
+
+	rm_tristripper_id* vertex_ids = rm_malloc(vertices_count * sizeof(rm_tristripper_id));
+
+	for (rm_size i = 0; i < vertices_count; i++)
+	{
+		vertex_ids[i] = (rm_tristripper_id)i;
+	}
+
+	for (rm_size i = vertices_count - 1; i > 0; i--)
+	{
+		rm_size other_index = (rm_size)(next_random() % (i + 1));
+		rm_swap(&vertex_ids[i], &vertex_ids[other_index]);
+	}
+
+	rm_size ids_count = 6 * grid_size * grid_size;
+	rm_tristripper_id* ids = rm_malloc(ids_count * sizeof(rm_tristripper_id));
+	rm_size ids_index = 0;
+
+	for (rm_size y = 0; y < grid_size; y++)
+	{
+		for (rm_size x = 0; x < grid_size; x++)
+		{
+			rm_tristripper_id a = vertex_ids[(y * (grid_size + 1)) + x];
+			rm_tristripper_id b = vertex_ids[(y * (grid_size + 1)) + x + 1];
+			rm_tristripper_id c = vertex_ids[((y + 1) * (grid_size + 1)) + x];
+			rm_tristripper_id d = vertex_ids[((y + 1) * (grid_size + 1)) + x + 1];
+
+			ids[ids_index++] = a;
+			ids[ids_index++] = b;
+			ids[ids_index++] = c;
+			ids[ids_index++] = b;
+			ids[ids_index++] = d;
+			ids[ids_index++] = c;
+		}
+	}
+
+	rm_tristripper_config config =
+	{
+		.use_tunneling = true,
+		.preserve_orientation = false,
+		.reorder_algorithm = RM_TRISTRIPPER_REORDER_ALGORITHM_NONE,
+		.threads_count = 1,
+		.exact_max_count = RM_TRISTRIPPER_NO_EXACT,
+		.preproc_algorithm = RM_TRISTRIPPER_PREPROC_ALGORITHM_STRIPIFY,
+		.max_count = 16,
+		.incremental = true,
+		.loop_limit = 2000,
+		.backtrack_after_loop_limit = true,
+		.dest_count = RM_TRISTRIPPER_NO_DEST_COUNT,
+		.optimize_usecs = RM_TRISTRIPPER_NO_OPTIMIZE
+	};
+
+	rm_tristripper_strip* strips;
+	rm_size strips_count;
+
+	rm_tristripper_create_strips(ids, ids_count, &config, &strips, &strips_count);
+
+	if (!check_round_trip("grid", strips, strips_count))
+	{
+		return 1;
+	}
+
+	//Renumbered, every vertex must map back to the one it came from:
+	rm_tristripper_strip* renumbered_strips = rm_malloc(strips_count * sizeof(rm_tristripper_strip));
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		renumbered_strips[i].ids_count = strips[i].ids_count;
+		renumbered_strips[i].ids = rm_mem_dup(strips[i].ids, strips[i].ids_count * sizeof(rm_tristripper_id));
+	}
+
+	rm_tristripper_id* remap = rm_malloc(vertices_count * sizeof(rm_tristripper_id));
+	rm_size used_count = rm_tristripper_codec_renumber(renumbered_strips, strips_count, remap, vertices_count);
+
+	if (used_count != vertices_count)
+	{
+		printf("FAILED: grid: %zu of %zu vertices are used after renumbering.\n", used_count, vertices_count);
+		return 1;
+	}
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		for (rm_size j = 0; j < strips[i].ids_count; j++)
+		{
+			if (remap[strips[i].ids[j]] != renumbered_strips[i].ids[j])
+			{
+				printf("FAILED: grid: ID %zu of strip %zu has not been renumbered consistently.\n", j, i);
+				return 1;
+			}
+		}
+	}
+
+	if (!check_round_trip("renumbered grid", renumbered_strips, strips_count))
+	{
+		return 1;
+	}
+
+	rm_free(remap);
+	rm_tristripper_dispose_strips(renumbered_strips, strips_count);
+	rm_tristripper_dispose_strips(strips, strips_count);
+	rm_free(ids);
+	rm_free(vertex_ids);
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include "rm_tristripper_mesh.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//Write small meshes in every supported format (and every PLY encoding) and check the triangles the reader makes of them.
+//The files contain the things real exporters produce: comments, extra properties, quads, degenerated faces,
+// "v/vt/vn" vertices, negative OBJ indices, CRLF line breaks and binary STL files that start with "solid".
+
+//Write a file to the temporary directory and return its path (valid until the next call):
+static const rm_char* write_file(const rm_char* name, const rm_void* data, rm_size size);
+
+//Read a mesh and compare its triangles with the expected ones.
+//Return "false" (after printing why) if they differ.
+static rm_bool check_mesh(const rm_char* path, rm_tristripper_mesh_format format, const rm_tristripper_id* expected_ids, rm_size expected_ids_count);
+
+//Append values to a binary file in the given byte order:
+static rm_void append_bytes(rm_uint8* data, rm_size* size, const rm_void* src_ptr, rm_size count);
+static rm_void append_uint32(rm_uint8* data, rm_size* size, rm_uint32 value, rm_bool is_big_endian);
+static rm_void append_float32(rm_uint8* data, rm_size* size, rm_float value);
+
+static const rm_char* write_file(const rm_char* name, const rm_void* data, rm_size size)
+{
+	static rm_char path[4096];
+
+	const rm_char* temp_dir = getenv("TMPDIR");
+	snprintf(path, sizeof(path), "%s/rm_tristripper_mesh_test_%ld_%s", temp_dir ? temp_dir : "/tmp", (long)getpid(), name);
+
+	FILE* file = fopen(path, "wb");
+
+	if (!file || (fwrite(data, 1, size, file) != size) || (fclose(file) != 0))
+	{
+		printf("FAILED: Could not write \"%s\".\n", path);
+		exit(1);
+	}
+
+	return path;
+}
+
+static rm_bool check_mesh(const rm_char* path, rm_tristripper_mesh_format format, const rm_tristripper_id* expected_ids, rm_size expected_ids_count)
+{
+	rm_tristripper_id_vec ids;
+	rm_vec_init(&ids);
+
+	//Something is already there, the reader must append:
+	rm_vec_push(&ids, 42);
+
+	rm_tristripper_read_mesh(path, format, &ids);
+	remove(path);
+
+	rm_bool result = (ids.count == expected_ids_count + 1) && (ids.data[0] == 42) && (memcmp(&ids.data[1], expected_ids, expected_ids_count * sizeof(rm_tristripper_id)) == 0);
+
+	if (!result)
+	{
+		printf("FAILED: \"%s\" has been read as:", path);
+
+		for (rm_size i = 1; i < ids.count; i++)
+		{
+			printf(" %" PRIu32, ids.data[i]);
+		}
+
+		printf("\n");
+	}
+
+	rm_vec_dispose(&ids);
+
+	return result;
+}
+
+static rm_void append_bytes(rm_uint8* data, rm_size* size, const rm_void* src_ptr, rm_size count)
+{
+	memcpy(data + *size, src_ptr, count);
+	*size += count;
+}
+
+static rm_void append_uint32(rm_uint8* data, rm_size* size, rm_uint32 value, rm_bool is_big_endian)
+{
+	for (rm_size i = 0; i < 4; i++)
+	{
+		data[(*size)++] = (rm_uint8)(value >> (is_big_endian ? (24 - (8 * i)) : (8 * i)));
+	}
+}
+
+static rm_void append_float32(rm_uint8* data, rm_size* size, rm_float value)
+{
+	rm_uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	append_uint32(data, size, bits, false);
+}
+
+int main(void)
+{
+	rm_uint8 data[4096];
+	rm_size size;
+
+	//Extensions:
+	rm_tristripper_mesh_format format;
+
+	if (!rm_tristripper_mesh_format_from_path("a/b.c/mesh.PLY", &format) || (format != RM_TRISTRIPPER_MESH_FORMAT_PLY) ||
+		!rm_tristripper_mesh_format_from_path("mesh.obj", &format) || (format != RM_TRISTRIPPER_MESH_FORMAT_OBJ) ||
+		!rm_tristripper_mesh_format_from_path("mesh.Stl", &format) || (format != RM_TRISTRIPPER_MESH_FORMAT_STL) ||
+		rm_tristripper_mesh_format_from_path("mesh.bin", &format) || rm_tristripper_mesh_format_from_path("mesh", &format))
+	{
+		printf("FAILED: The format is not derived from the extension correctly.\n");
+		return 1;
+	}
+
+	//ASCII PLY with a quad, a triangle with an extra property and a face that is dropped:
+	const rm_char* ply_ascii =
+		"ply\n"
+		"format ascii 1.0\n"
+		"comment made by hand\n"
+		"element vertex 5\n"
+		"property float x\n"
+		"property float y\n"
+		"property float z\n"
+		"element face 3\n"
+		"property list uchar int vertex_indices\n"
+		"property uchar red\n"
+		"end_header\n"
+		"0 0 0\n"
+		"1 0 0\n"
+		"1 1 0\n"
+		"0 1 0\n"
+		"2 2 2\n"
+		"4 0 1 2 3 7\n"
+		"3 1 4 2 9\n"
+		"2 0 1 5\n";
+
+	const rm_tristripper_id ply_ascii_ids[] = { 0, 1, 2, 0, 2, 3, 1, 4, 2 };
+
+	if (!check_mesh(write_file("ascii.ply", ply_ascii, strlen(ply_ascii)), RM_TRISTRIPPER_MESH_FORMAT_PLY, ply_ascii_ids, rm_array_count(ply_ascii_ids)))
+	{
+		return 1;
+	}
+
+	//Binary PLY (both byte orders) with a scalar property in front of the indices and another element after the faces:
+	for (rm_size i = 0; i < 2; i++)
+	{
+		rm_bool is_big_endian = (i == 1);
+
+		size = 0;
+		size += (rm_size)sprintf((rm_char*)data,
+			"ply\n"
+			"format %s 1.0\n"
+			"element vertex 11\n"
+			"property double x\n"
+			"element face 2\n"
+			"property float quality\n"
+			"property list uint8 uint32 vertex_index\n"
+			"element edge 1\n"
+			"property int vertex1\n"
+			"end_header\n",
+			is_big_endian ? "binary_big_endian" : "binary_little_endian");
+
+		rm_uint8 vertices[11 * 8] = { 0 };
+		append_bytes(data, &size, vertices, sizeof(vertices));
+
+		const rm_uint32 faces[2][4] = { { 5, 6, 7 }, { 7, 8, 9, 10 } };
+
+		for (rm_size j = 0; j < 2; j++)
+		{
+			append_uint32(data, &size, 0x3F800000, is_big_endian);
+			data[size++] = (rm_uint8)(3 + j);
+
+			for (rm_size k = 0; k < 3 + j; k++)
+			{
+				append_uint32(data, &size, faces[j][k], is_big_endian);
+			}
+		}
+
+		append_uint32(data, &size, 1, is_big_endian);
+
+		const rm_tristripper_id ply_binary_ids[] = { 5, 6, 7, 7, 8, 9, 7, 9, 10 };
+
+		if (!check_mesh(write_file(is_big_endian ? "be.ply" : "le.ply", data, size), RM_TRISTRIPPER_MESH_FORMAT_PLY, ply_binary_ids, rm_array_count(ply_binary_ids)))
+		{
+			return 1;
+		}
+	}
+
+	//OBJ with all kinds of vertex references and line breaks:
+	const rm_char* obj =
+		"# made by hand\r\n"
+		"mtllib mesh.mtl\r\n"
+		"v 0 0 0\r\n"
+		"v 1 0 0\r\n"
+		"v 1 1 0\n"
+		"v 0 1 0\n"
+		"vt 0 0\n"
+		"vn 0 0 1\n"
+		"o quad\n"
+		"f 1/1/1 2/1/1 3/1/1\r\n"
+		"f 1//1 3//1 4//1\n"
+		"\tf -4 -3 -2 -1\n"
+		"f 1 2\n"
+		"s off\n"
+		"f 4 3 2";
+
+	const rm_tristripper_id obj_ids[] = { 0, 1, 2, 0, 2, 3, 0, 1, 2, 0, 2, 3, 3, 2, 1 };
+
+	if (!check_mesh(write_file("mesh.obj", obj, strlen(obj)), RM_TRISTRIPPER_MESH_FORMAT_OBJ, obj_ids, rm_array_count(obj_ids)))
+	{
+		return 1;
+	}
+
+	//Binary STL that starts with "solid", two triangles share an edge (once with -0.0 instead of 0.0):
+	const rm_float stl_tris[2][3][3] =
+	{
+		{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { -0.0f, 1.0f, 0.0f } }
+	};
+
+	size = 0;
+	memset(data, 0, 80);
+	memcpy(data, "solid but binary", 16);
+	size += 80;
+
+	append_uint32(data, &size, 2, false);
+
+	for (rm_size i = 0; i < 2; i++)
+	{
+		//Normal, vertices, attribute:
+		for (rm_size j = 0; j < 3; j++)
+		{
+			append_float32(data, &size, 0.0f);
+		}
+
+		for (rm_size j = 0; j < 3; j++)
+		{
+			for (rm_size k = 0; k < 3; k++)
+			{
+				append_float32(data, &size, stl_tris[i][j][k]);
+			}
+		}
+
+		data[size++] = 0;
+		data[size++] = 0;
+	}
+
+	const rm_tristripper_id stl_ids[] = { 0, 1, 2, 1, 3, 2 };
+
+	if (!check_mesh(write_file("mesh.stl", data, size), RM_TRISTRIPPER_MESH_FORMAT_STL, stl_ids, rm_array_count(stl_ids)))
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include "rm_mem.h"
+#include "rm_tristripper.h"
+#include "rm_tristripper_strip_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//Write tiles of random strips to a strip file, map it and read every tile and every strip back.
+//The IDs jump around the whole range (so the deltas need every varint length), one tile is empty and one brings its own stats.
+
+#define TILES_COUNT ((rm_size)24)
+
+static rm_uint64 random_state;
+
+static rm_uint64 next_random(rm_void);
+
+//Create the strips of a tile:
+static rm_void create_random_strips(rm_size strips_count, rm_tristripper_strip** strips);
+
+//Compare a strip with the one that has been written:
+static rm_bool is_same_strip(const rm_tristripper_strip* strip, const rm_tristripper_id* ids, rm_size ids_count);
+
+static rm_uint64 next_random(rm_void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+
+	return random_state;
+}
+
+static rm_void create_random_strips(rm_size strips_count, rm_tristripper_strip** strips)
+{
+	*strips = (strips_count == 0) ? null : rm_malloc(strips_count * sizeof(rm_tristripper_strip));
+
+	for (rm_size i = 0; i < strips_count; i++)
+	{
+		rm_tristripper_strip* strip = &(*strips)[i];
+		strip->ids_count = 3 + (rm_size)(next_random() % 60);
+		strip->ids = rm_malloc(strip->ids_count * sizeof(rm_tristripper_id));
+
+		for (rm_size j = 0; j < strip->ids_count; j++)
+		{
+			switch (next_random() % 4)
+			{
+				case 0:
+					//Anywhere:
+					strip->ids[j] = (rm_tristripper_id)next_random();
+					break;
+
+				case 1:
+					//A swap:
+					strip->ids[j] = (j > 1) ? strip->ids[j - 2] : 0;
+					break;
+
+				default:
+					//Close to the previous one:
+					strip->ids[j] = (j > 0) ? (strip->ids[j - 1] + (rm_tristripper_id)(next_random() % 7) - 3) : (rm_tristripper_id)(next_random() % 1000);
+					break;
+			}
+		}
+	}
+}
+
+static rm_bool is_same_strip(const rm_tristripper_strip* strip, const rm_tristripper_id* ids, rm_size ids_count)
+{
+	return (strip->ids_count == ids_count) && (memcmp(strip->ids, ids, ids_count * sizeof(rm_tristripper_id)) == 0);
+}
+
+int main(void)
+{
+	const rm_char* temp_dir = getenv("TMPDIR");
+
+	rm_char path[4096];
+	snprintf(path, sizeof(path), "%s/rm_tristripper_strip_file_test_%ld.rmts", temp_dir ? temp_dir : "/tmp", (long)getpid());
+
+	//Write the tiles and keep them for the comparison:
+	rm_tristripper_strip* tiles_strips[TILES_COUNT];
+	rm_size tiles_strips_counts[TILES_COUNT];
+	rm_tristripper_stats tiles_stats[TILES_COUNT];
+
+	random_state = 0x9E3779B97F4A7C15ull;
+
+	rm_tristripper_strip_file_writer writer;
+	rm_tristripper_strip_file_writer_open(&writer, path);
+
+	for (rm_size i = 0; i < TILES_COUNT; i++)
+	{
+		tiles_strips_counts[i] = (i == 3) ? 0 : (1 + (rm_size)(next_random() % 200));
+		create_random_strips(tiles_strips_counts[i], &tiles_strips[i]);
+
+		rm_tristripper_calculate_stats(tiles_strips[i], tiles_strips_counts[i], &tiles_stats[i]);
+
+		//Let the writer calculate the stats on its own for all tiles but one:
+		rm_tristripper_strip_file_writer_add_tile(&writer, tiles_strips[i], tiles_strips_counts[i], (i == 5) ? &tiles_stats[i] : null);
+	}
+
+	rm_tristripper_strip_file_writer_close(&writer);
+
+	//Read them back:
+	rm_tristripper_strip_file file;
+	rm_tristripper_strip_file_open(&file, path, RM_FILE_MAP_ACCESS_SEQUENTIAL);
+
+	if (file.tiles_count != TILES_COUNT)
+	{
+		printf("FAILED: The file has %zu tiles instead of %zu.\n", file.tiles_count, TILES_COUNT);
+		return 1;
+	}
+
+	rm_size strip_index = 0;
+
+	for (rm_size i = 0; i < TILES_COUNT; i++)
+	{
+		rm_tristripper_strip_file_tile tile;
+		rm_tristripper_strip_file_get_tile(&file, i, &tile);
+
+		rm_size ids_count = 0;
+
+		for (rm_size j = 0; j < tiles_strips_counts[i]; j++)
+		{
+			ids_count += tiles_strips[i][j].ids_count;
+		}
+
+		const rm_tristripper_stats* stats = &tiles_stats[i];
+
+		if ((tile.first_strip_index != strip_index) || (tile.strips_count != tiles_strips_counts[i]) || (tile.ids_count != ids_count) ||
+			(tile.stats.strips_count != stats->strips_count) || (tile.stats.valid_tris_count != stats->valid_tris_count) || (tile.stats.swaps_count != stats->swaps_count) ||
+			(memcmp(tile.stats.vertex_cost_models, stats->vertex_cost_models, sizeof(stats->vertex_cost_models)) != 0))
+		{
+			printf("FAILED: The table entry of tile %zu differs.\n", i);
+			return 1;
+		}
+
+		//The whole tile:
+		rm_tristripper_strip* strips;
+		rm_size strips_count;
+
+		rm_tristripper_strip_file_read_tile(&file, i, &strips, &strips_count);
+
+		for (rm_size j = 0; j < strips_count; j++)
+		{
+			if (!is_same_strip(&tiles_strips[i][j], strips[j].ids, strips[j].ids_count))
+			{
+				printf("FAILED: Strip %zu of tile %zu differs.\n", j, i);
+				return 1;
+			}
+		}
+
+		rm_tristripper_dispose_strips(strips, strips_count);
+
+		//Strip by strip:
+		for (rm_size j = 0; j < tiles_strips_counts[i]; j++)
+		{
+			rm_size strip_ids_count = rm_tristripper_strip_file_get_strip_ids_count(&file, strip_index);
+			rm_tristripper_id* ids = rm_malloc(strip_ids_count * sizeof(rm_tristripper_id));
+
+			rm_tristripper_strip_file_decode_strip(&file, strip_index, ids);
+
+			if (!is_same_strip(&tiles_strips[i][j], ids, strip_ids_count))
+			{
+				printf("FAILED: Strip %zu differs when it is decoded on its own.\n", strip_index);
+				return 1;
+			}
+
+			rm_free(ids);
+			strip_index++;
+		}
+
+		rm_tristripper_dispose_strips(tiles_strips[i], tiles_strips_counts[i]);
+	}
+
+	if (file.strips_count != strip_index)
+	{
+		printf("FAILED: The file has %zu strips instead of %zu.\n", file.strips_count, strip_index);
+		return 1;
+	}
+
+	rm_tristripper_strip_file_close(&file);
+	remove(path);
+
+	printf("OK\n");
+	return 0;
+}